@@ -0,0 +1,96 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+// Large contiguous vs. chunked and compressed arrays written/read with h5::array_interface (through the HDF5 filter
+// pipeline or with the direct chunk I/O).
+
+#include <benchmark/benchmark.h>
+#include <h5/h5.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+  // Smooth data which compresses reasonably well.
+  std::vector<double> make_data(long n) {
+    std::vector<double> data(n);
+    for (long i = 0; i < n; ++i) data[i] = std::sin(0.001 * static_cast<double>(i));
+    return data;
+  }
+
+  h5::array_interface::array_view make_view(std::vector<double> &data) {
+    h5::array_interface::array_view v{h5::hdf5_type<double>(), (void *)data.data(), 1, false};
+    v.slab.count[0] = v.parent_shape[0] = data.size();
+    return v;
+  }
+
+  h5::write_options make_options(bool chunked) {
+    if (not chunked) return {};
+    return h5::write_options{.chunk_bytes = 1 << 20, .deflate_level = 1, .shuffle = true};
+  }
+
+} // namespace
+
+static void BM_ArrayWrite(benchmark::State &state, bool chunked) {
+  auto data = make_data(state.range(0));
+  auto opts = make_options(chunked);
+  h5::file f("bench_array.h5", 'w');
+  for (auto _ : state) h5::array_interface::write(f, "data", make_view(data), opts);
+  state.SetBytesProcessed(static_cast<long>(state.iterations() * data.size() * sizeof(double)));
+}
+BENCHMARK_CAPTURE(BM_ArrayWrite, contiguous, false)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+BENCHMARK_CAPTURE(BM_ArrayWrite, chunked_deflate, true)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+static void BM_ArrayRead(benchmark::State &state, bool chunked) {
+  auto data = make_data(state.range(0));
+  {
+    h5::file f("bench_array.h5", 'w');
+    h5::array_interface::write(f, "data", make_view(data), make_options(chunked));
+  }
+  h5::file f("bench_array.h5", 'r');
+  for (auto _ : state) {
+    h5::array_interface::read(f, "data", make_view(data));
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<long>(state.iterations() * data.size() * sizeof(double)));
+}
+BENCHMARK_CAPTURE(BM_ArrayRead, contiguous, false)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+BENCHMARK_CAPTURE(BM_ArrayRead, chunked_deflate, true)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+static void BM_ArrayWriteChunks(benchmark::State &state) {
+  auto data = make_data(state.range(0));
+  auto opts = make_options(true);
+  h5::file f("bench_array.h5", 'w');
+  for (auto _ : state) h5::array_interface::write_chunks(f, "data", make_view(data), opts);
+  state.SetBytesProcessed(static_cast<long>(state.iterations() * data.size() * sizeof(double)));
+}
+BENCHMARK(BM_ArrayWriteChunks)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+static void BM_ArrayReadChunks(benchmark::State &state) {
+  auto data = make_data(state.range(0));
+  {
+    h5::file f("bench_array.h5", 'w');
+    h5::array_interface::write_chunks(f, "data", make_view(data), make_options(true));
+  }
+  h5::file f("bench_array.h5", 'r');
+  for (auto _ : state) {
+    h5::array_interface::read_chunks(f, "data", make_view(data));
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<long>(state.iterations() * data.size() * sizeof(double)));
+}
+BENCHMARK(BM_ArrayReadChunks)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
@@ -0,0 +1,77 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+// Enumeration of groups with many children.
+
+#include <benchmark/benchmark.h>
+#include <h5/h5.hpp>
+
+#include <set>
+#include <string>
+
+namespace {
+
+  // Create a file with a group containing one dataset and n - 1 soft links to it (once per process and size).
+  std::string prepare_file(long n) {
+    static std::set<long> prepared;
+    auto fname = "bench_group_" + std::to_string(n) + ".h5";
+    if (prepared.insert(n).second) {
+      h5::file f(fname, 'w');
+      auto g = h5::group{f}.create_group("children");
+      h5::write(g, "target", 1.0);
+      for (long i = 1; i < n; ++i) g.create_softlink("target", "link_" + std::to_string(i), false);
+    }
+    return fname;
+  }
+
+} // namespace
+
+static void BM_GroupForEachChild(benchmark::State &state) {
+  h5::file f(prepare_file(state.range(0)), 'r');
+  auto g = h5::group{f}.open_group("children");
+  for (auto _ : state) {
+    long count = 0;
+    g.for_each_child([&count](std::string_view, h5::object_type) { return ++count, true; });
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GroupForEachChild)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_GroupAllNames(benchmark::State &state) {
+  h5::file f(prepare_file(state.range(0)), 'r');
+  auto g = h5::group{f}.open_group("children");
+  for (auto _ : state) {
+    auto names = g.get_all_subgroup_dataset_names();
+    benchmark::DoNotOptimize(names.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GroupAllNames)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_GroupHasKey(benchmark::State &state) {
+  h5::file f(prepare_file(state.range(0)), 'r');
+  auto g    = h5::group{f}.open_group("children");
+  long i    = 1;
+  auto name = std::string{};
+  for (auto _ : state) {
+    name = "link_" + std::to_string(i);
+    benchmark::DoNotOptimize(g.has_key(name));
+    i = (i % (state.range(0) - 1)) + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GroupHasKey)->Arg(10000)->Arg(100000)->Arg(1000000);
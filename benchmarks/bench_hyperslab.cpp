@@ -0,0 +1,88 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+// Strided hyperslab reads from a 2-dimensional dataset.
+
+#include <benchmark/benchmark.h>
+#include <h5/h5.hpp>
+
+#include <numeric>
+#include <vector>
+
+namespace {
+
+  constexpr h5::hsize_t n_rows = 4096;
+  constexpr h5::hsize_t n_cols = 1024;
+
+  // Write the dataset once per process.
+  void prepare_file() {
+    static bool const done = []() {
+      std::vector<double> data(n_rows * n_cols);
+      std::iota(data.begin(), data.end(), 0.0);
+      h5::array_interface::array_view v{h5::hdf5_type<double>(), (void *)data.data(), 2, false};
+      v.slab.count = v.parent_shape = {n_rows, n_cols};
+      h5::file f("bench_hyperslab.h5", 'w');
+      h5::array_interface::write(f, "contiguous", v, h5::write_options{});
+      h5::array_interface::write(f, "chunked", v, h5::write_options{.chunk_shape = {64, 64}});
+      return true;
+    }();
+    benchmark::DoNotOptimize(done);
+  }
+
+  // Read every stride-th row or column (all columns/rows) into a contiguous buffer.
+  void read_strided(benchmark::State &state, const char *name, bool rows) {
+    prepare_file();
+    auto stride = static_cast<h5::hsize_t>(state.range(0));
+    h5::file f("bench_hyperslab.h5", 'r');
+    auto ds = h5::group{f}.open_dataset(name);
+
+    h5::array_interface::hyperslab sl(2, false);
+    sl.stride = (rows ? h5::v_t{stride, 1} : h5::v_t{1, stride});
+    sl.count  = (rows ? h5::v_t{n_rows / stride, n_cols} : h5::v_t{n_rows, n_cols / stride});
+    std::vector<double> buf(sl.size());
+    h5::array_interface::array_view v{h5::hdf5_type<double>(), (void *)buf.data(), 2, false};
+    v.slab.count = v.parent_shape = sl.count;
+
+    for (auto _ : state) {
+      h5::array_interface::read(ds, v, sl);
+      benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<long>(state.iterations() * buf.size() * sizeof(double)));
+  }
+
+} // namespace
+
+static void BM_HyperslabRows(benchmark::State &state, const char *name) { read_strided(state, name, true); }
+BENCHMARK_CAPTURE(BM_HyperslabRows, contiguous, "contiguous")->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK_CAPTURE(BM_HyperslabRows, chunked, "chunked")->RangeMultiplier(4)->Range(1, 256);
+
+static void BM_HyperslabColumns(benchmark::State &state, const char *name) { read_strided(state, name, false); }
+BENCHMARK_CAPTURE(BM_HyperslabColumns, contiguous, "contiguous")->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK_CAPTURE(BM_HyperslabColumns, chunked, "chunked")->RangeMultiplier(4)->Range(1, 256);
+
+static void BM_LazySlice(benchmark::State &state) {
+  prepare_file();
+  h5::file f("bench_hyperslab.h5", 'r');
+  h5::lazy_dataset ds(f, "chunked");
+  h5::hsize_t row = 0;
+  for (auto _ : state) {
+    auto slice = ds.slice<double>({row, 0}, {1, n_cols});
+    benchmark::DoNotOptimize(slice.data());
+    row = (row + 1) % n_rows;
+  }
+  state.SetBytesProcessed(static_cast<long>(state.iterations() * n_cols * sizeof(double)));
+}
+BENCHMARK(BM_LazySlice);
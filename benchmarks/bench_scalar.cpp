@@ -0,0 +1,61 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+// Scalar write/read throughput.
+
+#include <benchmark/benchmark.h>
+#include <h5/h5.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+  std::vector<std::string> make_names(long n) {
+    std::vector<std::string> names;
+    for (long i = 0; i < n; ++i) names.push_back(std::to_string(i));
+    return names;
+  }
+
+} // namespace
+
+static void BM_ScalarWrite(benchmark::State &state) {
+  auto names = make_names(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    h5::file f("bench_scalar.h5", 'w');
+    state.ResumeTiming();
+    for (std::size_t i = 0; i < names.size(); ++i) h5::write(f, names[i], static_cast<double>(i));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ScalarWrite)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_ScalarRead(benchmark::State &state) {
+  auto names = make_names(state.range(0));
+  {
+    h5::file f("bench_scalar.h5", 'w');
+    for (std::size_t i = 0; i < names.size(); ++i) h5::write(f, names[i], static_cast<double>(i));
+  }
+  h5::file f("bench_scalar.h5", 'r');
+  double x = 0;
+  for (auto _ : state) {
+    for (auto const &name : names) h5::read(f, name, x);
+    benchmark::DoNotOptimize(x);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ScalarRead)->Arg(100)->Arg(1000)->Arg(10000);
@@ -0,0 +1,61 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+// Serialization of nested maps and vectors into memory buffers.
+
+#include <benchmark/benchmark.h>
+#include <h5/h5.hpp>
+#include <h5/serialization.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+  using nested_t = std::map<std::string, std::map<std::string, std::vector<double>>>;
+
+  // Nested map with n outer entries, each containing 8 vectors of 16 doubles.
+  nested_t make_nested(long n) {
+    nested_t x;
+    for (long i = 0; i < n; ++i) {
+      auto &inner = x["entry_" + std::to_string(i)];
+      for (int j = 0; j < 8; ++j) inner[std::to_string(j)] = std::vector<double>(16, static_cast<double>(i + j));
+    }
+    return x;
+  }
+
+} // namespace
+
+static void BM_Serialize(benchmark::State &state) {
+  auto x = make_nested(state.range(0));
+  for (auto _ : state) {
+    auto buf = h5::serialize(x);
+    benchmark::DoNotOptimize(buf.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Serialize)->RangeMultiplier(10)->Range(1, 1000);
+
+static void BM_Deserialize(benchmark::State &state) {
+  auto buf = h5::serialize(make_nested(state.range(0)));
+  for (auto _ : state) {
+    auto x = h5::deserialize<nested_t>(buf);
+    benchmark::DoNotOptimize(x);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Deserialize)->RangeMultiplier(10)->Range(1, 1000);
@@ -0,0 +1,39 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+// Round trips of std::vector<std::string> with fixed and variable length strings.
+
+#include <benchmark/benchmark.h>
+#include <h5/h5.hpp>
+
+#include <string>
+#include <vector>
+
+static void BM_StringVectorRoundTrip(benchmark::State &state, bool variable_length) {
+  std::vector<std::string> v;
+  for (long i = 0; i < state.range(0); ++i) v.push_back("string_" + std::to_string(i * 7919 % 100003));
+  auto opts = h5::write_options{.variable_length_strings = variable_length};
+  h5::file f("bench_string.h5", 'w');
+  std::vector<std::string> v_in;
+  for (auto _ : state) {
+    h5::write(f, "v", v, opts);
+    h5::read(f, "v", v_in);
+    benchmark::DoNotOptimize(v_in.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_CAPTURE(BM_StringVectorRoundTrip, fixed_length, false)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK_CAPTURE(BM_StringVectorRoundTrip, variable_length, true)->RangeMultiplier(10)->Range(10, 100000);
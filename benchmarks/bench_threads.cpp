@@ -0,0 +1,63 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+// Concurrent reads of a chunked and compressed dataset from multiple threads sharing one file and one
+// h5::lazy_dataset (reads are serialized by h5::library_lock unless HDF5 is thread-safe).
+
+#include <benchmark/benchmark.h>
+#include <h5/h5.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+  constexpr h5::hsize_t n_rows     = 4096;
+  constexpr h5::hsize_t n_cols     = 1024;
+  constexpr h5::hsize_t block_rows = 64;
+
+  // Write the dataset once per process and open a lazy proxy which is shared by all threads.
+  h5::lazy_dataset const &shared_dataset() {
+    static h5::lazy_dataset const ds = []() {
+      std::vector<double> data(n_rows * n_cols);
+      for (std::size_t i = 0; i < data.size(); ++i) data[i] = std::sin(0.001 * static_cast<double>(i));
+      h5::array_interface::array_view v{h5::hdf5_type<double>(), (void *)data.data(), 2, false};
+      v.slab.count = v.parent_shape = {n_rows, n_cols};
+      {
+        h5::file f("bench_threads.h5", 'w');
+        h5::array_interface::write(f, "data", v, h5::write_options{.chunk_shape = {block_rows, n_cols}, .deflate_level = 1, .shuffle = true});
+      }
+      return h5::lazy_dataset(h5::file("bench_threads.h5", 'r'), "data");
+    }();
+    return ds;
+  }
+
+} // namespace
+
+// Each thread reads blocks of rows (one chunk each), starting at a different block.
+static void BM_ThreadedRead(benchmark::State &state) {
+  auto const &ds     = shared_dataset();
+  auto const nblocks = n_rows / block_rows;
+  auto block         = static_cast<h5::hsize_t>(state.thread_index()) % nblocks;
+  std::vector<double> buf(block_rows * n_cols);
+  for (auto _ : state) {
+    ds.read_slice(buf.data(), {block * block_rows, 0}, {block_rows, n_cols});
+    benchmark::ClobberMemory();
+    block = (block + 1) % nblocks;
+  }
+  state.SetBytesProcessed(static_cast<long>(state.iterations() * buf.size() * sizeof(double)));
+}
+BENCHMARK(BM_ThreadedRead)->ThreadRange(1, 8)->UseRealTime();
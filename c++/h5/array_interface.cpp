@@ -20,16 +20,30 @@
  */
 
 #include "./array_interface.hpp"
+#include "./complex.hpp"
+#include "./ensemble_reader.hpp"
 #include "./macros.hpp"
+#include "./stats.hpp"
 #include "./stl/string.hpp"
+#include "./threading.hpp"
 
 #include <hdf5.h>
-#include <hdf5_hl.h>
 
 #include <numeric>
 #include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -37,32 +51,544 @@ namespace h5::array_interface {
 
   namespace {
 
-    // Create an HDF5 memory dataspace.
-    dataspace make_mem_dspace(array_view const &v) {
-      // scalar case
-      if (v.rank() == 0) return H5Screate(H5S_SCALAR);
+    // Create a 1-dimensional HDF5 memory dataspace selecting the elements of a view with arbitrary strides.
+    dataspace make_strided_mem_dspace(array_view const &v) {
+      // merge adjacent dimensions which are contiguous with respect to each other
+      std::vector<hsize_t> counts, strides;
+      for (int d = 0; d < v.rank(); ++d) {
+        auto n = v.slab.count[d];
+        auto s = static_cast<hsize_t>(v.mem_strides[d]);
+        if (n == 1) continue;
+        if (not counts.empty() and strides.back() == n * s) {
+          counts.back() *= n;
+          strides.back() = s;
+        } else {
+          counts.push_back(n);
+          strides.push_back(s);
+        }
+      }
+      if (counts.empty()) counts = strides = {1};
 
-      // create a dataspace of rank v.rank() and with shape v.parent_shape
-      dataspace dspace = H5Screate_simple(v.slab.rank(), v.parent_shape.data(), nullptr);
+      // extent of the memory and check if the elements are ordered, i.e. if every stride exceeds the extent of the inner block
+      int rank       = static_cast<int>(counts.size());
+      hsize_t extent = 1;
+      bool ordered   = true;
+      for (int d = rank - 1; d >= 0; --d) {
+        if (strides[d] < extent) ordered = false;
+        extent += (counts[d] - 1) * strides[d];
+      }
+      dataspace dspace = H5Screate_simple(1, &extent, nullptr);
       if (!dspace.is_valid()) throw std::runtime_error("Error in make_mem_dspace: Creating the dataspace for an array_view failed");
 
-      // select the hyperslab according to v.slab
-      herr_t err = H5Sselect_hyperslab(dspace, H5S_SELECT_SET, v.slab.offset.data(), v.slab.stride.data(), v.slab.count.data(),
-                                       (v.slab.block.empty() ? nullptr : v.slab.block.data()));
-      if (err < 0) throw std::runtime_error("Error in make_mem_dspace: Selecting the hyperslab failed");
+      // number of rows (all but the innermost dimension) and the offset of a row given its index
+      hsize_t n_rows = std::accumulate(counts.begin(), counts.end() - 1, hsize_t{1}, std::multiplies<>());
+      auto row_offset = [&](hsize_t r) {
+        hsize_t offset = 0;
+        for (int d = rank - 2; d >= 0; --d) {
+          offset += (r % counts[d]) * strides[d];
+          r /= counts[d];
+        }
+        return offset;
+      };
+
+      // ordered elements: union of the rows (each row is a single strided hyperslab)
+      herr_t err = 0;
+      if (ordered) {
+        for (hsize_t r = 0; r < n_rows and err >= 0; ++r) {
+          hsize_t offset = row_offset(r);
+          err = H5Sselect_hyperslab(dspace, (r == 0 ? H5S_SELECT_SET : H5S_SELECT_OR), &offset, &strides.back(), &counts.back(), nullptr);
+        }
+        if (err < 0) throw std::runtime_error("Error in make_mem_dspace: Selecting the hyperslabs failed");
+        return dspace;
+      }
 
-      // return the dataspace
+      // otherwise select the points in C-order
+      std::vector<hsize_t> coords;
+      coords.reserve(n_rows * counts.back());
+      for (hsize_t r = 0; r < n_rows; ++r) {
+        hsize_t offset = row_offset(r);
+        for (hsize_t i = 0; i < counts.back(); ++i) coords.push_back(offset + i * strides.back());
+      }
+      err = H5Sselect_elements(dspace, H5S_SELECT_SET, coords.size(), coords.data());
+      if (err < 0) throw std::runtime_error("Error in make_mem_dspace: Selecting the points failed");
       return dspace;
     }
 
+    // Create a new dataset for an array view with the given dataset creation policy (unlinks an existing dataset).
+    dataset create_dataset(group g, std::string const &name, array_view const &v, write_options const &opts) {
+      // unlink the dataset if it already exists
+      g.unlink(name);
+
+      // shape of the hyperslab in memory
+      auto hs_shape = v.slab.shape();
+
+      // dataset creation property list (chunking, filters, fill value, etc.)
+      proplist cparms = make_dataset_create_proplist(opts, v.ty, hs_shape, v.is_complex);
+
+      // dataspace for the dataset in the file
+      dataspace file_dspace = H5Screate_simple(v.slab.rank(), hs_shape.data(), nullptr);
+
+      // create the dataset in the file
+      dataset ds = H5Dcreate2(g, name.c_str(), v.ty, file_dspace, H5P_DEFAULT, cparms, H5P_DEFAULT);
+      if (!ds.is_valid())
+        throw std::runtime_error("Error in h5::array_interface::write: Creating the dataset " + name + " in the group " + g.name() + " failed");
+      return ds;
+    }
+
+    // Check if a datatype contains variable-length data.
+    bool has_variable_length(datatype const &ty) { return H5Tis_variable_str(ty) > 0 or H5Tdetect_class(ty, H5T_VLEN) > 0; }
+
+    // Incremental 64-bit hash of a byte sequence (only used to detect changes of the content of a dataset). The result
+    // does not depend on how the sequence is split into updates.
+    class content_hash {
+      public:
+      void update(std::byte const *p, std::size_t n) {
+        n_ += n;
+
+        // complete a pending word
+        if (n_tail_ > 0) {
+          auto m = std::min(n, 8 - n_tail_);
+          std::memcpy(tail_ + n_tail_, p, m);
+          n_tail_ += m;
+          p += m;
+          n -= m;
+          if (n_tail_ < 8) return;
+          std::uint64_t w = 0;
+          std::memcpy(&w, tail_, 8);
+          mix(w);
+          n_tail_ = 0;
+        }
+        for (; n >= 8; p += 8, n -= 8) {
+          std::uint64_t w = 0;
+          std::memcpy(&w, p, 8);
+          mix(w);
+        }
+        if (n > 0) std::memcpy(tail_, p, n);
+        n_tail_ = n;
+      }
+
+      [[nodiscard]] std::uint64_t value() const {
+        auto copy = *this;
+        for (std::size_t i = 0; i < n_tail_; ++i) copy.mix(static_cast<std::uint64_t>(tail_[i]));
+        auto h = copy.h_ ^ n_;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+      }
+
+      private:
+      void mix(std::uint64_t w) {
+        w *= 0x87c37b91114253d5ULL;
+        w = std::rotl(w, 31) * 0x4cf5ad432745937fULL;
+        h_ ^= w;
+        h_ = std::rotl(h_, 27) * 5 + 0x52dce729;
+      }
+
+      std::uint64_t h_ = 0x9e3779b97f4a7c15ULL;
+      std::uint64_t n_ = 0;
+      std::byte tail_[8] = {};
+      std::size_t n_tail_ = 0;
+    };
+
+    // Hash the elements selected by a view in C-order.
+    std::uint64_t hash_view(array_view const &v) {
+      content_hash h;
+      dataspace mem_dspace = make_mem_dspace(v);
+      if (H5Sget_select_npoints(mem_dspace) > 0) {
+        auto elem_size = H5Tget_size(v.ty);
+        std::vector<std::byte> buf(std::max<std::size_t>(1, (std::size_t{1} << 20) / elem_size) * elem_size);
+        auto op = [](void const *dst, std::size_t n, void *h_ptr) -> herr_t {
+          static_cast<content_hash *>(h_ptr)->update(static_cast<std::byte const *>(dst), n);
+          return 0;
+        };
+        if (H5Dgather(mem_dspace, v.start, v.ty, buf.size(), buf.data(), op, &h) < 0)
+          throw std::runtime_error("Error in h5::array_interface::write: Gathering the data for the content hash failed");
+      }
+      return h.value();
+    }
+
+    // Call an HDF5 function with the automatic error printing turned off.
+    template <typename F>
+    auto silenced(F &&f) {
+      H5E_auto2_t old_func  = nullptr;
+      void *old_client_data = nullptr;
+      H5Eget_auto2(H5E_DEFAULT, &old_func, &old_client_data);
+      H5Eset_auto2(H5E_DEFAULT, nullptr, nullptr);
+      auto res = f();
+      H5Eset_auto2(H5E_DEFAULT, old_func, old_client_data);
+      return res;
+    }
+
+    // Hash the content of a dataset in C-order by reading it in blocks along the first dimension (empty if reading fails).
+    // If a held h5::library_lock is given, it is released while a block is hashed so that other threads can read.
+    std::optional<std::uint64_t> hash_dataset(dataset const &ds, std::optional<library_lock> *lock = nullptr) {
+      content_hash h;
+      datatype ty      = H5Dget_type(ds);
+      dataspace dspace = H5Dget_space(ds);
+      int rank         = H5Sget_simple_extent_ndims(dspace);
+      if (rank < 0) return {};
+      dims_t dims(rank);
+      H5Sget_simple_extent_dims(dspace, dims.data(), nullptr);
+      if (H5Sget_simple_extent_npoints(dspace) == 0) return h.value();
+
+      // number of rows (elements for scalars) per block
+      auto row_bytes = H5Tget_size(ty);
+      for (int d = 1; d < rank; ++d) row_bytes *= dims[d];
+      hsize_t n_rows = (rank == 0 ? 1 : dims[0]);
+      hsize_t block  = std::clamp<hsize_t>((std::size_t{1} << 20) / std::max<std::size_t>(row_bytes, 1), 1, n_rows);
+      std::vector<std::byte> buf(block * row_bytes);
+      for (hsize_t r = 0; r < n_rows; r += block) {
+        auto n           = std::min(block, n_rows - r);
+        dataspace mspace = H5Screate(H5S_SCALAR);
+        if (rank > 0) {
+          dims_t offset(rank, 0), count = dims;
+          offset[0] = r;
+          count[0]  = n;
+          H5Sselect_hyperslab(dspace, H5S_SELECT_SET, offset.data(), nullptr, count.data(), nullptr);
+          mspace = H5Screate_simple(rank, count.data(), nullptr);
+        }
+        // reading fails for corrupted chunks if the dataset has the Fletcher32 filter
+        if (silenced([&]() { return H5Dread(ds, ty, mspace, dspace, H5P_DEFAULT, buf.data()); }) < 0) return {};
+        if (lock != nullptr) lock->reset();
+        h.update(buf.data(), n * row_bytes);
+        if (lock != nullptr) lock->emplace();
+      }
+      return h.value();
+    }
+
+    // Read the content hash of a dataset (if there is one).
+    std::optional<std::uint64_t> read_hash(dataset const &ds) {
+      if (H5Aexists(ds, "__hash__") <= 0) return {};
+      attribute attr = H5Aopen(ds, "__hash__", H5P_DEFAULT);
+      std::uint64_t res = 0;
+      if (!attr.is_valid() or H5Aread(attr, H5T_NATIVE_UINT64, &res) < 0) return {};
+      return res;
+    }
+
+    // Store the content hash of a dataset (an existing hash is replaced).
+    void write_hash(dataset const &ds, std::uint64_t h) {
+      if (H5Aexists(ds, "__hash__") > 0) H5Adelete(ds, "__hash__");
+      dataspace dspace = detail::scalar_dataspace();
+      attribute attr   = H5Acreate2(ds, "__hash__", H5T_STD_U64LE, dspace, H5P_DEFAULT, H5P_DEFAULT);
+      if (!attr.is_valid() or H5Awrite(attr, H5T_NATIVE_UINT64, &h) < 0)
+        throw std::runtime_error("Error in h5::array_interface::write: Writing the content hash failed");
+    }
+
+    // Remove the content hash of a dataset whose content is modified without computing a new hash.
+    void remove_hash(dataset const &ds) {
+      if (H5Aexists(ds, "__hash__") > 0 and H5Adelete(ds, "__hash__") < 0)
+        throw std::runtime_error("Error in h5::array_interface: Removing the content hash failed");
+    }
+
+    // Check if a dataset has the Fletcher32 filter in its pipeline.
+    bool has_fletcher32(dataset const &ds) {
+      proplist dcpl = H5Dget_create_plist(ds);
+      int n         = H5Pget_nfilters(dcpl);
+      for (int i = 0; i < n; ++i) {
+        unsigned flags = 0;
+        std::size_t n_cd = 0;
+        if (H5Pget_filter2(dcpl, static_cast<unsigned>(i), &flags, &n_cd, nullptr, 0, nullptr, nullptr) == H5Z_FILTER_FLETCHER32) return true;
+      }
+      return false;
+    }
+
+    // Check the integrity of a dataset while holding the given h5::library_lock (it is released while hashing).
+    verify_result verify_dataset(dataset const &ds, std::optional<library_lock> &lock) {
+      H5_INSTRUMENT(instr, "array_interface::verify_dataset", ds);
+      verify_result res;
+      bool fletcher = has_fletcher32(ds);
+      auto stored   = read_hash(ds);
+      if (has_variable_length(datatype{H5Dget_type(ds)})) return res;
+      res.has_checksum = (fletcher or stored.has_value());
+      if (not res.has_checksum) return res;
+      auto h = hash_dataset(ds, &lock);
+      res.ok = (h.has_value() and (not stored or *stored == *h));
+      return res;
+    }
+
+    // Collect the paths of all datasets in a group and its subgroups.
+    void collect_dataset_paths(group const &g, std::string const &prefix, std::vector<std::string> &paths) {
+      g.for_each_child([&](std::string_view name, object_type type) {
+        auto path = prefix + std::string{name};
+        if (type == object_type::dataset) paths.push_back(path);
+        else if (type == object_type::group) collect_dataset_paths(g.open_group(std::string{name}), path + "/", paths);
+        return true;
+      });
+    }
+
+    // Dataset to which a view is written according to h5::write_options::update.
+    struct write_target {
+      dataset ds;
+      bool created = false; // new dataset or reused dataset without attributes
+      bool skip    = false;
+      std::optional<std::uint64_t> hash;
+    };
+
+    // Open an existing dataset which can be overwritten by the given view (invalid otherwise).
+    dataset open_compatible_dataset(group const &g, std::string const &name, array_view const &v) {
+      if (not g.has_dataset(name)) return {};
+      dataset ds       = g.open_dataset(name);
+      datatype file_ty = H5Dget_type(ds);
+      if (H5Tequal(file_ty, v.ty) <= 0 or (H5Aexists(ds, "__complex__") > 0) != v.is_complex) return {};
+      dataspace dspace = H5Dget_space(ds);
+      if (H5Sget_simple_extent_ndims(dspace) != v.rank()) return {};
+      dims_t dims(v.rank());
+      H5Sget_simple_extent_dims(dspace, dims.data(), nullptr);
+      if (dims != v.slab.shape()) return {};
+      return ds;
+    }
+
+    // Get the dataset to write a view to (an existing dataset is reused if allowed and possible).
+    write_target get_write_target(group g, std::string const &name, array_view const &v, write_options const &opts) {
+      using mode = write_options::update_mode;
+      write_target res;
+      bool hashed = ((opts.update == mode::skip_unchanged or opts.content_hash) and not has_variable_length(v.ty));
+      if (hashed) res.hash = hash_view(v);
+
+      // files opened with h5::file_options::overwrite_in_place reuse compatible datasets instead of recreating them
+      if (opts.update == mode::recreate and g.get_file().overwrite_in_place()) {
+        auto hs_shape   = v.slab.shape();
+        proplist cparms = make_dataset_create_proplist(opts, v.ty, hs_shape, v.is_complex);
+        res.ds          = g.open_dataset_for_overwrite(name, v.ty, dataspace{H5Screate_simple(v.slab.rank(), hs_shape.data(), nullptr)}, cparms);
+        res.created     = res.ds.is_valid();
+        if (res.created) return res;
+      }
+
+      // overwrite an existing dataset in place
+      if (opts.update != mode::recreate) {
+        res.ds = open_compatible_dataset(g, name, v);
+        if (res.ds.is_valid()) {
+          auto old_hash = read_hash(res.ds);
+          res.skip      = (opts.update == mode::skip_unchanged and hashed and old_hash == res.hash);
+          if (old_hash and not hashed) remove_hash(res.ds);
+          return res;
+        }
+      }
+
+      // create a new dataset
+      res.ds      = create_dataset(g, name, v, opts);
+      res.created = true;
+      return res;
+    }
+
+    // Add the attributes of a dataset after a view has been written to it.
+    void finish_write(write_target const &t, array_view const &v) {
+      if (t.created and v.is_complex) h5_write_attribute(t.ds, "__complex__", "1");
+      if (t.hash and not t.skip) write_hash(t.ds, *t.hash);
+    }
+
+    // Get the name of a member of a compound datatype.
+    std::string get_member_name(datatype const &ty, unsigned idx) {
+      char *name = H5Tget_member_name(ty, idx);
+      if (name == nullptr) return {};
+      std::string res{name};
+      H5free_memory(name);
+      return res;
+    }
+
+    // Get the type of the real and imaginary parts if the given datatype is a complex datatype (invalid otherwise).
+    datatype get_complex_part_type(datatype const &ty) {
+      auto cls = H5Tget_class(ty);
+#if H5_VERSION_GE(2, 0, 0)
+      if (cls == H5T_COMPLEX) return H5Tget_super(ty);
+#endif
+      if (cls != H5T_COMPOUND or H5Tget_nmembers(ty) != 2 or get_member_name(ty, 0) != "r" or get_member_name(ty, 1) != "i") return {};
+      datatype r_ty = H5Tget_member_type(ty, 0), i_ty = H5Tget_member_type(ty, 1);
+      auto size     = H5Tget_size(r_ty);
+      if (H5Tget_class(r_ty) != H5T_FLOAT or not hdf5_type_equal(r_ty, i_ty) or H5Tget_member_offset(ty, 0) != 0
+          or H5Tget_member_offset(ty, 1) != size or H5Tget_size(ty) != 2 * size)
+        return {};
+      return r_ty;
+    }
+
+    // Check if the given datatype is a native HDF5 complex datatype.
+    bool is_native_complex(datatype const &ty) {
+#if H5_VERSION_GE(2, 0, 0)
+      return H5Tget_class(ty) == H5T_COMPLEX;
+#else
+      std::ignore = ty;
+      return false;
+#endif
+    }
+
+    // Create a compound datatype with the members "r" and "i" of the given floating point type.
+    datatype make_complex_compound(datatype const &part) {
+      auto size   = H5Tget_size(part);
+      datatype ty = H5Tcreate(H5T_COMPOUND, 2 * size);
+      if (H5Tinsert(ty, "r", 0, part) < 0 or H5Tinsert(ty, "i", size, part) < 0)
+        throw std::runtime_error("Error in h5::array_interface::to_complex_datatype: Creating the complex compound datatype failed");
+      return ty;
+    }
+
+    // Get a compound datatype with the members "r" and "i" of the given floating point type (created once per native type).
+    datatype get_complex_compound(datatype const &part) {
+      switch (get_type_code(part)) {
+        case type_code::float64: return hdf5_type<dcplx_t>();
+        case type_code::float32: {
+          static datatype const ty = make_complex_compound(hdf5_type<float>());
+          return ty;
+        }
+        case type_code::long_double: {
+          static datatype const ty = make_complex_compound(hdf5_type<long double>());
+          return ty;
+        }
+        default: return make_complex_compound(part);
+      }
+    }
+
+    // If the dataset has a complex datatype, turn a complex view and hyperslab into a view and hyperslab of complex elements.
+    void adapt_complex_view(datatype const &file_ty, array_view &v, hyperslab &sl) {
+      if (not v.is_complex or not get_complex_part_type(file_ty).is_valid()) return;
+      v  = to_complex_datatype(v, is_native_complex(file_ty));
+      sl = to_complex_datatype(sl);
+    }
+
+    // Check that an array view can be read from a dataset with the given type according to the conversion policy.
+    // Returns true if the data has to be converted.
+    bool check_type_compatibility(datatype const &ty, array_view const &v, transfer_options const &xfer) {
+      // types with the same classification are compatible (full comparison only for unknown, string and compound types)
+      auto code = get_type_code(v.ty);
+      if (code != type_code::unknown and code != type_code::string and code != type_code::compound and code == get_type_code(ty)) return false;
+      if (H5Tget_class(v.ty) != H5Tget_class(ty))
+        throw std::runtime_error("Error in h5::array_interface::read: Incompatible HDF5 types: " + get_name_of_h5_type(v.ty) + " != "
+                                 + get_name_of_h5_type(ty));
+
+      bool needs_conversion = not hdf5_type_equal(v.ty, ty);
+      if (needs_conversion and xfer.conversion == transfer_options::conversion_policy::forbid)
+        throw std::runtime_error("Error in h5::array_interface::read: Type conversion from " + get_name_of_h5_type(ty) + " to "
+                                 + get_name_of_h5_type(v.ty) + " is forbidden");
+      if (needs_conversion and xfer.conversion == transfer_options::conversion_policy::warn)
+        std::cerr << "WARNING: HDF5 type mismatch while reading into an array_view: " + get_name_of_h5_type(v.ty) + " != "
+              + get_name_of_h5_type(ty) + "\n";
+      return needs_conversion;
+    }
+
+    // Check that an array view (and an optional hyperslab) can be read from a dataset with the given type and dataspace.
+    // Returns true if the data has to be converted.
+    bool check_read_compatibility(datatype const &ty, dataspace const &file_dspace, array_view const &v, hyperslab const &sl,
+                                  transfer_options const &xfer) {
+      bool needs_conversion = check_type_compatibility(ty, v, xfer);
+      auto sl_size          = sl.empty() ? static_cast<hsize_t>(H5Sget_simple_extent_npoints(file_dspace)) : sl.size();
+      if (sl_size != v.slab.size()) throw std::runtime_error("Error in h5::array_interface::read: Incompatible sizes");
+      return needs_conversion;
+    }
+
+    // Call a function with a value of the C++ type corresponding to a numeric type code.
+    template <typename F>
+    bool visit_numeric(type_code code, F &&f) {
+      switch (code) {
+        case type_code::int8: f(std::int8_t{}); return true;
+        case type_code::uint8: f(std::uint8_t{}); return true;
+        case type_code::int16: f(std::int16_t{}); return true;
+        case type_code::uint16: f(std::uint16_t{}); return true;
+        case type_code::int32: f(std::int32_t{}); return true;
+        case type_code::uint32: f(std::uint32_t{}); return true;
+        case type_code::int64: f(std::int64_t{}); return true;
+        case type_code::uint64: f(std::uint64_t{}); return true;
+        case type_code::float32: f(float{}); return true;
+        case type_code::float64: f(double{}); return true;
+        case type_code::long_double: f(static_cast<long double>(0)); return true;
+        default: return false;
+      }
+    }
+
+    // Convert n values (integers are clamped to the range of the target type and floating point values out of range
+    // are mapped to +/- infinity like HDF5 does).
+    template <typename D, typename S>
+    void convert_values(S const *src, D *dst, std::size_t n) {
+      if constexpr (std::is_integral_v<D> and std::is_integral_v<S>) {
+        using lim = std::numeric_limits<D>;
+        for (std::size_t i = 0; i < n; ++i) {
+          auto x = src[i];
+          dst[i] = (std::cmp_less(x, lim::min()) ? lim::min() : (std::cmp_greater(x, lim::max()) ? lim::max() : static_cast<D>(x)));
+        }
+      } else if constexpr (std::is_floating_point_v<D> and std::is_floating_point_v<S> and (sizeof(D) < sizeof(S))) {
+        // casting a finite value which is out of range of the target type is undefined behavior
+        using lim = std::numeric_limits<D>;
+        for (std::size_t i = 0; i < n; ++i) {
+          auto x = src[i];
+          dst[i] = (x > lim::max() ? lim::infinity() : (x < lim::lowest() ? -lim::infinity() : static_cast<D>(x)));
+        }
+      } else {
+        for (std::size_t i = 0; i < n; ++i) dst[i] = static_cast<D>(src[i]);
+      }
+    }
+
+    // HDF5 callback for H5Dscatter which provides the whole buffer at once.
+    struct scatter_data {
+      void const *buf;
+      std::size_t nbytes;
+    };
+
+    herr_t scatter_callback(void const **src_buf, std::size_t *src_buf_bytes_used, void *op_data) {
+      auto *data          = static_cast<scatter_data *>(op_data);
+      *src_buf            = data->buf;
+      *src_buf_bytes_used = data->nbytes;
+      return 0;
+    }
+
+    // Read the selected elements with their file type and convert them in memory (integer-integer or float-float only).
+    // Returns false if the fast path does not apply.
+    bool read_with_fast_conversion(dataset const &ds, datatype const &ty, dataspace const &file_dspace, dataspace const &mem_dspace,
+                                   array_view const &v, proplist const &dxpl) {
+      auto src_code = get_type_code(ty), dst_code = get_type_code(v.ty);
+      if (H5Tget_class(ty) != H5Tget_class(v.ty)) return false;
+
+      auto n        = static_cast<std::size_t>(H5Sget_select_npoints(file_dspace));
+      auto dst_size = H5Tget_size(v.ty);
+      bool direct   = (not v.is_strided() and H5Sget_select_npoints(mem_dspace) == H5Sget_simple_extent_npoints(mem_dspace));
+      bool done     = false;
+      visit_numeric(src_code, [&]<typename S>(S) {
+        visit_numeric(dst_code, [&]<typename D>(D) {
+          // raw read into a contiguous buffer
+          std::vector<S> raw(n);
+          hsize_t dim          = n;
+          dataspace raw_dspace = H5Screate_simple(1, &dim, nullptr);
+          if (H5Dread(ds, hdf5_type<S>(), raw_dspace, file_dspace, dxpl, raw.data()) < 0)
+            throw std::runtime_error("Error in h5::array_interface::read: Reading the dataset failed");
+
+          // convert directly into the view if it is contiguous and C-ordered, otherwise scatter the converted values
+          if (direct) {
+            convert_values(raw.data(), static_cast<D *>(v.start), n);
+          } else {
+            std::vector<D> converted(n);
+            convert_values(raw.data(), converted.data(), n);
+            scatter_data data{converted.data(), n * dst_size};
+            if (H5Dscatter(scatter_callback, &data, v.ty, mem_dspace, v.start) < 0)
+              throw std::runtime_error("Error in h5::array_interface::read: Scattering the converted data failed");
+          }
+          done = true;
+        });
+      });
+      return done;
+    }
+
   } // namespace
 
-  std::pair<v_t, v_t> get_parent_shape_and_h5_strides(long const *np_strides, int rank, long view_size) {
+  bool check_read_compatibility(dataset_info const &info, array_view const &v, transfer_options const &xfer) {
+    // real values read into a complex view are converted like values of a different type
+    if (v.is_complex and not info.has_complex_attribute) {
+      if (xfer.conversion == transfer_options::conversion_policy::forbid)
+        throw std::runtime_error("Error in h5::array_interface::read: Type conversion from " + get_name_of_h5_type(info.ty) + " to complex "
+                                 + get_name_of_h5_type(v.ty) + " is forbidden");
+      if (xfer.conversion == transfer_options::conversion_policy::warn)
+        std::cerr << "WARNING: HDF5 type mismatch while reading into an array_view: complex " + get_name_of_h5_type(v.ty) + " != "
+              + get_name_of_h5_type(info.ty) + "\n";
+      auto real_xfer       = xfer;
+      real_xfer.conversion = transfer_options::conversion_policy::allow;
+      std::ignore          = check_type_compatibility(info.ty, v, real_xfer);
+      return true;
+    }
+    return check_type_compatibility(info.ty, v, xfer);
+  }
+
+  std::pair<dims_t, dims_t> get_parent_shape_and_h5_strides(long const *np_strides, int rank, long view_size) {
     // scalar case: return empty vectors
     if (rank == 0) return {};
 
     // empty view case: return (0,0,0), (1,1,1)
-    if (view_size == 0) return {v_t(rank, 0), v_t(rank, 1)};
+    if (view_size == 0) return {dims_t(rank, 0), dims_t(rank, 1)};
 
     // for the general case, we would like to find a parent_shape and h5_strides such that the following equations hold (rank = N):
     // 1. np_strides[N - 1] = h5_strides[N - 1]
@@ -75,17 +601,20 @@ namespace h5::array_interface {
     // This is not a problem as long as HDF5 manages to select the correct elements in memory.
 
     // create the result vectors
-    v_t parent_shape(rank), h5_strides(rank);
+    dims_t parent_shape(rank), h5_strides(rank);
 
-    // We initialize the h5_strides array to the values of np_strides
-    // and successively divide off the parent_shape values as they appear
-    // in the equations above.
-    for (int u = 0; u < rank; ++u) h5_strides[u] = np_strides[u];
-    for (int u = rank - 2; u >= 0; --u) {
-      hsize_t gcd = h5_strides[u];
-      for (int v = u - 1; v >= 0; --v) { gcd = std::gcd(gcd, h5_strides[v]); }
-      parent_shape[u + 1] = gcd;
-      for (int v = u; v >= 0; --v) { h5_strides[v] /= gcd; }
+    // We choose parent_shape[u + 1] * ... * parent_shape[N - 1] = gcd(np_strides[0], ..., np_strides[u]) for u < N - 1.
+    // The prefix gcds divide each other, so the parent_shape values are their ratios and the h5_strides follow
+    // by dividing the np_strides by the corresponding prefix gcd.
+    dims_t prefix_gcd(rank, 1);
+    hsize_t gcd = 0;
+    for (int u = 0; u < rank - 1; ++u) {
+      gcd           = std::gcd(gcd, static_cast<hsize_t>(np_strides[u]));
+      prefix_gcd[u] = std::max(gcd, hsize_t{1});
+    }
+    for (int u = 0; u < rank; ++u) {
+      h5_strides[u] = static_cast<hsize_t>(np_strides[u]) / prefix_gcd[u];
+      if (u > 0) parent_shape[u] = prefix_gcd[u - 1] / prefix_gcd[u];
     }
 
     // from the above equations it follows that parent_shape[0] (size of the slowest varying dimension)
@@ -95,15 +624,116 @@ namespace h5::array_interface {
     return {parent_shape, h5_strides};
   }
 
+  array_view make_strided_view(datatype ty, void *start, v_t const &shape, std::vector<long> const &strides, bool is_complex) {
+    if (shape.size() != strides.size()) throw std::runtime_error("Error in h5::array_interface::make_strided_view: Shape and strides must have the same size");
+    if (std::any_of(strides.begin(), strides.end(), [](long s) { return s < 0; }))
+      throw std::runtime_error("Error in h5::array_interface::make_strided_view: Negative strides are not supported");
+
+    // view with the full shape and strides in units of ty (including the possible imaginary dimension)
+    int rank = static_cast<int>(shape.size());
+    array_view res{std::move(ty), start, rank, is_complex};
+    small_vector<long, 8> full_strides(res.rank(), 1);
+    for (int d = 0; d < rank; ++d) {
+      res.slab.count[d] = shape[d];
+      full_strides[d]   = strides[d] * (is_complex ? 2 : 1);
+    }
+    if (res.rank() == 0) return res;
+
+    // try to describe the layout by a hyperslab of a parent array: the selection in every inner dimension has to fit
+    auto view_size                  = static_cast<long>(res.slab.size());
+    auto [parent_shape, h5_strides] = get_parent_shape_and_h5_strides(full_strides.data(), res.rank(), view_size);
+    bool fits                       = true;
+    for (int d = 0; d < res.rank(); ++d) {
+      auto n = res.slab.count[d];
+      if (n > 1 and (h5_strides[d] == 0 or (d > 0 and (n - 1) * h5_strides[d] >= parent_shape[d]))) fits = false;
+    }
+    if (view_size == 0 or fits) {
+      for (int d = 0; d < res.rank(); ++d) {
+        res.slab.stride[d]  = std::max(h5_strides[d], hsize_t{1});
+        res.parent_shape[d] = std::max(parent_shape[d], res.slab.count[d] * res.slab.stride[d]);
+      }
+      return res;
+    }
+
+    // otherwise keep the strides
+    res.parent_shape = res.slab.count;
+    res.mem_strides  = full_strides;
+    return res;
+  }
+
+  dataspace make_mem_dspace(array_view const &v) {
+    // scalar case
+    if (v.rank() == 0) return H5Screate(H5S_SCALAR);
+
+    // arbitrary strides
+    if (v.is_strided()) return make_strided_mem_dspace(v);
+
+    // create a dataspace of rank v.rank() and with shape v.parent_shape
+    dataspace dspace = H5Screate_simple(v.slab.rank(), v.parent_shape.data(), nullptr);
+    if (!dspace.is_valid()) throw std::runtime_error("Error in make_mem_dspace: Creating the dataspace for an array_view failed");
+
+    // select the hyperslab according to v.slab
+    herr_t err = H5Sselect_hyperslab(dspace, H5S_SELECT_SET, v.slab.offset.data(), v.slab.stride.data(), v.slab.count.data(),
+                                     (v.slab.block.empty() ? nullptr : v.slab.block.data()));
+    if (err < 0) throw std::runtime_error("Error in make_mem_dspace: Selecting the hyperslab failed");
+
+    // return the dataspace
+    return dspace;
+  }
+
+  array_view to_complex_datatype(array_view const &v, bool native) {
+    auto const &sl = v.slab;
+    if (not v.is_complex or sl.offset.back() != 0 or sl.shape().back() != 2 or (not v.is_strided() and v.parent_shape.back() != 2)
+        or (v.is_strided() and v.mem_strides.back() != 1))
+      throw std::runtime_error("Error in h5::array_interface::to_complex_datatype: View does not select the real and imaginary parts together");
+
+    // memory datatype of the complex values
+    datatype ty;
+#if H5_VERSION_GE(2, 0, 0)
+    if (native) ty = H5Tcomplex_create(v.ty);
+#else
+    std::ignore = native;
+#endif
+    if (not ty.is_valid()) ty = get_complex_compound(v.ty);
+
+    // remove the trailing dimension
+    int rank = v.rank() - 1;
+    array_view res{std::move(ty), v.start, rank, false};
+    std::copy_n(v.parent_shape.begin(), rank, res.parent_shape.begin());
+    res.slab = to_complex_datatype(v.slab);
+    if (v.is_strided()) {
+      res.mem_strides.resize(rank);
+      for (int d = 0; d < rank; ++d) res.mem_strides[d] = v.mem_strides[d] / 2;
+    }
+    return res;
+  }
+
+  hyperslab to_complex_datatype(hyperslab const &sl) {
+    if (sl.empty()) return {};
+    if (sl.offset.back() != 0 or sl.shape().back() != 2)
+      throw std::runtime_error("Error in h5::array_interface::to_complex_datatype: Hyperslab does not select the real and imaginary parts together");
+    hyperslab res = sl;
+    for (auto *x : {&res.offset, &res.stride, &res.count}) x->pop_back();
+    if (not res.block.empty()) res.block.pop_back();
+    return res;
+  }
+
   dataset_info get_dataset_info(dataset ds) {
     // retrieve shape and datatype information
-    datatype ty                = H5Dget_type(ds);
-    bool has_complex_attribute = H5LTfind_attribute(ds, "__complex__");
-    dataspace dspace           = H5Dget_space(ds);
-    int rank                   = H5Sget_simple_extent_ndims(dspace);
-    v_t dims_out(rank);
+    datatype ty      = H5Dget_type(ds);
+    dataspace dspace = H5Dget_space(ds);
+    int rank         = H5Sget_simple_extent_ndims(dspace);
+    dims_t dims_out(rank);
     H5Sget_simple_extent_dims(dspace, dims_out.data(), nullptr);
 
+    // complex values stored with a complex datatype look like complex values stored with an additional dimension
+    if (auto part_ty = get_complex_part_type(ty); part_ty.is_valid()) {
+      dims_out.push_back(2);
+      return {std::move(dims_out), std::move(part_ty), true, true};
+    }
+
+    // only real floating point datasets with a trailing dimension of size 2 can have the complex attribute
+    bool has_complex_attribute = (rank > 0 and dims_out.back() == 2 and H5Tget_class(ty) == H5T_FLOAT and H5Aexists(ds, "__complex__") > 0);
     return {std::move(dims_out), ty, has_complex_attribute};
   }
 
@@ -112,104 +742,346 @@ namespace h5::array_interface {
     return get_dataset_info(ds);
   }
 
+  v_t get_dataset_shape(dataset ds) {
+    dataspace dspace = H5Dget_space(ds);
+    int rank         = H5Sget_simple_extent_ndims(dspace);
+    if (rank < 0) throw std::runtime_error("Error in h5::array_interface::get_dataset_shape: Getting the rank of the dataspace failed");
+    v_t dims(rank);
+    H5Sget_simple_extent_dims(dspace, dims.data(), nullptr);
+    return dims;
+  }
+
+  int get_dataset_rank(dataset ds) {
+    dataspace dspace = H5Dget_space(ds);
+    int rank         = H5Sget_simple_extent_ndims(dspace);
+    if (rank < 0) throw std::runtime_error("Error in h5::array_interface::get_dataset_rank: Getting the rank of the dataspace failed");
+    return rank;
+  }
+
+  type_code get_dataset_type_code(dataset ds) { return get_type_code(datatype{H5Dget_type(ds)}); }
+
+  hsize_t get_dataset_storage_size(dataset ds) { return H5Dget_storage_size(ds); }
+
+  std::vector<dataset_metadata> describe_group(group g) {
+    std::vector<dataset_metadata> res;
+    g.for_each_child([&](std::string_view name, object_type type) {
+      if (type != object_type::dataset) return true;
+      std::string key{name};
+      dataset ds = H5Dopen2(g, key.c_str(), H5P_DEFAULT);
+      if (!ds.is_valid()) throw std::runtime_error("Error in h5::array_interface::describe_group: Opening the dataset " + key + " failed");
+      res.push_back({key, get_dataset_shape(ds), get_dataset_type_code(ds), get_dataset_storage_size(ds)});
+      return true;
+    });
+    return res;
+  }
+
+  verify_result verify_dataset(dataset ds) {
+    // the lock is only released while hashing (a lock held by the caller is not released)
+    std::optional<library_lock> lock{std::in_place};
+    return verify_dataset(ds, lock);
+  }
+
+  std::vector<verify_result> verify(group g, int n_threads) {
+    std::vector<std::string> paths;
+    collect_dataset_paths(g, "", paths);
+    std::vector<verify_result> res(paths.size());
+    if (paths.empty()) return res;
+
+    // verify the datasets on a pool of threads (the hashes are computed while other threads read)
+    if (n_threads <= 0) n_threads = static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+    n_threads = static_cast<int>(std::min(static_cast<std::size_t>(n_threads), paths.size()));
+    h5::detail::ensemble_for_threads(paths.size(), n_threads, [&](std::size_t i) {
+      std::optional<library_lock> lock{std::in_place};
+      dataset ds  = g.open_dataset(paths[i]);
+      res[i]      = verify_dataset(ds, lock);
+      res[i].name = paths[i];
+    });
+    return res;
+  }
+
+  bool same_content(group g1, group g2) {
+    H5_INSTRUMENT(instr, "array_interface::same_content", g1);
+    std::vector<std::string> paths1, paths2;
+    collect_dataset_paths(g1, "", paths1);
+    collect_dataset_paths(g2, "", paths2);
+    std::sort(paths1.begin(), paths1.end());
+    std::sort(paths2.begin(), paths2.end());
+    if (paths1 != paths2) return false;
+
+    for (auto const &path : paths1) {
+      dataset ds1 = g1.open_dataset(path), ds2 = g2.open_dataset(path);
+      datatype ty1 = H5Dget_type(ds1), ty2 = H5Dget_type(ds2);
+      if (H5Tequal(ty1, ty2) <= 0 or get_dataset_shape(ds1) != get_dataset_shape(ds2)) return false;
+      if (has_variable_length(ty1))
+        throw std::runtime_error("Error in h5::array_interface::same_content: Dataset " + path + " contains variable-length data which can not be hashed");
+
+      // use the stored hashes and only hash the content of datasets without one
+      auto h1 = read_hash(ds1);
+      auto h2 = read_hash(ds2);
+      if (not h1) h1 = hash_dataset(ds1);
+      if (not h2) h2 = hash_dataset(ds2);
+      if (not h1 or not h2) throw std::runtime_error("Error in h5::array_interface::same_content: Reading the dataset " + path + " failed");
+      if (*h1 != *h2) return false;
+    }
+    return true;
+  }
+
+  void write(group g, std::string const &name, array_view const &v, write_options const &opts) {
+    // store complex values with a complex datatype
+    if (v.is_complex and opts.complex_storage != write_options::complex_format::extra_dimension) {
+      write(g, name, to_complex_datatype(v, opts.complex_storage == write_options::complex_format::native), opts);
+      return;
+    }
+    H5_INSTRUMENT(instr, "array_interface::write", g, name);
+
+    // create the dataset in the file or reuse an existing one
+    auto target = get_write_target(g, name, v, opts);
+    if (target.skip) return;
+
+    // memory dataspace
+    dataspace mem_dspace = make_mem_dspace(v);
+
+    // write to the file dataset
+    if (H5Sget_simple_extent_npoints(mem_dspace) > 0) { // avoid writing empty arrays
+      H5_INSTRUMENT_BYTES(instr, H5Sget_select_npoints(mem_dspace) * H5Tget_size(v.ty));
+      herr_t err = H5Dwrite(target.ds, v.ty, mem_dspace, H5S_ALL, H5P_DEFAULT, v.start);
+      if (err < 0)
+        throw std::runtime_error("Error in h5::array_interface::write: Writing to the dataset " + name + " in the group" + g.name() + " failed");
+    }
+
+    // add complex and hash attributes
+    finish_write(target, v);
+  }
+
   void write(group g, std::string const &name, array_view const &v, bool compress) {
+    write(g, name, v, (compress ? write_options{.deflate_level = 1} : write_options{}));
+  }
+
+  void create_extensible(group g, std::string const &name, array_view const &v, write_options opts) {
+    if (v.rank() == 0) throw std::runtime_error("Error in h5::array_interface::create_extensible: Rank of the array_view has to be > 0");
+
+    // store complex values with a complex datatype
+    if (v.is_complex and opts.complex_storage != write_options::complex_format::extra_dimension) {
+      if (v.rank() == 1) throw std::runtime_error("Error in h5::array_interface::create_extensible: Rank of the complex array_view has to be > 1");
+      create_extensible(g, name, to_complex_datatype(v, opts.complex_storage == write_options::complex_format::native), std::move(opts));
+      return;
+    }
+    H5_INSTRUMENT(instr, "array_interface::create_extensible", g, name);
+
     // unlink the dataset if it already exists
     g.unlink(name);
 
-    // shape of the hyperslab in memory
-    auto hs_shape = v.slab.shape();
+    // shape of the hyperslab in memory and the maximum shape of the dataset
+    auto hs_shape  = v.slab.shape();
+    auto max_shape = hs_shape;
+    max_shape[0]   = H5S_UNLIMITED;
 
-    // chunk the dataset and add compression
-    proplist cparms = H5P_DEFAULT;
-    if (compress and (v.rank() != 0)) {
-      int n_dims = v.rank();
-      std::vector<hsize_t> chunk_dims(n_dims);
-      hsize_t const max_chunk_size = hsize_t{1UL << 32} - hsize_t{1}; // 2^32 - 1 = 4 GB
-      hsize_t chunk_size           = H5Tget_size(v.ty);
-      for (int i = v.rank() - 1; i >= 0; --i) {
-        H5_ASSERT(max_chunk_size >= chunk_size);
-        hsize_t max_dim = max_chunk_size / chunk_size;
-        chunk_dims[i]   = std::clamp(hs_shape[i], hsize_t{1}, max_dim);
-        chunk_size *= chunk_dims[i];
-      }
-      cparms = H5Pcreate(H5P_DATASET_CREATE);
-      H5Pset_chunk(cparms, n_dims, chunk_dims.data());
-      H5Pset_deflate(cparms, 1);
+    // by default, choose the chunk length such that a chunk holds about 1 MB (or opts.chunk_bytes) of data
+    if (opts.chunk_shape.empty()) {
+      hsize_t const target_chunk_size = (opts.chunk_bytes > 0 ? opts.chunk_bytes : hsize_t{1} << 20);
+      hsize_t row_size = std::accumulate(hs_shape.begin() + 1, hs_shape.end(), hsize_t{H5Tget_size(v.ty)}, std::multiplies<>());
+      opts.chunk_shape = hs_shape;
+      opts.chunk_shape[0] = std::max(hsize_t{1}, target_chunk_size / std::max(hsize_t{1}, row_size));
+      std::replace(opts.chunk_shape.begin() + 1, opts.chunk_shape.end(), hsize_t{0}, hsize_t{1});
     }
 
+    // dataset creation property list (extensible datasets are always chunked)
+    proplist cparms = make_dataset_create_proplist(opts, v.ty, hs_shape, v.is_complex);
+
     // dataspace for the dataset in the file
-    dataspace file_dspace = H5Screate_simple(v.slab.rank(), hs_shape.data(), nullptr);
+    dataspace file_dspace = H5Screate_simple(v.slab.rank(), hs_shape.data(), max_shape.data());
 
     // create the dataset in the file
     dataset ds = H5Dcreate2(g, name.c_str(), v.ty, file_dspace, H5P_DEFAULT, cparms, H5P_DEFAULT);
     if (!ds.is_valid())
-      throw std::runtime_error("Error in h5::array_interface::write: Creating the dataset " + name + " in the group " + g.name() + " failed");
+      throw std::runtime_error("Error in h5::array_interface::create_extensible: Creating the dataset " + name + " in the group " + g.name()
+                               + " failed");
 
     // memory dataspace
     dataspace mem_dspace = make_mem_dspace(v);
 
     // write to the file dataset
-    if (H5Sget_simple_extent_npoints(mem_dspace) > 0) { // avoid writing empty arrays
+    if (H5Sget_simple_extent_npoints(file_dspace) > 0) { // avoid writing empty arrays
+      H5_INSTRUMENT_BYTES(instr, H5Sget_select_npoints(mem_dspace) * H5Tget_size(v.ty));
       herr_t err = H5Dwrite(ds, v.ty, mem_dspace, H5S_ALL, H5P_DEFAULT, v.start);
       if (err < 0)
-        throw std::runtime_error("Error in h5::array_interface::write: Writing to the dataset " + name + " in the group" + g.name() + " failed");
+        throw std::runtime_error("Error in h5::array_interface::create_extensible: Writing to the dataset " + name + " in the group " + g.name()
+                                 + " failed");
     }
 
     // add complex attribute if the data is complex valued
     if (v.is_complex) h5_write_attribute(ds, "__complex__", "1");
   }
 
-  void write_slice(group g, std::string const &name, array_view const &v, hyperslab sl) {
-    // empty hyperslab
-    if (sl.empty()) return;
+  void create_extensible(group g, std::string const &name, array_view const &v, bool compress, hsize_t chunk_length) {
+    auto opts = (compress ? write_options{.deflate_level = 1} : write_options{});
+    if (chunk_length > 0 and v.rank() > 0) {
+      opts.chunk_shape    = v.slab.shape();
+      opts.chunk_shape[0] = chunk_length;
+      std::replace(opts.chunk_shape.begin() + 1, opts.chunk_shape.end(), hsize_t{0}, hsize_t{1});
+    }
+    create_extensible(g, name, v, opts);
+  }
+
+  void append(group g, std::string const &name, array_view const &v) {
+    // open existing dataset and get its current and maximum shape
+    dataset ds            = g.open_dataset(name);
+    datatype ty           = H5Dget_type(ds);
+    dataspace file_dspace = H5Dget_space(ds);
+
+    // append complex values to a dataset with a complex datatype
+    if (v.is_complex and get_complex_part_type(ty).is_valid()) {
+      append(g, name, to_complex_datatype(v, is_native_complex(ty)));
+      return;
+    }
+    H5_INSTRUMENT(instr, "array_interface::append", g, name);
+
+    int rank              = H5Sget_simple_extent_ndims(file_dspace);
+    dims_t dims(rank), max_dims(rank);
+    H5Sget_simple_extent_dims(file_dspace, dims.data(), max_dims.data());
 
     // check consistency of input
-    if (v.slab.size() != sl.size()) throw std::runtime_error("Error in h5::array_interface::write_slice: Incompatible sizes");
+    auto hs_shape = v.slab.shape();
+    if (rank == 0 or rank != v.rank())
+      throw std::runtime_error("Error in h5::array_interface::append: Incompatible ranks: " + std::to_string(v.rank()) + " != " + std::to_string(rank));
+    if (not std::equal(hs_shape.begin() + 1, hs_shape.end(), dims.begin() + 1))
+      throw std::runtime_error("Error in h5::array_interface::append: Incompatible shapes");
+
+    if (not hdf5_type_equal(v.ty, ty))
+      throw std::runtime_error("Error in h5::array_interface::append: Incompatible HDF5 types: " + get_name_of_h5_type(v.ty)
+                               + " != " + get_name_of_h5_type(ty));
+
+    // nothing to append
+    if (hs_shape[0] == 0) return;
+
+    if (max_dims[0] != H5S_UNLIMITED and dims[0] + hs_shape[0] > max_dims[0])
+      throw std::runtime_error("Error in h5::array_interface::append: Dataset " + name + " in the group " + g.name() + " is not extensible");
+
+    // extend the dataset along the first dimension
+    auto new_dims = dims;
+    new_dims[0] += hs_shape[0];
+    herr_t err = H5Dset_extent(ds, new_dims.data());
+    if (err < 0) throw std::runtime_error("Error in h5::array_interface::append: Extending the dataset " + name + " in the group " + g.name() + " failed");
+
+    // select the newly added region in the file dataspace
+    file_dspace = H5Dget_space(ds);
+    dims_t offset(rank, 0);
+    offset[0] = dims[0];
+    err       = H5Sselect_hyperslab(file_dspace, H5S_SELECT_SET, offset.data(), nullptr, hs_shape.data(), nullptr);
+    if (err < 0) throw std::runtime_error("Error in h5::array_interface::append: Selecting the hyperslab failed");
+
+    // memory dataspace
+    dataspace mem_dspace = make_mem_dspace(v);
+
+    // write to the selected region of the file dataset
+    H5_INSTRUMENT_BYTES(instr, H5Sget_select_npoints(mem_dspace) * H5Tget_size(v.ty));
+    err = H5Dwrite(ds, v.ty, mem_dspace, file_dspace, H5P_DEFAULT, v.start);
+    if (err < 0) throw std::runtime_error("Error in h5::array_interface::append: Writing to the dataset " + name + " in the group " + g.name() + " failed");
+
+    // the stored content hash is no longer valid
+    remove_hash(ds);
+  }
 
-    auto ds_info = get_dataset_info(g, name);
-    if (not hdf5_type_equal(v.ty, ds_info.ty))
+  void write_slice(dataset ds, array_view const &v_in, hyperslab sl, transfer_options const &xfer) {
+    // empty hyperslab (collective transfers require a call to H5Dwrite on every process)
+    bool collective = (xfer.mode == transfer_options::transfer_mode::collective);
+    if (sl.empty() and not collective) return;
+    H5_INSTRUMENT(instr, "array_interface::write_slice", ds);
+
+    // check consistency of input
+    if (not sl.empty() and v_in.slab.size() != sl.size()) throw std::runtime_error("Error in h5::array_interface::write_slice: Incompatible sizes");
+
+    datatype ty  = H5Dget_type(ds);
+    array_view v = v_in;
+    adapt_complex_view(ty, v, sl);
+    if (not hdf5_type_equal(v.ty, ty))
       throw std::runtime_error("Error in h5::array_interface::write_slice: Incompatible HDF5 types: " + get_name_of_h5_type(v.ty)
-                               + " != " + get_name_of_h5_type(ds_info.ty));
+                               + " != " + get_name_of_h5_type(ty));
 
-    // open existing dataset, get dataspace and select hyperslab
-    dataset ds            = g.open_dataset(name);
+    // get dataspace and select hyperslab (or nothing in case of an empty hyperslab)
     dataspace file_dspace = H5Dget_space(ds);
-    herr_t err            = H5Sselect_hyperslab(file_dspace, H5S_SELECT_SET, sl.offset.data(), sl.stride.data(), sl.count.data(),
-                                                (sl.block.empty() ? nullptr : sl.block.data()));
+    herr_t err            = (sl.empty() ? H5Sselect_none(file_dspace)
+                                        : H5Sselect_hyperslab(file_dspace, H5S_SELECT_SET, sl.offset.data(), sl.stride.data(), sl.count.data(),
+                                                              (sl.block.empty() ? nullptr : sl.block.data())));
     if (err < 0) throw std::runtime_error("Error in h5::array_interface::write_slice: Selecting the hyperslab failed");
 
     // memory dataspace
-    dataspace mem_dspace = make_mem_dspace(v);
+    dataspace mem_dspace = (sl.empty() ? dataspace{H5Scopy(file_dspace)} : make_mem_dspace(v));
 
     // write to the selected hyperslab of the file dataset
     if (H5Sget_simple_extent_npoints(file_dspace) > 0) {
-      err = H5Dwrite(ds, v.ty, mem_dspace, file_dspace, H5P_DEFAULT, v.start);
-      if (err < 0)
-        throw std::runtime_error("Error in h5::array_interface::write_slice: Writing the dataset " + name + " in the group " + g.name() + " failed");
+      H5_INSTRUMENT_BYTES(instr, H5Sget_select_npoints(mem_dspace) * H5Tget_size(v.ty));
+      proplist dxpl = make_dataset_transfer_proplist(xfer);
+      err           = H5Dwrite(ds, v.ty, mem_dspace, file_dspace, dxpl, v.start);
+      if (err < 0) throw std::runtime_error("Error in h5::array_interface::write_slice: Writing to the dataset failed");
     }
+
+    // the stored content hash is no longer valid (collective transfers require every process to modify the metadata)
+    if (not sl.empty() or collective) remove_hash(ds);
+  }
+
+  void write_slice(group g, std::string const &name, array_view const &v, hyperslab sl, transfer_options const &xfer) {
+    // empty hyperslab
+    if (sl.empty() and xfer.mode == transfer_options::transfer_mode::independent) return;
+    write_slice(g.open_dataset(name), v, std::move(sl), xfer);
   }
 
   void write_attribute(object obj, std::string const &name, array_view v) {
-    // check if the attribute already exists
-    if (H5LTfind_attribute(obj, name.c_str()) != 0)
-      throw std::runtime_error("Error in h5::array_interface::write_attribute: Attribute " + name + " already exists");
+    H5_INSTRUMENT(instr, "array_interface::write_attribute", obj, name);
 
-    // memory dataspace
-    dataspace mem_dspace = make_mem_dspace(v);
+    // dataspace of the attribute has the shape of the hyperslab
+    auto shape        = v.slab.shape();
+    dataspace a_space =
+       (shape.empty() ? detail::scalar_dataspace() : dataspace{H5Screate_simple(static_cast<int>(shape.size()), shape.data(), nullptr)});
+
+    // reuse an existing attribute with the same datatype and shape, otherwise delete it
+    attribute attr;
+    if (H5Aexists(obj, name.c_str()) > 0) {
+      attr              = H5Aopen(obj, name.c_str(), H5P_DEFAULT);
+      datatype old_ty   = H5Aget_type(attr);
+      dataspace old_spc = H5Aget_space(attr);
+      if (H5Tequal(old_ty, v.ty) <= 0 or H5Sextent_equal(old_spc, a_space) <= 0) {
+        attr.close();
+        if (H5Adelete(obj, name.c_str()) < 0)
+          throw std::runtime_error("Error in h5::array_interface::write_attribute: Deleting the existing attribute " + name + " failed");
+      }
+    }
 
     // create attribute to write to
-    attribute attr = H5Acreate2(obj, name.c_str(), v.ty, mem_dspace, H5P_DEFAULT, H5P_DEFAULT);
+    if (!attr.is_valid()) attr = H5Acreate2(obj, name.c_str(), v.ty, a_space, H5P_DEFAULT, H5P_DEFAULT);
     if (!attr.is_valid()) throw std::runtime_error("Error in h5::array_interface::write_attribute: Creating the attribute " + name + " failed");
 
+    // gather the selected elements if they are not contiguous and C-ordered in memory
+    dataspace mem_dspace = make_mem_dspace(v);
+    auto npoints         = H5Sget_select_npoints(mem_dspace);
+    void const *buf      = v.start;
+    std::vector<std::byte> tmp;
+    if (v.is_strided() or npoints != H5Sget_simple_extent_npoints(mem_dspace)) {
+      tmp.resize(npoints * H5Tget_size(v.ty));
+      if (H5Dgather(mem_dspace, v.start, v.ty, tmp.size(), tmp.data(), nullptr, nullptr) < 0)
+        throw std::runtime_error("Error in h5::array_interface::write_attribute: Gathering the data for the attribute " + name + " failed");
+      buf = tmp.data();
+    }
+
     // write to the attribute
-    herr_t err = H5Awrite(attr, v.ty, v.start);
+    H5_INSTRUMENT_BYTES(instr, npoints * H5Tget_size(v.ty));
+    herr_t err = H5Awrite(attr, v.ty, buf);
     if (err < 0) throw std::runtime_error("Error in h5::array_interface::write_attribute: Writing to the attribute " + name + " failed");
   }
 
-  void read(group g, std::string const &name, array_view v, hyperslab sl) {
-    // open dataset and get dataspace
-    dataset ds            = g.open_dataset(name);
+  void write_attributes(object obj, std::vector<std::pair<std::string, array_view>> const &items) {
+    for (auto const &[name, v] : items) write_attribute(obj, name, v);
+  }
+
+  void read(dataset ds, array_view v, hyperslab sl, transfer_options const &xfer) {
+    H5_INSTRUMENT(instr, "array_interface::read", ds);
+
+    // get dataspace and datatype
     dataspace file_dspace = H5Dget_space(ds);
+    datatype ty           = H5Dget_type(ds);
+
+    // read complex values stored with a complex datatype
+    adapt_complex_view(ty, v, sl);
 
     // if provided, select the hyperslab of the file dataspace
     if (not sl.empty()) {
@@ -219,48 +1091,188 @@ namespace h5::array_interface {
     }
 
     // check consistency of input
-    auto ds_info = get_dataset_info(g, name);
-    if (H5Tget_class(v.ty) != H5Tget_class(ds_info.ty))
-      throw std::runtime_error("Error in h5::array_interface::read: Incompatible HDF5 types: " + get_name_of_h5_type(v.ty)
-                               + " != " + get_name_of_h5_type(ds_info.ty));
-
-    if (not hdf5_type_equal(v.ty, ds_info.ty))
-      std::cerr << "WARNING: HDF5 type mismatch while reading into an array_view: " + get_name_of_h5_type(v.ty)
-            + " != " + get_name_of_h5_type(ds_info.ty) + "\n";
-
-    auto sl_size = sl.size();
-    if (sl.empty()) { sl_size = std::accumulate(ds_info.lengths.begin(), ds_info.lengths.end(), (hsize_t)1, std::multiplies<>()); }
-    if (sl_size != v.slab.size()) throw std::runtime_error("Error in h5::array_interface::read: Incompatible sizes");
+    bool needs_conversion = check_read_compatibility(ty, file_dspace, v, sl, xfer);
 
     // memory dataspace
     dataspace mem_dspace = make_mem_dspace(v);
 
     // read the selected hyperslab from the file dataset
     if (H5Sget_simple_extent_npoints(file_dspace) > 0) {
-      herr_t err = H5Dread(ds, v.ty, mem_dspace, file_dspace, H5P_DEFAULT, v.start);
+      H5_INSTRUMENT_BYTES(instr, H5Sget_select_npoints(mem_dspace) * H5Tget_size(v.ty));
+      proplist dxpl = make_dataset_transfer_proplist(xfer);
+      if (needs_conversion and xfer.fast_conversion and read_with_fast_conversion(ds, ty, file_dspace, mem_dspace, v, dxpl)) return;
+      herr_t err = H5Dread(ds, v.ty, mem_dspace, file_dspace, dxpl, v.start);
+      if (err < 0) throw std::runtime_error("Error in h5::array_interface::read: Reading the dataset failed");
+    }
+  }
+
+  void read(group g, std::string const &name, array_view v, hyperslab sl, transfer_options const &xfer) {
+    read(g.open_dataset(name), std::move(v), std::move(sl), xfer);
+  }
+
+  void write_multi(group g, std::vector<std::pair<std::string, array_view>> const &items_in, write_options const &opts,
+                   transfer_options const &xfer) {
+    H5_INSTRUMENT(instr, "array_interface::write_multi", g);
+
+    // store complex values with a complex datatype
+    auto items = items_in;
+    if (opts.complex_storage != write_options::complex_format::extra_dimension) {
+      for (auto &[name, v] : items) {
+        if (v.is_complex) v = to_complex_datatype(v, opts.complex_storage == write_options::complex_format::native);
+      }
+    }
+
+    // create or reuse all datasets and collect the arguments for the write call (empty and unchanged arrays are not written)
+    std::vector<write_target> dsets;
+    std::vector<dataspace> mem_dspaces;
+    std::vector<std::size_t> idxs;
+    dsets.reserve(items.size());
+    for (std::size_t i = 0; i < items.size(); ++i) {
+      auto const &[name, v] = items[i];
+      dsets.push_back(get_write_target(g, name, v, opts));
+      dataspace mem_dspace = make_mem_dspace(v);
+      if (not dsets.back().skip and H5Sget_simple_extent_npoints(mem_dspace) > 0) {
+        H5_INSTRUMENT_BYTES(instr, H5Sget_select_npoints(mem_dspace) * H5Tget_size(v.ty));
+        mem_dspaces.push_back(std::move(mem_dspace));
+        idxs.push_back(i);
+      }
+    }
+
+    proplist dxpl = make_dataset_transfer_proplist(xfer);
+#if H5_VERSION_GE(1, 14, 0)
+    // write all datasets with a single call
+    if (not idxs.empty()) {
+      auto count = idxs.size();
+      std::vector<hid_t> dset_ids(count), mem_type_ids(count), mem_space_ids(count), file_space_ids(count, H5S_ALL);
+      std::vector<void const *> bufs(count);
+      for (std::size_t j = 0; j < count; ++j) {
+        auto const &v     = items[idxs[j]].second;
+        dset_ids[j]       = dsets[idxs[j]].ds;
+        mem_type_ids[j]   = v.ty;
+        mem_space_ids[j]  = mem_dspaces[j];
+        bufs[j]           = v.start;
+      }
+      herr_t err = H5Dwrite_multi(count, dset_ids.data(), mem_type_ids.data(), mem_space_ids.data(), file_space_ids.data(), dxpl, bufs.data());
+      if (err < 0) throw std::runtime_error("Error in h5::array_interface::write_multi: Writing to the datasets in the group " + g.name() + " failed");
+    }
+#else
+    // write one dataset after the other
+    for (std::size_t j = 0; j < idxs.size(); ++j) {
+      auto const &[name, v] = items[idxs[j]];
+      herr_t err            = H5Dwrite(dsets[idxs[j]].ds, v.ty, mem_dspaces[j], H5S_ALL, dxpl, v.start);
       if (err < 0)
-        throw std::runtime_error("Error in h5::array_interface::read: Reading the dataset " + name + " in the group " + g.name() + " failed");
+        throw std::runtime_error("Error in h5::array_interface::write_multi: Writing to the dataset " + name + " in the group " + g.name() + " failed");
     }
+#endif
+
+    // add complex and hash attributes
+    for (std::size_t i = 0; i < items.size(); ++i) finish_write(dsets[i], items[i].second);
+  }
+
+  void read_multi(group g, std::vector<std::pair<std::string, array_view>> const &items_in, transfer_options const &xfer) {
+    H5_INSTRUMENT(instr, "array_interface::read_multi", g);
+
+    // open all datasets, check the consistency of the input and collect the arguments for the read call
+    auto items = items_in;
+    std::vector<dataset> dsets;
+    std::vector<dataspace> mem_dspaces;
+    std::vector<std::size_t> idxs;
+    dsets.reserve(items.size());
+    for (std::size_t i = 0; i < items.size(); ++i) {
+      auto &[name, v] = items[i];
+      dsets.push_back(g.open_dataset(name));
+      dataspace file_dspace = H5Dget_space(dsets.back());
+      datatype ty           = H5Dget_type(dsets.back());
+      hyperslab sl;
+      adapt_complex_view(ty, v, sl);
+      std::ignore = check_read_compatibility(ty, file_dspace, v, sl, xfer);
+      if (H5Sget_simple_extent_npoints(file_dspace) > 0) {
+        H5_INSTRUMENT_BYTES(instr, H5Sget_select_npoints(file_dspace) * H5Tget_size(v.ty));
+        mem_dspaces.push_back(make_mem_dspace(v));
+        idxs.push_back(i);
+      }
+    }
+
+    proplist dxpl = make_dataset_transfer_proplist(xfer);
+#if H5_VERSION_GE(1, 14, 0)
+    // read all datasets with a single call
+    if (not idxs.empty()) {
+      auto count = idxs.size();
+      std::vector<hid_t> dset_ids(count), mem_type_ids(count), mem_space_ids(count), file_space_ids(count, H5S_ALL);
+      std::vector<void *> bufs(count);
+      for (std::size_t j = 0; j < count; ++j) {
+        auto const &v     = items[idxs[j]].second;
+        dset_ids[j]       = dsets[idxs[j]];
+        mem_type_ids[j]   = v.ty;
+        mem_space_ids[j]  = mem_dspaces[j];
+        bufs[j]           = v.start;
+      }
+      herr_t err = H5Dread_multi(count, dset_ids.data(), mem_type_ids.data(), mem_space_ids.data(), file_space_ids.data(), dxpl, bufs.data());
+      if (err < 0) throw std::runtime_error("Error in h5::array_interface::read_multi: Reading the datasets in the group " + g.name() + " failed");
+    }
+#else
+    // read one dataset after the other
+    for (std::size_t j = 0; j < idxs.size(); ++j) {
+      auto const &[name, v] = items[idxs[j]];
+      herr_t err            = H5Dread(dsets[idxs[j]], v.ty, mem_dspaces[j], H5S_ALL, dxpl, v.start);
+      if (err < 0)
+        throw std::runtime_error("Error in h5::array_interface::read_multi: Reading the dataset " + name + " in the group " + g.name() + " failed");
+    }
+#endif
+  }
+
+  v_t get_attribute_shape(object obj, std::string const &name) {
+    attribute attr = H5Aopen(obj, name.c_str(), H5P_DEFAULT);
+    if (!attr.is_valid()) throw std::runtime_error("Error in h5::array_interface::get_attribute_shape: Opening the attribute " + name + " failed");
+    dataspace space = H5Aget_space(attr);
+    v_t dims(std::max(H5Sget_simple_extent_ndims(space), 0));
+    H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+    return dims;
   }
 
   void read_attribute(object obj, std::string const &name, array_view v) {
+    H5_INSTRUMENT(instr, "array_interface::read_attribute", obj, name);
+
     // open attribute
     attribute attr = H5Aopen(obj, name.c_str(), H5P_DEFAULT);
     if (!attr.is_valid()) throw std::runtime_error("Error in h5::array_interface::read_attribute: Opening the attribute " + name + " failed");
 
-    // get dataspace information
+    // get dataspace information (the shape has to match the shape of the hyperslab)
     dataspace space = H5Aget_space(attr);
     int rank        = H5Sget_simple_extent_ndims(space);
-    if (rank != 0) throw std::runtime_error("Error in h5::array_interface::read_attribute: Attribute " + name + " has a rank != 0");
+    v_t dims(std::max(rank, 0));
+    H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+    if (dims != v.slab.shape())
+      throw std::runtime_error("Error in h5::array_interface::read_attribute: Shape of the attribute " + name + " does not match the shape of the array_view");
 
     // get datatype information
-    auto eq = H5Tequal(H5Aget_type(attr), v.ty);
+    datatype a_ty = H5Aget_type(attr);
+    auto eq       = H5Tequal(a_ty, v.ty);
     if (eq < 0) throw std::runtime_error("Error in h5::array_interface::read_attribute: H5Tequal call failed");
     if (eq == 0) throw std::runtime_error("Error in h5::array_interface::read_attribute: Incompatible HDF5 types");
 
-    // read the attribute
-    auto err = H5Aread(attr, v.ty, v.start);
-    if (err < 0) throw std::runtime_error("Error in h5::array_interface::read_attribute: Reading the attribute " + name + " failed");
+    // read the attribute directly if the selected elements are contiguous and C-ordered in memory
+    dataspace mem_dspace = make_mem_dspace(v);
+    auto npoints         = H5Sget_select_npoints(mem_dspace);
+    H5_INSTRUMENT_BYTES(instr, npoints * H5Tget_size(v.ty));
+    if (not v.is_strided() and npoints == H5Sget_simple_extent_npoints(mem_dspace)) {
+      auto err = H5Aread(attr, v.ty, v.start);
+      if (err < 0) throw std::runtime_error("Error in h5::array_interface::read_attribute: Reading the attribute " + name + " failed");
+      return;
+    }
+
+    // otherwise read into a contiguous buffer and scatter the elements
+    std::vector<std::byte> tmp(npoints * H5Tget_size(v.ty));
+    if (H5Aread(attr, v.ty, tmp.data()) < 0)
+      throw std::runtime_error("Error in h5::array_interface::read_attribute: Reading the attribute " + name + " failed");
+    auto op = [](void const **src, std::size_t *src_size, void *data) -> herr_t {
+      auto *buf = static_cast<std::vector<std::byte> *>(data);
+      *src      = buf->data();
+      *src_size = buf->size();
+      return 0;
+    };
+    if (H5Dscatter(op, &tmp, v.ty, mem_dspace, v.start) < 0)
+      throw std::runtime_error("Error in h5::array_interface::read_attribute: Scattering the data of the attribute " + name + " failed");
   }
 
 } // namespace h5::array_interface
@@ -24,11 +24,14 @@
 
 #include "./group.hpp"
 #include "./object.hpp"
+#include "./properties.hpp"
+#include "./small_vector.hpp"
 
 #include <algorithm>
 #include <numeric>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace h5::array_interface {
 
@@ -40,7 +43,7 @@ namespace h5::array_interface {
   /// Simple struct to store basic information about an HDF5 dataset.
   struct dataset_info {
     /// Shape of the dataspace in the dataset.
-    v_t lengths;
+    dims_t lengths;
 
     /// h5::datatype stored in the dataset.
     datatype ty;
@@ -48,6 +51,27 @@ namespace h5::array_interface {
     /// Whether the stored values are complex.
     bool has_complex_attribute;
 
+    /// Whether the complex values are stored with a compound or a native complex datatype (`ty` is the type of the parts).
+    bool has_complex_datatype = false;
+
+    /// Get the rank of the dataspace in the dataset.
+    [[nodiscard]] int rank() const { return static_cast<int>(lengths.size()); }
+  };
+
+  /// Lightweight metadata of an HDF5 dataset which is retrieved without reading any attributes.
+  struct dataset_metadata {
+    /// Name of the dataset.
+    std::string name;
+
+    /// Shape of the dataspace in the dataset (complex datatypes do not add a dimension).
+    v_t lengths;
+
+    /// h5::type_code of the datatype stored in the dataset.
+    type_code code = type_code::unknown;
+
+    /// Number of bytes allocated in the file for the raw data (after compression).
+    hsize_t storage_size = 0;
+
     /// Get the rank of the dataspace in the dataset.
     [[nodiscard]] int rank() const { return static_cast<int>(lengths.size()); }
   };
@@ -90,16 +114,16 @@ namespace h5::array_interface {
    */
   struct hyperslab {
     /// Index offset for each dimension.
-    v_t offset;
+    dims_t offset;
 
     /// Stride in each dimension (in the HDF5 sense).
-    v_t stride;
+    dims_t stride;
 
     /// Number of elements or blocks to select along each dimension.
-    v_t count;
+    dims_t count;
 
     /// Shape of a single block selected from the dataspace.
-    v_t block;
+    dims_t block;
 
     /**
      * @brief Construct a new empty hyperslab for a dataspace of a given rank.
@@ -128,16 +152,15 @@ namespace h5::array_interface {
     [[nodiscard]] bool empty() const { return count.empty(); }
 
     /// Get the shape of the selected hyperslab.
-    [[nodiscard]] v_t shape() const {
-      v_t shape(rank());
+    [[nodiscard]] dims_t shape() const {
+      dims_t shape(rank());
       std::transform(count.begin(), count.end(), block.begin(), shape.begin(), std::multiplies<>());
       return shape;
     }
 
     /// Get the total number of elements in the hyperslab.
-    [[nodiscard]] auto size() const {
-      auto sh = shape();
-      return std::accumulate(sh.begin(), sh.end(), (hsize_t)1, std::multiplies<>());
+    [[nodiscard]] hsize_t size() const {
+      return std::transform_reduce(count.begin(), count.end(), block.begin(), (hsize_t)1, std::multiplies<>(), std::multiplies<>());
     }
   };
 
@@ -150,6 +173,11 @@ namespace h5::array_interface {
    * Note that the shape of the parent array does not necessarily have to correspond to the actual shape and size of
    * the underlying memory. It is only used to select the correct elements in the hyperslab.
    *
+   * Memory layouts which cannot be described by a hyperslab of a parent array (e.g. strides which do not divide each
+   * other) are described by the element strides in `mem_strides` instead (see h5::array_interface::make_strided_view).
+   * In this case, `parent_shape` is ignored and `slab` selects the full `slab.count` elements with offset 0, stride 1
+   * and block 1.
+   *
    * If the data of the array is complex, its imaginary part is treated as just another dimension.
    */
   struct array_view {
@@ -160,7 +188,7 @@ namespace h5::array_interface {
     void *start;
 
     /// Shape of the (contiguous) parent array.
-    v_t parent_shape;
+    dims_t parent_shape;
 
     /// h5::array_interface::hyperslab specifying the selection of the view.
     hyperslab slab;
@@ -168,6 +196,9 @@ namespace h5::array_interface {
     /// Whether the data is complex valued.
     bool is_complex;
 
+    /// Strides of the view in units of elements of `ty` (only set if the layout is not a hyperslab of `parent_shape`).
+    std::vector<long> mem_strides = {};
+
     /**
      * @brief Construct a new empty array view.
      *
@@ -186,6 +217,9 @@ namespace h5::array_interface {
 
     /// Get the rank of the view (including the possible added imaginary dimension).
     [[nodiscard]] int rank() const { return slab.rank(); }
+
+    /// Check whether the memory layout of the view is given by `mem_strides`.
+    [[nodiscard]] bool is_strided() const { return not mem_strides.empty(); }
   };
 
   /**
@@ -210,11 +244,63 @@ namespace h5::array_interface {
    * @param view_size Number of elements in the given view.
    * @return std::pair containing the shape of the parent array and the HDF5 strides of the view.
    */
-  std::pair<v_t, v_t> get_parent_shape_and_h5_strides(long const *np_strides, int rank, long view_size);
+  std::pair<dims_t, dims_t> get_parent_shape_and_h5_strides(long const *np_strides, int rank, long view_size);
+
+  /**
+   * @brief Create a view on an n-dimensional array with arbitrary numpy/nda-style strides.
+   *
+   * @details If possible, the layout is described by a single hyperslab of a parent array (see
+   * h5::array_interface::get_parent_shape_and_h5_strides). Otherwise, e.g. for strides which do not divide each other
+   * or for column-major layouts of padded arrays, the strides are stored in h5::array_interface::array_view::mem_strides
+   * and the memory dataspace selects the elements as a union of hyperslabs (if the elements are stored in C-order) or
+   * as a list of points. In both cases, the data is read and written without a temporary copy.
+   *
+   * @param ty h5::datatype of the array (of the real and imaginary parts if complex).
+   * @param start Pointer to the first element of the view.
+   * @param shape Shape of the view (excluding the possible added imaginary dimension).
+   * @param strides Non-negative strides of the view in units of elements (complex numbers count as one element).
+   * @param is_complex Whether the data is complex valued.
+   * @return h5::array_interface::array_view on the given memory.
+   */
+  [[nodiscard]] array_view make_strided_view(datatype ty, void *start, v_t const &shape, std::vector<long> const &strides, bool is_complex = false);
+
+  /**
+   * @brief Create the HDF5 memory dataspace selecting the elements of an array view.
+   *
+   * @param v h5::array_interface::array_view.
+   * @return h5::dataspace with the selected elements of the view.
+   */
+  [[nodiscard]] dataspace make_mem_dspace(array_view const &v);
+
+  /**
+   * @brief Get a view on complex data which uses a complex HDF5 datatype instead of the additional dimension.
+   *
+   * @details The trailing dimension of size 2 is removed from the view and its datatype is replaced by a compound
+   * datatype with the members "r" and "i" of the original type or, if `native == true` and HDF5 >= 2.0, by a native
+   * HDF5 complex datatype. The view refers to the same memory as the original view.
+   *
+   * @param v Complex valued h5::array_interface::array_view (the real and imaginary parts have to be selected together).
+   * @param native Whether to use a native HDF5 complex datatype.
+   * @return h5::array_interface::array_view with datatype of the complex values.
+   */
+  [[nodiscard]] array_view to_complex_datatype(array_view const &v, bool native = false);
+
+  /**
+   * @brief Remove the additional dimension for the imaginary part from a complex hyperslab.
+   *
+   * @param sl Complex h5::array_interface::hyperslab (the real and imaginary parts have to be selected together).
+   * @return h5::array_interface::hyperslab for a dataset with a complex datatype (empty if `sl` is empty).
+   */
+  [[nodiscard]] hyperslab to_complex_datatype(hyperslab const &sl);
 
   /**
    * @brief Retrieve the shape and the h5::datatype from a dataset.
    *
+   * @details Complex values are detected from the datatype of the dataset (a compound with the members "r" and "i" of
+   * the same floating point type or a native HDF5 complex datatype) or from the `__complex__` attribute for datasets
+   * with an additional dimension. In both cases, the returned info looks like the one of a dataset with an additional
+   * dimension, i.e. the shape ends with a 2 and the datatype is the one of the real and imaginary parts.
+   *
    * @param ds h5::dataset.
    * @return h5::array_interface::dataset_info containing the shape and HDF5 type of the dataset.
    */
@@ -229,11 +315,139 @@ namespace h5::array_interface {
    */
   dataset_info get_dataset_info(group g, std::string const &name);
 
+  /**
+   * @brief Get the shape of the dataspace of a dataset.
+   *
+   * @details In contrast to h5::array_interface::get_dataset_info, it only queries the dataspace, i.e. it neither
+   * inspects the datatype nor the attributes of the dataset. Complex values stored with a complex datatype therefore
+   * do not have an additional dimension.
+   *
+   * @param ds h5::dataset.
+   * @return Shape of the dataset.
+   */
+  [[nodiscard]] v_t get_dataset_shape(dataset ds);
+
+  /**
+   * @brief Get the rank of the dataspace of a dataset (see h5::array_interface::get_dataset_shape).
+   *
+   * @param ds h5::dataset.
+   * @return Rank of the dataset.
+   */
+  [[nodiscard]] int get_dataset_rank(dataset ds);
+
+  /**
+   * @brief Classify the datatype stored in a dataset (see h5::get_type_code).
+   *
+   * @param ds h5::dataset.
+   * @return h5::type_code of the datatype of the dataset.
+   */
+  [[nodiscard]] type_code get_dataset_type_code(dataset ds);
+
+  /**
+   * @brief Get the number of bytes allocated in the file for the raw data of a dataset (see `H5Dget_storage_size`).
+   *
+   * @param ds h5::dataset.
+   * @return Storage size in bytes.
+   */
+  [[nodiscard]] hsize_t get_dataset_storage_size(dataset ds);
+
+  /**
+   * @brief Get the metadata of all datasets in a group.
+   *
+   * @details The links of the group are visited once with h5::group::for_each_child. Only the dataspace, the datatype
+   * and the storage size of each dataset are queried, i.e. no attributes are read. This makes it cheap to index groups
+   * with many datasets. Subgroups and other objects are skipped.
+   *
+   * @param g h5::group.
+   * @return Vector of h5::array_interface::dataset_metadata in the order of h5::group::for_each_child.
+   */
+  [[nodiscard]] std::vector<dataset_metadata> describe_group(group g);
+
+  /// Result of the integrity check of a single dataset (see h5::array_interface::verify).
+  struct verify_result {
+    /// Path of the dataset relative to the verified group (empty if a single dataset is verified).
+    std::string name;
+
+    /// Whether the dataset has a Fletcher32 checksum or a stored content hash.
+    bool has_checksum = false;
+
+    /// Whether no corruption was detected (always true if there is nothing to check).
+    bool ok = true;
+  };
+
+  /**
+   * @brief Check the integrity of a dataset.
+   *
+   * @details Datasets written with h5::write_options::fletcher32 store a checksum of every chunk which HDF5 checks when
+   * the chunk is read. Datasets written with h5::write_options::content_hash (or with the `skip_unchanged` update mode)
+   * store a 64-bit hash of their content in the attribute `__hash__`. If the dataset has one of them, it is read in
+   * blocks of about 1 MB and the verification fails if a chunk cannot be read or if the hash of the content differs
+   * from the stored one. Datasets without checksums and datasets with variable-length data are not read.
+   *
+   * @param ds h5::dataset.
+   * @return h5::array_interface::verify_result.
+   */
+  [[nodiscard]] verify_result verify_dataset(dataset ds);
+
+  /**
+   * @brief Check the integrity of all datasets in a group and its subgroups.
+   *
+   * @details The datasets are verified as in h5::array_interface::verify_dataset on a pool of `n_threads` worker
+   * threads, i.e. hashing the content of one dataset overlaps with reading the next ones. Each worker holds an
+   * h5::library_lock only while it calls into HDF5, so the blocks are hashed concurrently even if the HDF5 library is
+   * not thread-safe.
+   *
+   * @code{.cpp}
+   * h5::file f("archive.h5", 'r');
+   * for (auto const &r : h5::array_interface::verify(f)) {
+   *   if (not r.ok) std::cerr << "corrupted dataset: " << r.name << "\n";
+   * }
+   * @endcode
+   *
+   * @param g h5::group.
+   * @param n_threads Number of worker threads (defaults to `std::thread::hardware_concurrency` if <= 0).
+   * @return Vector of h5::array_interface::verify_result for all datasets (depth-first in the order of h5::group::for_each_child).
+   */
+  [[nodiscard]] std::vector<verify_result> verify(group g, int n_threads = 0);
+
+  /**
+   * @brief Check whether two groups contain the same datasets with the same content.
+   *
+   * @details The groups are compared recursively. They have the same content if they contain datasets with the same
+   * paths, datatypes, shapes and content hashes. The hashes stored with h5::write_options::content_hash are used
+   * without reading the data, only datasets without a stored hash are read and hashed. Attributes are not compared.
+   *
+   * Throws an exception if a dataset contains variable-length data.
+   *
+   * @param g1 First h5::group.
+   * @param g2 Second h5::group.
+   * @return True if the groups have the same content, false otherwise.
+   */
+  [[nodiscard]] bool same_content(group g1, group g2);
+
+  /**
+   * @brief Write an array view to an HDF5 dataset using the given dataset creation policy.
+   *
+   * @details If a link with the given name already exists, it is first unlinked.
+   *
+   * Complex valued data is stored according to h5::write_options::complex_storage.
+   *
+   * @param g h5::group in which the dataset is created.
+   * @param name Name of the dataset
+   * @param v h5::array_interface::array_view to be written.
+   * @param opts h5::write_options specifying the chunking, the filter pipeline and the fill value settings.
+   */
+  void write(group g, std::string const &name, array_view const &v, write_options const &opts);
+
   /**
    * @brief Write an array view to an HDF5 dataset.
    *
    * @details If a link with the given name already exists, it is first unlinked.
    *
+   * If `compress == true`, it is equivalent to calling h5::array_interface::write with
+   * `h5::write_options{.deflate_level = 1}`, i.e. the data is stored (in most cases) in a single chunk which is
+   * compressed with the deflate filter. Otherwise, a contiguous dataset is created.
+   *
    * @param g h5::group in which the dataset is created.
    * @param name Name of the dataset
    * @param v h5::array_interface::array_view to be written.
@@ -241,41 +455,193 @@ namespace h5::array_interface {
    */
   void write(group g, std::string const &name, array_view const &v, bool compress);
 
+  /**
+   * @brief Write an array view to a new extensible HDF5 dataset.
+   *
+   * @details The first dimension of the created dataset is unlimited (`H5S_UNLIMITED`), all other dimensions are fixed
+   * to the corresponding extent of the view. Such a dataset can be extended later on with
+   * h5::array_interface::append. The view may be empty along the first dimension to create an empty dataset.
+   *
+   * Extensible datasets are always chunked. If `chunk_length` is zero, the number of entries along the first dimension
+   * in a single chunk is chosen such that a chunk holds about 1 MB of data.
+   *
+   * If a link with the given name already exists, it is first unlinked.
+   *
+   * @param g h5::group in which the dataset is created.
+   * @param name Name of the dataset.
+   * @param v h5::array_interface::array_view to be written (rank > 0).
+   * @param compress Whether to compress the dataset.
+   * @param chunk_length Number of entries along the first dimension in a single chunk.
+   */
+  void create_extensible(group g, std::string const &name, array_view const &v, bool compress, hsize_t chunk_length = 0);
+
+  /**
+   * @brief Write an array view to a new extensible HDF5 dataset using the given dataset creation policy.
+   *
+   * @details Same as h5::array_interface::create_extensible(group, std::string const &, array_view const &, bool, hsize_t)
+   * except that the chunk shape and the filter pipeline are taken from the given h5::write_options. If no chunk shape is
+   * specified, the number of entries along the first dimension in a single chunk is chosen such that a chunk holds
+   * about `opts.chunk_bytes` bytes (1 MB if `opts.chunk_bytes == 0`).
+   *
+   * @param g h5::group in which the dataset is created.
+   * @param name Name of the dataset.
+   * @param v h5::array_interface::array_view to be written (rank > 0).
+   * @param opts h5::write_options specifying the chunking, the filter pipeline and the fill value settings.
+   */
+  void create_extensible(group g, std::string const &name, array_view const &v, write_options opts);
+
+  /**
+   * @brief Append an array view to an existing extensible HDF5 dataset.
+   *
+   * @details The dataset is extended along its first dimension by the extent of the first dimension of the view and
+   * the view is written to the newly added region. All other dimensions as well as the datatypes of the view and the
+   * dataset have to match. Otherwise, an exception is thrown. A stored content hash (see
+   * h5::write_options::content_hash) is removed.
+   *
+   * @param g h5::group which contains the dataset.
+   * @param name Name of the dataset.
+   * @param v h5::array_interface::array_view to be appended.
+   */
+  void append(group g, std::string const &name, array_view const &v);
+
   /**
    * @brief Write an array view to a selected hyperslab of an existing HDF5 dataset.
    *
    * @details It checks if the number of elements in the view is the same as selected in the hyperslab and if the
-   * datatypes are compatible. Otherwise, an exception is thrown.
+   * datatypes are compatible. Otherwise, an exception is thrown. A stored content hash (see
+   * h5::write_options::content_hash) is removed.
    *
    * @param g h5::group which contains the dataset.
    * @param name Name of the dataset.
    * @param v h5::array_interface::array_view to be written.
    * @param sl h5::array_interface::hyperslab specifying the selection to be written to.
+   * @param xfer h5::transfer_options specifying the data transfer mode.
    */
-  void write_slice(group g, std::string const &name, array_view const &v, hyperslab sl);
+  void write_slice(group g, std::string const &name, array_view const &v, hyperslab sl, transfer_options const &xfer = {});
+
+  /**
+   * @brief Write an array view to a selected hyperslab of an already opened HDF5 dataset.
+   *
+   * @details See h5::array_interface::write_slice(group, std::string const &, array_view const &, hyperslab).
+   *
+   * @param ds h5::dataset to write to.
+   * @param v h5::array_interface::array_view to be written.
+   * @param sl h5::array_interface::hyperslab specifying the selection to be written to.
+   * @param xfer h5::transfer_options specifying the data transfer mode.
+   */
+  void write_slice(dataset ds, array_view const &v, hyperslab sl, transfer_options const &xfer = {});
 
   /**
    * @brief Write an array view to an HDF5 attribute.
    *
+   * @details The attribute has the shape of the hyperslab of the view, i.e. views of any rank can be written. Strided
+   * views are gathered into a contiguous buffer first.
+   *
+   * An existing attribute with the same name is overwritten. If its datatype and shape match, it is reused.
+   * Otherwise, it is deleted and created again.
+   *
    * @param obj h5::object to which the attribute is attached.
    * @param name Name of the attribute.
    * @param v v h5::array_interface::array_view to be written.
    */
   void write_attribute(object obj, std::string const &name, array_view v);
 
+  /**
+   * @brief Write multiple array views to HDF5 attributes of the same object.
+   *
+   * @details See h5::array_interface::write_attribute. The object is only opened once by the caller, which avoids the
+   * repeated lookups of writing the attributes by key.
+   *
+   * @param obj h5::object to which the attributes are attached.
+   * @param items Pairs of attribute names and h5::array_interface::array_view objects to be written.
+   */
+  void write_attributes(object obj, std::vector<std::pair<std::string, array_view>> const &items);
+
+  /**
+   * @brief Check if an array view can be read from a dataset.
+   *
+   * @details Datatypes of different classes are incompatible and an exception is thrown. Otherwise, if the datatypes
+   * differ or if real values are read into a complex view, the data has to be converted while reading. Depending on
+   * the conversion policy of the given h5::transfer_options, the conversion is allowed silently, allowed with a
+   * warning or forbidden, in which case an exception is thrown.
+   *
+   * @param info h5::array_interface::dataset_info of the dataset.
+   * @param v h5::array_interface::array_view to read into.
+   * @param xfer h5::transfer_options specifying the type conversion policy.
+   * @return True if the data has to be converted, false otherwise.
+   */
+  bool check_read_compatibility(dataset_info const &info, array_view const &v, transfer_options const &xfer = {});
+
   /**
    * @brief Read a given hyperslab from an HDF5 dataset into an array view.
    *
+   * @details If the datatype in memory differs from the datatype in the file, the data is converted according to the
+   * conversion policy of the given h5::transfer_options.
+   *
    * @param g h5::group which contains the dataset.
    * @param name Name of the dataset.
    * @param v h5::array_interface::array_view to read into.
    * @param sl h5::array_interface::hyperslab specifying the selection to read from.
+   * @param xfer h5::transfer_options specifying the data transfer mode and the type conversion policy.
+   */
+  void read(group g, std::string const &name, array_view v, hyperslab sl = {}, transfer_options const &xfer = {});
+
+  /**
+   * @brief Read a given hyperslab from an already opened HDF5 dataset into an array view.
+   *
+   * @details This avoids opening the dataset again, e.g. if the h5::array_interface::dataset_info of the dataset has
+   * already been retrieved with h5::array_interface::get_dataset_info(dataset).
+   *
+   * @param ds h5::dataset to read from.
+   * @param v h5::array_interface::array_view to read into.
+   * @param sl h5::array_interface::hyperslab specifying the selection to read from.
+   * @param xfer h5::transfer_options specifying the data transfer mode and the type conversion policy.
+   */
+  void read(dataset ds, array_view v, hyperslab sl = {}, transfer_options const &xfer = {});
+
+  /**
+   * @brief Write multiple array views to new HDF5 datasets in the same group.
+   *
+   * @details Each array view is written to a newly created dataset with the given name (see
+   * h5::array_interface::write). All datasets are created first and then written with a single call to
+   * `H5Dwrite_multi`. This reduces the overhead of writing many small datasets, especially with parallel HDF5. For
+   * HDF5 versions < 1.14, the datasets are written one after the other.
+   *
+   * @param g h5::group in which the datasets are created.
+   * @param items Pairs of dataset names and h5::array_interface::array_view objects to be written.
+   * @param opts h5::write_options used for all datasets.
+   * @param xfer h5::transfer_options specifying the data transfer mode.
+   */
+  void write_multi(group g, std::vector<std::pair<std::string, array_view>> const &items, write_options const &opts = {},
+                   transfer_options const &xfer = {});
+
+  /**
+   * @brief Read multiple HDF5 datasets in the same group into array views.
+   *
+   * @details All datasets are opened and checked first (see h5::array_interface::read) and then read with a single
+   * call to `H5Dread_multi`. For HDF5 versions < 1.14, the datasets are read one after the other.
+   *
+   * @param g h5::group containing the datasets.
+   * @param items Pairs of dataset names and h5::array_interface::array_view objects to read into.
+   * @param xfer h5::transfer_options specifying the data transfer mode.
+   */
+  void read_multi(group g, std::vector<std::pair<std::string, array_view>> const &items, transfer_options const &xfer = {});
+
+  /**
+   * @brief Get the shape of the dataspace of an HDF5 attribute.
+   *
+   * @param obj h5::object to which the attribute is attached.
+   * @param name Name of the attribute.
+   * @return Shape of the attribute (empty for scalar attributes).
    */
-  void read(group g, std::string const &name, array_view v, hyperslab sl = {});
+  [[nodiscard]] v_t get_attribute_shape(object obj, std::string const &name);
 
   /**
    * @brief Read from an HDF5 attribute into an array view.
    *
+   * @details The shape of the attribute has to match the shape of the hyperslab of the view and the datatypes have to
+   * be equal. Strided views are filled by scattering the data from a contiguous buffer.
+   *
    * @param obj h5::object to which the attribute is attached.
    * @param name Name of the attribute.
    * @param v h5::array_interface::array_view to read into.
@@ -0,0 +1,196 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Implementation details for async_writer.hpp.
+ */
+
+#include "./async_writer.hpp"
+#include "./threading.hpp"
+
+#include <hdf5.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace h5 {
+
+  namespace {
+
+    // Recursively copy the elements selected by the hyperslab of a view into a contiguous buffer.
+    void gather(array_interface::array_view const &v, std::vector<hsize_t> const &mem_strides, std::size_t elem_size, int d, std::byte const *src,
+                std::byte *&dst) {
+      auto const &sl = v.slab;
+
+      // views with arbitrary strides: copy every element
+      if (v.is_strided()) {
+        for (hsize_t c = 0; c < sl.count[d]; ++c) {
+          auto const *p = src + c * mem_strides[d] * elem_size;
+          if (d == v.rank() - 1) {
+            std::memcpy(dst, p, elem_size);
+            dst += elem_size;
+          } else {
+            gather(v, mem_strides, elem_size, d + 1, p, dst);
+          }
+        }
+        return;
+      }
+
+      hsize_t block    = (sl.block.empty() ? 1 : sl.block[d]);
+      auto const *base = src + sl.offset[d] * mem_strides[d] * elem_size;
+
+      // innermost dimension: copy each block (or the whole selection if the blocks are adjacent)
+      if (d == v.rank() - 1) {
+        if (sl.stride[d] == block) {
+          auto nbytes = sl.count[d] * block * elem_size;
+          std::memcpy(dst, base, nbytes);
+          dst += nbytes;
+        } else {
+          for (hsize_t c = 0; c < sl.count[d]; ++c) {
+            std::memcpy(dst, base + c * sl.stride[d] * elem_size, block * elem_size);
+            dst += block * elem_size;
+          }
+        }
+        return;
+      }
+
+      // outer dimensions: recurse into every selected index
+      for (hsize_t c = 0; c < sl.count[d]; ++c) {
+        for (hsize_t b = 0; b < block; ++b) gather(v, mem_strides, elem_size, d + 1, base + (c * sl.stride[d] + b) * mem_strides[d] * elem_size, dst);
+      }
+    }
+
+    // Copy the selected elements of a view into a staging buffer and create a contiguous view on the buffer.
+    std::pair<std::shared_ptr<std::vector<std::byte>>, array_interface::array_view> snapshot(array_interface::array_view const &v) {
+      auto elem_size = H5Tget_size(v.ty);
+      int rank       = v.rank();
+      auto buf       = std::make_shared<std::vector<std::byte>>((rank == 0 ? 1 : v.slab.size()) * elem_size);
+
+      // copy the data
+      if (rank == 0) {
+        std::memcpy(buf->data(), v.start, elem_size);
+      } else if (not buf->empty()) {
+        std::vector<hsize_t> mem_strides(rank, 1);
+        if (v.is_strided()) {
+          std::copy(v.mem_strides.begin(), v.mem_strides.end(), mem_strides.begin());
+        } else {
+          for (int i = rank - 2; i >= 0; --i) mem_strides[i] = mem_strides[i + 1] * v.parent_shape[i + 1];
+        }
+        auto *dst = buf->data();
+        gather(v, mem_strides, elem_size, 0, static_cast<std::byte const *>(v.start), dst);
+      }
+
+      // contiguous view on the staging buffer
+      array_interface::array_view staged{v.ty, buf->data(), rank - v.is_complex, v.is_complex};
+      staged.parent_shape = v.slab.shape();
+      staged.slab.count   = v.slab.shape();
+      return {std::move(buf), std::move(staged)};
+    }
+
+  } // namespace
+
+  async_writer::async_writer(group g) : g_(std::move(g)) {
+    if (is_library_threadsafe()) thread_ = std::thread([this]() { run(); });
+  }
+
+  async_writer::~async_writer() {
+    try {
+      flush();
+    } catch (...) {} // NOLINT (errors are discarded)
+    {
+      std::lock_guard lock(mtx_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+  }
+
+  std::shared_future<void> async_writer::write(std::string const &name, array_interface::array_view const &v, write_options const &opts) {
+    auto [buf, staged] = snapshot(v);
+    return submit([name, opts, buf = std::move(buf), staged = std::move(staged)](group g) { array_interface::write(g, name, staged, opts); });
+  }
+
+  std::shared_future<void> async_writer::submit(std::function<void(group)> op) {
+    // the exception is stored in the future and recorded for the next flush
+    std::packaged_task<void(group)> task([this, op = std::move(op)](group g) {
+      try {
+        op(std::move(g));
+      } catch (...) {
+        record_error(std::current_exception());
+        throw;
+      }
+    });
+    auto fut = task.get_future().share();
+
+    // perform the operation synchronously if there is no I/O thread
+    if (not is_async()) {
+      task(g_);
+      return fut;
+    }
+
+    // queue the operation
+    {
+      std::lock_guard lock(mtx_);
+      queue_.push_back(std::move(task));
+      ++pending_;
+    }
+    cv_.notify_one();
+    return fut;
+  }
+
+  void async_writer::flush() {
+    std::unique_lock lock(mtx_);
+    done_cv_.wait(lock, [this]() { return pending_ == 0; });
+    if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+
+  std::size_t async_writer::pending() const {
+    std::lock_guard lock(mtx_);
+    return pending_;
+  }
+
+  void async_writer::record_error(std::exception_ptr err) {
+    std::lock_guard lock(mtx_);
+    if (not error_) error_ = std::move(err);
+  }
+
+  void async_writer::run() {
+    while (true) {
+      // wait for the next operation
+      std::packaged_task<void(group)> task;
+      {
+        std::unique_lock lock(mtx_);
+        cv_.wait(lock, [this]() { return stop_ or not queue_.empty(); });
+        if (queue_.empty()) return;
+        task = std::move(queue_.front());
+        queue_.pop_front();
+      }
+
+      // execute it and notify waiting threads
+      task(g_);
+      {
+        std::lock_guard lock(mtx_);
+        --pending_;
+      }
+      done_cv_.notify_all();
+    }
+  }
+
+} // namespace h5
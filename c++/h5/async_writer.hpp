@@ -0,0 +1,190 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Provides an asynchronous writer which performs the HDF5 I/O on a dedicated thread.
+ */
+
+#ifndef LIBH5_ASYNC_WRITER_HPP
+#define LIBH5_ASYNC_WRITER_HPP
+
+#include "./array_interface.hpp"
+#include "./generic.hpp"
+#include "./group.hpp"
+#include "./macros.hpp"
+#include "./properties.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace h5 {
+
+  /**
+   * @addtogroup rw_async
+   * @{
+   */
+
+  /**
+   * @brief Write data to an HDF5 group on a dedicated I/O thread.
+   *
+   * @details The writer takes a snapshot of the data that is passed to one of its `write` methods and queues the
+   * actual HDF5 calls. The queued operations are performed in order on a background thread. The caller can continue
+   * to modify its data as soon as the `write` call returns, which allows the I/O to overlap with the computation,
+   * e.g. hiding the latency of a checkpoint behind the next iteration of a solver:
+   * - For an h5::array_interface::array_view, the selected elements are copied into a contiguous staging buffer.
+   * - For any other type, the object itself is copied and written with h5::write on the I/O thread.
+   *
+   * Each `write` returns a `std::shared_future` which becomes ready once the data has been written and which carries
+   * a possible exception. flush() blocks until all queued operations have been completed. The destructor flushes the
+   * writer as well.
+   *
+   * If the HDF5 library is not thread-safe (see `H5is_library_threadsafe`), no I/O thread is started and all
+   * operations are performed synchronously. Otherwise, HDF5 serializes all API calls with a global lock, i.e. calls
+   * from other threads are safe but block while the I/O thread is inside the library.
+   *
+   * @note Only the memory of fixed-size datatypes is copied into the staging buffers. Views of variable-length data
+   * still refer to the memory of the caller.
+   *
+   * @code{.cpp}
+   * h5::file f("checkpoint.h5", 'w');
+   * h5::async_writer writer(f);
+   * for (int i = 0; i < n_iter; ++i) {
+   *   compute(data);
+   *   writer.write("data_" + std::to_string(i), data);
+   * }
+   * writer.flush();
+   * @endcode
+   */
+  class async_writer {
+    public:
+    /**
+     * @brief Construct an asynchronous writer for the given group.
+     * @param g h5::group in which the datasets are created.
+     */
+    explicit async_writer(group g);
+
+    /// Deleted copy constructor.
+    async_writer(async_writer const &) = delete;
+
+    /// Deleted copy assignment operator.
+    async_writer &operator=(async_writer const &) = delete;
+
+    /// Destructor flushes the writer (errors are discarded) and stops the I/O thread.
+    ~async_writer();
+
+    /// Get the group in which the datasets are created.
+    [[nodiscard]] group const &get_group() const { return g_; }
+
+    /// Check whether the operations are performed on a background thread.
+    [[nodiscard]] bool is_async() const { return thread_.joinable(); }
+
+    /**
+     * @brief Queue a write of an array view to a new HDF5 dataset.
+     *
+     * @details The elements selected by the view are copied into a contiguous staging buffer before the function
+     * returns. The dataset is written with h5::array_interface::write.
+     *
+     * @param name Name of the dataset.
+     * @param v h5::array_interface::array_view to be written.
+     * @param opts h5::write_options specifying the chunking, the filter pipeline and the fill value settings.
+     * @return `std::shared_future` which is ready once the dataset has been written.
+     */
+    std::shared_future<void> write(std::string const &name, array_interface::array_view const &v, write_options const &opts = {});
+
+    /**
+     * @brief Queue a write of an arbitrary object with h5::write.
+     *
+     * @details The object is copied before the function returns.
+     *
+     * @tparam T Type of the object (has to be copy or move constructible).
+     * @param name Name of the dataset/subgroup.
+     * @param x Object to be written.
+     * @return `std::shared_future` which is ready once the object has been written.
+     */
+    template <typename T>
+    std::shared_future<void> write(std::string const &name, T const &x) {
+      return submit([name, x](group g) { h5::write(g, name, x); });
+    }
+
+    /**
+     * @brief Queue a write of an arbitrary object with h5::write by taking ownership of it.
+     *
+     * @tparam T Type of the object.
+     * @param name Name of the dataset/subgroup.
+     * @param x Object to be written (is moved from).
+     * @return `std::shared_future` which is ready once the object has been written.
+     */
+    template <typename T>
+    std::shared_future<void> write(std::string const &name, T &&x)
+      H5_REQUIRES(not std::is_lvalue_reference_v<T> and not std::is_same_v<std::decay_t<T>, array_interface::array_view>) {
+      return submit([name, x = std::move(x)](group g) { h5::write(g, name, x); });
+    }
+
+    /**
+     * @brief Queue an arbitrary operation on the group.
+     *
+     * @details The operation has to own all the data it accesses, since it is executed at some later point on the
+     * I/O thread.
+     *
+     * @param op Callable object taking an h5::group.
+     * @return `std::shared_future` which is ready once the operation has been executed.
+     */
+    std::shared_future<void> submit(std::function<void(group)> op);
+
+    /**
+     * @brief Block until all queued operations have been completed.
+     *
+     * @details It rethrows the first exception that occurred in an operation since the last call to flush().
+     */
+    void flush();
+
+    /// Get the number of queued operations which have not been completed yet.
+    [[nodiscard]] std::size_t pending() const;
+
+    private:
+    // Main loop of the I/O thread.
+    void run();
+
+    // Record an error unless an earlier one has not been reported yet.
+    void record_error(std::exception_ptr err);
+
+    private:
+    group g_;
+    std::deque<std::packaged_task<void(group)>> queue_;
+    std::size_t pending_ = 0;
+    std::exception_ptr error_;
+    bool stop_ = false;
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::condition_variable done_cv_;
+    std::thread thread_;
+  };
+
+  /** @} */
+
+} // namespace h5
+
+#endif // LIBH5_ASYNC_WRITER_HPP
@@ -0,0 +1,353 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Implementation details for chunk_io.hpp.
+ */
+
+#include "./chunk_io.hpp"
+#include "./stats.hpp"
+#include "./stl/string.hpp"
+#include "./threading.hpp"
+
+#include <hdf5.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace h5::array_interface {
+
+  namespace {
+
+    // Filters of a dataset which can be applied outside of HDF5.
+    struct chunk_pipeline {
+      bool shuffle      = false;
+      int deflate_level = -1;
+      int deflate_idx   = -1;
+    };
+
+    // Get the filter pipeline of a dataset (throws if it contains unsupported filters).
+    chunk_pipeline get_chunk_pipeline(proplist const &dcpl, char const *fname) {
+      chunk_pipeline res;
+      int n_filters = H5Pget_nfilters(dcpl);
+      for (int i = 0; i < n_filters; ++i) {
+        unsigned flags = 0, cd_values[8] = {};
+        std::size_t n_cd = 8;
+        auto id          = H5Pget_filter2(dcpl, static_cast<unsigned>(i), &flags, &n_cd, cd_values, 0, nullptr, nullptr);
+        if (id == H5Z_FILTER_SHUFFLE and res.deflate_idx < 0) {
+          res.shuffle = true;
+        } else if (id == H5Z_FILTER_DEFLATE and res.deflate_idx < 0) {
+          res.deflate_level = static_cast<int>(n_cd > 0 ? cd_values[0] : 6);
+          res.deflate_idx   = i;
+        } else {
+          throw std::runtime_error(std::string{"Error in h5::array_interface::"} + fname + ": Only the shuffle and deflate filters are supported");
+        }
+      }
+      return res;
+    }
+
+    // Check that a datatype has a fixed size.
+    void check_fixed_size(datatype const &ty, char const *fname) {
+      if (H5Tis_variable_str(ty) > 0 or H5Tdetect_class(ty, H5T_VLEN) > 0)
+        throw std::runtime_error(std::string{"Error in h5::array_interface::"} + fname + ": Variable-length datatypes are not supported");
+    }
+
+    // Geometry of the chunks of a dataset and of the view in memory.
+    struct chunk_layout {
+      v_t shape, chunk, n_chunks;
+      hsize_t total = 1;
+      std::size_t elem_size = 0;
+      std::size_t chunk_bytes = 0;
+      std::byte *mem = nullptr;
+
+      // memory offsets (in elements) of every index in every dimension
+      std::vector<std::vector<std::ptrdiff_t>> offsets;
+
+      // whether consecutive elements of the innermost dimension are adjacent in memory
+      bool contiguous_rows = true;
+
+      chunk_layout(array_view const &v, v_t shape_, v_t chunk_) : shape(std::move(shape_)), chunk(std::move(chunk_)), mem(static_cast<std::byte *>(v.start)) {
+        int rank = static_cast<int>(shape.size());
+        n_chunks.resize(rank);
+        for (int d = 0; d < rank; ++d) {
+          n_chunks[d] = (shape[d] + chunk[d] - 1) / chunk[d];
+          total *= n_chunks[d];
+        }
+        elem_size   = H5Tget_size(v.ty);
+        chunk_bytes = elem_size;
+        for (auto c : chunk) chunk_bytes *= c;
+
+        // offsets of the elements selected by the view
+        offsets.resize(rank);
+        std::ptrdiff_t pstride = 1;
+        for (int d = rank - 1; d >= 0; --d) {
+          auto &offs = offsets[d];
+          offs.resize(shape[d]);
+          hsize_t b = (v.slab.block.empty() ? 1 : v.slab.block[d]);
+          for (hsize_t j = 0; j < shape[d]; ++j) {
+            if (v.is_strided()) {
+              offs[j] = static_cast<std::ptrdiff_t>(j) * v.mem_strides[d];
+            } else {
+              offs[j] = static_cast<std::ptrdiff_t>(v.slab.offset[d] + (j / b) * v.slab.stride[d] + j % b) * pstride;
+            }
+          }
+          if (not v.is_strided()) pstride *= static_cast<std::ptrdiff_t>(v.parent_shape[d]);
+        }
+        auto const &last = offsets.back();
+        for (std::size_t j = 1; j < last.size(); ++j) contiguous_rows = contiguous_rows and last[j] == last[j - 1] + 1;
+      }
+
+      // offset of the chunk with the given linear index in the dataset
+      [[nodiscard]] v_t chunk_offset(hsize_t idx) const {
+        v_t res(shape.size());
+        for (int d = static_cast<int>(shape.size()) - 1; d >= 0; --d) {
+          res[d] = (idx % n_chunks[d]) * chunk[d];
+          idx /= n_chunks[d];
+        }
+        return res;
+      }
+
+      // copy the elements of a chunk from the view into a chunk buffer (to_chunk == true) or vice versa
+      void copy(v_t const &off, std::byte *buf, bool to_chunk) const {
+        int rank = static_cast<int>(shape.size());
+        v_t ext(rank), idx(rank, 0);
+        for (int d = 0; d < rank; ++d) ext[d] = std::min(chunk[d], shape[d] - off[d]);
+        while (true) {
+          // position of the current row in the chunk buffer and in memory
+          std::size_t pos       = 0;
+          std::ptrdiff_t mem_os = 0;
+          for (int d = 0; d < rank; ++d) {
+            pos = pos * chunk[d] + (d == rank - 1 ? 0 : idx[d]);
+            if (d < rank - 1) mem_os += offsets[d][off[d] + idx[d]];
+          }
+          auto const &last = offsets.back();
+          std::byte *row   = buf + pos * elem_size;
+          if (contiguous_rows) {
+            std::byte *src = mem + (mem_os + last[off.back()]) * static_cast<std::ptrdiff_t>(elem_size);
+            if (to_chunk) std::memcpy(row, src, ext.back() * elem_size);
+            else std::memcpy(src, row, ext.back() * elem_size);
+          } else {
+            for (hsize_t i = 0; i < ext.back(); ++i) {
+              std::byte *src = mem + (mem_os + last[off.back() + i]) * static_cast<std::ptrdiff_t>(elem_size);
+              if (to_chunk) std::memcpy(row + i * elem_size, src, elem_size);
+              else std::memcpy(src, row + i * elem_size, elem_size);
+            }
+          }
+
+          // next row
+          int d = rank - 2;
+          for (; d >= 0; --d) {
+            if (++idx[d] < ext[d]) break;
+            idx[d] = 0;
+          }
+          if (d < 0) return;
+        }
+      }
+    };
+
+    // Transpose the bytes of the elements (same as the HDF5 shuffle filter) or undo it.
+    void shuffle_bytes(std::byte const *src, std::byte *dst, std::size_t n_bytes, std::size_t elem_size, bool forward) {
+      std::size_t n = n_bytes / elem_size;
+      for (std::size_t e = 0; e < elem_size; ++e) {
+        for (std::size_t i = 0; i < n; ++i) {
+          if (forward) dst[e * n + i] = src[i * elem_size + e];
+          else dst[i * elem_size + e] = src[e * n + i];
+        }
+      }
+    }
+
+    // Call f(i) for every i in [0, n) on multiple threads and rethrow the first exception.
+    template <typename F>
+    void parallel_for(hsize_t n, int n_threads, F const &f) {
+      if (n_threads <= 0) n_threads = static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+      n_threads = static_cast<int>(std::min<hsize_t>(n_threads, n));
+
+      std::atomic<hsize_t> next = 0;
+      std::exception_ptr err;
+      std::mutex err_mtx;
+      auto worker = [&]() {
+        for (hsize_t i = next++; i < n; i = next++) {
+          try {
+            f(i);
+          } catch (...) {
+            std::lock_guard lock(err_mtx);
+            if (not err) err = std::current_exception();
+            next = n;
+          }
+        }
+      };
+
+      std::vector<std::thread> pool;
+      for (int t = 1; t < n_threads; ++t) pool.emplace_back(worker);
+      worker();
+      for (auto &t : pool) t.join();
+      if (err) std::rethrow_exception(err);
+    }
+
+  } // namespace
+
+  void write_chunks(group g, std::string const &name, array_view const &v, write_options opts, int n_threads) {
+    // store complex values with a complex datatype
+    if (v.is_complex and opts.complex_storage != write_options::complex_format::extra_dimension) {
+      write_chunks(g, name, to_complex_datatype(v, opts.complex_storage == write_options::complex_format::native), std::move(opts), n_threads);
+      return;
+    }
+    if (v.rank() == 0) throw std::runtime_error("Error in h5::array_interface::write_chunks: Rank of the array_view has to be > 0");
+    check_fixed_size(v.ty, "write_chunks");
+    H5_INSTRUMENT(instr, "array_interface::write_chunks", g, name);
+
+    // create the chunked dataset (chunks of about 1 MB by default)
+    if (opts.chunk_shape.empty() and opts.chunk_bytes == 0) opts.chunk_bytes = hsize_t{1} << 20;
+    auto shape            = v.slab.shape();
+    proplist dcpl         = make_dataset_create_proplist(opts, v.ty, shape, v.is_complex);
+    auto pipeline         = get_chunk_pipeline(dcpl, "write_chunks");
+    dataspace file_dspace = H5Screate_simple(v.rank(), shape.data(), nullptr);
+    g.unlink(name);
+    dataset ds = H5Dcreate2(g, name.c_str(), v.ty, file_dspace, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    if (!ds.is_valid())
+      throw std::runtime_error("Error in h5::array_interface::write_chunks: Creating the dataset " + name + " in the group " + g.name() + " failed");
+
+    // gather, filter and write the chunks in parallel
+    v_t chunk(v.rank());
+    H5Pget_chunk(dcpl, v.rank(), chunk.data());
+    chunk_layout layout{v, shape, chunk};
+    if (v.slab.size() > 0) {
+      parallel_for(layout.total, n_threads, [&](hsize_t idx) {
+        auto off = layout.chunk_offset(idx);
+        std::vector<std::byte> raw(layout.chunk_bytes), tmp;
+        layout.copy(off, raw.data(), true);
+        if (pipeline.shuffle and layout.elem_size > 1) {
+          tmp.resize(raw.size());
+          shuffle_bytes(raw.data(), tmp.data(), raw.size(), layout.elem_size, true);
+          std::swap(raw, tmp);
+        }
+
+        // compress the chunk (keep it uncompressed if it does not shrink)
+        std::uint32_t mask = 0;
+        if (pipeline.deflate_level >= 0) {
+          auto n_out = compressBound(static_cast<uLong>(raw.size()));
+          tmp.resize(n_out);
+          int zerr = compress2(reinterpret_cast<Bytef *>(tmp.data()), &n_out, reinterpret_cast<Bytef const *>(raw.data()),
+                               static_cast<uLong>(raw.size()), pipeline.deflate_level);
+          if (zerr != Z_OK) throw std::runtime_error("Error in h5::array_interface::write_chunks: Compressing a chunk failed");
+          if (n_out < raw.size()) {
+            tmp.resize(n_out);
+            std::swap(raw, tmp);
+          } else {
+            mask |= std::uint32_t{1} << pipeline.deflate_idx;
+          }
+        }
+
+        // write the chunk
+        library_lock lock;
+        if (H5Dwrite_chunk(ds, H5P_DEFAULT, mask, off.data(), raw.size(), raw.data()) < 0)
+          throw std::runtime_error("Error in h5::array_interface::write_chunks: Writing a chunk of the dataset " + name + " failed");
+      });
+      H5_INSTRUMENT_BYTES(instr, v.slab.size() * layout.elem_size);
+    }
+
+    // add complex attribute if the data is complex valued
+    if (v.is_complex) h5_write_attribute(ds, "__complex__", "1");
+  }
+
+  void read_chunks(group g, std::string const &name, array_view v, int n_threads) {
+    H5_INSTRUMENT(instr, "array_interface::read_chunks", g, name);
+    dataset ds = g.open_dataset(name);
+
+    // read complex values stored with a complex datatype
+    auto info    = get_dataset_info(ds);
+    auto file_ty = get_hdf5_type(ds);
+    if (info.has_complex_datatype and v.is_complex) v = to_complex_datatype(v, H5Tget_class(file_ty) != H5T_COMPOUND);
+
+    // check the layout, shape and datatype
+    proplist dcpl = H5Dget_create_plist(ds);
+    if (H5Pget_layout(dcpl) != H5D_CHUNKED) throw std::runtime_error("Error in h5::array_interface::read_chunks: Dataset " + name + " is not chunked");
+    dataspace file_dspace = H5Dget_space(ds);
+    int rank              = H5Sget_simple_extent_ndims(file_dspace);
+    v_t shape(rank);
+    H5Sget_simple_extent_dims(file_dspace, shape.data(), nullptr);
+    if (v.rank() != rank or v.slab.shape() != shape)
+      throw std::runtime_error("Error in h5::array_interface::read_chunks: Shape of the array_view != shape of the dataset " + name);
+    if (not hdf5_type_equal(v.ty, file_ty) or H5Tget_size(v.ty) != H5Tget_size(file_ty))
+      throw std::runtime_error("Error in h5::array_interface::read_chunks: Datatype of the array_view != datatype of the dataset " + name);
+    check_fixed_size(v.ty, "read_chunks");
+    auto pipeline = get_chunk_pipeline(dcpl, "read_chunks");
+
+    // fill value for chunks which have not been allocated
+    v_t chunk(rank);
+    H5Pget_chunk(dcpl, rank, chunk.data());
+    chunk_layout layout{v, shape, chunk};
+    std::vector<std::byte> fill(layout.elem_size);
+    if (H5Pget_fill_value(dcpl, v.ty, fill.data()) < 0) std::fill(fill.begin(), fill.end(), std::byte{0});
+
+    // read, filter and scatter the chunks in parallel
+    if (v.slab.size() == 0) return;
+    parallel_for(layout.total, n_threads, [&](hsize_t idx) {
+      auto off = layout.chunk_offset(idx);
+      std::vector<std::byte> raw, tmp;
+      std::uint32_t mask = 0;
+      {
+        library_lock lock;
+        hsize_t n_bytes = 0;
+        if (H5Dget_chunk_storage_size(ds, off.data(), &n_bytes) >= 0 and n_bytes > 0) {
+          raw.resize(n_bytes);
+          if (H5Dread_chunk(ds, H5P_DEFAULT, off.data(), &mask, raw.data()) < 0)
+            throw std::runtime_error("Error in h5::array_interface::read_chunks: Reading a chunk of the dataset " + name + " failed");
+        }
+      }
+
+      // unallocated chunk
+      if (raw.empty()) {
+        raw.resize(layout.chunk_bytes);
+        for (std::size_t i = 0; i < raw.size(); i += fill.size()) std::memcpy(raw.data() + i, fill.data(), fill.size());
+        layout.copy(off, raw.data(), false);
+        return;
+      }
+
+      // undo the filters which have been applied
+      if (pipeline.deflate_level >= 0 and (mask & (std::uint32_t{1} << pipeline.deflate_idx)) == 0) {
+        tmp.resize(layout.chunk_bytes);
+        auto n_out = static_cast<uLongf>(tmp.size());
+        int zerr   = uncompress(reinterpret_cast<Bytef *>(tmp.data()), &n_out, reinterpret_cast<Bytef const *>(raw.data()), static_cast<uLong>(raw.size()));
+        if (zerr != Z_OK or n_out != layout.chunk_bytes)
+          throw std::runtime_error("Error in h5::array_interface::read_chunks: Decompressing a chunk of the dataset " + name + " failed");
+        std::swap(raw, tmp);
+      }
+      if (raw.size() != layout.chunk_bytes)
+        throw std::runtime_error("Error in h5::array_interface::read_chunks: Unexpected size of a chunk of the dataset " + name);
+      if (pipeline.shuffle and layout.elem_size > 1 and (mask & 1U) == 0) {
+        tmp.resize(raw.size());
+        shuffle_bytes(raw.data(), tmp.data(), raw.size(), layout.elem_size, false);
+        std::swap(raw, tmp);
+      }
+      layout.copy(off, raw.data(), false);
+    });
+    H5_INSTRUMENT_BYTES(instr, v.slab.size() * layout.elem_size);
+  }
+
+} // namespace h5::array_interface
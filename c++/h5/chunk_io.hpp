@@ -0,0 +1,82 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Provides functions to read/write chunked datasets directly, i.e. by bypassing the HDF5 filter pipeline.
+ */
+
+#ifndef LIBH5_CHUNK_IO_HPP
+#define LIBH5_CHUNK_IO_HPP
+
+#include "./array_interface.hpp"
+#include "./group.hpp"
+#include "./properties.hpp"
+
+#include <string>
+
+namespace h5::array_interface {
+
+  /**
+   * @addtogroup rw_arrayinterface
+   * @{
+   */
+
+  /**
+   * @brief Write an array view to a new chunked HDF5 dataset by compressing the chunks on multiple threads.
+   *
+   * @details The dataset is created with the same layout as h5::array_interface::write would create for the given
+   * h5::write_options. If neither a chunk shape nor a target chunk size is specified, chunks of about 1 MB are used.
+   *
+   * The chunks are then gathered from the view, shuffled and compressed with zlib in parallel by `n_threads` worker
+   * threads and stored with `H5Dwrite_chunk`. The resulting dataset is indistinguishable from one written with
+   * h5::array_interface::write and can be read by any HDF5 application. Chunks which do not shrink when compressed are
+   * stored uncompressed (the deflate filter is marked as skipped for these chunks).
+   *
+   * Only the shuffle and the deflate filters are supported. The datatype must not contain variable-length data.
+   *
+   * If a link with the given name already exists, it is first unlinked.
+   *
+   * @param g h5::group in which the dataset is created.
+   * @param name Name of the dataset.
+   * @param v h5::array_interface::array_view to be written (rank > 0).
+   * @param opts h5::write_options specifying the chunking and the filter pipeline.
+   * @param n_threads Number of worker threads (defaults to `std::thread::hardware_concurrency` if <= 0).
+   */
+  void write_chunks(group g, std::string const &name, array_view const &v, write_options opts, int n_threads = 0);
+
+  /**
+   * @brief Read a chunked HDF5 dataset into an array view by decompressing the chunks on multiple threads.
+   *
+   * @details The raw chunks are fetched with `H5Dread_chunk` and decompressed, unshuffled and scattered into the view
+   * in parallel by `n_threads` worker threads. Chunks which have not been allocated are filled with the fill value of
+   * the dataset.
+   *
+   * The view has to have the same shape as the dataset and the same datatype (there are no type conversions). Only the
+   * shuffle and the deflate filters are supported.
+   *
+   * @param g h5::group containing the dataset.
+   * @param name Name of the dataset.
+   * @param v h5::array_interface::array_view to read into.
+   * @param n_threads Number of worker threads (defaults to `std::thread::hardware_concurrency` if <= 0).
+   */
+  void read_chunks(group g, std::string const &name, array_view v, int n_threads = 0);
+
+  /** @} */
+
+} // namespace h5::array_interface
+
+#endif // LIBH5_CHUNK_IO_HPP
@@ -0,0 +1,75 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Implementation details for compound.hpp.
+ */
+
+#include "./compound.hpp"
+
+#include <hdf5.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace h5 {
+
+  hid_t make_compound_type(std::size_t size, std::vector<compound_member> const &members) {
+    datatype cmpd = H5Tcreate(H5T_COMPOUND, size);
+    if (!cmpd.is_valid()) throw std::runtime_error("Error in h5::make_compound_type: Creating the compound datatype failed");
+
+    for (auto const &m : members) {
+      // complex members are stored as a compound with a real and an imaginary part
+      datatype ty = m.ty;
+      if (m.is_complex) {
+        auto elem_size = H5Tget_size(m.ty);
+        ty             = H5Tcreate(H5T_COMPOUND, 2 * elem_size);
+        if (H5Tinsert(ty, "r", 0, m.ty) < 0 or H5Tinsert(ty, "i", elem_size, m.ty) < 0)
+          throw std::runtime_error("Error in h5::make_compound_type: Creating the complex datatype of the member " + m.name + " failed");
+      }
+
+      // fixed size arrays
+      if (not m.dims.empty()) ty = H5Tarray_create2(ty, static_cast<unsigned>(m.dims.size()), m.dims.data());
+
+      if (ty < 0 or H5Tinsert(cmpd, m.name.c_str(), m.offset, ty) < 0)
+        throw std::runtime_error("Error in h5::make_compound_type: Inserting the member " + m.name + " failed");
+    }
+
+    // lock the datatype and release the ownership (it is never closed)
+    if (H5Tlock(cmpd) < 0) throw std::runtime_error("Error in h5::make_compound_type: Locking the compound datatype failed");
+    hid_t id = cmpd;
+    H5Iinc_ref(id);
+    return id;
+  }
+
+  std::vector<std::string> get_compound_member_names(datatype const &ty) {
+    std::vector<std::string> res;
+    if (H5Tget_class(ty) != H5T_COMPOUND) return res;
+    auto n = H5Tget_nmembers(ty);
+    if (n < 0) throw std::runtime_error("Error in h5::get_compound_member_names: Getting the number of members failed");
+    res.reserve(n);
+    for (unsigned i = 0; i < static_cast<unsigned>(n); ++i) {
+      char *name = H5Tget_member_name(ty, i);
+      if (name == nullptr) throw std::runtime_error("Error in h5::get_compound_member_names: Getting the name of a member failed");
+      res.emplace_back(name);
+      H5free_memory(name);
+    }
+    return res;
+  }
+
+} // namespace h5
@@ -0,0 +1,172 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Provides the H5_COMPOUND macro to map user defined structs to HDF5 compound datatypes.
+ */
+
+#ifndef LIBH5_COMPOUND_HPP
+#define LIBH5_COMPOUND_HPP
+
+#include "./complex.hpp"
+#include "./object.hpp"
+#include "./utils.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace h5 {
+
+  /**
+   * @addtogroup h5_types
+   * @{
+   */
+
+  /// Description of a single member of an HDF5 compound datatype.
+  struct compound_member {
+    /// Name of the member.
+    std::string name;
+
+    /// Offset of the member in bytes.
+    std::size_t offset;
+
+    /// h5::datatype of the member (of a single element if the member is an array).
+    datatype ty;
+
+    /// Whether the member is complex valued (it is stored as a compound with the fields "r" and "i").
+    bool is_complex = false;
+
+    /// Dimensions if the member is a fixed size array (empty otherwise).
+    v_t dims = {};
+  };
+
+  /**
+   * @brief Create a locked HDF5 compound datatype.
+   *
+   * @details The returned type is never closed. It is meant to be created once per C++ type (see H5_COMPOUND).
+   *
+   * @param size Size of the C++ type in bytes.
+   * @param members Members of the compound type.
+   * @return HDF5 ID of the compound datatype.
+   */
+  [[nodiscard]] hid_t make_compound_type(std::size_t size, std::vector<compound_member> const &members);
+
+  /**
+   * @brief Get the names of the members of an HDF5 compound datatype.
+   *
+   * @param ty h5::datatype.
+   * @return Names of the members in the order of their indices (empty if the datatype is not a compound datatype).
+   */
+  [[nodiscard]] std::vector<std::string> get_compound_member_names(datatype const &ty);
+
+  /**
+   * @brief Check if a type has been registered as an HDF5 compound datatype with H5_COMPOUND.
+   * @tparam T Type to check.
+   */
+  template <typename T>
+  constexpr bool is_compound_v = requires(T const *p) {
+    { h5_compound_type(p) } -> std::same_as<hid_t>;
+  };
+
+  namespace detail {
+
+    // Type trait to check if a type is a std::array.
+    template <typename T>
+    struct _is_std_array : std::false_type {};
+
+    template <typename T, std::size_t N>
+    struct _is_std_array<std::array<T, N>> : std::true_type {};
+
+    // Describe a member of type M of a compound datatype.
+    template <typename M>
+    compound_member make_compound_member(const char *name, std::size_t offset) {
+      if constexpr (std::is_array_v<M> or _is_std_array<M>::value) {
+        // fixed size arrays (the dimension of the outer array comes first)
+        using E = std::remove_cvref_t<decltype(std::declval<M &>()[0])>;
+        auto m  = make_compound_member<E>(name, offset);
+        m.dims.insert(m.dims.begin(), sizeof(M) / sizeof(E));
+        return m;
+      } else {
+        static_assert(std::is_arithmetic_v<M> or is_complex_v<M> or is_compound_v<M> or std::is_same_v<M, dcplx_t>,
+                      "Error in h5::H5_COMPOUND: Members have to be arithmetic, complex, compound types or fixed size arrays of them");
+        return {name, offset, hdf5_type<M>(), is_complex_v<M>};
+      }
+    }
+
+  } // namespace detail
+
+  /** @} */
+
+} // namespace h5
+
+// ---------------- Compound datatypes ----------------
+
+// Apply a macro to every argument (up to 256 arguments).
+#define H5_PARENS ()
+#define H5_EXPAND(...) H5_EXPAND4(H5_EXPAND4(H5_EXPAND4(H5_EXPAND4(__VA_ARGS__))))
+#define H5_EXPAND4(...) H5_EXPAND3(H5_EXPAND3(H5_EXPAND3(H5_EXPAND3(__VA_ARGS__))))
+#define H5_EXPAND3(...) H5_EXPAND2(H5_EXPAND2(H5_EXPAND2(H5_EXPAND2(__VA_ARGS__))))
+#define H5_EXPAND2(...) H5_EXPAND1(H5_EXPAND1(H5_EXPAND1(H5_EXPAND1(__VA_ARGS__))))
+#define H5_EXPAND1(...) __VA_ARGS__
+#define H5_FOR_EACH(MACRO, T, ...) __VA_OPT__(H5_EXPAND(H5_FOR_EACH_HELPER(MACRO, T, __VA_ARGS__)))
+#define H5_FOR_EACH_HELPER(MACRO, T, A1, ...) MACRO(T, A1) __VA_OPT__(H5_FOR_EACH_AGAIN H5_PARENS(MACRO, T, __VA_ARGS__))
+#define H5_FOR_EACH_AGAIN() H5_FOR_EACH_HELPER
+
+// Describe a single member of a compound datatype.
+#define H5_COMPOUND_MEMBER(T, M) ::h5::detail::make_compound_member<decltype(T::M)>(#M, offsetof(T, M)),
+
+/**
+ * @ingroup h5_types
+ * @brief Register a struct as an HDF5 compound datatype.
+ *
+ * @details The macro has to be used in the namespace of the struct. It defines the function
+ * `h5_compound_type(T const *)` which is found by ADL and which creates the compound datatype the first time it is
+ * called. The struct has to be standard layout and its members have to be arithmetic, complex, other registered
+ * compound types or fixed size arrays of them.
+ *
+ * Afterwards, h5::hdf5_type returns the compound datatype and scalars, `std::vector` and `std::array` objects of the
+ * struct are read/written with a single `H5Dread`/`H5Dwrite` call:
+ *
+ * @code{.cpp}
+ * struct particle {
+ *   double x, y, z;
+ *   float weight;
+ * };
+ * H5_COMPOUND(particle, x, y, z, weight);
+ *
+ * std::vector<particle> events(1000000);
+ * h5::write(file, "events", events); // 1d dataset of compound type
+ * @endcode
+ *
+ * When reading, HDF5 matches the members by name, i.e. the order of the members in the file and in memory can differ.
+ *
+ * @param T Struct type.
+ * @param ... Names of the members to be stored.
+ */
+#define H5_COMPOUND(T, ...)                                                                                                                          \
+  [[maybe_unused]] inline ::h5::hid_t h5_compound_type(T const *) {                                                                                  \
+    static ::h5::hid_t const dt = ::h5::make_compound_type(sizeof(T), {H5_FOR_EACH(H5_COMPOUND_MEMBER, T, __VA_ARGS__)});                           \
+    return dt;                                                                                                                                       \
+  }                                                                                                                                                  \
+  static_assert(std::is_standard_layout_v<T>, "Error in h5::H5_COMPOUND: Type has to be standard layout")
+
+#endif // LIBH5_COMPOUND_HPP
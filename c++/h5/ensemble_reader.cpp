@@ -0,0 +1,204 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+
+/**
+ * @file
+ * @brief Implementation details for ensemble_reader.hpp.
+ */
+
+#include "./ensemble_reader.hpp"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace h5::detail {
+
+  namespace {
+
+    // Header of a message sent from a worker process to the calling process.
+    struct message_header {
+      std::uint64_t index;
+      std::uint64_t failed;
+      std::uint64_t size;
+    };
+
+    // Write all bytes to a file descriptor.
+    bool write_all(int fd, void const *data, std::size_t size) {
+      auto const *p = static_cast<char const *>(data);
+      while (size > 0) {
+        auto n = ::write(fd, p, size);
+        if (n < 0 and errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<std::size_t>(n);
+      }
+      return true;
+    }
+
+    // Read exactly the given number of bytes from a file descriptor (false on EOF or error).
+    bool read_all(int fd, void *data, std::size_t size) {
+      auto *p = static_cast<char *>(data);
+      while (size > 0) {
+        auto n = ::read(fd, p, size);
+        if (n < 0 and errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<std::size_t>(n);
+      }
+      return true;
+    }
+
+    // Main loop of a worker process: handle every n_workers-th task and send the results through the pipe.
+    [[noreturn]] void run_worker_process(int fd, std::size_t first, std::size_t n, int n_workers,
+                                         std::function<std::vector<std::byte>(std::size_t)> const &f) {
+      for (std::size_t i = first; i < n; i += n_workers) {
+        std::vector<std::byte> bytes;
+        std::string error;
+        bool failed = true;
+        try {
+          bytes  = f(i);
+          failed = false;
+        } catch (std::exception const &e) { error = e.what(); } catch (...) {}
+        if (failed and error.empty()) error = "Error in h5::ensemble_reader::read: Unknown exception in a worker process";
+        message_header hdr{i, failed, (failed ? error.size() : bytes.size())};
+        if (not write_all(fd, &hdr, sizeof(hdr)) or not write_all(fd, (failed ? static_cast<void const *>(error.data()) : bytes.data()), hdr.size))
+          ::_exit(1);
+        if (failed) break;
+      }
+      ::close(fd);
+      ::_exit(0);
+    }
+
+  } // namespace
+
+  std::pair<ensemble_options::execution, int> resolve_ensemble_options(ensemble_options const &opts, std::size_t n) {
+    using exec    = ensemble_options::execution;
+    int n_workers = (opts.n_workers > 0 ? opts.n_workers : static_cast<int>(std::max(1U, std::thread::hardware_concurrency())));
+    n_workers     = static_cast<int>(std::min<std::size_t>(n_workers, std::max<std::size_t>(n, 1)));
+    auto mode     = opts.mode;
+    if (mode == exec::automatic) mode = (is_library_threadsafe() ? exec::threads : exec::processes);
+    if (mode == exec::serial or n_workers == 1) return {exec::serial, 1};
+    return {mode, n_workers};
+  }
+
+  void ensemble_for_threads(std::size_t n, int n_workers, std::function<void(std::size_t)> const &f) {
+    std::atomic<std::size_t> next = 0;
+    std::exception_ptr err;
+    std::mutex err_mtx;
+    auto worker = [&]() {
+      for (std::size_t i = next++; i < n; i = next++) {
+        try {
+          f(i);
+        } catch (...) {
+          std::lock_guard lock(err_mtx);
+          if (not err) err = std::current_exception();
+          next = n;
+        }
+      }
+    };
+
+    // the calling thread is one of the workers
+    std::vector<std::thread> pool;
+    for (int t = 1; t < n_workers; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool) t.join();
+    if (err) std::rethrow_exception(err);
+  }
+
+  std::vector<std::vector<std::byte>> ensemble_for_processes(std::size_t n, int n_workers, std::function<std::vector<std::byte>(std::size_t)> const &f) {
+    // start the worker processes, each with its own pipe
+    std::vector<pid_t> pids;
+    std::vector<int> fds;
+    for (int w = 0; w < n_workers; ++w) {
+      int p[2];
+      pid_t pid = -1;
+      if (::pipe(p) == 0) {
+        pid = ::fork();
+        if (pid < 0) {
+          ::close(p[0]);
+          ::close(p[1]);
+        }
+      }
+      if (pid < 0) {
+        for (int fd : fds) ::close(fd);
+        for (auto id : pids) ::waitpid(id, nullptr, 0);
+        throw std::runtime_error("Error in h5::ensemble_reader::read: Starting a worker process failed");
+      }
+      if (pid == 0) {
+        for (int fd : fds) ::close(fd);
+        ::close(p[0]);
+        run_worker_process(p[1], w, n, n_workers, f);
+      }
+      ::close(p[1]);
+      pids.push_back(pid);
+      fds.push_back(p[0]);
+    }
+
+    // drain the pipes concurrently (a full pipe would block its worker)
+    std::vector<std::vector<std::byte>> res(n);
+    std::vector<char> received(n, 0);
+    std::vector<std::string> errors(n);
+    auto drain = [&](int fd) {
+      message_header hdr{};
+      while (read_all(fd, &hdr, sizeof(hdr))) {
+        if (hdr.index >= n) break;
+        if (hdr.failed != 0) {
+          errors[hdr.index].resize(hdr.size, ' ');
+          if (not read_all(fd, errors[hdr.index].data(), hdr.size)) break;
+        } else {
+          res[hdr.index].resize(hdr.size);
+          if (not read_all(fd, res[hdr.index].data(), hdr.size)) break;
+        }
+        received[hdr.index] = 1;
+      }
+      ::close(fd);
+    };
+    std::vector<std::thread> readers;
+    for (std::size_t w = 1; w < fds.size(); ++w) readers.emplace_back(drain, fds[w]);
+    drain(fds[0]);
+    for (auto &t : readers) t.join();
+
+    // wait for the workers and report the first error
+    bool crashed = false;
+    for (auto id : pids) {
+      int status = 0;
+      while (::waitpid(id, &status, 0) < 0 and errno == EINTR) {}
+      crashed = crashed or not WIFEXITED(status) or WEXITSTATUS(status) != 0;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      if (not errors[i].empty()) throw std::runtime_error(errors[i]);
+      if (received[i] == 0)
+        throw std::runtime_error("Error in h5::ensemble_reader::read: No result received for the file with index " + std::to_string(i)
+                                 + (crashed ? " (a worker process terminated unexpectedly)" : ""));
+    }
+    return res;
+  }
+
+} // namespace h5::detail
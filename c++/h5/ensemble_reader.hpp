@@ -0,0 +1,210 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+
+/**
+ * @file
+ * @brief Provides a reader which reads the same object from many HDF5 files with a pool of workers.
+ */
+
+#ifndef LIBH5_ENSEMBLE_READER_HPP
+#define LIBH5_ENSEMBLE_READER_HPP
+
+#include "./file.hpp"
+#include "./generic.hpp"
+#include "./serialization.hpp"
+#include "./threading.hpp"
+#include "./utils.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace h5 {
+
+  /**
+   * @addtogroup threading
+   * @{
+   */
+
+  /// Options for an h5::ensemble_reader.
+  struct ensemble_options {
+    /// How the files are distributed over the workers.
+    enum class execution {
+      automatic, ///< Threads if the HDF5 library is thread-safe, processes otherwise.
+      serial,    ///< Read all files on the calling thread.
+      threads,   ///< Read the files on a pool of threads.
+      processes  ///< Read the files in forked worker processes.
+    };
+
+    /// Execution mode.
+    execution mode = execution::automatic;
+
+    /// Number of workers (defaults to `std::thread::hardware_concurrency` if <= 0).
+    int n_workers = 0;
+  };
+
+  namespace detail {
+
+    // Get the execution mode and the number of workers which are actually used for n files.
+    std::pair<ensemble_options::execution, int> resolve_ensemble_options(ensemble_options const &opts, std::size_t n);
+
+    // Call f(i) for every i in [0, n) on a pool of threads and rethrow the first exception.
+    void ensemble_for_threads(std::size_t n, int n_workers, std::function<void(std::size_t)> const &f);
+
+    // Call f(i) for every i in [0, n) in forked worker processes and return the byte buffers in input order.
+    std::vector<std::vector<std::byte>> ensemble_for_processes(std::size_t n, int n_workers, std::function<std::vector<std::byte>(std::size_t)> const &f);
+
+    // Check if a type is an std::vector.
+    template <typename T>
+    constexpr bool is_std_vector_v = false;
+
+    template <typename T, typename A>
+    constexpr bool is_std_vector_v<std::vector<T, A>> = true;
+
+  } // namespace detail
+
+  /**
+   * @brief Read the same dataset/subgroup from many HDF5 files with a pool of workers.
+   *
+   * @details Parameter sweeps and ensemble runs often produce a large number of small files which all contain an
+   * object at the same path. The reader opens the files in read-only mode and reads the object with h5::read, using
+   * `n_workers` workers. The results are returned in the order of the given files:
+   *
+   * @code{.cpp}
+   * std::vector<std::string> files = {"run_0.h5", "run_1.h5", "run_2.h5"};
+   * h5::ensemble_reader<std::vector<double>> reader(files, "results/energy");
+   * auto energies = reader.read();                 // one std::vector<double> per file
+   * auto [shape, data] = reader.read_stacked();    // shape = {3, n}, data in C-order
+   * @endcode
+   *
+   * Even if the HDF5 library is thread-safe, it serializes all API calls with a global lock. With threads, only the
+   * work outside of the library overlaps, e.g. the conversion into `T`. Forked worker processes have their own copy of
+   * the library and scale with the number of cores. Each worker process reads every n-th file, serializes the result
+   * (see h5::serialize) and sends it to the calling process through a pipe, where it is deserialized again. `T` then
+   * also has to be writable. Worker processes must not be started while other threads of the calling process are
+   * inside the HDF5 library.
+   *
+   * If a file cannot be read, an exception with the name of the file is thrown after the workers have finished.
+   *
+   * @tparam T Type of the objects (has to be default constructible and readable with h5::read).
+   */
+  template <typename T>
+  class ensemble_reader {
+    public:
+    /// Result of read_stacked(): the objects of all files stacked along a new leading dimension.
+    struct stacked {
+      /// Shape of the stacked array (number of files and size of a single object).
+      v_t shape;
+
+      /// Elements of the stacked array in C-order.
+      std::vector<typename T::value_type> data;
+    };
+
+    /**
+     * @brief Construct a reader for an object in the given files.
+     *
+     * @param files Names of the HDF5 files.
+     * @param path Path of the dataset/subgroup in each of the files.
+     * @param opts h5::ensemble_options.
+     */
+    ensemble_reader(std::vector<std::string> files, std::string path, ensemble_options opts = {})
+       : files_(std::move(files)), path_(std::move(path)), opts_(opts) {}
+
+    /// Get the number of files.
+    [[nodiscard]] std::size_t size() const { return files_.size(); }
+
+    /// Get the names of the files.
+    [[nodiscard]] std::vector<std::string> const &files() const { return files_; }
+
+    /// Get the path of the object in each file.
+    [[nodiscard]] std::string const &path() const { return path_; }
+
+    /// Get the execution mode which is used by read() (never ensemble_options::execution::automatic).
+    [[nodiscard]] ensemble_options::execution mode() const { return detail::resolve_ensemble_options(opts_, files_.size()).first; }
+
+    /**
+     * @brief Read the object from all files.
+     * @return `std::vector` containing the objects in the order of the files.
+     */
+    [[nodiscard]] std::vector<T> read() const {
+      auto [mode, n_workers] = detail::resolve_ensemble_options(opts_, files_.size());
+      std::vector<T> res(files_.size());
+      if (mode == ensemble_options::execution::processes) {
+        auto bufs = detail::ensemble_for_processes(files_.size(), n_workers, [this](std::size_t i) {
+          T x{};
+          read_one(i, x);
+          return serialize(x);
+        });
+        for (std::size_t i = 0; i < bufs.size(); ++i) res[i] = deserialize<T>(bufs[i]);
+      } else {
+        detail::ensemble_for_threads(files_.size(), n_workers, [this, &res](std::size_t i) {
+          library_lock lock;
+          read_one(i, res[i]);
+        });
+      }
+      return res;
+    }
+
+    /**
+     * @brief Read the object from all files and stack them into a single array.
+     *
+     * @details All objects have to have the same size.
+     *
+     * @return Stacked array of shape `{size(), n}`, where `n` is the size of a single object.
+     */
+    [[nodiscard]] stacked read_stacked() const
+      requires(detail::is_std_vector_v<T>)
+    {
+      auto objs = read();
+      stacked res{{objs.size(), (objs.empty() ? 0 : objs[0].size())}, {}};
+      res.data.reserve(res.shape[0] * res.shape[1]);
+      for (std::size_t i = 0; i < objs.size(); ++i) {
+        if (objs[i].size() != res.shape[1])
+          throw std::runtime_error("Error in h5::ensemble_reader::read_stacked: Size of " + path_ + " in " + files_[i]
+                                   + " differs from the size in " + files_[0]);
+        res.data.insert(res.data.end(), objs[i].begin(), objs[i].end());
+      }
+      return res;
+    }
+
+    private:
+    // Read the object from the i-th file.
+    void read_one(std::size_t i, T &x) const {
+      try {
+        file f{files_[i], 'r'};
+        h5::read(f, path_, x);
+      } catch (std::exception const &e) {
+        throw std::runtime_error("Error in h5::ensemble_reader::read: Reading " + path_ + " from " + files_[i] + " failed: " + e.what());
+      }
+    }
+
+    private:
+    std::vector<std::string> files_;
+    std::string path_;
+    ensemble_options opts_;
+  };
+
+  /** @} */
+
+} // namespace h5
+
+#endif // LIBH5_ENSEMBLE_READER_HPP
@@ -20,11 +20,18 @@
  */
 
 #include "./file.hpp"
+#include "./stats.hpp"
 
 #include <hdf5.h>
 #include <hdf5_hl.h>
 
+#include <atomic>
+#include <cstring>
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
 
 using namespace std::string_literals;
 
@@ -34,39 +41,227 @@ using namespace std::string_literals;
 
 namespace h5 {
 
-  file::file(const char *name, char mode) {
-    switch (mode) {
-      // open existing file in read only mode
-      case 'r': id = H5Fopen(name, H5F_ACC_RDONLY, H5P_DEFAULT); break;
-      // create new or overwrite existing file in read-write mode
-      case 'w': id = H5Fcreate(name, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT); break;
-      // create new or append to exisiting file in read-write mode
-      case 'a': {
-        // turn off error handling
-        herr_t (*old_func)(void *) = nullptr;
-        void *old_client_data      = nullptr;
-        H5Eget_auto1(&old_func, &old_client_data);
-        H5Eset_auto1(nullptr, nullptr);
-
-        // this may fail
-        id = H5Fcreate(name, H5F_ACC_EXCL, H5P_DEFAULT, H5P_DEFAULT);
-
-        // turn on error handling
-        H5Eset_auto1(old_func, old_client_data);
-
-        // open in read-write mode if creation failed
-        if (id < 0) id = H5Fopen(name, H5F_ACC_RDWR, H5P_DEFAULT);
-        break;
+  namespace {
+
+    // Reference counted user data of the file image callbacks used for buffered memory files which do not copy their
+    // initial file image.
+    //
+    // The image is either owned (stored in `buf` and resized if the file grows) or an external buffer with a fixed
+    // capacity (which is zero for read-only views). If the file outgrows the capacity of an external buffer, the image
+    // is moved to an owned buffer (instead of letting the write operation fail). All images handed out to the
+    // property lists and to the core driver are aliases of the same buffer. Allocations therefore return the buffer
+    // itself and copies into the buffer are no-ops. Property lists hold a reference via udata_copy/udata_free. The core
+    // driver does not copy the user data, so opening the file image acquires a reference which is released when the
+    // file is closed.
+    struct file_image {
+      std::vector<std::byte> buf = {};
+      std::byte *data            = nullptr;
+      std::size_t size           = 0;
+      std::size_t capacity       = 0;
+      bool owned                 = false;
+      int ref_count              = 1;
+    };
+
+    // Resize the file image (moves the image to an owned buffer if it exceeds the capacity of an external buffer).
+    void resize_file_image(file_image *img, std::size_t size) {
+      if (not img->owned and size > img->capacity) {
+        img->buf.assign(img->data, img->data + img->size);
+        img->owned = true;
+      }
+      if (img->owned) {
+        img->buf.resize(size);
+        img->data = img->buf.data();
       }
-      // create new file in read-write mode if the file does not exist yet
-      case 'e': id = H5Fcreate(name, H5F_ACC_EXCL, H5P_DEFAULT, H5P_DEFAULT); break;
-      default: throw std::runtime_error("File mode is not one of r, w, a, e");
+      img->size = size;
     }
 
-    // throw an exception if opening/creating the file failed
-    if (id < 0) throw std::runtime_error("Opening/Creating the file "s + name + " failed");
+    // Get a unique name for a buffered memory file (the core driver identifies open files by their names).
+    std::string memory_file_name() {
+      static std::atomic<long> counter{0};
+      return "MemoryBuffer" + std::to_string(counter++);
+    }
+
+  } // namespace
+
+  // File image callbacks passed to HDF5 (C language linkage, but internal to this translation unit).
+  extern "C" {
+
+  static void *file_image_malloc(size_t size, H5FD_file_image_op_t op, void *udata) {
+    auto *img = static_cast<file_image *>(udata);
+    if (size > img->size) {
+      if (img->capacity == 0) return nullptr;
+      resize_file_image(img, size);
+    }
+    if (op == H5FD_FILE_IMAGE_OP_FILE_OPEN) ++img->ref_count;
+    return img->data;
+  }
+
+  static void *file_image_memcpy(void *dest, const void *src, size_t size, H5FD_file_image_op_t, void *udata) {
+    if (dest != static_cast<file_image *>(udata)->data) std::memcpy(dest, src, size);
+    return dest;
+  }
+
+  static void *file_image_realloc(void *ptr, size_t size, H5FD_file_image_op_t, void *udata) {
+    auto *img = static_cast<file_image *>(udata);
+    if (ptr != img->data or (not img->owned and img->capacity == 0)) return nullptr;
+    resize_file_image(img, size);
+    return img->data;
+  }
+
+  static void *file_image_udata_copy(void *udata) {
+    ++static_cast<file_image *>(udata)->ref_count;
+    return udata;
+  }
+
+  static herr_t file_image_udata_free(void *udata) {
+    auto *img = static_cast<file_image *>(udata);
+    if (--img->ref_count == 0) delete img;
+    return 0;
+  }
+
+  static herr_t file_image_free(void *, H5FD_file_image_op_t op, void *udata) {
+    if (op == H5FD_FILE_IMAGE_OP_FILE_CLOSE) return file_image_udata_free(udata);
+    return 0;
+  }
+
+  } // extern "C"
+
+  namespace {
+
+    // Open a buffered memory file which uses the given file image without copying it (steals the initial reference).
+    hid_t open_file_image(file_image *img, unsigned flags, std::size_t increment = 64 * 1024) {
+      H5FD_file_image_callbacks_t callbacks{file_image_malloc, file_image_memcpy,     file_image_realloc,
+                                            file_image_free,   file_image_udata_copy, file_image_udata_free,
+                                            img};
+
+      // create a file access property list which uses the `H5FD_CORE` driver and the file image callbacks
+      proplist fapl = H5Pcreate(H5P_FILE_ACCESS);
+      herr_t err    = (fapl.is_valid() ? H5Pset_fapl_core(fapl, increment, false) : -1);
+      if (err >= 0) err = H5Pset_file_image_callbacks(fapl, &callbacks);
+
+      // release the initial reference (the property list holds its own reference)
+      auto *data = img->data;
+      auto size  = img->size;
+      file_image_udata_free(img);
+      CHECK_OR_THROW((err >= 0), "Setting the core file driver and the file image callbacks in fapl failed");
+
+      // set the initial file image
+      err = H5Pset_file_image(fapl, data, size);
+      CHECK_OR_THROW((err >= 0), "Setting the file image to a given memory buffer failed");
+
+      // open the buffered memory file
+      return H5Fopen(memory_file_name().c_str(), flags, fapl);
+    }
+
+    // Get the file image of an empty HDF5 file.
+    std::vector<std::byte> const &empty_file_image() {
+      static auto const image = file{}.as_buffer();
+      return image;
+    }
+
+
+    // Set the file driver of a file on disk in the given file access property list.
+    void set_file_driver(hid_t fapl, file_options const &opts, char mode) {
+      herr_t err = 0;
+      if (auto const *split = std::get_if<split_driver>(&opts.driver)) {
+        err = H5Pset_fapl_split(fapl, split->meta_ext.c_str(), H5P_DEFAULT, split->raw_ext.c_str(), H5P_DEFAULT);
+      } else if (auto const *direct = std::get_if<direct_driver>(&opts.driver)) {
+#ifdef H5_HAVE_DIRECT
+        err = H5Pset_fapl_direct(fapl, direct->mem_alignment, direct->block_size, direct->cbuf_size);
+        // align large objects to the file system blocks unless the user has chosen an alignment
+        if (err >= 0 and opts.alignment <= 1 and direct->alignment > 1) err = H5Pset_alignment(fapl, direct->alignment, direct->alignment);
+#else
+        (void)direct;
+        CHECK_OR_THROW(false, "The HDF5 library has been built without support for the direct I/O file driver");
+#endif
+      } else if (auto const *ros3 = std::get_if<ros3_driver>(&opts.driver)) {
+#ifdef H5_HAVE_ROS3_VFD
+        CHECK_OR_THROW((mode == 'r'), "Files opened with the ROS3 driver are read-only");
+        H5FD_ros3_fapl_t fa{};
+        fa.version      = H5FD_CURR_ROS3_FAPL_T_VERSION;
+        fa.authenticate = static_cast<hbool_t>(not ros3->key_id.empty());
+        CHECK_OR_THROW((ros3->aws_region.size() <= H5FD_ROS3_MAX_REGION_LEN and ros3->key_id.size() <= H5FD_ROS3_MAX_SECRET_ID_LEN
+                        and ros3->secret_key.size() <= H5FD_ROS3_MAX_SECRET_KEY_LEN),
+                       "ROS3 credentials are too long");
+        std::strncpy(fa.aws_region, ros3->aws_region.c_str(), H5FD_ROS3_MAX_REGION_LEN);
+        std::strncpy(fa.secret_id, ros3->key_id.c_str(), H5FD_ROS3_MAX_SECRET_ID_LEN);
+        std::strncpy(fa.secret_key, ros3->secret_key.c_str(), H5FD_ROS3_MAX_SECRET_KEY_LEN);
+        err = H5Pset_fapl_ros3(fapl, &fa);
+#else
+        (void)ros3;
+        (void)mode;
+        CHECK_OR_THROW(false, "The HDF5 library has been built without support for the ROS3 file driver");
+#endif
+      }
+      CHECK_OR_THROW((err >= 0), "Setting the file driver in fapl failed");
+    }
+
+    // Open an existing file or create a new file in the given mode with the given file access and creation property lists.
+    hid_t open_or_create(const char *name, char mode, hid_t fapl, hid_t fcpl, bool swmr) {
+      unsigned const swmr_read  = (swmr ? H5F_ACC_SWMR_READ : 0);
+      unsigned const swmr_write = (swmr ? H5F_ACC_SWMR_WRITE : 0);
+      hid_t id                  = -1;
+      switch (mode) {
+        // open existing file in read only mode
+        case 'r': id = H5Fopen(name, H5F_ACC_RDONLY | swmr_read, fapl); break;
+        // create new or overwrite existing file in read-write mode
+        case 'w': id = H5Fcreate(name, H5F_ACC_TRUNC | swmr_write, fcpl, fapl); break;
+        // create new or append to exisiting file in read-write mode
+        case 'a': {
+          // turn off error handling
+          herr_t (*old_func)(void *) = nullptr;
+          void *old_client_data      = nullptr;
+          H5Eget_auto1(&old_func, &old_client_data);
+          H5Eset_auto1(nullptr, nullptr);
+
+          // this may fail
+          id = H5Fcreate(name, H5F_ACC_EXCL | swmr_write, fcpl, fapl);
+
+          // turn on error handling
+          H5Eset_auto1(old_func, old_client_data);
+
+          // open in read-write mode if creation failed
+          if (id < 0) id = H5Fopen(name, H5F_ACC_RDWR | swmr_write, fapl);
+          break;
+        }
+        // create new file in read-write mode if the file does not exist yet
+        case 'e': id = H5Fcreate(name, H5F_ACC_EXCL | swmr_write, fcpl, fapl); break;
+        default: throw std::runtime_error("File mode is not one of r, w, a, e");
+      }
+
+      // throw an exception if opening/creating the file failed
+      if (id < 0) throw std::runtime_error("Opening/Creating the file "s + name + " failed");
+      return id;
+    }
+
+  } // namespace
+
+  file::file(const char *name, char mode, file_options const &opts)
+     : overwrite_in_place_(opts.overwrite_in_place), swmr_read_(opts.swmr and mode == 'r') {
+    H5_INSTRUMENT(instr, "file::open", name);
+
+    // create the file access and file creation property lists
+    proplist fapl = make_file_access_proplist(opts);
+    proplist fcpl = make_file_create_proplist(opts);
+    set_file_driver(fapl, opts, mode);
+    id = open_or_create(name, mode, fapl, fcpl, opts.swmr);
   }
 
+#ifdef H5_MPI_SUPPORT
+  file::file(const char *name, char mode, MPI_Comm comm, MPI_Info info, file_options const &opts) : overwrite_in_place_(opts.overwrite_in_place) {
+    H5_INSTRUMENT(instr, "file::open", name);
+
+    // create the file access property list and set the MPI-IO file driver
+    CHECK_OR_THROW((std::holds_alternative<std::monostate>(opts.driver)), "Parallel files always use the MPI-IO file driver");
+    CHECK_OR_THROW((not opts.swmr), "SWMR is not supported with the MPI-IO file driver");
+    proplist fapl = make_file_access_proplist(opts);
+    proplist fcpl = make_file_create_proplist(opts);
+    auto err      = H5Pset_fapl_mpio(fapl, comm, info);
+    CHECK_OR_THROW((err >= 0), "Setting the MPI-IO file driver in fapl failed");
+    id = open_or_create(name, mode, fapl, fcpl, false);
+  }
+#endif
+
   // same function is used in h5::group
   std::string file::name() const {
     // get length of the name
@@ -84,21 +279,31 @@ namespace h5 {
 
   void file::flush() {
     if (not is_valid()) return;
+    H5_INSTRUMENT(instr, "file::flush", id);
     auto err = H5Fflush(id, H5F_SCOPE_GLOBAL);
     CHECK_OR_THROW((err >= 0), "Flushing the file failed");
   }
 
-  file::file() {
-    // create a file access property list
-    proplist fapl = H5Pcreate(H5P_FILE_ACCESS);
-    CHECK_OR_THROW((fapl >= 0), "Creating the fapl failed");
+  void file::start_swmr_write() {
+    auto err = H5Fstart_swmr_write(id);
+    CHECK_OR_THROW((err >= 0), "Starting the SWMR write mode failed (the file has to be opened in read-write mode and use the latest file format)");
+  }
+
+  file::file() : file(file_options{}) {}
+
+  file::file(file_options const &opts) : overwrite_in_place_(opts.overwrite_in_place) {
+    // create a file access and a file creation property list
+    proplist fapl = make_file_access_proplist(opts);
+    proplist fcpl = make_file_create_proplist(opts);
 
     // set the file driver to use the `H5FD_CORE` driver
-    auto err = H5Pset_fapl_core(fapl, (size_t)(64 * 1024), false);
+    CHECK_OR_THROW((std::holds_alternative<std::monostate>(opts.driver)), "Buffered memory files always use the core file driver");
+    CHECK_OR_THROW((opts.memory_increment > 0), "Memory increment of a buffered memory file has to be > 0");
+    auto err = H5Pset_fapl_core(fapl, opts.memory_increment, false);
     CHECK_OR_THROW((err >= 0), "Setting the core file driver in fapl failed");
 
     // create a buffered memory file
-    this->id = H5Fcreate("MemoryBuffer", 0, H5P_DEFAULT, fapl);
+    this->id = H5Fcreate(memory_file_name().c_str(), 0, fcpl, fapl);
     CHECK_OR_THROW((this->is_valid()), "Creating a buffered memory file failed");
   }
 
@@ -116,10 +321,78 @@ namespace h5 {
     CHECK_OR_THROW((err >= 0), "Setting the file image to a given memory buffer failed");
 
     // create a buffered memory file
-    this->id = H5Fopen("MemoryBuffer", H5F_ACC_RDWR, fapl);
+    this->id = H5Fopen(memory_file_name().c_str(), H5F_ACC_RDWR, fapl);
+    CHECK_OR_THROW((this->is_valid()), "Creating a buffered memory file failed");
+  }
+
+  file::file(std::vector<std::byte> &&buf) {
+    // take ownership of the buffer
+    auto *img  = new file_image{std::move(buf)};
+    img->data  = img->buf.data();
+    img->size  = img->buf.size();
+    img->owned = true;
+
+    // create a buffered memory file
+    this->id = open_file_image(img, H5F_ACC_RDWR);
     CHECK_OR_THROW((this->is_valid()), "Creating a buffered memory file failed");
   }
 
+  file file::from_buffer_view(std::span<std::byte const> buf) {
+    // open the file image without copying or releasing the buffer
+    auto *img = new file_image{.data = const_cast<std::byte *>(buf.data()), .size = buf.size()}; // NOLINT (HDF5 wants a non-const pointer)
+    auto f    = file{object{open_file_image(img, H5F_ACC_RDONLY)}};
+    CHECK_OR_THROW((f.is_valid()), "Opening a read-only buffered memory file failed");
+    return f;
+  }
+
+  file file::create_in_buffer(std::span<std::byte> buf) {
+    // copy an empty file image to the beginning of the buffer
+    auto const &empty = empty_file_image();
+    CHECK_OR_THROW((buf.size() >= empty.size()), "Buffer is too small to hold an empty HDF5 file");
+    std::memcpy(buf.data(), empty.data(), empty.size());
+
+    // open the file image with a fixed capacity (use the smallest increment to avoid overallocating)
+    auto *img = new file_image{.data = buf.data(), .size = empty.size(), .capacity = buf.size()};
+    auto f    = file{object{open_file_image(img, H5F_ACC_RDWR, 1)}};
+    CHECK_OR_THROW((f.is_valid()), "Creating a buffered memory file in a given buffer failed");
+    return f;
+  }
+
+  std::size_t file::image_size() const {
+    // flush the file
+    auto f   = hid_t(*this);
+    auto err = H5Fflush(f, H5F_SCOPE_GLOBAL);
+    CHECK_OR_THROW((err >= 0), "Flushing the buffered memory file failed");
+
+    // retrieve size of the file image
+    ssize_t image_len = H5Fget_file_image(f, nullptr, (size_t)0);
+    CHECK_OR_THROW((image_len > 0), "Getting the file image size failed");
+    return static_cast<std::size_t>(image_len);
+  }
+
+  std::span<std::byte const> file::buffer_view() const {
+    // flush the file
+    auto f   = hid_t(*this);
+    auto err = H5Fflush(f, H5F_SCOPE_GLOBAL);
+    CHECK_OR_THROW((err >= 0), "Flushing the buffered memory file failed");
+
+    // check the file driver
+    proplist fapl = H5Fget_access_plist(f);
+    CHECK_OR_THROW((fapl >= 0 and H5Pget_driver(fapl) == H5FD_CORE), "Buffer views are only supported for buffered memory files");
+
+    // retrieve size of the file image
+    ssize_t image_len = H5Fget_file_image(f, nullptr, (size_t)0);
+    CHECK_OR_THROW((image_len > 0), "Getting the file image size failed");
+
+    // the file handle of the core driver is a pointer to its memory buffer
+    void *handle = nullptr;
+    err          = H5Fget_vfd_handle(f, fapl, &handle);
+    CHECK_OR_THROW((err >= 0 and handle != nullptr), "Getting the memory buffer of the core driver failed");
+    auto *data = *static_cast<std::byte **>(handle);
+
+    return {data, static_cast<std::size_t>(image_len)};
+  }
+
   std::vector<std::byte> file::as_buffer() const {
     // flush the file
     auto f   = hid_t(*this);
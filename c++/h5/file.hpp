@@ -23,10 +23,16 @@
 #define LIBH5_FILE_HPP
 
 #include "./object.hpp"
+#include "./properties.hpp"
+
+#ifdef H5_MPI_SUPPORT
+#include <mpi.h>
+#endif
 
 #include <cstddef>
 #include <span>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace h5 {
@@ -49,6 +55,16 @@ namespace h5 {
      */
     file();
 
+    /**
+     * @brief Constructor to create a buffered memory file with the given file access options.
+     *
+     * @details The size of the memory buffer grows in steps of h5::file_options::memory_increment bytes. Choosing it
+     * close to the expected size of the file avoids repeated reallocations of the buffer.
+     *
+     * @param opts h5::file_options to configure the file access property list.
+     */
+    explicit file(file_options const &opts);
+
     /**
      * @brief Constructor to open an existing file or to create a new file on disk.
      *
@@ -61,16 +77,64 @@ namespace h5 {
      * - 'e': Create a new file if the file does not already exists, otherwise throw an exception (calls `H5Fcreate` with
      * `H5F_ACC_EXCL`)
      *
+     * The file access property list is created from the given h5::file_options, e.g. to configure the chunk cache,
+     * the metadata cache or the alignment of objects in the file. The file driver is selected with
+     * h5::file_options::driver, e.g. to store the metadata and the raw data in separate files (h5::split_driver), to
+     * bypass the page cache (h5::direct_driver) or to read files from S3 object storage (h5::ros3_driver).
+     *
+     * If h5::file_options::swmr is set, the file is opened for single-writer/multiple-reader (SWMR) access, i.e. other
+     * processes can read the file while it is being written:
+     * - In mode 'r', the file is opened as a SWMR reader. Every dataset opened via h5::group::open_dataset is refreshed
+     * (see `H5Drefresh`) such that the data which has been flushed by the writer is visible. Datasets which are kept
+     * open, e.g. by an h5::lazy_dataset, have to be refreshed explicitly.
+     * - In the other modes, the file is opened as a SWMR writer. Data becomes visible to the readers when it is flushed
+     * (see file::flush). Readers only see objects which already existed when they opened the file. The usual pattern is
+     * therefore to create all (extensible) datasets first and to append to them afterwards.
+     *
+     * Alternatively, a file which uses the latest file format can be switched to SWMR writing with
+     * file::start_swmr_write after all objects have been created.
+     *
      * @param name Name of the file.
      * @param mode Mode in which to open the file.
+     * @param opts h5::file_options to configure the file access property list.
      */
-    file(const char *name, char mode);
+    file(const char *name, char mode, file_options const &opts = {});
 
     /**
      * @brief Constructor to open an existing file or to create a new file on disk.
-     * @details See file::file(const char*, char) for a more detailed description.
+     * @details See file::file(const char*, char, file_options const &) for a more detailed description.
+     */
+    file(std::string const &name, char mode, file_options const &opts = {}) : file(name.c_str(), mode, opts) {}
+
+#ifdef H5_MPI_SUPPORT
+    /**
+     * @brief Constructor to open an existing file or to create a new file on disk for parallel I/O.
+     *
+     * @details It modifies the file access property list to use the MPI-IO file driver (see `H5Pset_fapl_mpio`).
+     * This is a collective operation, i.e. it has to be called by all processes in the given communicator. See
+     * file::file(const char*, char, file_options const &) for a description of the available modes.
+     *
+     * Datasets in the file can be read/written collectively by passing the corresponding h5::transfer_options to the
+     * functions in h5::array_interface.
+     *
+     * HDF5 does not support SWMR with the MPI-IO file driver, i.e. an exception is thrown if h5::file_options::swmr
+     * is set.
+     *
+     * @param name Name of the file.
+     * @param mode Mode in which to open the file.
+     * @param comm MPI communicator.
+     * @param info MPI info object.
+     * @param opts h5::file_options to configure the file access property list.
      */
-    file(std::string const &name, char mode) : file(name.c_str(), mode) {}
+    file(const char *name, char mode, MPI_Comm comm, MPI_Info info = MPI_INFO_NULL, file_options const &opts = {});
+
+    /**
+     * @brief Constructor to open an existing file or to create a new file on disk for parallel I/O.
+     * @details See file::file(const char*, char, MPI_Comm, MPI_Info, file_options const &) for a more detailed description.
+     */
+    file(std::string const &name, char mode, MPI_Comm comm, MPI_Info info = MPI_INFO_NULL, file_options const &opts = {})
+       : file(name.c_str(), mode, comm, info, opts) {}
+#endif
 
     /// Get the name of the file.
     [[nodiscard]] std::string name() const;
@@ -78,25 +142,105 @@ namespace h5 {
     /// Flush the file by calling `H5Fflush`.
     void flush();
 
+    /// Check whether existing objects are overwritten instead of unlinked (see h5::file_options::overwrite_in_place).
+    [[nodiscard]] bool overwrite_in_place() const { return overwrite_in_place_; }
+
+    /// Check whether the file has been opened as a SWMR reader (see h5::file_options::swmr).
+    [[nodiscard]] bool swmr_read() const { return swmr_read_; }
+
+    /**
+     * @brief Switch a file which has been opened in read-write mode to SWMR writing by calling `H5Fstart_swmr_write`.
+     *
+     * @details The file has to use the latest file format, e.g. by setting h5::file_options::swmr when it is created.
+     * All objects which the readers should see have to be created before.
+     */
+    void start_swmr_write();
+
     private:
+    // Whether existing objects are overwritten instead of unlinked.
+    bool overwrite_in_place_ = false;
+
+    // Whether the file has been opened as a SWMR reader.
+    bool swmr_read_ = false;
+
     // Constructor to create a buffered memory file with an initial file image of a given size.
     file(const std::byte *buf, size_t size);
 
+    // Constructor to take ownership of an already opened HDF5 file.
+    explicit file(object &&obj) : object(std::move(obj)) {}
+
     public:
     /**
      * @brief Constructor to create a buffered memory file from a byte buffer.
+     * @details The byte buffer is copied into the memory file.
      * @param buf Byte buffer.
      */
     file(std::span<std::byte> const &buf) : file(buf.data(), buf.size()) {}
 
     /**
      * @brief Constructor to create a buffered memory file from a byte buffer.
+     * @details The byte buffer is copied into the memory file.
      * @param buf Byte buffer.
      */
     file(std::vector<std::byte> const &buf) : file(buf.data(), buf.size()) {}
 
+    /**
+     * @brief Constructor to create a buffered memory file by taking ownership of a byte buffer.
+     *
+     * @details The file is opened in read-write mode and uses the given buffer as its file image without copying it.
+     * The buffer is released when the file and all HDF5 objects in the file have been closed. If the file grows, the
+     * buffer is resized which might reallocate it.
+     *
+     * @param buf Byte buffer (is moved from).
+     */
+    file(std::vector<std::byte> &&buf);
+
+    /**
+     * @brief Create a read-only buffered memory file which operates directly on a given byte buffer.
+     *
+     * @details It uses custom file image callbacks (see `H5Pset_file_image_callbacks`) with the same semantics as the
+     * `H5LT_FILE_IMAGE_DONT_COPY` and `H5LT_FILE_IMAGE_DONT_RELEASE` flags of `H5LTopen_file_image`, i.e. the buffer is
+     * neither copied nor released by HDF5. The caller is responsible for keeping the buffer alive and unchanged as long
+     * as the file or any HDF5 object in the file is open.
+     *
+     * @param buf Byte buffer containing an HDF5 file image.
+     * @return Read-only h5::file using the given buffer.
+     */
+    [[nodiscard]] static file from_buffer_view(std::span<std::byte const> buf);
+
+    /**
+     * @brief Create a new buffered memory file which stores its file image in a given fixed-size buffer.
+     *
+     * @details The buffer is never reallocated. If the file image exceeds the size of the buffer, it is moved to an
+     * internally allocated buffer and the given buffer is no longer used (this can be checked by comparing it with
+     * file::buffer_view). The caller is responsible for keeping the buffer alive as long as the file or any HDF5 object
+     * in the file is open. Otherwise, once the file has been closed, the first file::image_size bytes of the buffer
+     * contain a valid file image.
+     *
+     * @param buf Byte buffer, which has to be at least as large as an empty HDF5 file.
+     * @return Read-write h5::file using the given buffer.
+     */
+    [[nodiscard]] static file create_in_buffer(std::span<std::byte> buf);
+
+    /// Get the size of the current file image in bytes (the file is flushed before).
+    [[nodiscard]] std::size_t image_size() const;
+
     /// Get a copy of the associated byte buffer.
     [[nodiscard]] std::vector<std::byte> as_buffer() const;
+
+    /**
+     * @brief Get a view of the associated byte buffer without copying it.
+     *
+     * @details The file is flushed before the view is created. The view is only valid as long as the file is open and
+     * no further data is written to it. This only works for buffered memory files, i.e. files using the `H5FD_CORE`
+     * driver.
+     *
+     * In contrast to file::as_buffer, the file status flags in the superblock are not cleared, since the view shows the
+     * image of the still open file.
+     *
+     * @return Span of the current file image of the memory file.
+     */
+    [[nodiscard]] std::span<std::byte const> buffer_view() const;
   };
 
 } // namespace h5
@@ -106,6 +106,22 @@ namespace h5 {
     h5_write(g, key, x, args...);
   }
 
+  /**
+   * @brief Generic implementation for appending a variable to an extensible HDF5 dataset.
+   *
+   * @details It calls the specialized `h5_append(group, std::string const &, T const &)` for the given `T`.
+   *
+   * @tparam T C++ type to be appended.
+   * @param g h5::group containing the dataset.
+   * @param key Name of the dataset to which the variable is appended.
+   * @param x Variable to be appended.
+   * @param args Additional arguments to be passed to the specialized `h5_append(group, std::string const &, T const &)` function.
+   */
+  template <typename T>
+  void append(group g, std::string const &key, T const &x, auto const &...args) {
+    h5_append(g, key, x, args...);
+  }
+
   /**
    * @brief Generic implementation for reading an HDF5 attribute.
    *
@@ -168,6 +184,26 @@ namespace h5 {
     h5_write_attribute(obj, key, x);
   }
 
+  /**
+   * @brief Write all key-value pairs of a map-like range to HDF5 attributes of the same object.
+   *
+   * @details It calls the specialized `h5_write_attribute(object, std::string const &, T const &)` for each value. The
+   * object is opened only once by the caller and existing attributes are overwritten, e.g.
+   *
+   * @code{.cpp}
+   * auto ds = h5::group{f}.open_dataset("data");
+   * h5::write_attributes(ds, std::map<std::string, std::vector<double>>{{"x_axis", x}, {"y_axis", y}});
+   * @endcode
+   *
+   * @tparam M Range of key-value pairs, e.g. a `std::map<std::string, T>`.
+   * @param obj h5::object to which the attributes are attached.
+   * @param m Key-value pairs to be written.
+   */
+  template <typename M>
+  void write_attributes(object obj, M const &m) {
+    for (auto const &[key, x] : m) h5_write_attribute(obj, key, x);
+  }
+
   /**
    * @brief Generic implementation for reading an HDF5 attribute.
    *
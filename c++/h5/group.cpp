@@ -20,16 +20,87 @@
  */
 
 #include "./group.hpp"
+#include "./stats.hpp"
 
 #include <hdf5.h>
 #include <hdf5_hl.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace h5 {
 
+  namespace {
+
+    // Call an HDF5 function with the automatic error printing turned off.
+    template <typename F>
+    auto silenced(F &&f) {
+      H5E_auto2_t old_func  = nullptr;
+      void *old_client_data = nullptr;
+      H5Eget_auto2(H5E_DEFAULT, &old_func, &old_client_data);
+      H5Eset_auto2(H5E_DEFAULT, nullptr, nullptr);
+      auto res = f();
+      H5Eset_auto2(H5E_DEFAULT, old_func, old_client_data);
+      return res;
+    }
+
+    // Remove all attributes of an HDF5 object.
+    void remove_attributes(object const &obj) {
+      std::vector<std::string> names;
+      auto collect = [](hid_t, const char *name, const H5A_info_t *, void *data) -> herr_t {
+        static_cast<std::vector<std::string> *>(data)->emplace_back(name);
+        return 0;
+      };
+      H5Aiterate2(obj, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, collect, &names);
+      for (auto const &name : names) {
+        if (H5Adelete(obj, name.c_str()) < 0) throw std::runtime_error("Error in h5::group: Removing the attribute " + name + " failed");
+      }
+    }
+
+    // Check if two dataset creation property lists have the same layout, chunk shape, filters and fill value.
+    bool same_creation_settings(hid_t dcpl1, hid_t dcpl2, datatype const &ty) {
+      // layout and chunk shape
+      auto layout = H5Pget_layout(dcpl1);
+      if (layout != H5Pget_layout(dcpl2)) return false;
+      if (layout == H5D_CHUNKED) {
+        std::vector<hsize_t> chunk1(H5S_MAX_RANK), chunk2(H5S_MAX_RANK);
+        int rank = H5Pget_chunk(dcpl1, H5S_MAX_RANK, chunk1.data());
+        if (rank != H5Pget_chunk(dcpl2, H5S_MAX_RANK, chunk2.data()) or chunk1 != chunk2) return false;
+      }
+
+      // filters (HDF5 adds parameters to some filters when the dataset is created, so only the given ones are compared)
+      int n_filters = H5Pget_nfilters(dcpl1);
+      if (n_filters != H5Pget_nfilters(dcpl2)) return false;
+      for (int i = 0; i < n_filters; ++i) {
+        unsigned flags1 = 0, flags2 = 0;
+        std::size_t n_cd1 = 16, n_cd2 = 16;
+        std::vector<unsigned> cd1(n_cd1), cd2(n_cd2);
+        auto id1 = H5Pget_filter2(dcpl1, static_cast<unsigned>(i), &flags1, &n_cd1, cd1.data(), 0, nullptr, nullptr);
+        auto id2 = H5Pget_filter2(dcpl2, static_cast<unsigned>(i), &flags2, &n_cd2, cd2.data(), 0, nullptr, nullptr);
+        if (id1 != id2 or (flags1 & H5Z_FLAG_OPTIONAL) != (flags2 & H5Z_FLAG_OPTIONAL) or n_cd1 < n_cd2) return false;
+        if (not std::equal(cd2.begin(), cd2.begin() + std::min<std::size_t>(n_cd2, cd2.size()), cd1.begin())) return false;
+      }
+
+      // fill value
+      H5D_fill_value_t status1 = H5D_FILL_VALUE_ERROR, status2 = H5D_FILL_VALUE_ERROR;
+      if (H5Pfill_value_defined(dcpl1, &status1) < 0 or H5Pfill_value_defined(dcpl2, &status2) < 0 or status1 != status2) return false;
+      if (status1 == H5D_FILL_VALUE_USER_DEFINED) {
+        if (H5Tis_variable_str(ty) > 0 or H5Tdetect_class(ty, H5T_VLEN) > 0) return false;
+        std::vector<std::byte> fill1(H5Tget_size(ty)), fill2(H5Tget_size(ty));
+        if (H5Pget_fill_value(dcpl1, ty, fill1.data()) < 0 or H5Pget_fill_value(dcpl2, ty, fill2.data()) < 0 or fill1 != fill2) return false;
+      }
+      return true;
+    }
+
+  } // namespace
+
   group::group(file f) : object(), parent_file(f) {
     id = H5Gopen2(f, "/", H5P_DEFAULT);
     if (id < 0) throw std::runtime_error("Error in h5::group: Opening the root group / for the file " + f.name() + " failed");
@@ -50,9 +121,14 @@ namespace h5 {
     return res;
   }
 
-  bool group::has_key(std::string const &key) const { return H5Lexists(id, key.c_str(), H5P_DEFAULT); }
+  bool group::has_key(std::string const &key) const {
+    H5_INSTRUMENT(instr, "group::has_key", id, key);
+    return H5Lexists(id, key.c_str(), H5P_DEFAULT);
+  }
 
   bool group::has_subgroup(std::string const &key) const {
+    H5_INSTRUMENT(instr, "group::has_subgroup", id, key);
+
     // check if a link with the given name exists
     if (!has_key(key)) return false;
 
@@ -67,6 +143,8 @@ namespace h5 {
   }
 
   bool group::has_dataset(std::string const &key) const {
+    H5_INSTRUMENT(instr, "group::has_dataset", id, key);
+
     // check if a link with the given name exists
     if (!has_key(key)) return false;
 
@@ -81,6 +159,8 @@ namespace h5 {
   }
 
   void group::unlink(std::string const &key, bool error_if_absent) const {
+    H5_INSTRUMENT(instr, "group::unlink", id, key);
+
     // check if a link with the given name exists
     if (!has_key(key)) {
       // throw an exception if `error_if_absent` is true
@@ -96,6 +176,7 @@ namespace h5 {
   group group::open_group(std::string const &key) const {
     // return the current group if the key is empty
     if (key.empty()) return *this;
+    H5_INSTRUMENT(instr, "group::open_group", id, key);
 
     // check if a link with the key exists
     if (!has_key(key)) throw std::runtime_error("Error in h5::group: " + key + " does not exist in the group " + name());
@@ -106,15 +187,39 @@ namespace h5 {
     return {obj, parent_file};
   }
 
-  group group::create_group(std::string const &key, bool delete_if_exists) const {
+  group group::create_group(std::string const &key, bool delete_if_exists) const { return create_group(key, group_options{}, delete_if_exists); }
+
+  group group::create_group(std::string const &key, group_options const &opts, bool delete_if_exists) const {
     // return the current group if the key is empty
     if (key.empty()) return *this;
+    H5_INSTRUMENT(instr, "group::create_group", id, key);
+
+    // reuse an existing group (or one which has been unlinked together with the links of this group)
+    if (delete_if_exists and parent_file.overwrite_in_place()) {
+      group res;
+      if (has_subgroup(key)) {
+        res = open_group(key);
+      } else if (object obj = take_unlinked_child(key, object_type::group); obj.is_valid()) {
+        unlink(key);
+        if (H5Olink(obj, id, key.c_str(), H5P_DEFAULT, H5P_DEFAULT) < 0)
+          throw std::runtime_error("Error in h5::group: Linking the subgroup " + key + " in the group " + name() + " failed");
+        res = group{obj, parent_file};
+      }
+
+      // remove its links and attributes (the children are only reused if they are written again)
+      if (res.is_valid()) {
+        res.unlink_children();
+        remove_attributes(res);
+        return res;
+      }
+    }
 
-    // unlink existing group if 'delete_if_exists' is true
+    // unlink an existing group if 'delete_if_exists' is true
     if (delete_if_exists) unlink(key);
 
     // create new subgroup
-    object obj = H5Gcreate2(id, key.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    auto gcpl  = make_group_create_proplist(opts);
+    object obj = H5Gcreate2(id, key.c_str(), H5P_DEFAULT, gcpl, H5P_DEFAULT);
     if (not obj.is_valid()) throw std::runtime_error("Error in h5::group: Creating the subgroup " + key + " in the group " + name() + " failed");
     return {obj, parent_file};
   }
@@ -137,18 +242,35 @@ namespace h5 {
     if (err < 0) throw std::runtime_error("Error in h5::group: Creating the softlink " + key + " -> " + target_key + " failed");
   }
 
-  dataset group::open_dataset(std::string const &key) const {
-    // check if a link with the given name exists
-    if (!has_key(key)) throw std::runtime_error("Error in h5::group: " + key + " does not exist in the group " + name());
+  dataset group::open_dataset(std::string const &key) const { return open_dataset_with_dapl(key, H5P_DEFAULT); }
 
-    // open the dataset
-    dataset ds = H5Dopen2(id, key.c_str(), H5P_DEFAULT);
-    if (!ds.is_valid()) throw std::runtime_error("Error in h5::group: Opening the dataset " + key + " in the group " + name() + " failed");
-    return ds;
+  dataset group::open_dataset(std::string const &key, chunk_cache_config const &cfg) const {
+    proplist dapl = make_dataset_access_proplist(cfg);
+    return open_dataset_with_dapl(key, dapl);
+  }
+
+  dataset group::open_dataset_with_dapl(std::string const &key, hid_t dapl) const {
+    H5_INSTRUMENT(instr, "group::open_dataset", id, key);
+
+    // try to open the dataset (only check if the link exists in case of a failure)
+    dataset ds = silenced([&]() { return H5Dopen2(id, key.c_str(), dapl); });
+    if (ds.is_valid()) {
+      // SWMR readers have to refresh the metadata of the dataset to see the data flushed by the writer
+      if (parent_file.swmr_read() and H5Drefresh(ds) < 0)
+        throw std::runtime_error("Error in h5::group: Refreshing the dataset " + key + " in the group " + name() + " failed");
+      return ds;
+    }
+    if (!has_key(key)) throw std::runtime_error("Error in h5::group: " + key + " does not exist in the group " + name());
+    throw std::runtime_error("Error in h5::group: Opening the dataset " + key + " in the group " + name() + " failed");
   }
 
   dataset group::create_dataset(std::string const &key, datatype ty, dataspace sp, hid_t pl) const {
-    // unlink existing link
+    H5_INSTRUMENT(instr, "group::create_dataset", id, key);
+
+    // reuse an existing dataset or unlink it
+    if (parent_file.overwrite_in_place()) {
+      if (dataset ds = open_dataset_for_overwrite(key, ty, sp, pl); ds.is_valid()) return ds;
+    }
     unlink(key);
 
     // create new dataset
@@ -159,55 +281,148 @@ namespace h5 {
 
   dataset group::create_dataset(std::string const &key, datatype ty, dataspace sp) const { return create_dataset(key, ty, sp, H5P_DEFAULT); }
 
-  // C callbacks for the next functions using H5Literate
-  extern "C" {
+  dataset group::open_dataset_for_overwrite(std::string const &key, datatype ty, dataspace sp) const {
+    return open_dataset_for_overwrite(key, std::move(ty), std::move(sp), H5P_DEFAULT);
+  }
+
+  dataset group::open_dataset_for_overwrite(std::string const &key, datatype ty, dataspace sp, hid_t pl) const {
+    // open the linked dataset or take the one which has been unlinked together with the links of this group
+    bool linked = has_dataset(key);
+    dataset ds  = (linked ? open_dataset(key) : take_unlinked_child(key, object_type::dataset));
+    if (not ds.is_valid()) return {};
+
+    // check the datatype and the extent
+    datatype file_ty      = H5Dget_type(ds);
+    dataspace file_dspace = H5Dget_space(ds);
+    if (H5Tequal(file_ty, ty) <= 0 or H5Sextent_equal(file_dspace, sp) <= 0) return {};
+
+    // check the creation settings
+    proplist file_dcpl = H5Dget_create_plist(ds);
+    proplist dcpl      = (pl == H5P_DEFAULT ? H5Pcreate(H5P_DATASET_CREATE) : H5Pcopy(pl));
+    if (not same_creation_settings(file_dcpl, dcpl, file_ty)) return {};
+
+    // link an unlinked dataset again
+    if (not linked) {
+      unlink(key);
+      if (H5Olink(ds, id, key.c_str(), H5P_DEFAULT, H5P_DEFAULT) < 0)
+        throw std::runtime_error("Error in h5::group: Linking the dataset " + key + " in the group " + name() + " failed");
+    }
 
-  herr_t get_group_elements_name_ds(::hid_t loc_id, const char *name, const H5L_info_t *, void *opdata) {
-    H5O_info_t object_info;
-    herr_t err = H5Oget_info_by_name(loc_id, name, &object_info, H5P_DEFAULT);
-    if (err < 0) throw std::runtime_error("Error in h5::get_group_elements_name_ds: H5Oget_info_by_name call failed");
-    if (object_info.type == H5O_TYPE_DATASET) static_cast<std::vector<std::string> *>(opdata)->push_back(name);
-    return 0;
+    // remove the attributes (they are written again together with the data)
+    remove_attributes(ds);
+    return ds;
   }
 
-  herr_t get_group_elements_name_grp(::hid_t loc_id, const char *name, const H5L_info_t *, void *opdata) {
-    H5O_info_t object_info;
-    herr_t err = H5Oget_info_by_name(loc_id, name, &object_info, H5P_DEFAULT);
-    if (err < 0) throw std::runtime_error("Error in h5::get_group_elements_name_grp: H5Oget_info_by_name call failed");
-    if (object_info.type == H5O_TYPE_GROUP) static_cast<std::vector<std::string> *>(opdata)->push_back(name);
-    return 0;
+  void group::unlink_children() {
+    // collect the names of the links first (the group must not be modified while iterating over its links)
+    std::vector<child_info> links = children();
+    if (links.empty()) return;
+
+    // park the hard links in an anonymous group (only the anonymous group is kept open, not each child)
+    object parked = H5Gcreate_anon(id, H5P_DEFAULT, H5P_DEFAULT);
+    if (not parked.is_valid()) throw std::runtime_error("Error in h5::group: Creating a temporary group in the group " + name() + " failed");
+    for (auto const &[key, type] : links) {
+      H5L_info_t linfo;
+      if (type != object_type::unknown and H5Lget_info(id, key.c_str(), &linfo, H5P_DEFAULT) >= 0 and linfo.type == H5L_TYPE_HARD) {
+        // H5Lmove cannot be used since it crashes for anonymous destination groups in some HDF5 versions
+        if (H5Lcreate_hard(id, key.c_str(), parked, key.c_str(), H5P_DEFAULT, H5P_DEFAULT) < 0)
+          throw std::runtime_error("Error in h5::group: Moving the link " + key + " out of the group " + name() + " failed");
+      }
+      unlink(key);
+    }
+    unlinked_children = std::move(parked);
   }
 
-  herr_t get_group_elements_name_ds_grp(::hid_t loc_id, const char *name, const H5L_info_t *, void *opdata) {
-    H5O_info_t object_info;
-    herr_t err = H5Oget_info_by_name(loc_id, name, &object_info, H5P_DEFAULT);
-    if (err < 0) throw std::runtime_error("Error in h5::get_group_elements_name_ds_grp: H5Oget_info_by_name call failed");
-    if ((object_info.type == H5O_TYPE_GROUP) or (object_info.type == H5O_TYPE_DATASET))
-      static_cast<std::vector<std::string> *>(opdata)->push_back(name);
-    return 0;
+  object group::take_unlinked_child(std::string const &key, object_type type) const {
+    if (not unlinked_children.is_valid() or H5Lexists(unlinked_children, key.c_str(), H5P_DEFAULT) <= 0) return {};
+    object res   = H5Oopen(unlinked_children, key.c_str(), H5P_DEFAULT);
+    auto id_type = H5Iget_type(res);
+    if ((type == object_type::group and id_type != H5I_GROUP) or (type == object_type::dataset and id_type != H5I_DATASET)) return {};
+    if (H5Ldelete(unlinked_children, key.c_str(), H5P_DEFAULT) < 0)
+      throw std::runtime_error("Error in h5::group: Removing the temporary link " + key + " in the group " + name() + " failed");
+    return res;
   }
 
-  } // extern "C"
+  namespace {
+
+    // Data passed to the H5Literate callback.
+    struct iterate_data {
+      std::function<bool(std::string_view, object_type)> const &f;
+      std::exception_ptr err = nullptr;
+    };
+
+    // Get the object type of a link by only reading the basic information of the object header.
+    object_type get_object_type(::hid_t loc_id, const char *name, const H5L_info_t *linfo) {
+      if (linfo->type != H5L_TYPE_HARD and linfo->type != H5L_TYPE_SOFT and linfo->type != H5L_TYPE_EXTERNAL) return object_type::unknown;
+#if H5_VERSION_GE(1, 12, 0)
+      H5O_info2_t oinfo;
+      auto err = silenced([&]() { return H5Oget_info_by_name3(loc_id, name, &oinfo, H5O_INFO_BASIC, H5P_DEFAULT); });
+#else
+      H5O_info_t oinfo;
+      auto err = silenced([&]() { return H5Oget_info_by_name2(loc_id, name, &oinfo, H5O_INFO_BASIC, H5P_DEFAULT); });
+#endif
+      if (err < 0) return object_type::unknown;
+      switch (oinfo.type) {
+        case H5O_TYPE_GROUP: return object_type::group;
+        case H5O_TYPE_DATASET: return object_type::dataset;
+        case H5O_TYPE_NAMED_DATATYPE: return object_type::named_datatype;
+        default: return object_type::unknown;
+      }
+    }
+
+    // C callback for H5Literate (exceptions must not propagate through the HDF5 library).
+    extern "C" herr_t for_each_child_callback(::hid_t loc_id, const char *name, const H5L_info_t *linfo, void *opdata) {
+      auto *data = static_cast<iterate_data *>(opdata);
+      try {
+        return data->f(name, get_object_type(loc_id, name, linfo)) ? 0 : 1;
+      } catch (...) {
+        data->err = std::current_exception();
+        return -1;
+      }
+    }
+
+    // Collect the names of all children of the given types.
+    std::vector<std::string> get_names(group const &g, bool groups, bool datasets) {
+      std::vector<std::string> names;
+      g.for_each_child([&](std::string_view name, object_type type) {
+        if ((groups and type == object_type::group) or (datasets and type == object_type::dataset)) names.emplace_back(name);
+        return true;
+      });
+      return names;
+    }
+
+  } // namespace
 
-  std::vector<std::string> group::get_all_subgroup_names() const {
-    std::vector<std::string> grp_name;
-    int r = H5Literate(::hid_t(id), H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, get_group_elements_name_grp, static_cast<void *>(&grp_name));
-    if (r != 0) throw std::runtime_error("Error in h5::group: Iterating over subgroups of the group " + name() + "failed");
-    return grp_name;
+  bool group::has_creation_order_index() const {
+    proplist gcpl  = H5Gget_create_plist(id);
+    unsigned flags = 0;
+    return gcpl.is_valid() and H5Pget_link_creation_order(gcpl, &flags) >= 0 and (flags & H5P_CRT_ORDER_INDEXED);
   }
 
-  std::vector<std::string> group::get_all_dataset_names() const {
-    std::vector<std::string> ds_name;
-    int r = H5Literate(::hid_t(id), H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, get_group_elements_name_ds, static_cast<void *>(&ds_name));
-    if (r != 0) throw std::runtime_error("Error in h5::group: Iterating over datasets of the group " + name() + "failed");
-    return ds_name;
+  void group::for_each_child(std::function<bool(std::string_view, object_type)> const &f) const {
+    H5_INSTRUMENT(instr, "group::for_each_child", id);
+
+    // iterate in creation order if possible (no sorting by name required)
+    auto [idx, order] = (has_creation_order_index() ? std::pair{H5_INDEX_CRT_ORDER, H5_ITER_INC} : std::pair{H5_INDEX_NAME, H5_ITER_NATIVE});
+    iterate_data data{f};
+    auto r = H5Literate(::hid_t(id), idx, order, nullptr, for_each_child_callback, static_cast<void *>(&data));
+    if (data.err) std::rethrow_exception(data.err);
+    if (r < 0) throw std::runtime_error("Error in h5::group: Iterating over the links of the group " + name() + " failed");
   }
 
-  std::vector<std::string> group::get_all_subgroup_dataset_names() const {
-    std::vector<std::string> ds_name;
-    int r = H5Literate(::hid_t(id), H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, get_group_elements_name_ds_grp, static_cast<void *>(&ds_name));
-    if (r != 0) throw std::runtime_error("Error in h5::group: Iterating over datasets and subgroups of the group " + name() + "failed");
-    return ds_name;
+  std::vector<child_info> group::children() const {
+    std::vector<child_info> res;
+    for_each_child([&res](std::string_view name, object_type type) {
+      res.push_back({std::string{name}, type});
+      return true;
+    });
+    return res;
   }
 
+  std::vector<std::string> group::get_all_subgroup_names() const { return get_names(*this, true, false); }
+
+  std::vector<std::string> group::get_all_dataset_names() const { return get_names(*this, false, true); }
+
+  std::vector<std::string> group::get_all_subgroup_dataset_names() const { return get_names(*this, true, true); }
+
 } // namespace h5
@@ -24,13 +24,43 @@
 #define LIBH5_GROUP_HPP
 
 #include "./file.hpp"
+#include "./properties.hpp"
 
+#include <functional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 namespace h5 {
 
+  /**
+   * @ingroup data_model
+   * @brief Type of an HDF5 object that a link in a group points to.
+   */
+  enum class object_type {
+    /// HDF5 group.
+    group,
+    /// HDF5 dataset.
+    dataset,
+    /// Named (committed) HDF5 datatype.
+    named_datatype,
+    /// Unknown object type or the link cannot be resolved (e.g. dangling soft links or unavailable external links).
+    unknown
+  };
+
+  /**
+   * @ingroup data_model
+   * @brief Name and object type of a child of an HDF5 group.
+   */
+  struct child_info {
+    /// Name of the link.
+    std::string name;
+
+    /// h5::object_type of the object the link points to.
+    object_type type;
+  };
+
   /**
    * @ingroup data_model
    * @brief A handle to an HDF5 group.
@@ -45,6 +75,19 @@ namespace h5 {
     // File to which the group belongs.
     file parent_file;
 
+    // Anonymous group holding the hard links of a group reused with h5::file_options::overwrite_in_place. Its children
+    // are linked again if they are written again and freed by HDF5 once the last copy of the group has been destroyed.
+    object unlinked_children;
+
+    // Open a dataset with the given dataset access property list.
+    [[nodiscard]] dataset open_dataset_with_dapl(std::string const &key, hid_t dapl) const;
+
+    // Remove all links of the group and move the hard links to subgroups and datasets to unlinked_children.
+    void unlink_children();
+
+    // Take the unlinked child with the given key if it has the given type (invalid otherwise).
+    [[nodiscard]] object take_unlinked_child(std::string const &key, object_type type) const;
+
     public:
     /// Default constructor (only necessary for the Python interface).
     group() = default;
@@ -116,6 +159,9 @@ namespace h5 {
      * @brief Create a subgroup with the given key in the group.
      *
      * @details If a subgroup with the given key already exists, it is unlinked first if `delete_if_exists == true`.
+     * If the file has been opened with h5::file_options::overwrite_in_place, the existing subgroup is reused instead
+     * (its links and attributes are removed, its children are only reused if they are written again).
+     *
      * If the given key is empty, a handle to the current group is returned. Throws an exception if the subgroup fails
      * to be created.
      *
@@ -125,6 +171,31 @@ namespace h5 {
      */
     group create_group(std::string const &key, bool delete_if_exists = true) const;
 
+    /**
+     * @brief Create a subgroup with the given key and group creation options in the group.
+     *
+     * @details Same as group::create_group(std::string const &, bool) const, except that the subgroup is created with
+     * a group creation property list made from the given h5::group_options. For groups with many links, e.g.
+     *
+     * @code{.cpp}
+     * auto grp = root.create_group("events", h5::group_options{.creation_order = true, .est_num_entries = 100000});
+     * @endcode
+     *
+     * tracking the creation order allows to iterate over the links without sorting them by name.
+     *
+     * @param key Name of the subgroup to be created.
+     * @param opts h5::group_options specifying the link storage and the creation order tracking.
+     * @param delete_if_exists If true, unlink first an existing subgroup with the same name.
+     * @return A handle to the created subgroup.
+     */
+    group create_group(std::string const &key, group_options const &opts, bool delete_if_exists = true) const;
+
+    /**
+     * @brief Check if the creation order of the links in the group is tracked and indexed.
+     * @return True if the links can be iterated in creation order, false otherwise.
+     */
+    [[nodiscard]] bool has_creation_order_index() const;
+
     /**
      * @brief Create a softlink with the given key to a target with a given target key in this group.
      *
@@ -142,17 +213,33 @@ namespace h5 {
      * @brief Open a dataset with the given key in the group.
      *
      * @details Throws an exception if there exists no link with the given key or if the dataset fails to be opened.
+     * The existence of the link is only checked if opening the dataset fails, i.e. opening an existing dataset requires
+     * a single lookup.
      *
      * @param key Name of the dataset.
      * @return A handle to the opened dataset.
      */
     [[nodiscard]] dataset open_dataset(std::string const &key) const;
 
+    /**
+     * @brief Open a dataset with the given key in the group and with the given chunk cache settings.
+     *
+     * @details The chunk cache settings only apply to the returned handle and override the settings of the file.
+     * Throws an exception if there exists no link with the given key or if the dataset fails to be opened.
+     *
+     * @param key Name of the dataset.
+     * @param cfg h5::chunk_cache_config specifying the chunk cache of the dataset.
+     * @return A handle to the opened dataset.
+     */
+    [[nodiscard]] dataset open_dataset(std::string const &key, chunk_cache_config const &cfg) const;
+
     /**
      * @brief Create a dataset with the given key, datatype, dataspace and dataset creation property list in this group.
      *
-     * @details It first unlinks an existing dataset with the same name. Throws an exception if the dataset fails to be
-     * created.
+     * @details It first unlinks an existing dataset with the same name. If the file has been opened with
+     * h5::file_options::overwrite_in_place, an existing dataset with the same datatype, extent and creation settings is
+     * reused instead (see group::open_dataset_for_overwrite). Throws an exception if the dataset fails
+     * to be created.
      *
      * @param key Name of the dataset to be created.
      * @param ty h5::datatype.
@@ -174,6 +261,63 @@ namespace h5 {
      */
     dataset create_dataset(std::string const &key, datatype ty, dataspace sp) const;
 
+    /**
+     * @brief Open an existing dataset which can be overwritten with data of the given datatype and dataspace.
+     *
+     * @details The dataset is compatible if its datatype is equal to the given one, if it has the same extent as the
+     * given dataspace and if it has been created with the same layout, chunk shape, filters and fill value as specified
+     * in the given dataset creation property list. All attributes of a compatible dataset are removed, i.e. it looks
+     * like a newly created dataset. If the group has been reused by group::create_group, a dataset whose
+     * link has been removed at that point is linked again.
+     *
+     * @param key Name of the dataset.
+     * @param ty h5::datatype.
+     * @param sp h5::dataspace.
+     * @param pl Dataset creation property list.
+     * @return A handle to the dataset or an invalid handle if there is no compatible dataset with the given key.
+     */
+    [[nodiscard]] dataset open_dataset_for_overwrite(std::string const &key, datatype ty, dataspace sp, hid_t pl) const;
+
+    /**
+     * @brief Open an existing dataset which can be overwritten with data of the given datatype and dataspace.
+     *
+     * @details It simply calls group::open_dataset_for_overwrite with the default dataset creation property list.
+     *
+     * @param key Name of the dataset.
+     * @param ty h5::datatype.
+     * @param sp h5::dataspace.
+     * @return A handle to the dataset or an invalid handle if there is no compatible dataset with the given key.
+     */
+    [[nodiscard]] dataset open_dataset_for_overwrite(std::string const &key, datatype ty, dataspace sp) const;
+
+    /**
+     * @brief Call a function for each child of the group in a single pass over its links.
+     *
+     * @details The links are visited with `H5Literate` in creation order if the group has a creation order index (see
+     * h5::group_options) and in the native order of the name index otherwise. The object type of each link
+     * is determined with `H5Oget_info_by_name` by only reading the basic information of the object header.
+     *
+     * The callback gets the name of the link and the h5::object_type of the object it points to. The name is only
+     * valid during the call. If the callback returns false, the iteration is stopped. Exceptions thrown by the
+     * callback stop the iteration and are rethrown.
+     *
+     * @code{.cpp}
+     * grp.for_each_child([](std::string_view name, h5::object_type type) {
+     *   if (type == h5::object_type::dataset) std::cout << name << "\n";
+     *   return true;
+     * });
+     * @endcode
+     *
+     * @param f Callable object taking a `std::string_view` and an h5::object_type and returning a bool.
+     */
+    void for_each_child(std::function<bool(std::string_view, object_type)> const &f) const;
+
+    /**
+     * @brief Get the names and object types of all the children of the group.
+     * @return A vector of h5::child_info objects in the order of group::for_each_child.
+     */
+    [[nodiscard]] std::vector<child_info> children() const;
+
     /**
      * @brief Get all the names of the subgroups in the current group.
      * @return A vector with the names of all the subgroups.
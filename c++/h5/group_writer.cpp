@@ -0,0 +1,218 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+
+/**
+ * @file
+ * @brief Implementation details for group_writer.hpp.
+ */
+
+#include "./group_writer.hpp"
+#include "./object.hpp"
+#include "./properties.hpp"
+#include "./stats.hpp"
+#include "./stl/string.hpp"
+
+#include <hdf5.h>
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace h5 {
+
+  namespace {
+
+    // Check if the children of a group can be created without looking for existing objects, i.e. if the group has no
+    // links (a single call instead of one existence check per child). A group reused with
+    // h5::file_options::overwrite_in_place has no links but its former children are reused when they are written again.
+    bool has_no_links(group const &g) {
+      if (g.get_file().overwrite_in_place()) return false;
+      H5G_info_t info;
+      if (H5Gget_info(g, &info) < 0) throw std::runtime_error("Error in h5::group_writer: Getting the info of the group " + g.name() + " failed");
+      return info.nlinks == 0;
+    }
+
+    // Dataset creation property list and file dataspace shared by all new datasets with the same datatype, shape and compression.
+    struct dataset_layout {
+      datatype ty;
+      dims_t shape;
+      bool compress;
+      proplist dcpl;
+      dataspace dspace;
+    };
+
+    // Get the layout for an array view from the cache or create it.
+    dataset_layout const &get_layout(std::vector<dataset_layout> &cache, array_interface::array_view const &v, bool compress) {
+      auto shape = v.slab.shape();
+      for (auto const &l : cache) {
+        if (l.compress == compress and l.shape == shape and H5Tequal(l.ty, v.ty) > 0) return l;
+      }
+      auto opts  = (compress ? write_options{.deflate_level = 1} : write_options{});
+      auto dcpl  = make_dataset_create_proplist(opts, v.ty, shape, v.is_complex);
+      auto rank  = static_cast<int>(shape.size());
+      auto space = dataspace{H5Screate_simple(rank, shape.data(), nullptr)};
+      cache.push_back({v.ty, std::move(shape), compress, std::move(dcpl), std::move(space)});
+      return cache.back();
+    }
+
+    // Create a new variable-length string attribute (no check for an existing attribute).
+    void create_string_attribute(object const &obj, std::string const &name, std::string const &value, datatype const &dt, dataspace const &space) {
+      attribute attr = H5Acreate2(obj, name.c_str(), dt, space, H5P_DEFAULT, H5P_DEFAULT);
+      if (not attr.is_valid()) throw std::runtime_error("Error in h5::group_writer: Creating the attribute " + name + " failed");
+      auto *s_ptr = value.c_str();
+      if (H5Awrite(attr, dt, &s_ptr) < 0) throw std::runtime_error("Error in h5::group_writer: Writing a string to the attribute " + name + " failed");
+    }
+
+  } // namespace
+
+  group_writer::group_writer(group parent, std::string const &name)
+     : g_(parent.create_group(name)), empty_(has_no_links(g_)), has_attributes_(name.empty()) {}
+
+  group_writer::group_writer(group g) : g_(std::move(g)), empty_(has_no_links(g_)), has_attributes_(true) {}
+
+  group_writer::group_writer(group g, bool empty, bool has_attributes) : g_(std::move(g)), empty_(empty), has_attributes_(has_attributes) {}
+
+  group_writer::~group_writer() {
+    try {
+      commit();
+    } catch (...) {} // NOLINT (errors are discarded)
+  }
+
+  void group_writer::add_name(std::string const &name) {
+    if (name.empty()) throw std::runtime_error("Error in h5::group_writer: Empty names are not allowed in the group " + g_.name());
+    if (not names_.insert(name).second)
+      throw std::runtime_error("Error in h5::group_writer: The object " + name + " has already been written to the group " + g_.name());
+  }
+
+  void group_writer::add_array(std::string const &name, array_interface::array_view const &v, bool compress) {
+    auto nbytes = v.slab.size() * H5Tget_size(v.ty);
+    std::vector<std::byte> data(nbytes);
+    if (nbytes > 0) std::memcpy(data.data(), v.start, nbytes);
+    arrays_.push_back({name, v, std::move(data), compress});
+  }
+
+  void group_writer::add_string(std::string const &name, std::string value) { strings_.push_back({name, std::move(value)}); }
+
+  group_writer &group_writer::write_attribute(std::string const &name, std::string value) {
+    if (not attribute_names_.insert(name).second)
+      throw std::runtime_error("Error in h5::group_writer: The attribute " + name + " has already been written to the group " + g_.name());
+    attributes_.push_back({name, std::move(value)});
+    return *this;
+  }
+
+  group_writer &group_writer::subgroup(std::string const &name) {
+    add_name(name);
+
+    // a subgroup of an empty group is created without checking for an existing link and is empty itself
+    if (empty_) {
+      children_.push_back(std::unique_ptr<group_writer>(new group_writer(g_.create_group(name, false), true, false)));
+    } else {
+      children_.push_back(std::make_unique<group_writer>(g_, name));
+    }
+    return *children_.back();
+  }
+
+  void group_writer::commit() {
+    H5_INSTRUMENT(instr, "group_writer::commit", g_);
+
+    // take the pending children (they are not written again if an error occurs)
+    auto arrays     = std::exchange(arrays_, {});
+    auto strings    = std::exchange(strings_, {});
+    auto attributes = std::exchange(attributes_, {});
+    for (auto &a : arrays) a.v.start = a.data.data();
+
+    // variable-length string datatype and scalar dataspace shared by all strings
+    datatype str_dt         = hdf5_type<std::string>();
+    dataspace scalar_dspace = detail::scalar_dataspace();
+
+    if (empty_) {
+      // create all datasets without checking for existing links
+      std::vector<dataset_layout> layouts;
+      std::vector<dataset> dsets;
+      dsets.reserve(arrays.size());
+      for (auto const &a : arrays) {
+        auto const &l = get_layout(layouts, a.v, a.compress);
+        dsets.emplace_back(H5Dcreate2(g_, a.name.c_str(), a.v.ty, l.dspace, H5P_DEFAULT, l.dcpl, H5P_DEFAULT));
+        if (not dsets.back().is_valid())
+          throw std::runtime_error("Error in h5::group_writer: Creating the dataset " + a.name + " in the group " + g_.name() + " failed");
+        H5_INSTRUMENT_BYTES(instr, a.data.size());
+      }
+
+      // write the data of all non-empty datasets
+      std::vector<std::size_t> idxs;
+      for (std::size_t i = 0; i < arrays.size(); ++i) {
+        if (not arrays[i].data.empty()) idxs.push_back(i);
+      }
+#if H5_VERSION_GE(1, 14, 0)
+      if (not idxs.empty()) {
+        auto count = idxs.size();
+        std::vector<hid_t> dset_ids(count), mem_type_ids(count), spaces(count, H5S_ALL);
+        std::vector<void const *> bufs(count);
+        for (std::size_t j = 0; j < count; ++j) {
+          dset_ids[j]     = dsets[idxs[j]];
+          mem_type_ids[j] = arrays[idxs[j]].v.ty;
+          bufs[j]         = arrays[idxs[j]].data.data();
+        }
+        if (H5Dwrite_multi(count, dset_ids.data(), mem_type_ids.data(), spaces.data(), spaces.data(), H5P_DEFAULT, bufs.data()) < 0)
+          throw std::runtime_error("Error in h5::group_writer: Writing to the datasets in the group " + g_.name() + " failed");
+      }
+#else
+      for (auto i : idxs) {
+        auto const &a = arrays[i];
+        if (H5Dwrite(dsets[i], a.v.ty, H5S_ALL, H5S_ALL, H5P_DEFAULT, a.data.data()) < 0)
+          throw std::runtime_error("Error in h5::group_writer: Writing to the dataset " + a.name + " in the group " + g_.name() + " failed");
+      }
+#endif
+
+      // mark the complex datasets
+      for (std::size_t i = 0; i < arrays.size(); ++i) {
+        if (arrays[i].v.is_complex) create_string_attribute(dsets[i], "__complex__", "1", str_dt, scalar_dspace);
+      }
+
+      // create and write the string datasets
+      for (auto const &s : strings) {
+        dataset ds = H5Dcreate2(g_, s.name.c_str(), str_dt, scalar_dspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        if (not ds.is_valid())
+          throw std::runtime_error("Error in h5::group_writer: Creating the dataset " + s.name + " in the group " + g_.name() + " failed");
+        H5_INSTRUMENT_BYTES(instr, s.value.size());
+        auto *s_ptr = s.value.c_str();
+        if (H5Dwrite(ds, str_dt, H5S_ALL, H5S_ALL, H5P_DEFAULT, &s_ptr) < 0)
+          throw std::runtime_error("Error in h5::group_writer: Writing a string to the dataset " + s.name + " in the group " + g_.name() + " failed");
+      }
+    } else {
+      // write one child after the other (existing objects are unlinked or overwritten)
+      for (auto const &a : arrays) array_interface::write(g_, a.name, a.v, a.compress);
+      for (auto const &s : strings) h5_write(g_, s.name, s.value);
+    }
+
+    // create the attributes of the group
+    for (auto const &[name, value] : attributes) {
+      if (has_attributes_) {
+        h5_write_attribute(g_, name, value);
+      } else {
+        create_string_attribute(g_, name, value, str_dt, scalar_dspace);
+      }
+    }
+
+    // commit the subgroups
+    for (auto &c : children_) c->commit();
+  }
+
+} // namespace h5
@@ -0,0 +1,239 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+
+/**
+ * @file
+ * @brief Provides a writer which batches the creation of the children of an HDF5 group.
+ */
+
+#ifndef LIBH5_GROUP_WRITER_HPP
+#define LIBH5_GROUP_WRITER_HPP
+
+#include "./array_interface.hpp"
+#include "./complex.hpp"
+#include "./format.hpp"
+#include "./generic.hpp"
+#include "./group.hpp"
+#include "./scalar.hpp"
+#include "./stl/vector.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+namespace h5 {
+
+  /**
+   * @addtogroup rw_generic
+   * @{
+   */
+
+  namespace detail {
+
+    // Is T a std::vector which the h5::group_writer writes in a batch, i.e. a std::vector of arithmetic or complex types?
+    template <typename T>
+    struct _is_batched_vector : std::false_type {};
+
+    template <typename T, typename A>
+    struct _is_batched_vector<std::vector<T, A>> : std::bool_constant<(std::is_arithmetic_v<T> and not std::is_same_v<T, bool>) or is_complex_v<T>> {};
+
+    template <typename T>
+    constexpr bool is_batched_vector_v = _is_batched_vector<T>::value;
+
+  } // namespace detail
+
+  /**
+   * @brief Write the members of a user defined type to an HDF5 group in a single pass.
+   *
+   * @details A typical `h5_write` of a user defined type creates a subgroup, writes a format tag and then writes every
+   * member with a separate call to h5::write. Each of these calls checks whether the link already exists, creates its
+   * own datatypes and property lists and writes the data. The writer instead collects the members and creates them
+   * together when commit() is called:
+   * - Whether the group has any links is checked once (with `H5Gget_info`). In an empty group, the datasets and
+   * subgroups are created without checking for existing links. In a group created by the writer, the attributes are
+   * created without checking for existing attributes. Groups in files opened with
+   * h5::file_options::overwrite_in_place are never treated as empty, so that existing datasets are reused.
+   * - The string datatype and the scalar dataspace of the attributes and string datasets, as well as the dataset
+   * creation property lists of vectors with the same shape are created once per commit.
+   * - All datasets are written with a single call to `H5Dwrite_multi` (HDF5 >= 1.14).
+   *
+   * The layout in the file is the same as with h5::write. Arithmetic and complex scalars, `std::string` and
+   * `std::vector` of arithmetic or complex types are batched. Their data is copied when they are passed to the writer.
+   * All other types are written immediately with h5::write. Nested objects can use their own writer by calling
+   * subgroup():
+   *
+   * @code{.cpp}
+   * friend void h5_write(h5::group g, std::string const &name, storable const &obj) {
+   *   h5::group_writer w(g, name);
+   *   w.write_format(obj);
+   *   w.write("vec", obj.vec);
+   *   w.write("s", obj.s);
+   *   auto &sub = w.subgroup("params");
+   *   sub.write("beta", obj.beta);
+   *   w.commit(); // commits the subgroup as well
+   * }
+   * @endcode
+   *
+   * In a non-empty group, the children are written one after the other with h5::write, i.e. existing objects with the
+   * same names are unlinked or overwritten (see h5::file_options::overwrite_in_place). Every dataset/subgroup and
+   * attribute name can only be written once during the lifetime of the writer.
+   */
+  class group_writer {
+    public:
+    /**
+     * @brief Construct a writer for a new subgroup.
+     *
+     * @details The subgroup is created immediately (see h5::group::create_group), only its children are deferred.
+     *
+     * @param parent h5::group in which the subgroup is created.
+     * @param name Name of the subgroup (an existing object with the same name is unlinked).
+     */
+    group_writer(group parent, std::string const &name);
+
+    /**
+     * @brief Construct a writer for an existing group.
+     * @param g h5::group to write to (existing objects with the same names as the written ones are unlinked).
+     */
+    explicit group_writer(group g);
+
+    /// Deleted copy constructor.
+    group_writer(group_writer const &) = delete;
+
+    /// Deleted copy assignment operator.
+    group_writer &operator=(group_writer const &) = delete;
+
+    /// Destructor commits the pending children (errors are discarded, call commit() to handle them).
+    ~group_writer();
+
+    /// Get the group to which the children are written.
+    [[nodiscard]] group const &get_group() const { return g_; }
+
+    /// Get the number of pending datasets and attributes (excluding the ones of subgroup writers).
+    [[nodiscard]] std::size_t pending() const { return arrays_.size() + strings_.size() + attributes_.size(); }
+
+    /**
+     * @brief Write an object to a child of the group.
+     *
+     * @details Arithmetic and complex scalars, strings and `std::vector` of arithmetic or complex types are copied
+     * and written by commit(). All other objects are written immediately with h5::write.
+     *
+     * @tparam T Type of the object.
+     * @param name Name of the dataset/subgroup.
+     * @param x Object to be written.
+     * @return Reference to the writer.
+     */
+    template <typename T>
+    group_writer &write(std::string const &name, T const &x) {
+      add_name(name);
+      if constexpr (std::is_arithmetic_v<T> or is_complex_v<T>) {
+        add_array(name, array_interface::array_view_from_scalar(x), false);
+      } else if constexpr (std::is_convertible_v<T const &, std::string>) {
+        add_string(name, std::string(x));
+      } else if constexpr (detail::is_batched_vector_v<T>) {
+        add_array(name, array_interface::array_view_from_vector(x), true);
+      } else {
+        h5::write(g_, name, x);
+      }
+      return *this;
+    }
+
+    /**
+     * @brief Write a string attribute to the group.
+     *
+     * @details The attribute is created by commit().
+     *
+     * @param name Name of the attribute.
+     * @param value Value of the attribute.
+     * @return Reference to the writer.
+     */
+    group_writer &write_attribute(std::string const &name, std::string value);
+
+    /**
+     * @brief Write the `hdf5_format` tag of a type to the group (see h5::write_hdf5_format).
+     *
+     * @tparam T Type whose `hdf5_format` tag is written.
+     * @return Reference to the writer.
+     */
+    template <typename T>
+    group_writer &write_format(T const &) {
+      return write_attribute("Format", get_hdf5_format<T>());
+    }
+
+    /**
+     * @brief Create a subgroup and get a writer for it.
+     *
+     * @details The subgroup is created immediately. Its writer is owned by this writer and committed together with it.
+     *
+     * @param name Name of the subgroup.
+     * @return Reference to the writer of the subgroup (valid as long as this writer).
+     */
+    group_writer &subgroup(std::string const &name);
+
+    /**
+     * @brief Create and write all pending children of the group and of the subgroup writers.
+     *
+     * @details The writer can be used again afterwards.
+     */
+    void commit();
+
+    private:
+    // Pending array dataset (the view refers to the copied data).
+    struct pending_array {
+      std::string name;
+      array_interface::array_view v;
+      std::vector<std::byte> data;
+      bool compress;
+    };
+
+    // Pending string dataset or attribute.
+    struct pending_string {
+      std::string name;
+      std::string value;
+    };
+
+    // Construct a writer for a group whose content is already known.
+    group_writer(group g, bool empty, bool has_attributes);
+
+    // Remember that a dataset/subgroup name has been written (throws if it has been written before).
+    void add_name(std::string const &name);
+
+    // Copy the data of a contiguous array view and add it to the pending datasets.
+    void add_array(std::string const &name, array_interface::array_view const &v, bool compress);
+
+    // Add a pending string dataset.
+    void add_string(std::string const &name, std::string value);
+
+    private:
+    group g_;
+    bool empty_;
+    bool has_attributes_;
+    std::unordered_set<std::string> names_;
+    std::unordered_set<std::string> attribute_names_;
+    std::vector<pending_array> arrays_;
+    std::vector<pending_string> strings_;
+    std::vector<pending_string> attributes_;
+    std::vector<std::unique_ptr<group_writer>> children_;
+  };
+
+  /** @} */
+
+} // namespace h5
+
+#endif // LIBH5_GROUP_WRITER_HPP
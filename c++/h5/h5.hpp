@@ -25,17 +25,32 @@
 #include <concepts>
 
 #include "./array_interface.hpp"
+#include "./async_writer.hpp"
+#include "./chunk_io.hpp"
 #include "./complex.hpp"
+#include "./compound.hpp"
+#include "./ensemble_reader.hpp"
 #include "./file.hpp"
 #include "./format.hpp"
 #include "./generic.hpp"
 #include "./group.hpp"
+#include "./group_writer.hpp"
+#include "./lazy_dataset.hpp"
+#include "./mapped_dataset.hpp"
 #include "./object.hpp"
+#include "./prefetch_reader.hpp"
+#include "./properties.hpp"
 #include "./scalar.hpp"
+#include "./small_vector.hpp"
+#include "./scratch.hpp"
+#include "./stats.hpp"
+#include "./threading.hpp"
 #include "./utils.hpp"
+#include "./virtual_dataset.hpp"
 #include "./stl/string.hpp"
 #include "./stl/array.hpp"
 #include "./stl/vector.hpp"
+#include "./stl/contiguous_range.hpp"
 #include "./stl/map.hpp"
 #include "./stl/pair.hpp"
 #include "./stl/tuple.hpp"
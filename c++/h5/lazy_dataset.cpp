@@ -0,0 +1,87 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Implementation details for lazy_dataset.hpp.
+ */
+
+#include "./lazy_dataset.hpp"
+#include "./threading.hpp"
+
+#include <hdf5.h>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace h5 {
+
+  lazy_dataset::lazy_dataset(group g, std::string const &name)
+     : ds_(g.open_dataset(name)), info_(array_interface::get_dataset_info(ds_)), file_dspace_(H5Dget_space(ds_)) {}
+
+  lazy_dataset::lazy_dataset(group g, std::string const &name, chunk_cache_config const &cfg)
+     : ds_(g.open_dataset(name, cfg)), info_(array_interface::get_dataset_info(ds_)), file_dspace_(H5Dget_space(ds_)) {}
+
+  bool lazy_dataset::refresh() {
+    library_lock lock;
+    if (H5Drefresh(ds_) < 0) throw std::runtime_error("Error in h5::lazy_dataset::refresh: Refreshing the dataset failed");
+    auto old_shape = info_.lengths;
+    info_          = array_interface::get_dataset_info(ds_);
+    file_dspace_   = H5Dget_space(ds_);
+    return info_.lengths != old_shape;
+  }
+
+  void lazy_dataset::read(array_interface::array_view const &v_in, array_interface::hyperslab const &sl_in, transfer_options const &xfer) const {
+    library_lock lock;
+    auto v  = v_in;
+    auto sl = sl_in;
+
+    // check the memory type unless it is known to match the type in the file (i.e. no conversion and no warning)
+    if (checked_ty_.load(std::memory_order_relaxed) != v.ty) {
+      if (not array_interface::check_read_compatibility(info_, v, xfer)) checked_ty_.store(v.ty, std::memory_order_relaxed);
+    }
+    if (not sl.empty() and sl.rank() != rank())
+      throw std::runtime_error("Error in h5::lazy_dataset::read: Rank of the hyperslab " + std::to_string(sl.rank()) + " != rank of the dataset "
+                               + std::to_string(rank()));
+
+    // read complex values stored with a complex datatype (the cached info contains the additional dimension)
+    if (info_.has_complex_datatype and v.is_complex) {
+      datatype file_ty = H5Dget_type(ds_);
+      v                = array_interface::to_complex_datatype(v, H5Tget_class(file_ty) != H5T_COMPOUND);
+      sl               = array_interface::to_complex_datatype(sl);
+    }
+
+    // select the hyperslab in a copy of the cached file dataspace
+    dataspace file_dspace = H5Scopy(file_dspace_);
+    if (not sl.empty()) {
+      herr_t err = H5Sselect_hyperslab(file_dspace, H5S_SELECT_SET, sl.offset.data(), sl.stride.data(), sl.count.data(),
+                                       (sl.block.empty() ? nullptr : sl.block.data()));
+      if (err < 0 or H5Sselect_valid(file_dspace) <= 0) throw std::runtime_error("Error in h5::lazy_dataset::read: Selecting the hyperslab failed");
+    }
+    auto n_selected = static_cast<hsize_t>(H5Sget_select_npoints(file_dspace));
+    if (n_selected != v.slab.size()) throw std::runtime_error("Error in h5::lazy_dataset::read: Incompatible sizes");
+    if (n_selected == 0) return;
+
+    // memory dataspace
+    dataspace mem_dspace = array_interface::make_mem_dspace(v);
+
+    // read the selected elements
+    herr_t err = H5Dread(ds_, v.ty, mem_dspace, file_dspace, make_dataset_transfer_proplist(xfer), v.start);
+    if (err < 0) throw std::runtime_error("Error in h5::lazy_dataset::read: Reading the dataset failed");
+  }
+
+} // namespace h5
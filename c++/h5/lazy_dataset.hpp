@@ -0,0 +1,210 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Provides a proxy for an HDF5 dataset which reads selected parts of the dataset on demand.
+ */
+
+#ifndef LIBH5_LAZY_DATASET_HPP
+#define LIBH5_LAZY_DATASET_HPP
+
+#include "./array_interface.hpp"
+#include "./complex.hpp"
+#include "./group.hpp"
+#include "./object.hpp"
+#include "./properties.hpp"
+#include "./threading.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace h5 {
+
+  /**
+   * @addtogroup rw_arrayinterface
+   * @{
+   */
+
+  /**
+   * @brief Proxy for an HDF5 dataset which reads hyperslabs of the dataset on demand.
+   *
+   * @details The dataset is opened once when the proxy is constructed and its h5::array_interface::dataset_info is
+   * cached. Subsequent reads only have to select the requested hyperslab and to call `H5Dread`. Once a memory type has
+   * been found to match the type stored in the dataset, it is not checked again.
+   *
+   * This makes it possible to walk through datasets which are too large to be loaded into memory as a whole:
+   *
+   * @code{.cpp}
+   * h5::file f("data.h5", 'r');
+   * h5::lazy_dataset ds(f, "big", h5::chunk_cache_config{.nslots = 10007, .nbytes = 64 << 20});
+   * for (hsize_t i = 0; i < ds.shape()[0]; ++i) {
+   *   auto row = ds.slice<double>({i, 0}, {1, ds.shape()[1]});
+   *   process(row);
+   * }
+   * @endcode
+   *
+   * Chunks which have been read and decoded are kept in the raw data chunk cache of the dataset. Its size can be
+   * configured with an h5::chunk_cache_config.
+   *
+   * If `T` is complex, the offsets, counts and strides refer to the dataset without the additional dimension for the
+   * imaginary part.
+   *
+   * The read methods can be called concurrently from multiple threads on the same proxy. Each read holds an
+   * h5::library_lock, i.e. the reads are serialized by h5 if the HDF5 library is not thread-safe.
+   */
+  class lazy_dataset {
+    public:
+    /**
+     * @brief Open the dataset with the given name in the given group.
+     *
+     * @param g h5::group containing the dataset.
+     * @param name Name of the dataset.
+     */
+    lazy_dataset(group g, std::string const &name);
+
+    /**
+     * @brief Open the dataset with the given name in the given group and configure its chunk cache.
+     *
+     * @param g h5::group containing the dataset.
+     * @param name Name of the dataset.
+     * @param cfg h5::chunk_cache_config specifying the chunk cache settings of the dataset.
+     */
+    lazy_dataset(group g, std::string const &name, chunk_cache_config const &cfg);
+
+    /**
+     * @brief Copy constructor shares the underlying HDF5 dataset.
+     * @param x Proxy to copy.
+     */
+    lazy_dataset(lazy_dataset const &x)
+       : ds_(x.ds_), info_(x.info_), file_dspace_(x.file_dspace_), checked_ty_(x.checked_ty_.load(std::memory_order_relaxed)) {}
+
+    /**
+     * @brief Copy assignment operator shares the underlying HDF5 dataset.
+     * @param x Proxy to copy.
+     */
+    lazy_dataset &operator=(lazy_dataset const &x) {
+      ds_          = x.ds_;
+      info_        = x.info_;
+      file_dspace_ = x.file_dspace_;
+      checked_ty_.store(x.checked_ty_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      return *this;
+    }
+
+    /// Get the underlying h5::dataset.
+    [[nodiscard]] dataset const &get_dataset() const { return ds_; }
+
+    /// Get the cached h5::array_interface::dataset_info of the dataset.
+    [[nodiscard]] array_interface::dataset_info const &info() const { return info_; }
+
+    /// Get the shape of the dataset (including the possible added imaginary dimension).
+    [[nodiscard]] dims_t const &shape() const { return info_.lengths; }
+
+    /// Get the rank of the dataset (including the possible added imaginary dimension).
+    [[nodiscard]] int rank() const { return info_.rank(); }
+
+    /// Get the total number of elements in the dataset.
+    [[nodiscard]] hsize_t size() const { return std::accumulate(shape().begin(), shape().end(), hsize_t{1}, std::multiplies<>()); }
+
+    /// Check whether the dataset stores complex values.
+    [[nodiscard]] bool is_complex() const { return info_.has_complex_attribute; }
+
+    /**
+     * @brief Refresh the metadata of the dataset by calling `H5Drefresh`.
+     *
+     * @details This is needed to see the data which has been appended and flushed by a SWMR writer since the dataset
+     * has been opened (see h5::file_options::swmr). The cached h5::array_interface::dataset_info and the shape are
+     * updated. It must not be called concurrently with reads from the same proxy.
+     *
+     * @return True if the shape of the dataset has changed.
+     */
+    bool refresh();
+
+    /**
+     * @brief Read a hyperslab of the dataset into an array view.
+     *
+     * @details It checks if the number of elements in the view is the same as selected in the hyperslab and if the
+     * datatypes are compatible (see h5::array_interface::check_read_compatibility). Otherwise, an exception is thrown.
+     *
+     * @param v h5::array_interface::array_view to read into.
+     * @param sl h5::array_interface::hyperslab specifying the selection to read from (empty selects the full dataset).
+     * @param xfer h5::transfer_options specifying the data transfer mode and the type conversion policy.
+     */
+    void read(array_interface::array_view const &v, array_interface::hyperslab const &sl = {}, transfer_options const &xfer = {}) const;
+
+    /**
+     * @brief Read a strided hyperslab of the dataset into a contiguous buffer.
+     *
+     * @tparam T Value type of the buffer.
+     * @param buf Pointer to a buffer which is large enough to hold all selected elements.
+     * @param offset Offset of the hyperslab in each dimension.
+     * @param count Number of elements to read in each dimension.
+     * @param stride Stride in each dimension (defaults to 1 if empty).
+     * @param xfer h5::transfer_options specifying the data transfer mode and the type conversion policy.
+     */
+    template <typename T>
+    void read_slice(T *buf, v_t const &offset, v_t const &count, v_t const &stride = {}, transfer_options const &xfer = {}) const {
+      if (offset.size() != count.size() or (not stride.empty() and stride.size() != count.size()))
+        throw std::runtime_error("Error in h5::lazy_dataset::read_slice: Offset, count and stride must have the same size");
+
+      // hyperslab in the file and contiguous view on the buffer (the lock also guards the datatype handle)
+      library_lock lock;
+      constexpr bool cplx = is_complex_v<T>;
+      int rank            = static_cast<int>(count.size());
+      auto sl             = array_interface::hyperslab(rank, cplx);
+      std::copy(offset.begin(), offset.end(), sl.offset.begin());
+      std::copy(count.begin(), count.end(), sl.count.begin());
+      if (not stride.empty()) std::copy(stride.begin(), stride.end(), sl.stride.begin());
+      array_interface::array_view v{hdf5_type<T>(), (void *)buf, rank, cplx};
+      v.slab.count        = sl.shape();
+      v.parent_shape      = v.slab.count;
+      read(v, sl, xfer);
+    }
+
+    /**
+     * @brief Read a strided hyperslab of the dataset into a new std::vector.
+     *
+     * @tparam T Value type of the vector.
+     * @param offset Offset of the hyperslab in each dimension.
+     * @param count Number of elements to read in each dimension.
+     * @param stride Stride in each dimension (defaults to 1 if empty).
+     * @param xfer h5::transfer_options specifying the data transfer mode and the type conversion policy.
+     * @return std::vector containing the selected elements in C-order.
+     */
+    template <typename T>
+    [[nodiscard]] std::vector<T> slice(v_t const &offset, v_t const &count, v_t const &stride = {}, transfer_options const &xfer = {}) const {
+      std::vector<T> res(std::accumulate(count.begin(), count.end(), hsize_t{1}, std::multiplies<>()));
+      read_slice(res.data(), offset, count, stride, xfer);
+      return res;
+    }
+
+    private:
+    dataset ds_;
+    array_interface::dataset_info info_;
+    dataspace file_dspace_;
+    mutable std::atomic<hid_t> checked_ty_ = -1;
+  };
+
+  /** @} */
+
+} // namespace h5
+
+#endif // LIBH5_LAZY_DATASET_HPP
@@ -0,0 +1,153 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Implementation details for mapped_dataset.hpp.
+ */
+
+#include "./mapped_dataset.hpp"
+#include "./threading.hpp"
+
+#include <hdf5.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace h5 {
+
+  namespace {
+
+    // Get the name of the file containing an HDF5 object.
+    std::string get_file_name(hid_t obj) {
+      auto len = H5Fget_name(obj, nullptr, 0);
+      if (len < 0) throw std::runtime_error("Error in h5::mapped_dataset: Getting the file name failed");
+      std::string res(len, '\0');
+      H5Fget_name(obj, res.data(), len + 1);
+      return res;
+    }
+
+    // Throw an exception with a given message and the description of errno.
+    [[noreturn]] void throw_errno(std::string const &msg) {
+      throw std::runtime_error("Error in h5::mapped_dataset: " + msg + " (" + std::strerror(errno) + ")");
+    }
+
+  } // namespace
+
+  mapped_dataset::mapped_dataset(group g, std::string const &name) {
+    library_lock lock;
+    dataset ds = g.open_dataset(name);
+
+    // only datasets with a contiguous layout in the file can be mapped
+    proplist dcpl = H5Dget_create_plist(ds);
+    if (H5Pget_layout(dcpl) != H5D_CONTIGUOUS or H5Pget_external_count(dcpl) != 0)
+      throw std::runtime_error("Error in h5::mapped_dataset: The dataset " + name + " does not have a contiguous layout");
+
+    // the data of files opened with other drivers (e.g. memory files) is not located in a file on disk
+    object f      = H5Iget_file_id(ds);
+    proplist fapl = H5Fget_access_plist(f);
+    if (H5Pget_driver(fapl) != H5FD_SEC2)
+      throw std::runtime_error("Error in h5::mapped_dataset: The file containing " + name + " has not been opened with the default driver");
+
+    // datatype, shape and total size of the raw data
+    ty_ = H5Dget_type(ds);
+    if (H5Tis_variable_str(ty_) > 0 or H5Tdetect_class(ty_, H5T_VLEN) > 0)
+      throw std::runtime_error("Error in h5::mapped_dataset: The dataset " + name + " contains variable-length data");
+    dataspace dspace = H5Dget_space(ds);
+    shape_.resize(H5Sget_simple_extent_ndims(dspace));
+    H5Sget_simple_extent_dims(dspace, shape_.data(), nullptr);
+    is_complex_ = (H5Aexists(ds, "__complex__") > 0);
+    nbytes_     = std::accumulate(shape_.begin(), shape_.end(), hsize_t{1}, std::multiplies<>()) * H5Tget_size(ty_);
+    if (nbytes_ == 0) return;
+
+    // the storage has to be allocated
+    haddr_t offset = H5Dget_offset(ds);
+    if (offset == HADDR_UNDEF) throw std::runtime_error("Error in h5::mapped_dataset: The storage of the dataset " + name + " has not been allocated");
+
+    // make sure that the raw data has been written to the file
+    unsigned intent = 0;
+    if (H5Fget_intent(f, &intent) >= 0 and (intent & H5F_ACC_RDWR) and H5Fflush(f, H5F_SCOPE_LOCAL) < 0)
+      throw std::runtime_error("Error in h5::mapped_dataset: Flushing the file failed");
+
+    // map the pages containing the raw data
+    auto fname = get_file_name(f);
+    int fd     = ::open(fname.c_str(), O_RDONLY);
+    if (fd < 0) throw_errno("Opening the file " + fname + " failed");
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 or static_cast<std::size_t>(st.st_size) < offset + nbytes_) {
+      ::close(fd);
+      throw std::runtime_error("Error in h5::mapped_dataset: The raw data of the dataset " + name + " exceeds the size of the file");
+    }
+    auto page_size = static_cast<haddr_t>(::sysconf(_SC_PAGESIZE));
+    auto start     = offset - offset % page_size;
+    map_len_       = nbytes_ + (offset - start);
+    void *addr     = ::mmap(nullptr, map_len_, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(start));
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+      map_len_ = 0;
+      throw_errno("Mapping the dataset " + name + " failed");
+    }
+    map_addr_ = addr;
+    data_     = static_cast<std::byte const *>(addr) + (offset - start);
+  }
+
+  void mapped_dataset::unmap() {
+    if (map_addr_ != nullptr) ::munmap(map_addr_, map_len_);
+    map_addr_ = nullptr;
+    map_len_  = 0;
+    data_     = nullptr;
+    nbytes_   = 0;
+  }
+
+  void mapped_dataset::swap(mapped_dataset &x) noexcept {
+    std::swap(map_addr_, x.map_addr_);
+    std::swap(map_len_, x.map_len_);
+    std::swap(data_, x.data_);
+    std::swap(nbytes_, x.nbytes_);
+    std::swap(ty_, x.ty_);
+    std::swap(shape_, x.shape_);
+    std::swap(is_complex_, x.is_complex_);
+  }
+
+  void mapped_dataset::check_type(datatype const &mem_ty, bool cplx, std::size_t elem_size) const {
+    library_lock lock;
+    if (not ty_.is_valid()) throw std::runtime_error("Error in h5::mapped_dataset::as_span: The mapping is empty");
+
+    // complex values are stored either as real values with a trailing dimension of size 2 or with a compound datatype
+    auto code     = get_type_code(ty_);
+    auto mem_code = get_type_code(mem_ty);
+    bool ok       = false;
+    if (cplx) {
+      ok = (is_complex_ and code == mem_code) or (not is_complex_ and code == type_code::complex_compound and mem_code == type_code::float64);
+    } else {
+      bool classified = (code != type_code::unknown and code != type_code::compound);
+      ok              = not is_complex_ and (classified ? code == mem_code : H5Tequal(ty_, mem_ty) > 0);
+    }
+    if (not ok or nbytes_ % elem_size != 0)
+      throw std::runtime_error("Error in h5::mapped_dataset::as_span: The datatype of the dataset is not compatible with the requested type");
+  }
+
+} // namespace h5
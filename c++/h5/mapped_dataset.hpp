@@ -0,0 +1,172 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Provides read-only, memory-mapped access to contiguous HDF5 datasets.
+ */
+
+#ifndef LIBH5_MAPPED_DATASET_HPP
+#define LIBH5_MAPPED_DATASET_HPP
+
+#include "./complex.hpp"
+#include "./group.hpp"
+#include "./object.hpp"
+#include "./utils.hpp"
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <utility>
+
+namespace h5 {
+
+  /**
+   * @addtogroup rw_arrayinterface
+   * @{
+   */
+
+  /**
+   * @brief Read-only memory mapping of the raw data of a contiguous HDF5 dataset.
+   *
+   * @details The raw data of a dataset with a contiguous layout (the default layout of h5::array_interface::write
+   * without any chunking or filters) is stored as a single block of bytes in the file. This class maps this block into
+   * the address space of the process with `mmap`. The data is then read lazily by the operating system when it is
+   * accessed and is cached in the page cache, i.e. there is neither an `H5Dread` nor a copy into a separate buffer:
+   *
+   * @code{.cpp}
+   * h5::file f("data.h5", 'r');
+   * auto m = h5::map_dataset(f, "big");
+   * std::span<double const> data = m.as_span<double>();
+   * double sum = std::accumulate(data.begin(), data.end(), 0.0);
+   * @endcode
+   *
+   * The dataset has to be stored in a file on disk which has been opened with the default (`H5FD_SEC2`) driver. Its
+   * storage has to be allocated and its datatype must not contain variable-length data. If the file has been opened in
+   * read-write mode, it is flushed before the data is mapped.
+   *
+   * The mapping stays valid after the file and the dataset have been closed. It reflects later writes to the dataset
+   * only as long as the dataset is not moved within the file, e.g. by recreating it.
+   *
+   * The data is interpreted in the byte order of the file. h5::mapped_dataset::as_span therefore requires the datatype
+   * of the dataset to be a native type (see h5::get_type_code).
+   */
+  class mapped_dataset {
+    public:
+    /// Default constructor creates an empty mapping.
+    mapped_dataset() = default;
+
+    /**
+     * @brief Map the raw data of the dataset with the given name in the given group.
+     *
+     * @details Throws an exception if the dataset cannot be mapped.
+     *
+     * @param g h5::group containing the dataset.
+     * @param name Name of the dataset.
+     */
+    mapped_dataset(group g, std::string const &name);
+
+    /// Copying is not allowed.
+    mapped_dataset(mapped_dataset const &) = delete;
+
+    /// Copy assignment is not allowed.
+    mapped_dataset &operator=(mapped_dataset const &) = delete;
+
+    /**
+     * @brief Move constructor takes over the mapping.
+     * @param x Mapping to move.
+     */
+    mapped_dataset(mapped_dataset &&x) noexcept { swap(x); }
+
+    /**
+     * @brief Move assignment operator releases the current mapping and takes over the other one.
+     * @param x Mapping to move.
+     */
+    mapped_dataset &operator=(mapped_dataset &&x) noexcept {
+      mapped_dataset tmp{std::move(x)};
+      swap(tmp);
+      return *this;
+    }
+
+    /// Destructor unmaps the data.
+    ~mapped_dataset() { unmap(); }
+
+    /// Unmap the data (the object is empty afterwards).
+    void unmap();
+
+    /// Get the h5::datatype of the dataset.
+    [[nodiscard]] datatype const &type() const { return ty_; }
+
+    /// Get the shape of the dataset (including the possible added imaginary dimension).
+    [[nodiscard]] v_t const &shape() const { return shape_; }
+
+    /// Check whether the dataset stores complex values.
+    [[nodiscard]] bool is_complex() const { return is_complex_; }
+
+    /// Get a pointer to the mapped raw data.
+    [[nodiscard]] std::byte const *data() const { return data_; }
+
+    /// Get the size of the mapped raw data in bytes.
+    [[nodiscard]] std::size_t size_bytes() const { return nbytes_; }
+
+    /**
+     * @brief Get a typed view of the mapped raw data.
+     *
+     * @details The elements are in C-order. An exception is thrown if the datatype of the dataset does not have the
+     * same binary representation as `T`. A complex `T` is compatible with real datasets which have a `__complex__`
+     * attribute and with compound complex datatypes.
+     *
+     * @tparam T Value type.
+     * @return std::span over the elements of the dataset.
+     */
+    template <typename T>
+    [[nodiscard]] std::span<T const> as_span() const {
+      check_type(hdf5_type<T>(), is_complex_v<T>, sizeof(T));
+      return {reinterpret_cast<T const *>(data_), nbytes_ / sizeof(T)}; // NOLINT (the bytes are elements of type T)
+    }
+
+    private:
+    // Throw an exception if the elements cannot be viewed as a given memory type.
+    void check_type(datatype const &mem_ty, bool cplx, std::size_t elem_size) const;
+
+    // Swap the mappings of two objects.
+    void swap(mapped_dataset &x) noexcept;
+
+    void *map_addr_ = nullptr;
+    std::size_t map_len_ = 0;
+    std::byte const *data_ = nullptr;
+    std::size_t nbytes_ = 0;
+    datatype ty_;
+    v_t shape_;
+    bool is_complex_ = false;
+  };
+
+  /**
+   * @brief Map the raw data of a contiguous dataset into memory.
+   *
+   * @details See h5::mapped_dataset for more details.
+   *
+   * @param g h5::group containing the dataset.
+   * @param name Name of the dataset.
+   * @return h5::mapped_dataset.
+   */
+  [[nodiscard]] inline mapped_dataset map_dataset(group g, std::string const &name) { return {g, name}; }
+
+  /** @} */
+
+} // namespace h5
+
+#endif // LIBH5_MAPPED_DATASET_HPP
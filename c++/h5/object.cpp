@@ -30,7 +30,10 @@
 #include <H5Ppublic.h>
 
 #include <algorithm>
+#include <array>
 #include <complex>
+#include <cstddef>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -61,12 +64,9 @@ namespace h5 {
       std::string name;
     };
 
-    // table of HDF5 datatypes and their names
-    std::vector<h5_name_t> h5_name_table; // NOLINT (global variable is in an unnamed namespace)
-
-    // initialize the table of HDF5 datatypes and their names
-    void init_h5_name_table() {
-      h5_name_table = std::vector<h5_name_t>{
+    // table of HDF5 datatypes and their names (initialized once in a thread-safe way)
+    std::vector<h5_name_t> const &h5_name_table() {
+      static std::vector<h5_name_t> const table{
          {hdf5_type<char>(), H5_AS_STRING(char)},
          {hdf5_type<signed char>(), H5_AS_STRING(signed char)},
          {hdf5_type<unsigned char>(), H5_AS_STRING(unsigned char)},
@@ -88,6 +88,7 @@ namespace h5 {
          {hdf5_type<std::string>(), H5_AS_STRING(std::string)},
          {hdf5_type<dcplx_t>(), "Complex Compound Datatype"} //
       };
+      return table;
     }
 
   } // namespace
@@ -168,25 +169,121 @@ namespace h5 {
     template <> hid_t hid_t_of<dcplx_t>  (){return  detail::cplx_cmpd_dt;}
     // clang-format on
 
-    // custom HDF5 datatype for bool (use a lambda to initialize it?)
+    // custom HDF5 datatype for bool (created only once)
     template <>
     hid_t hid_t_of<bool>() {
-      hid_t bool_enum_h5type = H5Tenum_create(H5T_NATIVE_CHAR);
-      char val               = 0;
-      H5Tenum_insert(bool_enum_h5type, "FALSE", (val = 0, &val));
-      H5Tenum_insert(bool_enum_h5type, "TRUE", (val = 1, &val));
+      static hid_t const bool_enum_h5type = []() {
+        hid_t dt = H5Tenum_create(H5T_NATIVE_CHAR);
+        char val = 0;
+        H5Tenum_insert(dt, "FALSE", (val = 0, &val));
+        H5Tenum_insert(dt, "TRUE", (val = 1, &val));
+        H5Tlock(dt);
+        return dt;
+      }();
       return bool_enum_h5type;
     }
 
+    datatype fixed_string_type(std::size_t size) {
+      // create a new datatype
+      auto make_type = [size]() {
+        datatype dt = H5Tcopy(H5T_C_S1);
+        if (not dt.is_valid() or H5Tset_size(dt, size) < 0 or H5Tset_cset(dt, H5T_CSET_UTF8) < 0)
+          throw std::runtime_error("Error in h5::detail::fixed_string_type: Creating the string datatype failed");
+        return dt;
+      };
+
+      // datatypes for small sizes are locked and cached (they are never closed)
+      constexpr std::size_t max_cached_size = 256;
+      if (size > max_cached_size) return make_type();
+      static std::mutex mtx;
+      static std::array<hid_t, max_cached_size + 1> cache{};
+      std::lock_guard lock{mtx};
+      if (cache[size] <= 0) {
+        auto dt = make_type();
+        if (H5Tlock(dt) < 0) throw std::runtime_error("Error in h5::detail::fixed_string_type: Locking the string datatype failed");
+        cache[size] = dt;
+        H5Iinc_ref(cache[size]);
+      }
+      return object::from_borrowed(cache[size]);
+    }
+
+    datatype str_dtype(std::size_t size) {
+      static_assert(H5T_VARIABLE == static_cast<std::size_t>(-1), "The default size of h5::detail::str_dtype has to be H5T_VARIABLE");
+      return size == H5T_VARIABLE ? hdf5_type<std::string>() : fixed_string_type(size);
+    }
+
+    dataspace scalar_dataspace() {
+      static hid_t const dspace = H5Screate(H5S_SCALAR);
+      if (dspace < 0) throw std::runtime_error("Error in h5::detail::scalar_dataspace: Creating the scalar dataspace failed");
+      return object::from_borrowed(dspace);
+    }
+
   } // namespace detail
 
+  type_code get_type_code(datatype const &dt) {
+    auto size = H5Tget_size(dt);
+    switch (H5Tget_class(dt)) {
+      case H5T_INTEGER: {
+        if (H5Tget_order(dt) != H5Tget_order(H5T_NATIVE_INT) or H5Tget_precision(dt) != 8 * size) return type_code::unknown;
+        bool is_signed = (H5Tget_sign(dt) == H5T_SGN_2);
+        switch (size) {
+          case 1: return is_signed ? type_code::int8 : type_code::uint8;
+          case 2: return is_signed ? type_code::int16 : type_code::uint16;
+          case 4: return is_signed ? type_code::int32 : type_code::uint32;
+          case 8: return is_signed ? type_code::int64 : type_code::uint64;
+          default: return type_code::unknown;
+        }
+      }
+      case H5T_FLOAT: {
+        if (H5Tget_order(dt) != H5Tget_order(H5T_NATIVE_DOUBLE)) return type_code::unknown;
+        if (size == sizeof(float) and H5Tget_precision(dt) == 32) return type_code::float32;
+        if (size == sizeof(double) and H5Tget_precision(dt) == 64) return type_code::float64;
+        if (size == sizeof(long double) and H5Tget_precision(dt) == H5Tget_precision(H5T_NATIVE_LDOUBLE)) return type_code::long_double;
+        return type_code::unknown;
+      }
+      case H5T_ENUM: return (size == 1 and H5Tequal(dt, hdf5_type<bool>()) > 0 ? type_code::boolean : type_code::unknown);
+      case H5T_STRING: return type_code::string;
+      case H5T_COMPOUND: {
+        // the complex compound type has two double members "r" and "i"
+        if (size != 2 * sizeof(double) or H5Tget_nmembers(dt) != 2) return type_code::compound;
+        if (H5Tget_member_index(dt, "r") != 0 or H5Tget_member_index(dt, "i") != 1) return type_code::compound;
+        datatype r = H5Tget_member_type(dt, 0), i = H5Tget_member_type(dt, 1);
+        bool is_dbl = (get_type_code(r) == type_code::float64 and get_type_code(i) == type_code::float64);
+        return (is_dbl ? type_code::complex_compound : type_code::compound);
+      }
+      default: return type_code::unknown;
+    }
+  }
+
   std::string get_name_of_h5_type(datatype dt) {
-    // initialize name table if it has not been done yet
-    if (h5_name_table.empty()) init_h5_name_table();
+    // names of the classified types (the first entry in the table with a given code wins)
+    static auto const names = []() {
+      std::array<std::string, static_cast<std::size_t>(type_code::compound) + 1> res;
+      for (auto const &x : h5_name_table()) {
+        auto &name = res[static_cast<std::size_t>(get_type_code(x.hdf5_type))];
+        if (name.empty()) name = x.name;
+      }
+      res[static_cast<std::size_t>(type_code::unknown)].clear();
+      res[static_cast<std::size_t>(type_code::compound)].clear();
+      return res;
+    }();
+    if (auto const &name = names[static_cast<std::size_t>(get_type_code(dt))]; not name.empty()) return name;
 
     // find name in table
-    auto _end = h5_name_table.end();
-    auto pos  = std::find_if(h5_name_table.begin(), _end, [dt](auto const &x) { return hdf5_type_equal(dt, x.hdf5_type); });
+    auto const &table = h5_name_table();
+    auto _end         = table.end();
+    auto pos          = std::find_if(table.begin(), _end, [dt](auto const &x) { return hdf5_type_equal(dt, x.hdf5_type); });
+
+    // compound types are described by the names of their members
+    if (pos == _end and H5Tget_class(dt) == H5T_COMPOUND) {
+      std::string res = "compound{";
+      for (int i = 0; i < H5Tget_nmembers(dt); ++i) {
+        char *name = H5Tget_member_name(dt, i);
+        res += (i > 0 ? ", " : "") + std::string{name};
+        H5free_memory(name);
+      }
+      return res + "}";
+    }
 
     // return name if found, otherwise throw an exception
     if (pos == _end) throw std::logic_error("Error in h5::get_name_of_h5_type: datatype not supported");
@@ -24,6 +24,8 @@
 
 #include "./utils.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace h5 {
@@ -144,19 +146,72 @@ namespace h5 {
     template <typename T>
     hid_t hid_t_of();
 
+    // Get a locked HDF5 datatype for fixed-length UTF-8 strings of the given size (small sizes are created only once).
+    [[nodiscard]] datatype fixed_string_type(std::size_t size);
+
+    // Get the datatype for fixed-length strings of the given size or for variable-length strings if size is
+    // H5T_VARIABLE (the datatypes must not be modified).
+    [[nodiscard]] datatype str_dtype(std::size_t size = static_cast<std::size_t>(-1));
+
+    // Get a scalar HDF5 dataspace which is created only once (it must not be modified).
+    [[nodiscard]] dataspace scalar_dataspace();
+
   } // namespace detail
 
   /**
    * @brief Map a given C++ type to an HDF5 datatype.
    *
+   * @details Types which have been registered with H5_COMPOUND are mapped to their HDF5 compound datatype.
+   *
    * @tparam T C++ type.
    * @return h5::datatype object corresponding to the given C++ type.
    */
   template <typename T>
   [[nodiscard]] datatype hdf5_type() {
-    return object::from_borrowed(detail::hid_t_of<T>());
+    if constexpr (requires(T const *p) { h5_compound_type(p); }) {
+      return object::from_borrowed(h5_compound_type(static_cast<T const *>(nullptr)));
+    } else {
+      return object::from_borrowed(detail::hid_t_of<T>());
+    }
   }
 
+  /// Compact classification of the HDF5 datatypes supported by h5 (see h5::get_type_code).
+  enum class type_code : std::uint8_t {
+    unknown,
+    int8,
+    uint8,
+    int16,
+    uint16,
+    int32,
+    uint32,
+    int64,
+    uint64,
+    float32,
+    float64,
+    long_double,
+    boolean,
+    string,
+    complex_compound,
+    compound
+  };
+
+  /**
+   * @brief Classify an HDF5 datatype.
+   *
+   * @details The classification only queries the class, size, sign, precision and byte order of the datatype, i.e. it
+   * requires a few cheap HDF5 calls. Integer and floating point types are only recognized if they have the native byte
+   * order and use all their bits. Enums are only classified as booleans if they are equal to the h5 bool type (see
+   * h5::hdf5_type) and compound types with the two double members "r" and "i" as h5::type_code::complex_compound.
+   *
+   * Two numeric, boolean or complex compound datatypes with the same code can be converted into each other without any
+   * loss (HDF5 only has to copy the bytes). This does not hold for h5::type_code::string, since strings may differ in
+   * their size, padding and character set.
+   *
+   * @param dt h5::datatype.
+   * @return h5::type_code of the datatype.
+   */
+  [[nodiscard]] type_code get_type_code(datatype const &dt);
+
   /**
    * @brief Get the name of an h5::datatype (for error messages).
    *
@@ -0,0 +1,219 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Provides a reader which prefetches a sequence of datasets on a dedicated I/O thread.
+ */
+
+#ifndef LIBH5_PREFETCH_READER_HPP
+#define LIBH5_PREFETCH_READER_HPP
+
+#include "./generic.hpp"
+#include "./group.hpp"
+#include "./threading.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace h5 {
+
+  /**
+   * @addtogroup rw_async
+   * @{
+   */
+
+  /**
+   * @brief Read a sequence of datasets/subgroups of an HDF5 group ahead of time on a dedicated I/O thread.
+   *
+   * @details The reader reads the objects with the given names in order with h5::read into a bounded pool of
+   * `depth + 1` buffers. While the caller works on the current object, the I/O thread reads up to `depth` of the
+   * following ones. A buffer is returned to the pool when the caller requests the next object and is then reused for
+   * one of the following reads, e.g. an `std::vector` keeps its capacity. The memory usage therefore stays constant,
+   * no matter how many objects are read:
+   *
+   * @code{.cpp}
+   * h5::file f("results.h5", 'r');
+   * h5::prefetch_reader<std::vector<double>> reader(f, 4);
+   * while (auto const *e = reader.next()) {
+   *   process(e->name, e->value); // the next 4 datasets are read in the meantime
+   * }
+   * @endcode
+   *
+   * Exceptions thrown while reading an object are rethrown by the call to next() which would return it. The reader can
+   * be used to continue with the following objects afterwards.
+   *
+   * If the HDF5 library is not thread-safe (see `H5is_library_threadsafe`), no I/O thread is started and each object
+   * is read synchronously by next().
+   *
+   * @tparam T Type of the objects (has to be default constructible and readable with h5::read).
+   */
+  template <typename T>
+  class prefetch_reader {
+    public:
+    /// An object read from the group together with its name.
+    struct entry {
+      /// Name of the dataset/subgroup.
+      std::string name;
+
+      /// Value read from the dataset/subgroup.
+      T value;
+    };
+
+    /**
+     * @brief Construct a reader for the given objects in the given group and start prefetching them.
+     *
+     * @param g h5::group containing the objects.
+     * @param names Names of the datasets/subgroups in the order in which they are returned.
+     * @param depth Maximum number of objects which are read ahead of the current one (has to be > 0).
+     */
+    prefetch_reader(group g, std::vector<std::string> names, std::size_t depth = 2)
+       : g_(std::move(g)), names_(std::move(names)), slots_(std::max(depth, std::size_t{1}) + 1) {
+      for (std::size_t i = 0; i < slots_.size(); ++i) free_.push_back(i);
+      if (is_library_threadsafe() and not names_.empty()) thread_ = std::thread([this]() { run(); });
+    }
+
+    /**
+     * @brief Construct a reader for all datasets in the given group (see h5::group::get_all_dataset_names).
+     *
+     * @param g h5::group containing the datasets.
+     * @param depth Maximum number of datasets which are read ahead of the current one (has to be > 0).
+     */
+    explicit prefetch_reader(group g, std::size_t depth = 2) : prefetch_reader(g, g.get_all_dataset_names(), depth) {}
+
+    /// Deleted copy constructor.
+    prefetch_reader(prefetch_reader const &) = delete;
+
+    /// Deleted copy assignment operator.
+    prefetch_reader &operator=(prefetch_reader const &) = delete;
+
+    /// Destructor stops the I/O thread after the current read has finished.
+    ~prefetch_reader() {
+      {
+        std::lock_guard lock(mtx_);
+        stop_ = true;
+      }
+      cv_.notify_all();
+      if (thread_.joinable()) thread_.join();
+    }
+
+    /// Check whether the objects are read on a background thread.
+    [[nodiscard]] bool is_async() const { return thread_.joinable(); }
+
+    /// Get the total number of objects.
+    [[nodiscard]] std::size_t size() const { return names_.size(); }
+
+    /**
+     * @brief Get the next object.
+     *
+     * @details It blocks until the next object has been read and releases the buffer of the previous one.
+     *
+     * @return Pointer to the next h5::prefetch_reader::entry (valid until the next call) or a `nullptr` if all objects
+     * have been returned.
+     */
+    entry const *next() {
+      std::unique_lock lock(mtx_);
+
+      // release the buffer of the previous object
+      if (current_ < slots_.size()) {
+        free_.push_back(std::exchange(current_, slots_.size()));
+        cv_.notify_all();
+      }
+      if (consumed_ == names_.size()) return nullptr;
+
+      // read the next object synchronously if there is no I/O thread
+      if (not is_async()) {
+        auto idx = free_.front();
+        free_.pop_front();
+        load(consumed_, slots_[idx]);
+        ready_.push_back(idx);
+      }
+
+      // wait for the next object
+      cv_.wait(lock, [this]() { return not ready_.empty(); });
+      current_ = ready_.front();
+      ready_.pop_front();
+      ++consumed_;
+      auto &s = slots_[current_];
+      if (s.error) std::rethrow_exception(std::exchange(s.error, nullptr));
+      return &s.e;
+    }
+
+    private:
+    // Buffer in the pool.
+    struct slot {
+      entry e;
+      std::exception_ptr error;
+    };
+
+    // Read the object with the given index into a buffer.
+    void load(std::size_t i, slot &s) {
+      s.e.name = names_[i];
+      try {
+        h5::read(g_, s.e.name, s.e.value);
+      } catch (...) { s.error = std::current_exception(); }
+    }
+
+    // Main loop of the I/O thread.
+    void run() {
+      for (std::size_t i = 0; i < names_.size(); ++i) {
+        // wait for a free buffer
+        std::size_t idx = 0;
+        {
+          std::unique_lock lock(mtx_);
+          cv_.wait(lock, [this]() { return stop_ or not free_.empty(); });
+          if (stop_) return;
+          idx = free_.front();
+          free_.pop_front();
+        }
+
+        // read the object and pass it to the consumer
+        load(i, slots_[idx]);
+        {
+          std::lock_guard lock(mtx_);
+          ready_.push_back(idx);
+        }
+        cv_.notify_all();
+      }
+    }
+
+    private:
+    group g_;
+    std::vector<std::string> names_;
+    std::vector<slot> slots_;
+    std::deque<std::size_t> free_;
+    std::deque<std::size_t> ready_;
+    std::size_t current_  = slots_.size();
+    std::size_t consumed_ = 0;
+    bool stop_            = false;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::thread thread_;
+  };
+
+  /** @} */
+
+} // namespace h5
+
+#endif // LIBH5_PREFETCH_READER_HPP
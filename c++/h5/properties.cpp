@@ -0,0 +1,296 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Implementation details for properties.hpp.
+ */
+
+#include "./properties.hpp"
+#include "./macros.hpp"
+
+#include <hdf5.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace h5 {
+
+  namespace {
+
+    // Get the chunk shape for a dataset of the given shape and element size.
+    v_t get_chunk_shape(write_options const &opts, v_t const &shape, hsize_t elem_size, bool is_complex) {
+      int rank = static_cast<int>(shape.size());
+
+      // user defined chunk shape
+      if (not opts.chunk_shape.empty()) {
+        auto chunk_shape = opts.chunk_shape;
+        if (is_complex and static_cast<int>(chunk_shape.size()) == rank - 1) chunk_shape.push_back(2);
+        if (static_cast<int>(chunk_shape.size()) != rank)
+          throw std::runtime_error("Error in h5::make_dataset_create_proplist: Rank of the chunk shape " + std::to_string(chunk_shape.size())
+                                   + " != rank of the dataset " + std::to_string(rank));
+        if (std::any_of(chunk_shape.begin(), chunk_shape.end(), [](auto c) { return c == 0; }))
+          throw std::runtime_error("Error in h5::make_dataset_create_proplist: Chunk dimensions have to be > 0");
+        return chunk_shape;
+      }
+
+      // clamp each dimension such that a chunk does not exceed 4 GB
+      v_t chunk_shape(rank);
+      hsize_t const max_chunk_size = hsize_t{1UL << 32} - hsize_t{1}; // 2^32 - 1 = 4 GB
+      hsize_t chunk_size           = elem_size;
+      for (int i = rank - 1; i >= 0; --i) {
+        H5_ASSERT(max_chunk_size >= chunk_size);
+        hsize_t max_dim = max_chunk_size / chunk_size;
+        chunk_shape[i]  = std::clamp(shape[i], hsize_t{1}, max_dim);
+        chunk_size *= chunk_shape[i];
+      }
+      if (opts.chunk_bytes == 0) return chunk_shape;
+
+      // halve the dimensions (except for the imaginary part) in a round-robin fashion until the target size is reached
+      int n_dims = rank - is_complex;
+      for (int i = 0; chunk_size > opts.chunk_bytes and n_dims > 0; i = (i + 1) % n_dims) {
+        if (std::all_of(chunk_shape.begin(), chunk_shape.begin() + n_dims, [](auto c) { return c == 1; })) break;
+        if (chunk_shape[i] == 1) continue;
+        auto new_dim = (chunk_shape[i] + 1) / 2;
+        chunk_size   = chunk_size / chunk_shape[i] * new_dim;
+        chunk_shape[i] = new_dim;
+      }
+      return chunk_shape;
+    }
+
+    // Convert a file format version to the corresponding HDF5 library version.
+    H5F_libver_t to_hdf5_libver(file_options::libver v) {
+      switch (v) {
+        case file_options::libver::earliest: return H5F_LIBVER_EARLIEST;
+        case file_options::libver::v18: return H5F_LIBVER_V18;
+        case file_options::libver::v110: return H5F_LIBVER_V110;
+        case file_options::libver::latest: return H5F_LIBVER_LATEST;
+      }
+      return H5F_LIBVER_LATEST;
+    }
+
+  } // namespace
+
+  proplist make_file_access_proplist(file_options const &opts) {
+    proplist fapl = H5Pcreate(H5P_FILE_ACCESS);
+    if (!fapl.is_valid()) throw std::runtime_error("Error in h5::make_file_access_proplist: Creating the property list failed");
+
+    // raw data chunk cache (the number of metadata cache elements is ignored by HDF5)
+    if (opts.chunk_cache) {
+      auto const &cc = *opts.chunk_cache;
+      if (H5Pset_cache(fapl, 0, cc.nslots, cc.nbytes, cc.w0) < 0)
+        throw std::runtime_error("Error in h5::make_file_access_proplist: Setting the chunk cache failed");
+    }
+
+    // metadata cache
+    if (opts.metadata_cache) {
+      auto const &mc = *opts.metadata_cache;
+      H5AC_cache_config_t config;
+      config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+      if (H5Pget_mdc_config(fapl, &config) < 0)
+        throw std::runtime_error("Error in h5::make_file_access_proplist: Getting the metadata cache config failed");
+      if (mc.initial_size > 0) {
+        config.set_initial_size = true;
+        config.initial_size     = mc.initial_size;
+      }
+      if (mc.min_size > 0) config.min_size = mc.min_size;
+      if (mc.max_size > 0) config.max_size = mc.max_size;
+      config.min_size = std::min(config.min_size, config.initial_size);
+      config.max_size = std::max(config.max_size, config.initial_size);
+      if (H5Pset_mdc_config(fapl, &config) < 0)
+        throw std::runtime_error("Error in h5::make_file_access_proplist: Setting the metadata cache config failed");
+    }
+
+    // alignment
+    if (opts.alignment > 1 and H5Pset_alignment(fapl, opts.alignment_threshold, opts.alignment) < 0)
+      throw std::runtime_error("Error in h5::make_file_access_proplist: Setting the alignment failed");
+
+    // file format versions (SWMR access requires at least the 1.10 format)
+    auto low = (opts.swmr ? std::max(opts.libver_low, file_options::libver::v110) : opts.libver_low);
+    if (low > opts.libver_high)
+      throw std::runtime_error("Error in h5::make_file_access_proplist: The low bound of the file format is above the high bound");
+    if ((low != file_options::libver::earliest or opts.libver_high != file_options::libver::latest)
+        and H5Pset_libver_bounds(fapl, to_hdf5_libver(low), to_hdf5_libver(opts.libver_high)) < 0)
+      throw std::runtime_error("Error in h5::make_file_access_proplist: Setting the library version bounds failed");
+
+    // page buffer
+    if (opts.page_buffer_size > 0 and H5Pset_page_buffer_size(fapl, opts.page_buffer_size, 0, 0) < 0)
+      throw std::runtime_error("Error in h5::make_file_access_proplist: Setting the page buffer size failed");
+
+    return fapl;
+  }
+
+  proplist make_file_create_proplist(file_options const &opts) {
+    using strategy = file_options::file_space_strategy;
+    if (opts.fs_strategy == strategy::library_default and not opts.persist_free_space and opts.free_space_threshold == 0
+        and opts.file_space_page_size == 0)
+      return proplist{H5P_DEFAULT};
+
+    proplist fcpl = H5Pcreate(H5P_FILE_CREATE);
+    if (!fcpl.is_valid()) throw std::runtime_error("Error in h5::make_file_create_proplist: Creating the property list failed");
+
+    // file space strategy, persistence and threshold (unset values keep their defaults)
+    H5F_fspace_strategy_t fs_strategy = H5F_FSPACE_STRATEGY_FSM_AGGR;
+    hbool_t persist                   = 0;
+    hsize_t threshold                 = 1;
+    if (H5Pget_file_space_strategy(fcpl, &fs_strategy, &persist, &threshold) < 0)
+      throw std::runtime_error("Error in h5::make_file_create_proplist: Getting the file space strategy failed");
+    switch (opts.fs_strategy) {
+      case strategy::library_default: break;
+      case strategy::fsm_aggr: fs_strategy = H5F_FSPACE_STRATEGY_FSM_AGGR; break;
+      case strategy::page: fs_strategy = H5F_FSPACE_STRATEGY_PAGE; break;
+      case strategy::aggr: fs_strategy = H5F_FSPACE_STRATEGY_AGGR; break;
+      case strategy::none: fs_strategy = H5F_FSPACE_STRATEGY_NONE; break;
+    }
+    if (opts.free_space_threshold > 0) threshold = opts.free_space_threshold;
+    if (H5Pset_file_space_strategy(fcpl, fs_strategy, static_cast<hbool_t>(opts.persist_free_space), threshold) < 0)
+      throw std::runtime_error("Error in h5::make_file_create_proplist: Setting the file space strategy failed");
+
+    // file space page size
+    if (opts.file_space_page_size > 0 and H5Pset_file_space_page_size(fcpl, opts.file_space_page_size) < 0)
+      throw std::runtime_error("Error in h5::make_file_create_proplist: Setting the file space page size failed");
+
+    return fcpl;
+  }
+
+  proplist make_dataset_access_proplist(chunk_cache_config const &cfg) {
+    proplist dapl = H5Pcreate(H5P_DATASET_ACCESS);
+    if (!dapl.is_valid()) throw std::runtime_error("Error in h5::make_dataset_access_proplist: Creating the property list failed");
+    if (H5Pset_chunk_cache(dapl, cfg.nslots, cfg.nbytes, cfg.w0) < 0)
+      throw std::runtime_error("Error in h5::make_dataset_access_proplist: Setting the chunk cache failed");
+    return dapl;
+  }
+
+  proplist make_dataset_transfer_proplist(transfer_options const &opts) {
+    bool collective = (opts.mode == transfer_options::transfer_mode::collective);
+    if (not collective and opts.conversion_buffer_size == 0) return proplist{H5P_DEFAULT};
+
+    proplist dxpl = H5Pcreate(H5P_DATASET_XFER);
+    if (!dxpl.is_valid()) throw std::runtime_error("Error in h5::make_dataset_transfer_proplist: Creating the property list failed");
+#ifdef H5_MPI_SUPPORT
+    // collective MPI-IO transfers
+    if (collective and H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE) < 0)
+      throw std::runtime_error("Error in h5::make_dataset_transfer_proplist: Setting the MPI-IO transfer mode failed");
+#endif
+
+    // type conversion and background buffers (allocated by HDF5)
+    if (opts.conversion_buffer_size > 0 and H5Pset_buffer(dxpl, opts.conversion_buffer_size, nullptr, nullptr) < 0)
+      throw std::runtime_error("Error in h5::make_dataset_transfer_proplist: Setting the conversion buffer size failed");
+    return dxpl;
+  }
+
+  proplist make_group_create_proplist(group_options const &opts) {
+    if (not opts.creation_order and opts.max_compact == 0 and opts.min_dense == 0 and opts.est_num_entries == 0 and opts.est_name_len == 0)
+      return proplist{H5P_DEFAULT};
+
+    proplist gcpl = H5Pcreate(H5P_GROUP_CREATE);
+    if (!gcpl.is_valid()) throw std::runtime_error("Error in h5::make_group_create_proplist: Creating the property list failed");
+
+    // creation order of the links
+    if (opts.creation_order and H5Pset_link_creation_order(gcpl, H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED) < 0)
+      throw std::runtime_error("Error in h5::make_group_create_proplist: Setting the link creation order failed");
+
+    // thresholds for the compact and dense link storage (unset values keep their defaults)
+    if (opts.max_compact > 0 or opts.min_dense > 0) {
+      unsigned max_compact = 0, min_dense = 0;
+      H5Pget_link_phase_change(gcpl, &max_compact, &min_dense);
+      if (opts.max_compact > 0) max_compact = opts.max_compact;
+      if (opts.min_dense > 0) min_dense = opts.min_dense;
+      if (H5Pset_link_phase_change(gcpl, max_compact, std::min(min_dense, max_compact)) < 0)
+        throw std::runtime_error("Error in h5::make_group_create_proplist: Setting the link phase change failed");
+    }
+
+    // estimated number of links and length of their names (unset values keep their defaults)
+    if (opts.est_num_entries > 0 or opts.est_name_len > 0) {
+      unsigned est_num_entries = 0, est_name_len = 0;
+      H5Pget_est_link_info(gcpl, &est_num_entries, &est_name_len);
+      if (opts.est_num_entries > 0) est_num_entries = opts.est_num_entries;
+      if (opts.est_name_len > 0) est_name_len = opts.est_name_len;
+      if (H5Pset_est_link_info(gcpl, est_num_entries, est_name_len) < 0)
+        throw std::runtime_error("Error in h5::make_group_create_proplist: Setting the estimated link info failed");
+    }
+
+    return gcpl;
+  }
+
+  proplist make_dataset_create_proplist(write_options const &opts, datatype const &ty, v_t const &shape, bool is_complex) {
+    proplist dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    if (!dcpl.is_valid()) throw std::runtime_error("Error in h5::make_dataset_create_proplist: Creating the property list failed");
+
+    // chunked layout and filter pipeline (not possible for scalars)
+    if (opts.is_chunked() and not shape.empty()) {
+      auto chunk_shape = get_chunk_shape(opts, shape, H5Tget_size(ty), is_complex);
+      if (H5Pset_chunk(dcpl, static_cast<int>(chunk_shape.size()), chunk_shape.data()) < 0)
+        throw std::runtime_error("Error in h5::make_dataset_create_proplist: Setting the chunk shape failed");
+
+      // shuffle filter
+      if (opts.shuffle and H5Pset_shuffle(dcpl) < 0)
+        throw std::runtime_error("Error in h5::make_dataset_create_proplist: Setting the shuffle filter failed");
+
+      // deflate filter
+      if (opts.deflate_level >= 0 and H5Pset_deflate(dcpl, static_cast<unsigned>(std::min(opts.deflate_level, 9))) < 0)
+        throw std::runtime_error("Error in h5::make_dataset_create_proplist: Setting the deflate filter failed");
+
+      // szip filter
+      if (opts.szip_pixels_per_block > 0) {
+        if (H5Zfilter_avail(H5Z_FILTER_SZIP) <= 0)
+          throw std::runtime_error("Error in h5::make_dataset_create_proplist: The szip filter is not available");
+        if (H5Pset_szip(dcpl, H5_SZIP_NN_OPTION_MASK, opts.szip_pixels_per_block) < 0)
+          throw std::runtime_error("Error in h5::make_dataset_create_proplist: Setting the szip filter failed");
+      }
+
+      // additional filters
+      for (auto const &f : opts.filters) {
+        auto flags = (f.optional ? H5Z_FLAG_OPTIONAL : H5Z_FLAG_MANDATORY);
+        if (H5Pset_filter(dcpl, f.id, flags, f.cd_values.size(), f.cd_values.data()) < 0)
+          throw std::runtime_error("Error in h5::make_dataset_create_proplist: Setting the filter with ID " + std::to_string(f.id) + " failed");
+      }
+
+      // checksum of the filtered chunks
+      if (opts.fletcher32 and H5Pset_fletcher32(dcpl) < 0)
+        throw std::runtime_error("Error in h5::make_dataset_create_proplist: Setting the Fletcher32 filter failed");
+    }
+
+    // fill value
+    if (not opts.fill_value.empty()) {
+      if (opts.fill_value.size() != H5Tget_size(ty))
+        throw std::runtime_error("Error in h5::make_dataset_create_proplist: Size of the fill value does not match the size of the datatype");
+      if (H5Pset_fill_value(dcpl, ty, opts.fill_value.data()) < 0)
+        throw std::runtime_error("Error in h5::make_dataset_create_proplist: Setting the fill value failed");
+    }
+
+    // fill time
+    H5D_fill_time_t fill_time = H5D_FILL_TIME_IFSET;
+    if (opts.fill == write_options::fill_time::alloc) fill_time = H5D_FILL_TIME_ALLOC;
+    if (opts.fill == write_options::fill_time::never) fill_time = H5D_FILL_TIME_NEVER;
+    if (H5Pset_fill_time(dcpl, fill_time) < 0) throw std::runtime_error("Error in h5::make_dataset_create_proplist: Setting the fill time failed");
+
+    // allocation time
+    if (opts.allocation != write_options::alloc_time::library_default) {
+      H5D_alloc_time_t alloc_time = H5D_ALLOC_TIME_LATE;
+      if (opts.allocation == write_options::alloc_time::early) alloc_time = H5D_ALLOC_TIME_EARLY;
+      if (opts.allocation == write_options::alloc_time::incremental) alloc_time = H5D_ALLOC_TIME_INCR;
+      if (H5Pset_alloc_time(dcpl, alloc_time) < 0)
+        throw std::runtime_error("Error in h5::make_dataset_create_proplist: Setting the allocation time failed");
+    }
+
+    return dcpl;
+  }
+
+} // namespace h5
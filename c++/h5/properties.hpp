@@ -0,0 +1,499 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Provides option types to configure the HDF5 property lists used by h5.
+ */
+
+#ifndef LIBH5_PROPERTIES_HPP
+#define LIBH5_PROPERTIES_HPP
+
+#include "./object.hpp"
+#include "./utils.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace h5 {
+
+  /**
+   * @addtogroup properties
+   * @{
+   */
+
+  /**
+   * @brief Filter in the HDF5 filter pipeline of a chunked dataset.
+   *
+   * @details This can be used to add registered filters like LZ4 (32004), Zstandard (32015) or Blosc (32001) to a
+   * dataset (see the <a href="https://github.com/HDFGroup/hdf5_plugins/blob/master/docs/RegisteredFilterPlugins.md">list
+   * of registered filters</a>). The filter itself has to be available at runtime, e.g. as a dynamically loaded plugin.
+   */
+  struct filter {
+    /// HDF5 filter identifier.
+    int id;
+
+    /// Auxiliary data passed to the filter.
+    std::vector<unsigned int> cd_values = {};
+
+    /// Whether the filter is optional, i.e. whether it may fail for some chunks without causing an error.
+    bool optional = false;
+  };
+
+  /**
+   * @brief Dataset creation policy used when writing arrays.
+   *
+   * @details It controls the layout of the dataset (contiguous or chunked), the filter pipeline and the fill value
+   * related settings. A default constructed object creates contiguous datasets without any filters.
+   *
+   * The dataset is chunked if a chunk shape or a target chunk size is given, or if any filter is requested:
+   * - If `chunk_shape` is not empty, it is used as the shape of a single chunk. For complex valued data, the
+   * additional dimension for the imaginary part can be omitted.
+   * - Otherwise, if `chunk_bytes` is non-zero, the chunk shape is chosen such that a single chunk holds at most
+   * `chunk_bytes` bytes. Starting from the full shape of the dataset, the extents are halved one dimension after the
+   * other until the chunk is small enough.
+   * - Otherwise, each dimension is clamped such that a single chunk does not exceed the HDF5 limit of 4 GB (in most
+   * cases this means that the whole dataset is stored in a single chunk).
+   *
+   * Filters are applied in the following order: shuffle, deflate, szip, all additional `filters` and finally the
+   * Fletcher32 checksum filter.
+   *
+   * The following example writes a 3-dimensional array of doubles in chunks of about 1 MB compressed with the
+   * shuffle and the deflate filter:
+   *
+   * @code{.cpp}
+   * auto opts = h5::write_options{.chunk_bytes = 1 << 20, .deflate_level = 4, .shuffle = true};
+   * h5::array_interface::write(g, "data", view, opts);
+   * @endcode
+   *
+   * By default, an existing dataset with the same name is unlinked and a new one is created. For checkpoints of a
+   * slowly changing state, `update` can be used to overwrite an existing dataset in place (its layout and filters are
+   * kept) and to skip datasets whose content has not changed:
+   *
+   * @code{.cpp}
+   * auto opts = h5::write_options{.update = h5::write_options::update_mode::skip_unchanged};
+   * h5::write(f, "state", state, opts);
+   * @endcode
+   *
+   * Integrity information is written with `fletcher32` (a checksum of every stored chunk) and `content_hash` (a hash
+   * of the whole content). Archives can then be checked with h5::array_interface::verify and compared without reading
+   * the data with h5::array_interface::same_content.
+   */
+  struct write_options {
+    /// Allocation time of the dataset storage (see `H5Pset_alloc_time`).
+    enum class alloc_time { library_default, early, incremental, late };
+
+    /// Time when the fill value is written to the dataset storage (see `H5Pset_fill_time`).
+    enum class fill_time { if_set, alloc, never };
+
+    /**
+     * @brief Storage format of complex valued data.
+     *
+     * @details
+     * - `extra_dimension`: Real datatype with an additional trailing dimension of size 2 and a `__complex__` attribute.
+     * - `compound`: Compound datatype with the members "r" and "i" (h5::dcplx_t for doubles).
+     * - `native`: HDF5 complex number datatype (`H5T_COMPLEX`, requires HDF5 >= 2.0, otherwise `compound` is used).
+     */
+    enum class complex_format { extra_dimension, compound, native };
+
+    /**
+     * @brief Policy for writing to an existing dataset.
+     *
+     * @details
+     * - `recreate`: Unlink the existing dataset and create a new one.
+     * - `in_place`: Overwrite the existing dataset if its shape and datatype match the data (otherwise recreate it).
+     * - `skip_unchanged`: Same as `in_place` but a 64-bit hash of the content is stored in the attribute `__hash__` (see
+     * `content_hash`) and the write is skipped if the stored hash matches the hash of the data. Datatypes with
+     * variable-length data are always written.
+     */
+    enum class update_mode { recreate, in_place, skip_unchanged };
+
+    /// Shape of a single chunk.
+    v_t chunk_shape = {};
+
+    /// Target size of a single chunk in bytes (only used if `chunk_shape` is empty).
+    hsize_t chunk_bytes = 0;
+
+    /// Deflate (gzip) compression level in the range `[0, 9]`. A negative value disables the deflate filter.
+    int deflate_level = -1;
+
+    /// Whether to apply the shuffle filter.
+    bool shuffle = false;
+
+    /// Number of pixels per block for the szip filter (nearest neighbor coding). Zero disables the szip filter.
+    unsigned int szip_pixels_per_block = 0;
+
+    /// Additional filters.
+    std::vector<filter> filters = {};
+
+    /// Whether to add the Fletcher32 checksum filter after all other filters (corrupted chunks fail to be read).
+    bool fletcher32 = false;
+
+    /// Fill value in the binary representation of the datatype of the dataset. If empty, the default fill value is used.
+    std::vector<std::byte> fill_value = {};
+
+    /// Allocation time of the dataset storage.
+    alloc_time allocation = alloc_time::library_default;
+
+    /// Time when the fill value is written.
+    fill_time fill = fill_time::if_set;
+
+    /// Whether to store strings as variable-length UTF-8 strings instead of padding them to the longest string.
+    bool variable_length_strings = false;
+
+    /// Storage format of complex valued data.
+    complex_format complex_storage = complex_format::extra_dimension;
+
+    /// Policy for writing to an existing dataset.
+    update_mode update = update_mode::recreate;
+
+    /// Whether to store a 64-bit hash of the content in the attribute `__hash__` (see h5::array_interface::verify).
+    bool content_hash = false;
+
+    /// Check whether the options require a chunked layout.
+    [[nodiscard]] bool is_chunked() const {
+      return not chunk_shape.empty() or chunk_bytes > 0 or deflate_level >= 0 or shuffle or szip_pixels_per_block > 0 or not filters.empty()
+         or fletcher32;
+    }
+  };
+
+  /**
+   * @brief Settings of the raw data chunk cache (see `H5Pset_cache` and `H5Pset_chunk_cache`).
+   *
+   * @details The cache is used to hold recently accessed chunks of chunked datasets in memory. The default values
+   * correspond to the HDF5 defaults. For best performance, `nbytes` should be large enough to hold all chunks that are
+   * needed by a typical read/write operation and `nslots` should be a prime number about 100 times larger than the
+   * number of chunks that fit into the cache.
+   */
+  struct chunk_cache_config {
+    /// Number of chunk slots in the hash table of the cache.
+    std::size_t nslots = 521;
+
+    /// Total size of the cache in bytes.
+    std::size_t nbytes = std::size_t{1} << 20;
+
+    /// Preemption policy in the range `[0, 1]` (fully read/written chunks are preferred for eviction if close to 1).
+    double w0 = 0.75;
+  };
+
+  /**
+   * @brief Settings of the metadata cache (see `H5Pset_mdc_config`).
+   *
+   * @details Only the size limits of the adaptive metadata cache can be changed. A value of zero keeps the corresponding
+   * HDF5 default. The minimum and maximum sizes are adjusted such that they are compatible with the initial size.
+   */
+  struct metadata_cache_config {
+    /// Initial size of the metadata cache in bytes.
+    std::size_t initial_size = 0;
+
+    /// Minimum size of the metadata cache in bytes.
+    std::size_t min_size = 0;
+
+    /// Maximum size of the metadata cache in bytes.
+    std::size_t max_size = 0;
+  };
+
+  /**
+   * @brief Settings of the split file driver (see `H5Pset_fapl_split`).
+   *
+   * @details The metadata and the raw data are stored in two separate files whose names are obtained by appending the
+   * given extensions to the file name. The metadata file can then be placed on fast storage (e.g. via a symbolic link)
+   * while the raw data goes to a file system optimized for large streaming transfers.
+   */
+  struct split_driver {
+    /// Extension of the metadata file.
+    std::string meta_ext = "-m.h5";
+
+    /// Extension of the raw data file.
+    std::string raw_ext = "-r.h5";
+  };
+
+  /**
+   * @brief Settings of the direct I/O file driver (see `H5Pset_fapl_direct`).
+   *
+   * @details Data is transferred with `O_DIRECT`, i.e. bypassing the page cache of the operating system. This is useful
+   * for streaming huge arrays which are not read again soon. Objects of at least `alignment` bytes are aligned to
+   * `alignment` in the file unless h5::file_options::alignment has been set explicitly. Requires an HDF5 library built
+   * with direct I/O support.
+   */
+  struct direct_driver {
+    /// Required memory alignment of the transfer buffers in bytes.
+    std::size_t mem_alignment = 4096;
+
+    /// File system block size in bytes.
+    std::size_t block_size = 4096;
+
+    /// Size of the copy buffer in bytes (multiple of the block size).
+    std::size_t cbuf_size = std::size_t{16} << 20;
+
+    /// Alignment of large objects in the file in bytes.
+    hsize_t alignment = 4096;
+  };
+
+  /**
+   * @brief Settings of the read-only S3 file driver (see `H5Pset_fapl_ros3`).
+   *
+   * @details The file name is the URL of the object, e.g. `https://bucket.s3.us-east-2.amazonaws.com/data.h5`, and the
+   * file can only be opened in mode 'r'. Anonymous access is used if no key id is given. Requires an HDF5 library built
+   * with the ROS3 driver.
+   */
+  struct ros3_driver {
+    /// AWS region of the bucket.
+    std::string aws_region = {};
+
+    /// Access key id.
+    std::string key_id = {};
+
+    /// Secret access key.
+    std::string secret_key = {};
+  };
+
+  /// File driver of an h5::file on disk (`std::monostate` selects the default `H5FD_SEC2` driver).
+  using file_driver = std::variant<std::monostate, split_driver, direct_driver, ros3_driver>;
+
+  /**
+   * @brief Options to configure the file access and file creation property lists of an h5::file.
+   *
+   * @details A default constructed object leaves all settings at their HDF5 defaults.
+   *
+   * The file space settings are only used when a new file is created. HDF5 does not reuse the space of unlinked
+   * objects after a file has been closed unless the free space is tracked persistently (`persist_free_space`). Together
+   * with `overwrite_in_place`, which makes h5 overwrite existing datasets instead of unlinking and recreating them,
+   * this keeps files which are written repeatedly in mode 'a' from growing without bound:
+   *
+   * @code{.cpp}
+   * h5::file f("checkpoint.h5", 'a', h5::file_options{.overwrite_in_place = true, .persist_free_space = true});
+   * h5::write(f, "state", state); // reuses the storage of an existing "state" dataset
+   * @endcode
+   *
+   * Files with many small objects benefit from the latest file format, which indexes chunks and stores groups more
+   * compactly, and from paged aggregation combined with a page buffer, which reads and caches the metadata in larger
+   * pages:
+   *
+   * @code{.cpp}
+   * auto opts = h5::file_options{.libver_low = h5::file_options::libver::latest, .fs_strategy = h5::file_options::file_space_strategy::page,
+   *                              .page_buffer_size = 4 << 20};
+   * h5::file f("archive.h5", 'w', opts);
+   * @endcode
+   */
+  struct file_options {
+    /// File space management strategy (see `H5Pset_file_space_strategy`).
+    enum class file_space_strategy { library_default, fsm_aggr, page, aggr, none };
+
+    /// Versions of the HDF5 file format (see `H5Pset_libver_bounds`).
+    enum class libver { earliest, v18, v110, latest };
+
+    /// Raw data chunk cache settings used for all datasets in the file.
+    std::optional<chunk_cache_config> chunk_cache = {};
+
+    /// Metadata cache settings.
+    std::optional<metadata_cache_config> metadata_cache = {};
+
+    /**
+     * @brief Earliest version of the file format used for the objects in the file.
+     *
+     * @details Newer object formats, e.g. more efficient chunk indices and compact group storage, are only used if the low
+     * bound allows them. Files written with a low bound of `v110` or `latest` can only be read by HDF5 1.10 or newer.
+     */
+    libver libver_low = libver::earliest;
+
+    /// Latest version of the file format used for the objects in the file.
+    libver libver_high = libver::latest;
+
+    /// Objects larger than or equal to this threshold (in bytes) are aligned in the file (see `H5Pset_alignment`).
+    hsize_t alignment_threshold = 1;
+
+    /// Alignment of objects in the file in bytes.
+    hsize_t alignment = 1;
+
+    /// File driver used to open files on disk (see h5::file_driver).
+    file_driver driver = {};
+
+    /// Number of bytes by which the memory buffer of a buffered memory file grows (`H5FD_CORE` driver only).
+    std::size_t memory_increment = 64 * 1024;
+
+    /**
+     * @brief Whether to overwrite existing objects instead of unlinking them.
+     *
+     * @details If true, h5::group::create_dataset reuses an existing dataset with the same datatype and extent and
+     * h5::group::create_group reuses an existing group. The attributes of a reused object are removed. The same applies
+     * to h5::array_interface::write with h5::write_options::update_mode::recreate. The links of a reused group are
+     * removed as well. Its children are only reused if they are written again, the others are deleted.
+     */
+    bool overwrite_in_place = false;
+
+    /// File space management strategy of a new file (`library_default` uses `fsm_aggr` if the free space is persisted).
+    file_space_strategy fs_strategy = file_space_strategy::library_default;
+
+    /// Whether to track the free space of a new file persistently across file sessions.
+    bool persist_free_space = false;
+
+    /// Smallest size of the free space sections which are tracked in bytes (0 keeps the HDF5 default).
+    hsize_t free_space_threshold = 0;
+
+    /// File space page size of a new file with the `page` strategy in bytes (0 keeps the HDF5 default of 4 KiB).
+    hsize_t file_space_page_size = 0;
+
+    /**
+     * @brief Size of the page buffer in bytes (see `H5Pset_page_buffer_size`).
+     *
+     * @details The page buffer caches whole file space pages and can only be used with files that have been created
+     * with the `page` strategy. It has to be at least as large as a single page. 0 disables the page buffer.
+     */
+    std::size_t page_buffer_size = 0;
+
+    /**
+     * @brief Whether to open the file for single-writer/multiple-reader (SWMR) access.
+     *
+     * @details Files opened in mode 'r' are opened as SWMR readers (`H5F_ACC_SWMR_READ`), files opened in one of the
+     * other modes as SWMR writers (`H5F_ACC_SWMR_WRITE`). The low bound of the file format is raised to `v110` if
+     * necessary, since SWMR requires it (see h5::file_options::libver_low). See h5::file for more details. SWMR is
+     * not supported for parallel files opened with the MPI-IO file driver.
+     */
+    bool swmr = false;
+  };
+
+  /**
+   * @brief Options to configure the dataset transfer property list used when reading or writing datasets.
+   *
+   * @details The transfer mode only has an effect for files which have been opened with the MPI-IO file driver (see
+   * h5::file). It is ignored if h5 has been built against a serial HDF5 library.
+   *
+   * The conversion options control what happens if the datatype in memory differs from the datatype stored in the
+   * file when reading a dataset with h5::array_interface::read:
+   * - `conversion_policy::warn` (default): Print a warning to `std::cerr` and convert the data.
+   * - `conversion_policy::allow`: Convert the data silently.
+   * - `conversion_policy::forbid`: Throw an exception.
+   *
+   * If `fast_conversion` is true, conversions between integer types or between floating point types (e.g. `float`
+   * to `double`) are done by h5 after reading the raw data from the file instead of by HDF5's soft conversion
+   * functions. Integers which do not fit into the target type are clamped, as HDF5 does. All other conversions are
+   * done by HDF5 using type conversion and background buffers of size `conversion_buffer_size`.
+   */
+  struct transfer_options {
+    /// MPI-IO data transfer mode (see `H5Pset_dxpl_mpio`).
+    enum class transfer_mode { independent, collective };
+
+    /// Policy for reading data whose datatype in the file differs from the datatype in memory.
+    enum class conversion_policy { warn, allow, forbid };
+
+    /// Data transfer mode.
+    transfer_mode mode = transfer_mode::independent;
+
+    /// Conversion policy.
+    conversion_policy conversion = conversion_policy::warn;
+
+    /// Size of the type conversion and background buffers in bytes (see `H5Pset_buffer`, 0 keeps the HDF5 default).
+    std::size_t conversion_buffer_size = 0;
+
+    /// Whether to convert between integer types and between floating point types in h5 instead of in HDF5.
+    bool fast_conversion = true;
+  };
+
+  /**
+   * @brief Options to configure the group creation property list of an h5::group.
+   *
+   * @details A default constructed object leaves all settings at their HDF5 defaults. A value of zero keeps the
+   * corresponding HDF5 default.
+   *
+   * Groups whose links are tracked and indexed in creation order are iterated in creation order (see
+   * h5::group::for_each_child), which avoids sorting the links by name. The link storage switches from compact (stored
+   * in the object header) to dense (stored in a fractal heap with a B-tree index) when the number of links exceeds
+   * `max_compact` and back when it drops below `min_dense`.
+   */
+  struct group_options {
+    /// Whether to track and index the creation order of links (see `H5Pset_link_creation_order`).
+    bool creation_order = false;
+
+    /// Maximum number of links to store in the compact format (see `H5Pset_link_phase_change`).
+    unsigned max_compact = 0;
+
+    /// Minimum number of links to store in the dense format (see `H5Pset_link_phase_change`).
+    unsigned min_dense = 0;
+
+    /// Estimated number of links in the group (see `H5Pset_est_link_info`).
+    unsigned est_num_entries = 0;
+
+    /// Estimated average length of the link names (see `H5Pset_est_link_info`).
+    unsigned est_name_len = 0;
+  };
+
+  /**
+   * @brief Create an HDF5 file access property list.
+   *
+   * @param opts h5::file_options specifying the settings.
+   * @return h5::proplist of class `H5P_FILE_ACCESS`.
+   */
+  [[nodiscard]] proplist make_file_access_proplist(file_options const &opts);
+
+  /**
+   * @brief Create an HDF5 file creation property list.
+   *
+   * @details If all file space settings have their default values, `H5P_DEFAULT` is returned.
+   *
+   * @param opts h5::file_options specifying the settings.
+   * @return h5::proplist of class `H5P_FILE_CREATE` or `H5P_DEFAULT`.
+   */
+  [[nodiscard]] proplist make_file_create_proplist(file_options const &opts);
+
+  /**
+   * @brief Create an HDF5 dataset access property list with the given chunk cache settings.
+   *
+   * @param cfg h5::chunk_cache_config specifying the chunk cache settings of the dataset.
+   * @return h5::proplist of class `H5P_DATASET_ACCESS`.
+   */
+  [[nodiscard]] proplist make_dataset_access_proplist(chunk_cache_config const &cfg);
+
+  /**
+   * @brief Create an HDF5 dataset transfer property list.
+   *
+   * @details If all options have their default values, `H5P_DEFAULT` is returned to avoid creating a new property
+   * list for every read/write operation.
+   *
+   * @param opts h5::transfer_options specifying the settings.
+   * @return h5::proplist of class `H5P_DATASET_XFER` or `H5P_DEFAULT`.
+   */
+  [[nodiscard]] proplist make_dataset_transfer_proplist(transfer_options const &opts);
+
+  /**
+   * @brief Create an HDF5 group creation property list.
+   *
+   * @details If all options have their default values, `H5P_DEFAULT` is returned.
+   *
+   * @param opts h5::group_options specifying the settings.
+   * @return h5::proplist of class `H5P_GROUP_CREATE` or `H5P_DEFAULT`.
+   */
+  [[nodiscard]] proplist make_group_create_proplist(group_options const &opts);
+
+  /**
+   * @brief Create an HDF5 dataset creation property list.
+   *
+   * @param opts h5::write_options specifying the policy.
+   * @param ty h5::datatype of the dataset.
+   * @param shape Shape of the dataset (including the possible added imaginary dimension).
+   * @param is_complex Whether the data is complex valued.
+   * @return h5::proplist of class `H5P_DATASET_CREATE`.
+   */
+  [[nodiscard]] proplist make_dataset_create_proplist(write_options const &opts, datatype const &ty, v_t const &shape, bool is_complex);
+
+  /** @} */
+
+} // namespace h5
+
+#endif // LIBH5_PROPERTIES_HPP
@@ -24,6 +24,7 @@
 
 #include "./array_interface.hpp"
 #include "./complex.hpp"
+#include "./compound.hpp"
 #include "./group.hpp"
 #include "./macros.hpp"
 #include "./object.hpp"
@@ -59,7 +60,7 @@ namespace h5 {
   /**
    * @brief Write a scalar to an HDF5 dataset.
    *
-   * @details The scalar type needs to be either arithmetic, complex or of type h5::dcplx_t.
+   * @details The scalar type needs to be either arithmetic, complex, of type h5::dcplx_t or a struct registered with H5_COMPOUND.
    *
    * @tparam T Scalar type.
    * @param g h5::group in which the dataset is created.
@@ -67,14 +68,15 @@ namespace h5 {
    * @param x Scalar value to be written.
    */
   template <typename T>
-  void h5_write(group g, std::string const &name, T const &x) H5_REQUIRES(std::is_arithmetic_v<T> or is_complex_v<T> or std::is_same_v<T, dcplx_t>) {
+  void h5_write(group g, std::string const &name, T const &x)
+     H5_REQUIRES(std::is_arithmetic_v<T> or is_complex_v<T> or std::is_same_v<T, dcplx_t> or is_compound_v<T>) {
     array_interface::write(g, name, array_interface::array_view_from_scalar(x), false);
   }
 
   /**
    * @brief Read a scalar from an HDF5 dataset.
    *
-   * @details The scalar type needs to be either arithmetic, complex or of type h5::dcplx_t.
+   * @details The scalar type needs to be either arithmetic, complex, of type h5::dcplx_t or a struct registered with H5_COMPOUND.
    *
    * @tparam T Scalar type.
    * @param g h5::group containing the dataset.
@@ -82,10 +84,16 @@ namespace h5 {
    * @param x Scalar variable to be read into.
    */
   template <typename T>
-  void h5_read(group g, std::string const &name, T &x) H5_REQUIRES(std::is_arithmetic_v<T> or is_complex_v<T> or std::is_same_v<T, dcplx_t>) {
-    // backward compatibility to read complex values stored the old way (in a subgroup)
+  void h5_read(group g, std::string const &name, T &x)
+     H5_REQUIRES(std::is_arithmetic_v<T> or is_complex_v<T> or std::is_same_v<T, dcplx_t> or is_compound_v<T>) {
+    // open the dataset only once and use the handle for all subsequent operations
+    dataset ds;
     if constexpr (is_complex_v<T>) {
-      if (g.has_subgroup(name)) {
+      try {
+        ds = g.open_dataset(name);
+      } catch (std::runtime_error const &) {
+        // backward compatibility to read complex values stored the old way (in a subgroup)
+        if (not g.has_subgroup(name)) throw;
         group gr = g.open_group(name);
         H5_ASSERT(gr.has_key("r") and gr.has_key("i"));
         double r = NAN, i = NAN;
@@ -94,27 +102,19 @@ namespace h5 {
         x = std::complex<double>{r, i};
         return;
       }
+    } else {
+      ds = g.open_dataset(name);
     }
 
-    // get dataset_info
-    auto ds_info = array_interface::get_dataset_info(g, name);
-
-    // read complex values stored as a compound HDF5 datatype
-    if constexpr (is_complex_v<T>) {
-      if (hdf5_type_equal(ds_info.ty, hdf5_type<dcplx_t>())) {
-        h5_read(g, name, reinterpret_cast<dcplx_t &>(x)); // NOLINT (reinterpret_cast is safe here)
-        return;
-      }
-    }
-
-    // read scalar value
-    array_interface::read(g, name, array_interface::array_view_from_scalar(x));
+    // read scalar value (complex values stored with a complex datatype are detected by array_interface::read)
+    array_interface::read(ds, array_interface::array_view_from_scalar(x));
   }
 
   /**
    * @brief Write a scalar to an HDF5 attribute.
    *
-   * @details The scalar type needs to be either arithmetic or std::complex.
+   * @details The scalar type needs to be either arithmetic or std::complex. An existing attribute with the same name
+   * is overwritten.
    *
    * @tparam T Scalar type.
    * @param obj h5::object to which the attribute is attached.
@@ -0,0 +1,141 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Implementation details for scratch.hpp.
+ */
+
+#include "./scratch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace h5 {
+
+  namespace {
+
+    // smallest block size and number of size classes (powers of two from 64 B to 8 MiB, the default pool limit), larger
+    // blocks are never pooled and therefore allocated with their exact size
+    constexpr int min_class_log2 = 6;
+    constexpr int n_classes      = 18;
+
+    // maximum number of cached bytes per thread
+    std::atomic<std::size_t> pool_limit{std::size_t{8} << 20};
+
+    // Get the size class of a block of the given size (-1 if the block is too large to be pooled).
+    int size_class(std::size_t nbytes) {
+      auto c = std::bit_width(std::max(nbytes, std::size_t{1} << min_class_log2) - 1) - min_class_log2;
+      return (c < n_classes ? static_cast<int>(c) : -1);
+    }
+
+    // Size of the blocks in a given size class.
+    std::size_t class_size(int c) { return std::size_t{1} << (c + min_class_log2); }
+
+    // Free lists of the scratch pool of a single thread.
+    struct pool {
+      std::array<std::vector<void *>, n_classes> free_lists;
+      scratch_pool_stats stats;
+
+      void release() {
+        for (auto &fl : free_lists) {
+          for (void *p : fl) ::operator delete(p);
+          fl.clear();
+          fl.shrink_to_fit();
+        }
+        stats.cached_bytes = 0;
+      }
+    };
+
+    // the pointer stays accessible (and is reset) after the pool of an exiting thread has been destroyed
+    thread_local pool *current_pool = nullptr;
+
+    // Owner of the pool of the calling thread.
+    struct pool_holder {
+      pool p;
+      pool_holder() { current_pool = &p; }
+      ~pool_holder() {
+        current_pool = nullptr;
+        p.release();
+      }
+      pool_holder(pool_holder const &)            = delete;
+      pool_holder &operator=(pool_holder const &) = delete;
+    };
+
+    // Get the pool of the calling thread (nullptr during thread exit).
+    pool *get_pool() {
+      thread_local pool_holder holder;
+      return current_pool;
+    }
+
+  } // namespace
+
+  void set_scratch_pool_limit(std::size_t nbytes) { pool_limit.store(nbytes, std::memory_order_relaxed); }
+
+  std::size_t get_scratch_pool_limit() { return pool_limit.load(std::memory_order_relaxed); }
+
+  void release_scratch_pool() {
+    if (auto *p = get_pool()) p->release();
+  }
+
+  scratch_pool_stats get_scratch_pool_stats() {
+    auto *p = get_pool();
+    return (p ? p->stats : scratch_pool_stats{});
+  }
+
+  namespace detail {
+
+    void *scratch_allocate(std::size_t nbytes) {
+      int c = size_class(nbytes);
+      if (c < 0) return ::operator new(nbytes);
+
+      // reuse a cached block of the same size class
+      auto *p = get_pool();
+      if (p != nullptr and not p->free_lists[c].empty()) {
+        void *ptr = p->free_lists[c].back();
+        p->free_lists[c].pop_back();
+        p->stats.cached_bytes -= class_size(c);
+        ++p->stats.hits;
+        return ptr;
+      }
+      if (p != nullptr) ++p->stats.misses;
+      return ::operator new(class_size(c));
+    }
+
+    void scratch_deallocate(void *ptr, std::size_t nbytes) noexcept {
+      if (ptr == nullptr) return;
+      int c = size_class(nbytes);
+
+      // cache the block if the limit is not exceeded
+      auto *p = (c < 0 ? nullptr : get_pool());
+      if (p != nullptr and p->stats.cached_bytes + class_size(c) <= get_scratch_pool_limit()) {
+        try {
+          p->free_lists[c].push_back(ptr);
+          p->stats.cached_bytes += class_size(c);
+          return;
+        } catch (...) {} // NOLINT (the block is freed below)
+      }
+      ::operator delete(ptr);
+    }
+
+  } // namespace detail
+
+} // namespace h5
@@ -0,0 +1,134 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Provides a per-thread pool of scratch memory for the temporary buffers used by h5.
+ */
+
+#ifndef LIBH5_SCRATCH_HPP
+#define LIBH5_SCRATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace h5 {
+
+  /**
+   * @addtogroup utilities
+   * @{
+   */
+
+  /// Statistics of the scratch pool of the calling thread.
+  struct scratch_pool_stats {
+    /// Number of bytes currently cached in the pool.
+    std::size_t cached_bytes = 0;
+
+    /// Number of allocations served from the pool.
+    std::uint64_t hits = 0;
+
+    /// Number of allocations which had to request new memory.
+    std::uint64_t misses = 0;
+  };
+
+  /**
+   * @brief Set the maximum number of bytes that the scratch pool of each thread keeps for reuse.
+   *
+   * @details Temporary buffers, e.g. the padded strings of an h5::char_buf or the pointers of variable-length string
+   * reads, are allocated with an h5::scratch_allocator. Freed blocks are cached in a pool owned by the freeing thread
+   * (in size classes of powers of two) and handed out again by later allocations of the same class. Blocks which would
+   * exceed the limit are returned to the system instead. The default limit is 8 MiB, a limit of 0 disables the pool.
+   * Blocks larger than 8 MiB are never cached (independent of the limit) and are allocated with their exact size.
+   *
+   * Lowering the limit does not release blocks which are already cached (see h5::release_scratch_pool).
+   *
+   * @param nbytes Maximum number of cached bytes per thread.
+   */
+  void set_scratch_pool_limit(std::size_t nbytes);
+
+  /// Get the maximum number of bytes that the scratch pool of each thread keeps for reuse.
+  [[nodiscard]] std::size_t get_scratch_pool_limit();
+
+  /// Return all blocks cached in the scratch pool of the calling thread to the system.
+  void release_scratch_pool();
+
+  /// Get the statistics of the scratch pool of the calling thread.
+  [[nodiscard]] scratch_pool_stats get_scratch_pool_stats();
+
+  namespace detail {
+
+    // Allocate a block of at least the given size from the scratch pool of the calling thread.
+    [[nodiscard]] void *scratch_allocate(std::size_t nbytes);
+
+    // Return a block allocated with scratch_allocate (with the same size) to the scratch pool of the calling thread.
+    void scratch_deallocate(void *p, std::size_t nbytes) noexcept;
+
+  } // namespace detail
+
+  /**
+   * @brief Stateless allocator which takes its memory from the per-thread scratch pool.
+   *
+   * @details Memory can be freed on a different thread than the one it was allocated on. See
+   * h5::set_scratch_pool_limit for more details.
+   *
+   * @tparam T Value type.
+   */
+  template <typename T>
+  struct scratch_allocator {
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Over-aligned types are not supported by h5::scratch_allocator");
+
+    /// Value type.
+    using value_type = T;
+
+    /// Default constructor.
+    scratch_allocator() = default;
+
+    /// Converting constructor from an allocator of another value type.
+    template <typename U>
+    scratch_allocator(scratch_allocator<U> const &) noexcept {} // NOLINT (implicit conversion is required by the standard)
+
+    /**
+     * @brief Allocate uninitialized memory for the given number of objects.
+     * @param n Number of objects.
+     * @return Pointer to the allocated memory.
+     */
+    [[nodiscard]] T *allocate(std::size_t n) { return static_cast<T *>(detail::scratch_allocate(n * sizeof(T))); }
+
+    /**
+     * @brief Deallocate memory which has been allocated with allocate().
+     * @param p Pointer to the memory.
+     * @param n Number of objects passed to allocate().
+     */
+    void deallocate(T *p, std::size_t n) noexcept { detail::scratch_deallocate(p, n * sizeof(T)); }
+
+    /// All scratch allocators are equal.
+    template <typename U>
+    friend bool operator==(scratch_allocator const &, scratch_allocator<U> const &) noexcept {
+      return true;
+    }
+  };
+
+  /// std::vector which takes its memory from the per-thread scratch pool (see h5::scratch_allocator).
+  template <typename T>
+  using scratch_vector = std::vector<T, scratch_allocator<T>>;
+
+  /** @} */
+
+} // namespace h5
+
+#endif // LIBH5_SCRATCH_HPP
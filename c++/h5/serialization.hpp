@@ -24,8 +24,13 @@
 
 #include "./file.hpp"
 #include "./generic.hpp"
+#include "./macros.hpp"
 
 #include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace h5 {
@@ -51,21 +56,117 @@ namespace h5 {
     return f.as_buffer();
   }
 
+  /**
+   * @brief Serialize an object to a byte buffer using a buffered memory file with the given options.
+   *
+   * @details It can be used to choose a memory increment which avoids repeated reallocations of the memory buffer
+   * (see h5::file_options::memory_increment).
+   *
+   * @tparam T Type of the object.
+   * @param x Object to be serialized.
+   * @param opts h5::file_options to configure the buffered memory file.
+   * @return Byte buffer containing the serialized object.
+   */
+  template <typename T>
+  [[nodiscard]] std::vector<std::byte> serialize(T const &x, file_options const &opts) {
+    file f{opts};
+    h5_write(f, "object", x);
+    return f.as_buffer();
+  }
+
+  /**
+   * @brief Get the number of bytes needed to serialize an object.
+   *
+   * @details It writes the object to a buffered memory file and returns the size of its file image. The result can be
+   * used to allocate a buffer for h5::serialize_into, e.g. once for many objects of the same shape.
+   *
+   * @tparam T Type of the object.
+   * @param x Object to be serialized.
+   * @return Size of the serialized object in bytes.
+   */
+  template <typename T>
+  [[nodiscard]] std::size_t serialized_size(T const &x) {
+    file f{};
+    h5_write(f, "object", x);
+    return f.image_size();
+  }
+
+  /**
+   * @brief Serialize an object into a caller-provided byte buffer.
+   *
+   * @details The object is written to a buffered memory file which stores its file image directly in the given buffer
+   * (see h5::file::create_in_buffer). No memory is allocated for the file image. Throws an exception if the buffer is
+   * too small (see h5::serialized_size).
+   *
+   * @tparam T Type of the object.
+   * @param x Object to be serialized.
+   * @param buf Byte buffer to write the serialized object to.
+   * @return Number of bytes at the beginning of the buffer which contain the serialized object.
+   */
+  template <typename T>
+  std::size_t serialize_into(T const &x, std::span<std::byte> buf) {
+    std::size_t size = 0;
+    {
+      auto f = file::create_in_buffer(buf);
+      h5_write(f, "object", x);
+      size = f.image_size();
+      if (f.buffer_view().data() != buf.data())
+        throw std::runtime_error("Error in h5::serialize_into: Buffer of size " + std::to_string(buf.size()) + " is too small, "
+                                 + std::to_string(size) + " bytes are required");
+    }
+    return size;
+  }
+
+  /**
+   * @brief Serialize an object to a byte buffer allocated with a given allocator.
+   *
+   * @details The buffer is allocated exactly once. If no size hint is given, the required size is determined with
+   * h5::serialized_size first. If the size hint is too small, an exception is thrown.
+   *
+   * @tparam T Type of the object.
+   * @tparam Alloc Allocator type for std::byte.
+   * @param x Object to be serialized.
+   * @param alloc Allocator used for the byte buffer.
+   * @param size_hint Size of the buffer in bytes (zero means that it is determined automatically).
+   * @return Byte buffer containing the serialized object.
+   */
+  template <typename T, typename Alloc>
+  [[nodiscard]] std::vector<std::byte, Alloc> serialize(T const &x, Alloc const &alloc, std::size_t size_hint = 0)
+     H5_REQUIRES(std::is_same_v<typename Alloc::value_type, std::byte>) {
+    auto buf = std::vector<std::byte, Alloc>(size_hint > 0 ? size_hint : serialized_size(x), alloc);
+    buf.resize(serialize_into(x, std::span<std::byte>{buf}));
+    return buf;
+  }
+
   /**
    * @brief Deserialize an object from a byte buffer.
    *
-   * @details It first creates a buffered memory file from the given byte buffer and then reads the object from the file.
+   * @details It first creates a read-only buffered memory file which operates directly on the given byte buffer (see
+   * h5::file::from_buffer_view) and then reads the object from the file. The buffer is not copied.
    *
    * @tparam T Type of the object.
    * @param buf Byte buffer containing the serialized object.
    * @return Object restored from the given byte buffer.
    */
   template <typename T>
-  [[nodiscard]] T deserialize(std::vector<std::byte> const &buf) {
-    file f{buf};
+  [[nodiscard]] T deserialize(std::span<std::byte const> buf) {
+    auto f = file::from_buffer_view(buf);
     return h5_read<T>(f, "object");
   }
 
+  /**
+   * @brief Deserialize an object from a byte buffer.
+   * @details See h5::deserialize(std::span<std::byte const>) for more details.
+   *
+   * @tparam T Type of the object.
+   * @param buf Byte buffer containing the serialized object.
+   * @return Object restored from the given byte buffer.
+   */
+  template <typename T>
+  [[nodiscard]] T deserialize(std::vector<std::byte> const &buf) {
+    return deserialize<T>(std::span<std::byte const>{buf});
+  }
+
   /** @} */
 
 } // namespace h5
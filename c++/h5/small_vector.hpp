@@ -0,0 +1,321 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+
+/**
+ * @file
+ * @brief Provides a vector with inline storage for a small number of elements.
+ */
+
+#ifndef LIBH5_SMALL_VECTOR_HPP
+#define LIBH5_SMALL_VECTOR_HPP
+
+#include "./utils.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace h5 {
+
+  /**
+   * @addtogroup utilities
+   * @{
+   */
+
+  /**
+   * @brief Contiguous container of trivially copyable elements which stores up to `N` elements inline.
+   *
+   * @details It provides the part of the `std::vector` interface which is used for the shapes and selections of
+   * dataspaces. Only if more than `N` elements are stored, the memory is allocated on the heap. It is implicitly
+   * convertible from and to an `std::vector` with the same value type, so that it can be used wherever an h5::v_t
+   * is expected.
+   *
+   * @tparam T Value type (has to be trivially copyable).
+   * @tparam N Number of inline elements.
+   */
+  template <typename T, std::size_t N>
+  class small_vector {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types are supported by h5::small_vector");
+    static_assert(N > 0, "The inline capacity of h5::small_vector has to be positive");
+
+    public:
+    /// Value type.
+    using value_type = T;
+
+    /// Size type.
+    using size_type = std::size_t;
+
+    /// Iterator type.
+    using iterator = T *;
+
+    /// Const iterator type.
+    using const_iterator = T const *;
+
+    /// Default constructor creates an empty vector.
+    small_vector() = default;
+
+    /**
+     * @brief Construct a vector with `n` copies of a given value.
+     * @param n Number of elements.
+     * @param value Value of the elements.
+     */
+    explicit small_vector(size_type n, T const &value = T{}) { assign(n, value); }
+
+    /**
+     * @brief Construct a vector from an initializer list.
+     * @param il Initializer list.
+     */
+    small_vector(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+    /**
+     * @brief Construct a vector from an iterator range.
+     *
+     * @tparam It Input iterator type.
+     * @param first Iterator to the first element.
+     * @param last Iterator past the last element.
+     */
+    template <std::input_iterator It>
+    small_vector(It first, It last) {
+      assign(first, last);
+    }
+
+    /**
+     * @brief Implicit conversion from an `std::vector`.
+     * @param v `std::vector` with the same value type.
+     */
+    small_vector(std::vector<T> const &v) { assign(v.begin(), v.end()); } // NOLINT (implicit conversion is intended)
+
+    /// Copy constructor.
+    small_vector(small_vector const &x) { assign(x.begin(), x.end()); }
+
+    /// Move constructor steals the heap memory of the moved from vector.
+    small_vector(small_vector &&x) noexcept { steal(x); }
+
+    /// Copy assignment operator.
+    small_vector &operator=(small_vector const &x) {
+      if (this != &x) assign(x.begin(), x.end());
+      return *this;
+    }
+
+    /// Move assignment operator steals the heap memory of the moved from vector.
+    small_vector &operator=(small_vector &&x) noexcept {
+      if (this != &x) {
+        deallocate();
+        steal(x);
+      }
+      return *this;
+    }
+
+    /// Assignment from an initializer list.
+    small_vector &operator=(std::initializer_list<T> il) {
+      assign(il.begin(), il.end());
+      return *this;
+    }
+
+    /// Destructor.
+    ~small_vector() { deallocate(); }
+
+    /// Implicit conversion to an `std::vector`.
+    operator std::vector<T>() const { return {begin(), end()}; } // NOLINT (implicit conversion is intended)
+
+    /**
+     * @brief Replace the contents with `n` copies of a given value.
+     * @param n Number of elements.
+     * @param value Value of the elements.
+     */
+    void assign(size_type n, T const &value) {
+      reserve_discard(n);
+      std::fill_n(data_, n, value);
+      size_ = n;
+    }
+
+    /**
+     * @brief Replace the contents with the elements of an iterator range.
+     *
+     * @tparam It Input iterator type.
+     * @param first Iterator to the first element.
+     * @param last Iterator past the last element.
+     */
+    template <std::input_iterator It>
+    void assign(It first, It last) {
+      if constexpr (std::forward_iterator<It>) {
+        auto n = static_cast<size_type>(std::distance(first, last));
+        reserve_discard(n);
+        std::copy(first, last, data_);
+        size_ = n;
+      } else {
+        clear();
+        for (; first != last; ++first) push_back(*first);
+      }
+    }
+
+    /// Get the number of elements.
+    [[nodiscard]] size_type size() const noexcept { return size_; }
+
+    /// Check whether the vector is empty.
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    /// Get the number of elements which can be stored without reallocation.
+    [[nodiscard]] size_type capacity() const noexcept { return cap_; }
+
+    /// Check whether the elements are stored inline, i.e. without a heap allocation.
+    [[nodiscard]] bool is_inline() const noexcept { return data_ == inline_data(); }
+
+    /// Get a pointer to the first element.
+    [[nodiscard]] T *data() noexcept { return data_; }
+
+    /// Get a const pointer to the first element.
+    [[nodiscard]] T const *data() const noexcept { return data_; }
+
+    /// Get an iterator to the first element.
+    [[nodiscard]] iterator begin() noexcept { return data_; }
+
+    /// Get a const iterator to the first element.
+    [[nodiscard]] const_iterator begin() const noexcept { return data_; }
+
+    /// Get a const iterator to the first element.
+    [[nodiscard]] const_iterator cbegin() const noexcept { return data_; }
+
+    /// Get an iterator past the last element.
+    [[nodiscard]] iterator end() noexcept { return data_ + size_; }
+
+    /// Get a const iterator past the last element.
+    [[nodiscard]] const_iterator end() const noexcept { return data_ + size_; }
+
+    /// Get a const iterator past the last element.
+    [[nodiscard]] const_iterator cend() const noexcept { return data_ + size_; }
+
+    /// Access the element at a given index (unchecked).
+    [[nodiscard]] T &operator[](size_type i) noexcept { return data_[i]; }
+
+    /// Access the element at a given index (unchecked).
+    [[nodiscard]] T const &operator[](size_type i) const noexcept { return data_[i]; }
+
+    /// Access the first element.
+    [[nodiscard]] T &front() noexcept { return data_[0]; }
+
+    /// Access the first element.
+    [[nodiscard]] T const &front() const noexcept { return data_[0]; }
+
+    /// Access the last element.
+    [[nodiscard]] T &back() noexcept { return data_[size_ - 1]; }
+
+    /// Access the last element.
+    [[nodiscard]] T const &back() const noexcept { return data_[size_ - 1]; }
+
+    /// Remove all elements (the capacity is kept).
+    void clear() noexcept { size_ = 0; }
+
+    /**
+     * @brief Make sure that at least `n` elements can be stored without reallocation.
+     * @param n Number of elements.
+     */
+    void reserve(size_type n) {
+      if (n <= cap_) return;
+      auto *p = std::allocator<T>{}.allocate(n);
+      std::copy(data_, data_ + size_, p);
+      deallocate();
+      data_ = p;
+      cap_  = n;
+    }
+
+    /**
+     * @brief Change the number of elements.
+     * @param n New number of elements.
+     * @param value Value of the added elements.
+     */
+    void resize(size_type n, T const &value = T{}) {
+      reserve(n);
+      if (n > size_) std::fill(data_ + size_, data_ + n, value);
+      size_ = n;
+    }
+
+    /// Append an element.
+    void push_back(T const &value) {
+      if (size_ == cap_) {
+        auto x = value; // value could refer to an element of the vector
+        reserve(2 * cap_);
+        data_[size_++] = x;
+      } else {
+        data_[size_++] = value;
+      }
+    }
+
+    /// Remove the last element.
+    void pop_back() noexcept { --size_; }
+
+    /// Check whether two vectors have the same elements (also used for comparisons with an `std::vector`).
+    friend bool operator==(small_vector const &a, small_vector const &b) { return std::equal(a.begin(), a.end(), b.begin(), b.end()); }
+
+    private:
+    [[nodiscard]] T *inline_data() noexcept { return reinterpret_cast<T *>(buf_); }
+    [[nodiscard]] T const *inline_data() const noexcept { return reinterpret_cast<T const *>(buf_); }
+
+    // Make room for n elements without keeping the current ones.
+    void reserve_discard(size_type n) {
+      if (n <= cap_) return;
+      auto *p = std::allocator<T>{}.allocate(n);
+      deallocate();
+      data_ = p;
+      cap_  = n;
+      size_ = 0;
+    }
+
+    // Free the heap memory (if any) and switch back to the inline storage (the size is not changed).
+    void deallocate() noexcept {
+      if (not is_inline()) std::allocator<T>{}.deallocate(data_, cap_);
+      data_ = inline_data();
+      cap_  = N;
+    }
+
+    // Take over the elements of another vector and leave it empty.
+    void steal(small_vector &x) noexcept {
+      if (x.is_inline()) {
+        std::copy(x.begin(), x.end(), inline_data());
+        size_ = x.size_;
+      } else {
+        data_ = std::exchange(x.data_, x.inline_data());
+        cap_  = std::exchange(x.cap_, N);
+        size_ = x.size_;
+      }
+      x.size_ = 0;
+    }
+
+    private:
+    alignas(T) std::byte buf_[N * sizeof(T)];
+    T *data_         = inline_data();
+    size_type size_  = 0;
+    size_type cap_   = N;
+  };
+
+  /**
+   * @brief Small vector of h5::hsize_t used for the shapes and selections of hyperslabs and array views.
+   *
+   * @details Up to 8 dimensions (including the possible added imaginary dimension) are stored without a heap allocation.
+   */
+  using dims_t = small_vector<hsize_t, 8>;
+
+  /** @} */
+
+} // namespace h5
+
+#endif // LIBH5_SMALL_VECTOR_HPP
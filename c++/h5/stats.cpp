@@ -0,0 +1,213 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Implementation details for stats.hpp.
+ */
+
+#include "./stats.hpp"
+
+#include <hdf5.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace h5 {
+
+  namespace {
+
+    using clock_t = std::chrono::steady_clock;
+
+    // Global state of the instrumentation (initialized once in a thread-safe way).
+    struct recorder {
+      std::mutex mtx;
+      std::map<std::string, op_stats, std::less<>> ops;
+      std::vector<trace_event> events;
+      std::atomic<bool> tracing = false;
+      std::size_t max_events    = 0;
+      clock_t::time_point epoch = clock_t::now();
+    };
+
+    recorder &get_recorder() {
+      static recorder rec;
+      return rec;
+    }
+
+    // Small integer identifying the calling thread.
+    std::uint32_t this_thread_id() {
+      static std::atomic<std::uint32_t> next_id = 0;
+      thread_local std::uint32_t const id       = next_id++;
+      return id;
+    }
+
+    // Get the full path of an HDF5 object.
+    std::string get_path(hid_t loc) {
+      ssize_t size = H5Iget_name(loc, nullptr, 0);
+      if (size <= 0) return {};
+      std::string res(size, '\0');
+      H5Iget_name(loc, res.data(), size + 1);
+      return res;
+    }
+
+    // Append a string to a JSON document (with escaping).
+    void append_json_string(std::string &out, std::string_view s) {
+      out += '"';
+      for (char c : s) {
+        switch (c) {
+          case '"': out += "\\\""; break;
+          case '\\': out += "\\\\"; break;
+          case '\n': out += "\\n"; break;
+          case '\t': out += "\\t"; break;
+          default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+              std::array<char, 8> buf{};
+              std::snprintf(buf.data(), buf.size(), "\\u%04x", static_cast<unsigned>(c));
+              out += buf.data();
+            } else {
+              out += c;
+            }
+        }
+      }
+      out += '"';
+    }
+
+    // Convert a number to a string for a JSON document.
+    template <typename T>
+    std::string to_json_number(T x) {
+      std::ostringstream ss;
+      ss.precision(17);
+      ss << x;
+      return ss.str();
+    }
+
+  } // namespace
+
+  std::map<std::string, op_stats> stats() {
+    auto &rec = get_recorder();
+    std::lock_guard lock(rec.mtx);
+    return {rec.ops.begin(), rec.ops.end()};
+  }
+
+  void reset_stats() {
+    auto &rec = get_recorder();
+    std::lock_guard lock(rec.mtx);
+    rec.ops.clear();
+    rec.events.clear();
+  }
+
+  void enable_tracing(bool on, std::size_t max_events) {
+    auto &rec = get_recorder();
+    std::lock_guard lock(rec.mtx);
+    rec.max_events = max_events;
+    rec.tracing.store(on, std::memory_order_relaxed);
+  }
+
+  bool tracing_enabled() { return get_recorder().tracing.load(std::memory_order_relaxed); }
+
+  std::vector<trace_event> trace_events() {
+    auto &rec = get_recorder();
+    std::lock_guard lock(rec.mtx);
+    return rec.events;
+  }
+
+  std::string stats_to_json() {
+    std::string out = "{";
+    bool first      = true;
+    for (auto const &[op, s] : stats()) {
+      if (not first) out += ", ";
+      first = false;
+      append_json_string(out, op);
+      out += ": {\"calls\": " + std::to_string(s.calls) + ", \"bytes\": " + std::to_string(s.bytes) + ", \"seconds\": " + to_json_number(s.seconds)
+         + "}";
+    }
+    return out + "}";
+  }
+
+  std::string trace_to_json() {
+    std::string out = "{\"traceEvents\": [";
+    bool first      = true;
+    for (auto const &ev : trace_events()) {
+      out += (first ? "\n" : ",\n");
+      first = false;
+      out += "{\"name\": ";
+      append_json_string(out, ev.op);
+      out += ", \"cat\": \"h5\", \"ph\": \"X\", \"ts\": " + to_json_number(ev.start_us) + ", \"dur\": " + to_json_number(ev.duration_us)
+         + ", \"pid\": 0, \"tid\": " + std::to_string(ev.thread_id) + ", \"args\": {\"name\": ";
+      append_json_string(out, ev.name);
+      out += ", \"bytes\": " + std::to_string(ev.bytes) + "}}";
+    }
+    return out + "\n]}\n";
+  }
+
+  void write_trace(std::string const &path) {
+    std::ofstream os(path);
+    if (not os) throw std::runtime_error("Error in h5::write_trace: Opening the file " + path + " failed");
+    os << trace_to_json();
+  }
+
+  namespace detail {
+
+    // the recorder is initialized before the first call is timed
+    scoped_op::scoped_op(const char *op, std::string_view name) : op_(op), name_(name) {
+      get_recorder();
+      start_ = clock_t::now();
+    }
+
+    scoped_op::scoped_op(const char *op, hid_t loc, std::string_view name) : scoped_op(op, name) { loc_ = loc; }
+
+    scoped_op::~scoped_op() {
+      auto end  = clock_t::now();
+      auto &rec = get_recorder();
+
+      // object names are only needed for the trace events
+      bool trace = rec.tracing.load(std::memory_order_relaxed);
+      std::string name;
+      if (trace) {
+        if (loc_ > 0) name = get_path(loc_);
+        if (not name_.empty()) {
+          if (not name.empty() and name.back() != '/') name += '/';
+          name += name_;
+        }
+      }
+
+      std::lock_guard lock(rec.mtx);
+      auto it = rec.ops.find(std::string_view{op_});
+      if (it == rec.ops.end()) it = rec.ops.emplace(op_, op_stats{}).first;
+      auto &s = it->second;
+      ++s.calls;
+      s.bytes += bytes_;
+      s.seconds += std::chrono::duration<double>(end - start_).count();
+
+      if (trace and rec.events.size() < rec.max_events) {
+        rec.events.push_back({op_, std::move(name), std::chrono::duration<double, std::micro>(start_ - rec.epoch).count(),
+                              std::chrono::duration<double, std::micro>(end - start_).count(), bytes_, this_thread_id()});
+      }
+    }
+
+  } // namespace detail
+
+} // namespace h5
@@ -0,0 +1,180 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Provides an opt-in instrumentation layer which records call counts, wall times and transferred bytes of
+ * the I/O operations in h5.
+ */
+
+#ifndef LIBH5_STATS_HPP
+#define LIBH5_STATS_HPP
+
+#include "./utils.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ---------------- Instrumentation ----------------
+
+#ifdef H5_INSTRUMENTATION
+#define H5_INSTRUMENT(VAR, ...) ::h5::detail::scoped_op VAR{__VA_ARGS__}
+#define H5_INSTRUMENT_BYTES(VAR, N) VAR.add_bytes(N)
+#else
+#define H5_INSTRUMENT(VAR, ...)
+#define H5_INSTRUMENT_BYTES(VAR, N)
+#endif
+
+namespace h5 {
+
+  /**
+   * @addtogroup stats
+   * @{
+   */
+
+  /**
+   * @brief Whether h5 has been compiled with instrumentation.
+   *
+   * @details The instrumentation is enabled by defining the macro `H5_INSTRUMENTATION` when compiling h5 (CMake option
+   * `Enable_Instrumentation`). Otherwise, no operations are recorded and the functions below return empty results.
+   */
+#ifdef H5_INSTRUMENTATION
+  constexpr bool instrumentation_enabled = true;
+#else
+  constexpr bool instrumentation_enabled = false;
+#endif
+
+  /// Accumulated statistics of a single instrumented operation.
+  struct op_stats {
+    /// Number of calls.
+    std::uint64_t calls = 0;
+
+    /// Number of bytes transferred to or from the file.
+    std::uint64_t bytes = 0;
+
+    /// Accumulated wall time in seconds (including the time spent in nested instrumented operations).
+    double seconds = 0.0;
+  };
+
+  /// Single recorded call of an instrumented operation.
+  struct trace_event {
+    /// Name of the operation, e.g. "array_interface::write".
+    std::string op;
+
+    /// Full path of the dataset, group, attribute or file the operation acted on.
+    std::string name;
+
+    /// Start time in microseconds since the first instrumented call.
+    double start_us = 0.0;
+
+    /// Duration in microseconds.
+    double duration_us = 0.0;
+
+    /// Number of bytes transferred.
+    std::uint64_t bytes = 0;
+
+    /// Small integer identifying the calling thread.
+    std::uint32_t thread_id = 0;
+  };
+
+  /**
+   * @brief Get the accumulated statistics of all instrumented operations.
+   * @return std::map from the operation names to their h5::op_stats.
+   */
+  [[nodiscard]] std::map<std::string, op_stats> stats();
+
+  /// Reset all accumulated statistics and discard the recorded trace events.
+  void reset_stats();
+
+  /**
+   * @brief Turn the recording of individual trace events on or off.
+   *
+   * @details Trace events contain the names of the objects an operation acted on. Retrieving the names requires
+   * additional HDF5 calls, therefore tracing is off by default, even if the instrumentation is enabled.
+   *
+   * @param on Whether to record trace events.
+   * @param max_events Maximum number of recorded events (further events are dropped).
+   */
+  void enable_tracing(bool on = true, std::size_t max_events = 1'000'000);
+
+  /// Check whether trace events are recorded.
+  [[nodiscard]] bool tracing_enabled();
+
+  /// Get a copy of the recorded trace events.
+  [[nodiscard]] std::vector<trace_event> trace_events();
+
+  /**
+   * @brief Get the accumulated statistics as a JSON object.
+   * @return JSON string of the form `{"<op>": {"calls": ..., "bytes": ..., "seconds": ...}, ...}`.
+   */
+  [[nodiscard]] std::string stats_to_json();
+
+  /**
+   * @brief Get the recorded trace events in the Chrome trace event format.
+   *
+   * @details The output can be loaded into `chrome://tracing` or Perfetto.
+   *
+   * @return JSON string of the form `{"traceEvents": [...]}`.
+   */
+  [[nodiscard]] std::string trace_to_json();
+
+  /**
+   * @brief Write the recorded trace events in the Chrome trace event format to a file.
+   * @param path Path of the output file.
+   */
+  void write_trace(std::string const &path);
+
+  /** @} */
+
+  namespace detail {
+
+    // Record a single call of an instrumented operation from construction to destruction (see H5_INSTRUMENT).
+    class scoped_op {
+      public:
+      // Construct the recorder for an operation on the object with the given name.
+      scoped_op(const char *op, std::string_view name = {});
+
+      // Construct the recorder for an operation on the child with the given name of the given object (the full path
+      // is only retrieved if tracing is enabled).
+      scoped_op(const char *op, hid_t loc, std::string_view name = {});
+
+      scoped_op(scoped_op const &)            = delete;
+      scoped_op &operator=(scoped_op const &) = delete;
+
+      // Record the call.
+      ~scoped_op();
+
+      // Add to the number of transferred bytes.
+      void add_bytes(std::uint64_t n) { bytes_ += n; }
+
+      private:
+      const char *op_;
+      hid_t loc_ = 0;
+      std::string_view name_;
+      std::uint64_t bytes_ = 0;
+      std::chrono::steady_clock::time_point start_;
+    };
+
+  } // namespace detail
+
+} // namespace h5
+
+#endif // LIBH5_STATS_HPP
@@ -24,16 +24,55 @@
 
 #include "../array_interface.hpp"
 #include "../complex.hpp"
+#include "../compound.hpp"
 #include "../macros.hpp"
 
 #include <algorithm>
 #include <array>
-#include <iostream>
+#include <cstddef>
 #include <string>
+#include <tuple>
 #include <type_traits>
 
 namespace h5 {
 
+  namespace detail {
+
+    // Value type, rank and shape of (nested) std::array objects.
+    template <typename T>
+    struct _nested_std_array {
+      using value_type                  = T;
+      static constexpr int rank          = 0;
+      static constexpr std::size_t size = 1;
+      static v_t shape() { return {}; }
+    };
+
+    template <typename T, std::size_t N>
+    struct _nested_std_array<std::array<T, N>> {
+      using value_type                  = typename _nested_std_array<T>::value_type;
+      static constexpr int rank          = 1 + _nested_std_array<T>::rank;
+      static constexpr std::size_t size = N * _nested_std_array<T>::size;
+      static v_t shape() {
+        auto res = _nested_std_array<T>::shape();
+        res.insert(res.begin(), N);
+        return res;
+      }
+    };
+
+    // Is T a nested std::array of arithmetic/complex types with contiguous elements, i.e. can it be stored in a
+    // multidimensional dataset?
+    template <typename T>
+    constexpr bool is_nested_simple_array_v = [] {
+      using V = typename _nested_std_array<T>::value_type;
+      if constexpr (_nested_std_array<T>::rank < 2 or not(std::is_arithmetic_v<V> or is_complex_v<V>)) {
+        return false;
+      } else {
+        return sizeof(T) == _nested_std_array<T>::size * sizeof(V);
+      }
+    }();
+
+  } // namespace detail
+
   /**
    * @addtogroup rw_array
    * @{
@@ -42,6 +81,10 @@ namespace h5 {
   /**
    * @brief Write a std::array to an HDF5 dataset/subgroup.
    *
+   * @details Arrays of arithmetic/complex types and nested arrays of them, e.g. `std::array<std::array<double, 3>, 3>`,
+   * are written to a single (multidimensional) dataset. Arrays of other types create a subgroup with a "shape" dataset
+   * and one dataset/subgroup per element.
+   *
    * @tparam T Value type of the std::array.
    * @tparam N Size of the std::array.
    * @param g h5::group in which the dataset/subgroup is created.
@@ -55,7 +98,7 @@ namespace h5 {
       auto char_arr = std::array<const char *, N>{};
       std::transform(cbegin(a), cend(a), begin(char_arr), [](std::string const &s) { return s.c_str(); });
       h5_write(g, name, char_arr);
-    } else if constexpr (std::is_arithmetic_v<T> or is_complex_v<T> or std::is_same_v<T, dcplx_t> or std::is_same_v<T, char *>
+    } else if constexpr (std::is_arithmetic_v<T> or is_complex_v<T> or std::is_same_v<T, dcplx_t> or is_compound_v<T> or std::is_same_v<T, char *>
                          or std::is_same_v<T, const char *>) {
       // array of arithmetic/complex types or char* or const char*
       h5::array_interface::array_view v{hdf5_type<T>(), (void *)a.data(), 1, is_complex_v<T>};
@@ -63,6 +106,14 @@ namespace h5 {
       v.slab.stride[0]  = 1;
       v.parent_shape[0] = N;
       h5::array_interface::write(g, name, v, true);
+    } else if constexpr (detail::is_nested_simple_array_v<std::array<T, N>>) {
+      // nested arrays of arithmetic/complex types
+      using V     = typename detail::_nested_std_array<T>::value_type;
+      auto shape  = detail::_nested_std_array<std::array<T, N>>::shape();
+      auto rank   = static_cast<int>(shape.size());
+      auto v      = h5::array_interface::array_view{hdf5_type<V>(), (void *)a.data(), rank, is_complex_v<V>};
+      for (int i = 0; i < rank; ++i) v.slab.count[i] = v.parent_shape[i] = shape[i];
+      h5::array_interface::write(g, name, v, true);
     } else {
       // array of generic type
       auto g2 = g.create_group(name);
@@ -71,6 +122,25 @@ namespace h5 {
     }
   }
 
+  /**
+   * @brief Write a std::array of arithmetic or complex types to an HDF5 dataset using the given dataset creation policy.
+   *
+   * @tparam T Value type of the std::array (arithmetic or complex).
+   * @tparam N Size of the std::array.
+   * @param g h5::group in which the dataset is created.
+   * @param name Name of the dataset to which the std::array is written.
+   * @param a std::array to be written.
+   * @param opts h5::write_options specifying the chunking, the filter pipeline and the fill value settings.
+   */
+  template <typename T, size_t N>
+  void h5_write(group g, std::string const &name, std::array<T, N> const &a, write_options const &opts)
+     H5_REQUIRES(std::is_arithmetic_v<T> or is_complex_v<T>) {
+    h5::array_interface::array_view v{hdf5_type<T>(), (void *)a.data(), 1, is_complex_v<T>};
+    v.slab.count[0]   = N;
+    v.parent_shape[0] = N;
+    h5::array_interface::write(g, name, v, opts);
+  }
+
   /**
    * @brief Read a std::array from an HDF5 dataset/subgroup.
    *
@@ -79,47 +149,63 @@ namespace h5 {
    * @param g h5::group containing the dataset/subgroup.
    * @param name Name of the dataset/subgroup from which the std::array is read.
    * @param a std::array to read into.
+   * @param xfer h5::transfer_options specifying the data transfer mode and the type conversion policy (only used for
+   * arrays of arithmetic/complex types).
    */
   template <typename T, size_t N>
-  void h5_read(group g, std::string name, std::array<T, N> &a) {
+  void h5_read(group g, std::string name, std::array<T, N> &a, transfer_options const &xfer = {}) {
     if constexpr (std::is_same_v<T, std::string>) {
       // array of strings
       auto char_arr = std::array<char *, N>{};
       h5_read(g, name, char_arr);
       std::copy(cbegin(char_arr), cend(char_arr), begin(a));
       std::for_each(begin(char_arr), end(char_arr), [](char *cb) { free(cb); }); // NOLINT (we have to free the memory allocated by h5_read)
-    } else if constexpr (std::is_arithmetic_v<T> or is_complex_v<T> or std::is_same_v<T, dcplx_t> or std::is_same_v<T, char *>
+    } else if constexpr (std::is_arithmetic_v<T> or is_complex_v<T> or std::is_same_v<T, dcplx_t> or is_compound_v<T> or std::is_same_v<T, char *>
                          or std::is_same_v<T, const char *>) {
-      // array of arithmetic/complex types or char* or const char*
-      auto ds_info = array_interface::get_dataset_info(g, name);
+      // array of arithmetic/complex types or char* or const char* (open the dataset only once)
+      auto ds      = g.open_dataset(name);
+      auto ds_info = array_interface::get_dataset_info(ds);
       H5_EXPECTS(ds_info.rank() == 1 + ds_info.has_complex_attribute);
       H5_EXPECTS(N == ds_info.lengths[0]);
 
-      if constexpr (is_complex_v<T>) {
-        // read complex values stored as a compound HDF5 datatype
-        if (hdf5_type_equal(ds_info.ty, hdf5_type<dcplx_t>())) {
-          h5_read(g, name, reinterpret_cast<std::array<dcplx_t, N> &>(a)); // NOLINT (reinterpret_cast is safe here)
-          return;
-        }
+      // use array_interface to read
+      array_interface::array_view v{hdf5_type<T>(), (void *)(a.data()), 1, is_complex_v<T>};
+      v.slab.count[0]   = N;
+      v.slab.stride[0]  = 1;
+      v.parent_shape[0] = N;
 
-        // read non-complex data into std::array<std::complex>
+      if constexpr (is_complex_v<T>) {
+        // read non-complex data into std::array<std::complex> (if the conversion policy allows it)
         if (!ds_info.has_complex_attribute) {
-          std::cerr << "WARNING: HDF5 type mismatch while reading into a std::array: std::complex<" + get_name_of_h5_type(hdf5_type<T>())
-                + "> != " + get_name_of_h5_type(ds_info.ty) + "\n";
-          std::array<double, N> tmp{};
-          h5_read(g, name, tmp);
+          std::ignore = array_interface::check_read_compatibility(ds_info, v, xfer);
+          auto real_xfer       = xfer;
+          real_xfer.conversion = transfer_options::conversion_policy::allow;
+          std::array<typename T::value_type, N> tmp{};
+          h5_read(g, name, tmp, real_xfer);
           std::copy(begin(tmp), end(tmp), begin(a));
           return;
         }
       }
-
-      // use array_interface to read
-      array_interface::array_view v{hdf5_type<T>(), (void *)(a.data()), 1, is_complex_v<T>};
-      v.slab.count[0]   = N;
-      v.slab.stride[0]  = 1;
-      v.parent_shape[0] = N;
-      array_interface::read(g, name, v);
+      array_interface::read(ds, v, {}, xfer);
     } else {
+      if constexpr (detail::is_nested_simple_array_v<std::array<T, N>>) {
+        // nested arrays of arithmetic/complex types stored in a multidimensional dataset
+        if (g.has_dataset(name)) {
+          using V      = typename detail::_nested_std_array<T>::value_type;
+          auto shape   = detail::_nested_std_array<std::array<T, N>>::shape();
+          auto rank    = static_cast<int>(shape.size());
+          auto ds      = g.open_dataset(name);
+          auto ds_info = array_interface::get_dataset_info(ds);
+          H5_EXPECTS(ds_info.has_complex_attribute == is_complex_v<V>);
+          H5_EXPECTS(ds_info.rank() == rank + ds_info.has_complex_attribute);
+          H5_EXPECTS(std::equal(shape.begin(), shape.end(), ds_info.lengths.begin()));
+          auto v = array_interface::array_view{hdf5_type<V>(), (void *)(a.data()), rank, is_complex_v<V>};
+          for (int i = 0; i < rank; ++i) v.slab.count[i] = v.parent_shape[i] = shape[i];
+          array_interface::read(ds, v);
+          return;
+        }
+      }
+
       // array of generic type
       auto g2 = g.open_group(name);
 
@@ -0,0 +1,237 @@
+// Copyright (c) 2019-2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn, Olivier Parcollet, Nils Wentzell, chuffa
+
+/**
+ * @file
+ * @brief Provides functions to read/write contiguous ranges of arithmetic/complex types (e.g. std::span) from/to HDF5.
+ */
+
+#ifndef LIBH5_STL_CONTIGUOUS_RANGE_HPP
+#define LIBH5_STL_CONTIGUOUS_RANGE_HPP
+
+#include "../array_interface.hpp"
+#include "../complex.hpp"
+#include "../group.hpp"
+#include "../object.hpp"
+#include "../properties.hpp"
+#include "../utils.hpp"
+
+#include <array>
+#include <cstddef>
+#include <ranges>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace h5 {
+
+  namespace detail {
+
+    // Types with their own h5_write/h5_read overloads which must not be treated as generic ranges.
+    template <typename T>
+    struct _has_dedicated_rw : std::false_type {};
+
+    template <typename T, typename A>
+    struct _has_dedicated_rw<std::vector<T, A>> : std::true_type {};
+
+    template <typename T, std::size_t N>
+    struct _has_dedicated_rw<std::array<T, N>> : std::true_type {};
+
+    template <typename C, typename T, typename A>
+    struct _has_dedicated_rw<std::basic_string<C, T, A>> : std::true_type {};
+
+  } // namespace detail
+
+  /**
+   * @addtogroup rw_range
+   * @{
+   */
+
+  /**
+   * @brief Concept to check if a type is a sized contiguous range of arithmetic or complex values, e.g. `std::span<double>`.
+   *
+   * @details `std::vector`, `std::array` and `std::basic_string` are excluded since they have their own overloads. Ranges
+   * of `char` are excluded as well, since they are treated as strings.
+   *
+   * @tparam R Range type.
+   */
+  template <typename R>
+  concept SimpleContiguousRange = std::ranges::contiguous_range<R> and std::ranges::sized_range<R>
+     and not detail::_has_dedicated_rw<std::remove_cvref_t<R>>::value and not std::is_same_v<std::ranges::range_value_t<R>, char>
+     and (std::is_arithmetic_v<std::ranges::range_value_t<R>> or is_complex_v<std::ranges::range_value_t<R>>);
+
+  /// Concept to check if a type is an h5::SimpleContiguousRange whose elements can be modified.
+  template <typename R>
+  concept WritableContiguousRange = SimpleContiguousRange<R> and std::ranges::output_range<R, std::ranges::range_value_t<R>>;
+
+  /** @} */
+
+  namespace array_interface {
+
+    /**
+     * @ingroup rw_arrayinterface
+     * @brief Create an h5::array_interface::array_view for a contiguous range without copying its elements.
+     *
+     * @tparam R h5::SimpleContiguousRange type.
+     * @param r Contiguous range.
+     * @return h5::array_interface::array_view of rank 1.
+     */
+    template <SimpleContiguousRange R>
+    array_view array_view_from_range(R &&r) {
+      using T = std::ranges::range_value_t<R>;
+      array_view res{hdf5_type<T>(), (void *)std::ranges::data(r), 1, is_complex_v<T>};
+      res.slab.count[0]   = std::ranges::size(r);
+      res.parent_shape[0] = std::ranges::size(r);
+      return res;
+    }
+
+  } // namespace array_interface
+
+  namespace detail {
+
+    // Create a 1d hyperslab of n elements starting at the given offset.
+    template <typename T>
+    array_interface::hyperslab make_range_slab(hsize_t offset, hsize_t n) {
+      array_interface::hyperslab sl{1, is_complex_v<T>};
+      sl.offset[0] = offset;
+      sl.count[0]  = n;
+      return sl;
+    }
+
+  } // namespace detail
+
+  /**
+   * @addtogroup rw_range
+   * @{
+   */
+
+  /**
+   * @brief Write a contiguous range to a 1d HDF5 dataset.
+   *
+   * @details The elements are written directly from the memory of the range, i.e. a sub-range of a larger buffer
+   * can be written without copying it into a std::vector first. The dataset is the same as the one written for a
+   * std::vector with the same elements.
+   *
+   * @tparam R h5::SimpleContiguousRange type.
+   * @param g h5::group in which the dataset is created.
+   * @param name Name of the dataset.
+   * @param r Contiguous range to be written.
+   */
+  template <SimpleContiguousRange R>
+  void h5_write(group g, std::string const &name, R const &r) {
+    array_interface::write(g, name, array_interface::array_view_from_range(r), true);
+  }
+
+  /**
+   * @brief Write a contiguous range to a 1d HDF5 dataset using the given dataset creation policy.
+   *
+   * @tparam R h5::SimpleContiguousRange type.
+   * @param g h5::group in which the dataset is created.
+   * @param name Name of the dataset.
+   * @param r Contiguous range to be written.
+   * @param opts h5::write_options specifying the chunking, the filter pipeline and the fill value settings.
+   */
+  template <SimpleContiguousRange R>
+  void h5_write(group g, std::string const &name, R const &r, write_options const &opts) {
+    array_interface::write(g, name, array_interface::array_view_from_range(r), opts);
+  }
+
+  /**
+   * @brief Read a 1d HDF5 dataset into a contiguous range.
+   *
+   * @details The range is not resized, i.e. it must have the same number of elements as the dataset. The elements are
+   * read directly into the memory of the range.
+   *
+   * @tparam R h5::WritableContiguousRange type.
+   * @param g h5::group containing the dataset.
+   * @param name Name of the dataset.
+   * @param r Contiguous range to read into.
+   */
+  template <WritableContiguousRange R>
+  void h5_read(group g, std::string const &name, R &&r) {
+    using T      = std::ranges::range_value_t<R>;
+    auto ds      = g.open_dataset(name);
+    auto lengths = array_interface::get_dataset_shape(ds);
+    int rank     = static_cast<int>(lengths.size());
+    if (rank != 1 + is_complex_v<T> and not(is_complex_v<T> and rank == 1))
+      throw make_runtime_error("Error in h5_read: Reading a contiguous range from an array of rank ", rank, " is not allowed");
+    if (lengths[0] != std::ranges::size(r))
+      throw make_runtime_error("Error in h5_read: Size of the contiguous range (", std::ranges::size(r), ") does not match the size of the dataset ",
+                               name, " (", lengths[0], ")");
+    array_interface::read(ds, array_interface::array_view_from_range(r));
+  }
+
+  /**
+   * @brief Append a contiguous range to an extensible 1d HDF5 dataset.
+   *
+   * @details See h5::h5_append(group, std::string const &, std::vector<T> const &, write_options const &).
+   *
+   * @tparam R h5::SimpleContiguousRange type.
+   * @param g h5::group containing the dataset.
+   * @param name Name of the dataset.
+   * @param r Contiguous range to be appended.
+   * @param opts h5::write_options used to create the dataset (ignored if the dataset already exists).
+   */
+  template <SimpleContiguousRange R>
+  void h5_append(group g, std::string const &name, R const &r, write_options const &opts = {.deflate_level = 1}) {
+    if (g.has_key(name))
+      array_interface::append(g, name, array_interface::array_view_from_range(r));
+    else
+      array_interface::create_extensible(g, name, array_interface::array_view_from_range(r), opts);
+  }
+
+  /**
+   * @brief Write a contiguous range to a part of an existing 1d HDF5 dataset.
+   *
+   * @details The elements are written to the positions `[offset, offset + size(r))` of the dataset, which has to be
+   * large enough.
+   *
+   * @tparam R h5::SimpleContiguousRange type.
+   * @param g h5::group containing the dataset.
+   * @param name Name of the dataset.
+   * @param r Contiguous range to be written.
+   * @param offset Position of the first element in the dataset.
+   * @param xfer h5::transfer_options specifying the data transfer mode.
+   */
+  template <SimpleContiguousRange R>
+  void write_slice(group g, std::string const &name, R const &r, hsize_t offset, transfer_options const &xfer = {}) {
+    using T = std::ranges::range_value_t<R>;
+    array_interface::write_slice(g, name, array_interface::array_view_from_range(r), detail::make_range_slab<T>(offset, std::ranges::size(r)), xfer);
+  }
+
+  /**
+   * @brief Read a part of a 1d HDF5 dataset into a contiguous range.
+   *
+   * @details The positions `[offset, offset + size(r))` of the dataset are read.
+   *
+   * @tparam R h5::WritableContiguousRange type.
+   * @param g h5::group containing the dataset.
+   * @param name Name of the dataset.
+   * @param r Contiguous range to read into.
+   * @param offset Position of the first element in the dataset.
+   * @param xfer h5::transfer_options specifying the data transfer mode.
+   */
+  template <WritableContiguousRange R>
+  void read_slice(group g, std::string const &name, R &&r, hsize_t offset, transfer_options const &xfer = {}) {
+    using T = std::ranges::range_value_t<R>;
+    array_interface::read(g, name, array_interface::array_view_from_range(r), detail::make_range_slab<T>(offset, std::ranges::size(r)), xfer);
+  }
+
+  /** @} */
+
+} // namespace h5
+
+#endif // LIBH5_STL_CONTIGUOUS_RANGE_HPP
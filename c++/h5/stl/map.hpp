@@ -25,7 +25,10 @@
 #include "../format.hpp"
 #include "../group.hpp"
 #include "./string.hpp"
+#include "./vector.hpp"
+#include "../complex.hpp"
 
+#include <cstddef>
 #include <map>
 #include <string>
 #include <type_traits>
@@ -33,11 +36,23 @@
 
 namespace h5 {
 
+  namespace detail {
+
+    // Can a std::map<keyT, valueT> be stored in the columnar layout?
+    template <typename keyT, typename valueT>
+    constexpr bool is_columnar_map_v = ((std::is_arithmetic_v<keyT> and not std::is_same_v<keyT, bool>) or std::is_same_v<keyT, std::string>)
+       and ((std::is_arithmetic_v<valueT> and not std::is_same_v<valueT, bool>) or is_complex_v<valueT>);
+
+  } // namespace detail
+
   /**
    * @addtogroup rw_map
    * @{
    */
 
+  /// `hdf5_format` tag of the columnar layout of a std::map with arithmetic/string keys and arithmetic/complex values.
+  constexpr const char *columnar_dict_format = "ColumnarDict";
+
   /// Specialization of h5::hdf5_format_impl for std::map.
   template <typename keyT, typename valueT>
   struct hdf5_format_impl<std::map<keyT, valueT>> {
@@ -47,6 +62,13 @@ namespace h5 {
   /**
    * @brief Write a std::map to an HDF5 subgroup.
    *
+   * @details Depending on the key and value types, the following is written:
+   * - If the keys are arithmetic types or strings and the values are arithmetic or complex types, the subgroup gets the
+   * `hdf5_format` tag "ColumnarDict" and contains 2 datasets: "keys" stores the sorted keys and "values" stores the
+   * corresponding values (columnar layout).
+   * - If the keys are strings, each value is written to a dataset/subgroup with the key as its name.
+   * - Otherwise, each key-value pair is written to a subgroup containing a "key" and a "val" dataset/subgroup.
+   *
    * @tparam keyT Key type of the std::map.
    * @tparam valueT Value type of the std::map.
    * @param g h5::group in which the subgroup is created.
@@ -55,11 +77,27 @@ namespace h5 {
    */
   template <typename keyT, typename valueT>
   void h5_write(group g, std::string const &name, std::map<keyT, valueT> const &m) {
-    // create the subgroup and write the hdf5_format tag
+    // create the subgroup
     auto gr = g.create_group(name);
-    write_hdf5_format(gr, m);
 
-    // write element by element
+    if constexpr (detail::is_columnar_map_v<keyT, valueT>) {
+      // write all keys and all values at once (columnar layout)
+      std::vector<keyT> keys;
+      std::vector<valueT> values;
+      keys.reserve(m.size());
+      values.reserve(m.size());
+      for (auto const &[key, val] : m) {
+        keys.push_back(key);
+        values.push_back(val);
+      }
+      write_hdf5_format_as_string(gr, columnar_dict_format);
+      h5_write(gr, "keys", keys);
+      h5_write(gr, "values", values);
+      return;
+    }
+
+    // write the hdf5_format tag and the map element by element
+    write_hdf5_format(gr, m);
     if constexpr (std::is_same_v<keyT, std::string>) {
       // if key is a string, use it for the dataset name
       for (auto const &[key, val] : m) h5_write(gr, key, val);
@@ -78,6 +116,10 @@ namespace h5 {
   /**
    * @brief Read a std::map from an HDF5 subgroup.
    *
+   * @details Both the columnar layout and the element-wise layouts written by
+   * h5::h5_write(group, std::string const &, std::map<keyT, valueT> const &) can be read. In the columnar layout, the
+   * keys and values are read in bulk and the map is constructed with hinted insertions.
+   *
    * @tparam keyT Key type of the std::map.
    * @tparam valueT Value type of the std::map.
    * @param g h5::group containing the subgroup.
@@ -90,6 +132,20 @@ namespace h5 {
     auto gr = g.open_group(name);
     m.clear();
 
+    if constexpr (detail::is_columnar_map_v<keyT, valueT>) {
+      // read all keys and all values at once (columnar layout)
+      if (read_hdf5_format(gr) == columnar_dict_format) {
+        std::vector<keyT> keys;
+        std::vector<valueT> values;
+        h5_read(gr, "keys", keys);
+        h5_read(gr, "values", values);
+        if (keys.size() != values.size())
+          throw make_runtime_error("Error in h5_read: Number of keys and values in the columnar layout of ", name, " do not match");
+        for (std::size_t i = 0; i < keys.size(); ++i) m.emplace_hint(m.end(), std::move(keys[i]), values[i]);
+        return;
+      }
+    }
+
     // loop over all subgroups and datasets in the current group
     for (auto const &x : gr.get_all_subgroup_dataset_names()) {
       valueT val;
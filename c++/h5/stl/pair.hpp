@@ -25,8 +25,11 @@
 #include "../format.hpp"
 #include "../group.hpp"
 #include "./string.hpp"
+#include "./tuple.hpp"
 
+#include <stdexcept>
 #include <string>
+#include <tuple>
 #include <utility>
 
 namespace h5 {
@@ -45,7 +48,9 @@ namespace h5 {
   /**
    * @brief Write a std::pair to an HDF5 subgroup.
    *
-   * @details Calls the specialized `h5_write` function for both values of the std::pair.
+   * @details If both values are arithmetic or complex, the std::pair is written in the compact layout of a
+   * `std::tuple<T1, T2>`, i.e. to a single scalar dataset with a compound datatype. Otherwise, it calls the specialized
+   * `h5_write` function for both values of the std::pair.
    *
    * @tparam T1 Value type #1.
    * @tparam T1 Value type #2.
@@ -55,6 +60,10 @@ namespace h5 {
    */
   template <typename T1, typename T2>
   void h5_write(group g, std::string const &name, std::pair<T1, T2> const &p) {
+    if constexpr (detail::is_compact_tuple_v<T1, T2>) {
+      detail::h5_write_compact_tuple(g, name, std::tuple<T1, T2>{p.first, p.second}, std::index_sequence_for<T1, T2>{});
+      return;
+    }
     auto gr = g.create_group(name);
     write_hdf5_format(gr, p);
     h5_write(gr, "0", p.first);
@@ -64,7 +73,8 @@ namespace h5 {
   /**
    * @brief Read a std::pair from an HDF5 subgroup.
    *
-   * @details Calls the specialized `h5_read` function for both values of the std::pair.
+   * @details Reads the compact layout from a dataset (see h5::h5_write(group, std::string const &, std::pair<T1, T2> const &))
+   * or calls the specialized `h5_read` function for both values of the std::pair.
    *
    * @tparam T1 Value type #1.
    * @tparam T1 Value type #2.
@@ -74,6 +84,14 @@ namespace h5 {
    */
   template <typename T1, typename T2>
   void h5_read(group g, std::string const &name, std::pair<T1, T2> &p) {
+    if constexpr (detail::is_compact_tuple_v<T1, T2>) {
+      if (g.has_dataset(name)) {
+        std::tuple<T1, T2> tup;
+        detail::h5_read_compact_tuple(g, name, tup, std::index_sequence_for<T1, T2>{});
+        p = {std::get<0>(tup), std::get<1>(tup)};
+        return;
+      }
+    }
     auto gr = g.open_group(name);
     if (gr.get_all_subgroup_dataset_names().size() != 2)
       throw std::runtime_error("Error in h5::h5_read: Reading a std::pair from a group with more/less than 2 subgroups/datasets is not allowed");
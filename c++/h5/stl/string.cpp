@@ -21,10 +21,11 @@
 
 #include "./string.hpp"
 #include "../macros.hpp"
+#include "../scratch.hpp"
+#include "../stats.hpp"
 #include "../utils.hpp"
 
 #include <hdf5.h>
-#include <hdf5_hl.h>
 
 #include <algorithm>
 #include <array>
@@ -38,24 +39,13 @@
 
 namespace h5 {
 
-  namespace {
-
-    // Returns an HDF5 datatype for a fixed-sized string with the given size or a variable-sized
-    // string if size == H5T_VARIABLE.
-    datatype str_dtype(size_t size = H5T_VARIABLE) {
-      datatype dt = H5Tcopy(H5T_C_S1);
-      auto err    = H5Tset_size(dt, size);
-      H5Tset_cset(dt, H5T_CSET_UTF8);
-      if (err < 0) throw std::runtime_error("Error in str_dtype: H5Tset_size call failed");
-      return dt;
-    }
-
-  } // namespace
-
   void h5_write(group g, std::string const &name, std::string const &s) {
+    H5_INSTRUMENT(instr, "h5_write(std::string)", g, name);
+    H5_INSTRUMENT_BYTES(instr, s.size());
+
     // create the dataset for a variable-sized string
-    datatype dt     = str_dtype();
-    dataspace space = H5Screate(H5S_SCALAR);
+    datatype dt     = detail::str_dtype();
+    dataspace space = detail::scalar_dataspace();
     dataset ds      = g.create_dataset(name, dt, space);
 
     // write the string to dataset
@@ -65,6 +55,8 @@ namespace h5 {
   }
 
   void h5_read(group g, std::string const &name, std::string &s) {
+    H5_INSTRUMENT(instr, "h5_read(std::string)", g, name);
+
     // clear the string
     s = "";
 
@@ -84,24 +76,28 @@ namespace h5 {
       auto err = H5Dread(ds, dt, H5S_ALL, H5S_ALL, H5P_DEFAULT, rd_ptr.data());
       if (err < 0) throw std::runtime_error("Error in h5_read: Reading a string from the dataset " + name + " in the group " + g.name() + " failed");
       s.append(rd_ptr[0]);
+      H5_INSTRUMENT_BYTES(instr, s.size());
 
       // free the resources allocated in the variable-length read
       err = H5Dvlen_reclaim(dt, dspace, H5P_DEFAULT, rd_ptr.data());
       if (err < 0) throw std::runtime_error("Error in h5_read: Freeing resources after reading a variable-length string failed");
     } else { // fixed-sized string
-      std::vector<char> buf(H5Tget_size(dt) + 1, 0x00);
+      scratch_vector<char> buf(H5Tget_size(dt) + 1, 0x00);
       auto err = H5Dread(ds, dt, H5S_ALL, H5S_ALL, H5P_DEFAULT, &buf[0]);
       if (err < 0) throw std::runtime_error("Error in h5_read: Reading a string from the dataset " + name + " in the group " + g.name() + " failed");
       s.append(&buf.front());
+      H5_INSTRUMENT_BYTES(instr, buf.size() - 1);
     }
   }
 
   void h5_write_attribute(object obj, std::string const &name, std::string const &s) {
     // create the variable-sized string datatype and the dataspace
-    datatype dt     = str_dtype();
-    dataspace space = H5Screate(H5S_SCALAR);
+    datatype dt     = detail::str_dtype();
+    dataspace space = detail::scalar_dataspace();
 
-    // create the attribute
+    // create the attribute (an existing attribute is overwritten)
+    if (H5Aexists(obj, name.c_str()) > 0 and H5Adelete(obj, name.c_str()) < 0)
+      throw std::runtime_error("Error in h5_write_attribute: Deleting the existing attribute " + name + " failed");
     attribute attr = H5Acreate2(obj, name.c_str(), dt, space, H5P_DEFAULT, H5P_DEFAULT);
     if (!attr.is_valid()) throw std::runtime_error("Error in h5_write_attribute: Creating the attribute " + name + " failed");
 
@@ -114,7 +110,7 @@ namespace h5 {
   void h5_read_attribute(object obj, std::string const &name, std::string &s) {
     // clear the string and return if the attribute is not present
     s = "";
-    if (H5LTfind_attribute(obj, name.c_str()) == 0) return;
+    if (H5Aexists(obj, name.c_str()) <= 0) return;
 
     // open the attribute and get dataspace and datatype information
     attribute attr   = H5Aopen(obj, name.c_str(), H5P_DEFAULT);
@@ -137,7 +133,7 @@ namespace h5 {
       err = H5Dvlen_reclaim(dt, dspace, H5P_DEFAULT, rd_ptr.data());
       if (err < 0) throw std::runtime_error("Error in h5_read_attribute: Freeing resources after reading a variable-length string failed");
     } else { // fixed-sized string
-      std::vector<char> buf(H5Tget_size(dt) + 1, 0x00);
+      scratch_vector<char> buf(H5Tget_size(dt) + 1, 0x00);
       auto err = H5Aread(attr, dt, (void *)(&buf[0]));
       if (err < 0) throw std::runtime_error("Error in h5_read_attribute: Reading a string from the attribute " + name + " failed");
       s.append(&buf.front());
@@ -146,15 +142,18 @@ namespace h5 {
 
   void h5_write_attribute_to_key(group g, std::string const &key, std::string const &name, std::string const &s) {
     // create the variable-sized string datatype and dataspace
-    datatype dt      = str_dtype();
-    dataspace dspace = H5Screate(H5S_SCALAR);
+    datatype dt      = detail::str_dtype();
+    dataspace dspace = detail::scalar_dataspace();
 
-    // create the attribute for a given key
+    // create the attribute for a given key (an existing attribute is overwritten)
+    if (H5Aexists_by_name(g, key.c_str(), name.c_str(), H5P_DEFAULT) > 0 and H5Adelete_by_name(g, key.c_str(), name.c_str(), H5P_DEFAULT) < 0)
+      throw std::runtime_error("Error in h5_write_attribute_to_key: Deleting the existing attribute " + name + " failed");
     attribute attr = H5Acreate_by_name(g, key.c_str(), name.c_str(), dt, dspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
     if (!attr.is_valid()) throw std::runtime_error("Error in h5_write_attribute_to_key: Creating the attribute " + name + " failed");
 
     // write the string to the attribute
-    herr_t err = H5Awrite(attr, dt, (void *)(s.c_str()));
+    auto *s_ptr = s.c_str();
+    herr_t err  = H5Awrite(attr, dt, &s_ptr);
     if (err < 0) throw std::runtime_error("Error in h5_write_attribute_to_key: Writing a string to the attribute " + name + " failed");
   }
 
@@ -184,7 +183,7 @@ namespace h5 {
       err = H5Dvlen_reclaim(dt, dspace, H5P_DEFAULT, rd_ptr.data());
       if (err < 0) throw std::runtime_error("Error in h5_read_attribute_to_key: Rreeing resources after reading a variable-length string failed");
     } else { // fixed-sized string
-      std::vector<char> buf(H5Tget_size(dt) + 1, 0x00);
+      scratch_vector<char> buf(H5Tget_size(dt) + 1, 0x00);
       auto err = H5Aread(attr, dt, &buf[0]);
       if (err < 0) throw std::runtime_error("Error in h5_read_attribute_to_key: Reading a string from the attribute " + name + " failed");
       s.append(&buf.front());
@@ -192,7 +191,7 @@ namespace h5 {
   }
 
   // HDF5 datatype of a char_buf is a fixed-sized string
-  datatype char_buf::dtype() const { return str_dtype(lengths.back()); }
+  datatype char_buf::dtype() const { return detail::str_dtype(lengths.back()); }
 
   // dataspace is an n-dimensional array of fixed-sized strings, each of length max_length + 1
   dataspace char_buf::dspace() const {
@@ -202,6 +201,9 @@ namespace h5 {
   }
 
   void h5_write(group g, std::string const &name, char_buf const &cb) {
+    H5_INSTRUMENT(instr, "h5_write(char_buf)", g, name);
+    H5_INSTRUMENT_BYTES(instr, cb.buffer.size());
+
     // create the dataset for the char_buf
     auto dt     = cb.dtype();
     auto dspace = cb.dspace();
@@ -213,6 +215,8 @@ namespace h5 {
   }
 
   void h5_read(group g, std::string const &name, char_buf &cb) {
+    H5_INSTRUMENT(instr, "h5_read(char_buf)", g, name);
+
     // open the dataset and get dataspace and datatype information
     dataset ds       = g.open_dataset(name);
     dataspace dspace = H5Dget_space(ds);
@@ -237,6 +241,7 @@ namespace h5 {
     if (err < 0) throw make_runtime_error("Error in h5_read: Reading a char_buf from the dataset ", name, " in the group ", g.name(), " failed");
 
     // move to output char_buf
+    H5_INSTRUMENT_BYTES(instr, cb_out.buffer.size());
     cb = std::move(cb_out);
   }
 
@@ -245,7 +250,9 @@ namespace h5 {
     auto dt     = cb.dtype();
     auto dspace = cb.dspace();
 
-    // create the attribute
+    // create the attribute (an existing attribute is overwritten)
+    if (H5Aexists(obj, name.c_str()) > 0 and H5Adelete(obj, name.c_str()) < 0)
+      throw make_runtime_error("Error in h5_write_attribute: Deleting the existing attribute ", name, " failed");
     attribute attr = H5Acreate2(obj, name.c_str(), dt, dspace, H5P_DEFAULT, H5P_DEFAULT);
     if (!attr.is_valid()) throw make_runtime_error("Error in h5_write_attribute: Creating the attribute ", name, " failed");
 
@@ -80,6 +80,8 @@ namespace h5 {
   /**
    * @brief Write a std::string to an HDF5 attribute.
    *
+   * @details An existing attribute with the same name is overwritten.
+   *
    * @param obj h5::object to which the attribute is attached.
    * @param name Name of the attribute.
    * @param s std::string to be written.
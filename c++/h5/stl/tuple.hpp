@@ -22,15 +22,22 @@
 #ifndef LIBH5_STL_TUPLE_HPP
 #define LIBH5_STL_TUPLE_HPP
 
+#include "../array_interface.hpp"
+#include "../complex.hpp"
+#include "../compound.hpp"
 #include "../format.hpp"
 #include "../group.hpp"
 #include "./string.hpp"
 
+#include <array>
 #include <cstddef>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace h5 {
 
@@ -47,6 +54,49 @@ namespace h5 {
 
   namespace detail {
 
+    // Is a std::tuple of the given types stored as a single scalar dataset with a compound datatype?
+    template <typename... Ts>
+    constexpr bool is_compact_tuple_v = sizeof...(Ts) > 0 and ((std::is_arithmetic_v<Ts> or is_complex_v<Ts>) and ...);
+
+    // Byte offsets of the elements of a compact tuple in a packed buffer (the last entry is the size of the buffer).
+    template <typename... Ts>
+    constexpr std::array<std::size_t, sizeof...(Ts) + 1> packed_tuple_offsets() {
+      std::array<std::size_t, sizeof...(Ts) + 1> res{};
+      std::array<std::size_t, sizeof...(Ts)> sizes{sizeof(Ts)...};
+      for (std::size_t i = 0; i < sizeof...(Ts); ++i) res[i + 1] = res[i] + sizes[i];
+      return res;
+    }
+
+    // Compound datatype with the members "0", "1", ... of a packed buffer (created only once per tuple type).
+    template <typename... Ts, std::size_t... Is>
+    hid_t compact_tuple_type(std::index_sequence<Is...>) {
+      static constexpr auto offsets = packed_tuple_offsets<Ts...>();
+      static hid_t const dt = make_compound_type(offsets.back(), {compound_member{std::to_string(Is), offsets[Is], hdf5_type<Ts>(), is_complex_v<Ts>}...});
+      return dt;
+    }
+
+    // Write a compact tuple to a scalar dataset with a compound datatype.
+    template <typename... Ts, std::size_t... Is>
+    void h5_write_compact_tuple(group g, std::string const &name, std::tuple<Ts...> const &tup, std::index_sequence<Is...> seq) {
+      static constexpr auto offsets = packed_tuple_offsets<Ts...>();
+      std::array<std::byte, offsets.back()> buf{};
+      (std::memcpy(buf.data() + offsets[Is], &std::get<Is>(tup), sizeof(Ts)), ...);
+      array_interface::array_view v{object::from_borrowed(compact_tuple_type<Ts...>(seq)), buf.data(), 0, false};
+      array_interface::write(g, name, v, false);
+    }
+
+    // Read a compact tuple from a scalar dataset with a compound datatype.
+    template <typename... Ts, std::size_t... Is>
+    void h5_read_compact_tuple(group g, std::string const &name, std::tuple<Ts...> &tup, std::index_sequence<Is...> seq) {
+      auto ds = g.open_dataset(name);
+      if (get_compound_member_names(get_hdf5_type(ds)) != std::vector<std::string>{std::to_string(Is)...})
+        throw std::runtime_error("Error in h5::h5_read: Reading a std::tuple from a dataset with different compound members is not allowed");
+      static constexpr auto offsets = packed_tuple_offsets<Ts...>();
+      std::array<std::byte, offsets.back()> buf{};
+      array_interface::read(ds, array_interface::array_view{object::from_borrowed(compact_tuple_type<Ts...>(seq)), buf.data(), 0, false});
+      (std::memcpy(&std::get<Is>(tup), buf.data() + offsets[Is], sizeof(Ts)), ...);
+    }
+
     // Helper function to write a tuple to HDF5.
     template <typename... Ts, std::size_t... Is>
     void h5_write_tuple_impl(group g, std::string const &, std::tuple<Ts...> const &tup, std::index_sequence<Is...>) {
@@ -67,7 +117,9 @@ namespace h5 {
   /**
    * @brief Write a std::tuple to an HDF5 subgroup.
    *
-   * @details Calls the specialized `h5_write` function for every element of the std::tuple.
+   * @details If all elements are arithmetic or complex, the std::tuple is written to a single scalar dataset with a
+   * compound datatype whose members are named "0", "1", ... (compact layout, read as a `tuple` in Python). Otherwise, it calls the specialized
+   * `h5_write` function for every element of the std::tuple.
    *
    * @tparam Ts Tuple types.
    * @param g h5::group in which the subgroup is created.
@@ -76,6 +128,10 @@ namespace h5 {
    */
   template <typename... Ts>
   void h5_write(group g, std::string const &name, std::tuple<Ts...> const &tup) {
+    if constexpr (detail::is_compact_tuple_v<Ts...>) {
+      detail::h5_write_compact_tuple(g, name, tup, std::index_sequence_for<Ts...>{});
+      return;
+    }
     auto gr = g.create_group(name);
     write_hdf5_format(gr, tup);
     detail::h5_write_tuple_impl(gr, name, tup, std::index_sequence_for<Ts...>{});
@@ -84,7 +140,8 @@ namespace h5 {
   /**
    * @brief Read a std::tuple from an HDF5 subgroup.
    *
-   * @details Calls the specialized `h5_read` function for every value of the std::tuple.
+   * @details Reads the compact layout from a dataset (see h5::h5_write(group, std::string const &, std::tuple<Ts...> const &))
+   * or calls the specialized `h5_read` function for every value of the std::tuple.
    *
    * @tparam Ts Tuple types.
    * @param g h5::group containing the subgroup.
@@ -93,6 +150,12 @@ namespace h5 {
    */
   template <typename... Ts>
   void h5_read(group g, std::string const &name, std::tuple<Ts...> &tup) {
+    if constexpr (detail::is_compact_tuple_v<Ts...>) {
+      if (g.has_dataset(name)) {
+        detail::h5_read_compact_tuple(g, name, tup, std::index_sequence_for<Ts...>{});
+        return;
+      }
+    }
     auto gr = g.open_group(name);
     detail::h5_read_tuple_impl(gr, name, tup, std::index_sequence_for<Ts...>{});
   }
@@ -20,33 +20,102 @@
  */
 
 #include "./vector.hpp"
+#include "../scratch.hpp"
+#include "../stats.hpp"
 
 #include <hdf5.h>
 #include <hdf5_hl.h>
 
 #include <algorithm>
 #include <cstring>
-#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace h5 {
 
-  char_buf to_char_buf(std::vector<std::string> const &v) {
-    // get size of longest string
-    size_t s = 1;
-    for (auto &x : v) s = std::max(s, x.size() + 1);
-
-    // copy each string to a buffer and pad with zeros
-    std::vector<char> buf;
-    buf.resize(std::max(v.size() * s, 1ul), 0x00);
-    size_t i = 0;
-    for (auto &x : v) {
-      strcpy(&buf[i * s], x.c_str());
-      ++i;
+  namespace {
+
+    // Create a dataset of strings with the given shape and write the buffer to it.
+    void write_strings(group g, std::string const &name, datatype const &dt, v_t const &dims, void const *buf, write_options const &opts) {
+      dataspace space = H5Screate_simple(static_cast<int>(dims.size()), dims.data(), nullptr);
+      auto dcpl       = make_dataset_create_proplist(opts, dt, dims, false);
+      dataset ds      = g.create_dataset(name, dt, space, dcpl);
+
+      // write the data (nothing to write for empty datasets)
+      if (H5Sget_simple_extent_npoints(space) > 0) {
+        auto err = H5Dwrite(ds, dt, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+        if (err < 0) throw std::runtime_error("Error in h5_write: Writing a vector of strings to the dataset " + name + " failed");
+      }
+    }
+
+    // Get the size of the longest string in a vector + 1 (at least 1).
+    std::size_t max_string_size(std::vector<std::string> const &v) {
+      std::size_t s = 1;
+      for (auto const &x : v) s = std::max(s, x.size() + 1);
+      return s;
+    }
+
+    // Copy strings into a zero-initialized buffer of fixed-length strings of the given size.
+    void pad_strings(std::vector<std::string> const &v, std::size_t s, char *buf) {
+      for (std::size_t i = 0; i < v.size(); ++i) std::memcpy(buf + i * s, v[i].data(), v[i].size());
+    }
+
+    // Get the dimensions of the dataspace of a dataset.
+    v_t get_dims(dataspace const &space) {
+      int rank = H5Sget_simple_extent_ndims(space);
+      if (rank < 0) throw std::runtime_error("Error in h5_read: Getting the rank of the dataspace failed");
+      v_t dims(rank);
+      H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+      return dims;
     }
 
-    // return char_buf
-    auto len = v_t{v.size(), s};
-    return {buf, len};
+    // Uninitialized character buffer from the scratch pool.
+    using scratch_char_buffer = std::vector<char, default_init_allocator<char, scratch_allocator<char>>>;
+
+    // Fixed-length strings: read the padded strings with a single H5Dread call into an uninitialized buffer.
+    scratch_char_buffer read_fl_strings(dataset const &ds, datatype const &ty, v_t &dims, std::size_t &len) {
+      dataspace space = H5Dget_space(ds);
+      dims            = get_dims(space);
+      len             = H5Tget_size(ty);
+      auto npoints    = static_cast<std::size_t>(H5Sget_simple_extent_npoints(space));
+      scratch_char_buffer buf(std::max<std::size_t>(npoints * len, 1));
+      if (npoints > 0 and H5Dread(ds, ty, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf.data()) < 0)
+        throw std::runtime_error("Error in h5_read: Reading fixed-length strings failed");
+      return buf;
+    }
+
+    // Variable-length strings: read the pointers to all strings with a single H5Dread call.
+    scratch_vector<char *> read_vl_strings(dataset const &ds, v_t &dims) {
+      dataspace space = H5Dget_space(ds);
+      dims            = get_dims(space);
+
+      scratch_vector<char *> ptrs(H5Sget_simple_extent_npoints(space), nullptr);
+      if (not ptrs.empty()) {
+        datatype mem_ty = detail::str_dtype();
+        if (H5Dread(ds, mem_ty, H5S_ALL, H5S_ALL, H5P_DEFAULT, ptrs.data()) < 0)
+          throw std::runtime_error("Error in h5_read: Reading variable-length strings failed");
+      }
+      return ptrs;
+    }
+
+    // Free the memory allocated by HDF5 for variable-length strings.
+    void reclaim_vl_strings(dataset const &ds, scratch_vector<char *> &ptrs) {
+      if (ptrs.empty()) return;
+      dataspace space = H5Dget_space(ds);
+      datatype mem_ty = detail::str_dtype();
+      H5Dvlen_reclaim(mem_ty, space, H5P_DEFAULT, ptrs.data());
+    }
+
+  } // namespace
+
+  char_buf to_char_buf(std::vector<std::string> const &v) {
+    // copy each string to the buffer and pad with zeros
+    auto s = max_string_size(v);
+    char_buf cb{{}, v_t{v.size(), s}};
+    cb.buffer.resize(std::max(v.size() * s, 1ul), 0x00);
+    pad_strings(v, s, cb.buffer.data());
+    return cb;
   }
 
   char_buf to_char_buf(std::vector<std::vector<std::string>> const &v) {
@@ -54,35 +123,27 @@ namespace h5 {
     size_t s = 1, lv = 0;
     for (auto &v1 : v) {
       lv = std::max(lv, v1.size());
-      for (auto &x : v1) s = std::max(s, x.size() + 1);
+      s  = std::max(s, max_string_size(v1));
     }
 
-    // copy each string to a buffer and pad with zeros
-    std::vector<char> buf;
-    buf.resize(std::max(v.size() * lv * s, 1ul), 0x00);
-    for (int i = 0, k = 0; i < v.size(); i++)
-      for (int j = 0; j < lv; j++, k++) {
-        if (j < v[i].size()) strcpy(&buf[k * s], v[i][j].c_str());
-      }
-
-    // return char_buf
-    auto len = v_t{v.size(), lv, s};
-    return {buf, len};
+    // copy each string to the buffer and pad with zeros
+    char_buf cb{{}, v_t{v.size(), lv, s}};
+    cb.buffer.resize(std::max(v.size() * lv * s, 1ul), 0x00);
+    for (std::size_t i = 0; i < v.size(); ++i) pad_strings(v[i], s, cb.buffer.data() + i * lv * s);
+    return cb;
   }
 
   void from_char_buf(char_buf const &cb, std::vector<std::string> &v) {
-    // prepare vector
-    v.clear();
+    // prepare vector (existing strings are reused)
     v.resize(cb.lengths[0]);
 
     // loop over all strings
     auto len_string = cb.lengths[1];
     long i          = 0;
     for (auto &x : v) {
-      // use full range from char_buf and remove null characters
+      // copy the string up to the first null character
       const char *bptr = &cb.buffer[i * len_string];
-      x                = std::string(bptr, bptr + len_string);
-      x.erase(std::remove(begin(x), end(x), '\0'), end(x));
+      x.assign(bptr, strnlen(bptr, len_string));
       ++i;
     }
   }
@@ -98,15 +159,122 @@ namespace h5 {
     long i              = 0;
     for (auto &v_inner : v) {
       for (int j = 0; j < inner_vec_size; ++j, ++i) {
-        // use full range from char_buf and remove null characters
+        // copy the string up to the first null character
         const char *bptr = &cb.buffer[i * len_string];
-        auto s           = std::string(bptr, bptr + len_string);
-        s.erase(std::remove(begin(s), end(s), '\0'), end(s));
-        v_inner.push_back(s);
+        v_inner.emplace_back(bptr, strnlen(bptr, len_string));
       }
     }
   }
 
+  void h5_write(group g, std::string const &name, std::vector<std::string> const &v, write_options const &opts) {
+    if (not opts.variable_length_strings) {
+      // padded fixed-length strings in a temporary buffer from the scratch pool
+      auto s = max_string_size(v);
+      scratch_vector<char> buf(std::max(v.size() * s, 1ul), 0x00);
+      pad_strings(v, s, buf.data());
+      return write_strings(g, name, detail::str_dtype(s), v_t{v.size()}, buf.data(), opts);
+    }
+
+    // pointers to the strings (no copies are made)
+    scratch_vector<const char *> ptrs(v.size());
+    std::transform(v.begin(), v.end(), ptrs.begin(), [](auto const &x) { return x.c_str(); });
+    write_strings(g, name, detail::str_dtype(), v_t{v.size()}, ptrs.data(), opts);
+  }
+
+  void h5_write(group g, std::string const &name, std::vector<std::vector<std::string>> const &v, write_options const &opts) {
+    std::size_t lv = 0, s = 1;
+    for (auto const &v1 : v) {
+      lv = std::max(lv, v1.size());
+      s  = std::max(s, max_string_size(v1));
+    }
+    if (not opts.variable_length_strings) {
+      // padded fixed-length strings in a temporary buffer from the scratch pool (shorter inner vectors are padded with
+      // empty strings)
+      scratch_vector<char> buf(std::max(v.size() * lv * s, 1ul), 0x00);
+      for (std::size_t i = 0; i < v.size(); ++i) pad_strings(v[i], s, buf.data() + i * lv * s);
+      return write_strings(g, name, detail::str_dtype(s), v_t{v.size(), lv}, buf.data(), opts);
+    }
+
+    // pointers to the strings (shorter inner vectors are padded with empty strings)
+    scratch_vector<const char *> ptrs(v.size() * lv, "");
+    for (std::size_t i = 0; i < v.size(); ++i)
+      for (std::size_t j = 0; j < v[i].size(); ++j) ptrs[i * lv + j] = v[i][j].c_str();
+    write_strings(g, name, detail::str_dtype(), v_t{v.size(), lv}, ptrs.data(), opts);
+  }
+
+  namespace detail {
+
+    void read_strings(group g, std::string const &name, std::vector<std::string> &v) {
+      H5_INSTRUMENT(instr, "h5_read(std::vector<std::string>)", g, name);
+      dataset ds  = g.open_dataset(name);
+      datatype ty = H5Dget_type(ds);
+
+      // fixed-length strings (copy each string up to the first null character, existing strings are reused)
+      v_t dims;
+      if (H5Tis_variable_str(ty) <= 0) {
+        std::size_t len = 0;
+        auto buf        = read_fl_strings(ds, ty, dims, len);
+        if (dims.size() != 1)
+          throw make_runtime_error("Error in h5_read: Reading a vector of strings from an array of rank ", dims.size(), " is not allowed");
+        H5_INSTRUMENT_BYTES(instr, dims[0] * len);
+        v.resize(dims[0]);
+        for (std::size_t i = 0; i < v.size(); ++i) {
+          const char *bptr = buf.data() + i * len;
+          v[i].assign(bptr, strnlen(bptr, len));
+        }
+        return;
+      }
+
+      // variable-length strings
+      auto ptrs = read_vl_strings(ds, dims);
+      if (dims.size() != 1) {
+        reclaim_vl_strings(ds, ptrs);
+        throw make_runtime_error("Error in h5_read: Reading a vector of strings from an array of rank ", dims.size(), " is not allowed");
+      }
+      v.resize(ptrs.size());
+      for (std::size_t i = 0; i < ptrs.size(); ++i) v[i] = (ptrs[i] ? ptrs[i] : "");
+      reclaim_vl_strings(ds, ptrs);
+    }
+
+    void read_strings(group g, std::string const &name, std::vector<std::vector<std::string>> &v) {
+      H5_INSTRUMENT(instr, "h5_read(std::vector<std::vector<std::string>>)", g, name);
+      dataset ds  = g.open_dataset(name);
+      datatype ty = H5Dget_type(ds);
+
+      // fixed-length strings (copy each string up to the first null character, existing strings are reused)
+      v_t dims;
+      if (H5Tis_variable_str(ty) <= 0) {
+        std::size_t len = 0;
+        auto buf        = read_fl_strings(ds, ty, dims, len);
+        if (dims.size() != 2)
+          throw make_runtime_error("Error in h5_read: Reading a vector of vectors of strings from an array of rank ", dims.size(), " is not allowed");
+        H5_INSTRUMENT_BYTES(instr, dims[0] * dims[1] * len);
+        v.resize(dims[0]);
+        for (std::size_t i = 0, k = 0; i < dims[0]; ++i) {
+          v[i].resize(dims[1]);
+          for (std::size_t j = 0; j < dims[1]; ++j, ++k) {
+            const char *bptr = buf.data() + k * len;
+            v[i][j].assign(bptr, strnlen(bptr, len));
+          }
+        }
+        return;
+      }
+
+      // variable-length strings
+      auto ptrs = read_vl_strings(ds, dims);
+      if (dims.size() != 2) {
+        reclaim_vl_strings(ds, ptrs);
+        throw make_runtime_error("Error in h5_read: Reading a vector of vectors of strings from an array of rank ", dims.size(), " is not allowed");
+      }
+      v.resize(dims[0]);
+      for (auto &v_inner : v) v_inner.resize(dims[1]);
+      for (std::size_t i = 0, k = 0; i < dims[0]; ++i)
+        for (std::size_t j = 0; j < dims[1]; ++j, ++k) v[i][j] = (ptrs[k] ? ptrs[k] : "");
+      reclaim_vl_strings(ds, ptrs);
+    }
+
+  } // namespace detail
+
   void h5_write_attribute(object obj, std::string const &name, std::vector<std::string> const &v) { h5_write_attribute(obj, name, to_char_buf(v)); }
 
   void h5_write_attribute(object obj, std::string const &name, std::vector<std::vector<std::string>> const &v) {
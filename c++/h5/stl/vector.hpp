@@ -26,12 +26,19 @@
 #include "../complex.hpp"
 #include "../format.hpp"
 #include "../group.hpp"
+#include "../macros.hpp"
+#include "../properties.hpp"
 #include "../scalar.hpp"
 #include "../utils.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <string>
 #include <vector>
 #include <type_traits>
+#include <utility>
 
 namespace h5 {
 
@@ -42,11 +49,12 @@ namespace h5 {
      * @brief Create an h5::array_interface::array_view for a std::vector.
      *
      * @tparam T Value type of std::vector.
+     * @tparam A Allocator type of std::vector.
      * @param v std::vector.
      * @return h5::array_interface::array_view of rank 1.
      */
-    template <typename T>
-    array_view array_view_from_vector(std::vector<T> const &v) {
+    template <typename T, typename A>
+    array_view array_view_from_vector(std::vector<T, A> const &v) {
       array_view res{hdf5_type<T>(), (void *)v.data(), 1, is_complex_v<std::decay_t<T>>};
       res.slab.count[0]   = v.size();
       res.parent_shape[0] = v.size();
@@ -55,17 +63,91 @@ namespace h5 {
 
   } // namespace array_interface
 
+  namespace detail {
+
+    // Is T a std::vector of arithmetic or complex types, i.e. can a std::vector<T> be stored in the packed layout?
+    template <typename T>
+    struct _is_packable : std::false_type {};
+
+    template <typename U>
+    struct _is_packable<std::vector<U>> : std::bool_constant<std::is_arithmetic_v<U> or is_complex_v<U>> {};
+
+    template <typename T>
+    constexpr bool is_packable_v = _is_packable<T>::value;
+
+  } // namespace detail
+
   /**
    * @addtogroup rw_vector
    * @{
    */
 
+  /**
+   * @brief Allocator adaptor which default-initializes instead of value-initializes elements.
+   *
+   * @details A `std::vector` with this allocator does not zero the memory of arithmetic/complex elements when it is
+   * resized. This avoids an extra pass over the memory when a large vector is read from HDF5, since `H5Dread`
+   * overwrites all elements anyway (see h5::default_init_vector).
+   *
+   * Constructions with arguments are forwarded to the underlying allocator.
+   *
+   * @tparam T Value type.
+   * @tparam A Underlying allocator type.
+   */
+  template <typename T, typename A = std::allocator<T>>
+  class default_init_allocator : public A {
+    using traits = std::allocator_traits<A>;
+
+    public:
+    /// Rebind the allocator to another value type.
+    template <typename U>
+    struct rebind {
+      /// Type of the rebound allocator.
+      using other = default_init_allocator<U, typename traits::template rebind_alloc<U>>;
+    };
+
+    using A::A;
+
+    /**
+     * @brief Default-initialize an object at the given address.
+     * @param p Pointer to uninitialized memory.
+     */
+    template <typename U>
+    void construct(U *p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+      ::new (static_cast<void *>(p)) U;
+    }
+
+    /**
+     * @brief Construct an object at the given address with the underlying allocator.
+     * @param p Pointer to uninitialized memory.
+     * @param args Constructor arguments.
+     */
+    template <typename U, typename... Args>
+    void construct(U *p, Args &&...args) {
+      traits::construct(static_cast<A &>(*this), p, std::forward<Args>(args)...);
+    }
+  };
+
+  /**
+   * @brief std::vector whose elements are default-initialized when it is resized.
+   *
+   * @details Reading into an h5::default_init_vector of arithmetic/complex types writes the data straight into
+   * uninitialized memory. Repeated reads of datasets with the same size reuse the storage of the vector.
+   *
+   * @tparam T Value type.
+   */
+  template <typename T>
+  using default_init_vector = std::vector<T, default_init_allocator<T>>;
+
+  /// `hdf5_format` tag of the packed layout of a vector of vectors of arithmetic/complex types.
+  constexpr const char *packed_list_format = "PackedList";
+
   // Specialization of h5::hdf5_format_impl for std::vector<std::string>.
   H5_SPECIALIZE_FORMAT2(std::vector<std::string>, vector<string>);
 
   /// Specialization of h5::hdf5_format_impl for std::vector.
-  template <typename T>
-  struct hdf5_format_impl<std::vector<T>> {
+  template <typename T, typename A>
+  struct hdf5_format_impl<std::vector<T, A>> {
     static std::string invoke() { return "List"; }
   };
 
@@ -101,28 +183,82 @@ namespace h5 {
    */
   void from_char_buf(char_buf const &cb, std::vector<std::vector<std::string>> &v);
 
+  /**
+   * @brief Write a vector of strings to an HDF5 dataset using the given dataset creation policy.
+   *
+   * @details If h5::write_options::variable_length_strings is set, the strings are written as a 1d dataset of
+   * variable-length UTF-8 strings. Otherwise, an h5::char_buf is written, i.e. each string is padded to the length of
+   * the longest string.
+   *
+   * @param g h5::group in which the dataset is created.
+   * @param name Name of the dataset.
+   * @param v Vector of strings to be written.
+   * @param opts h5::write_options specifying the string storage, the chunking and the filter pipeline.
+   */
+  void h5_write(group g, std::string const &name, std::vector<std::string> const &v, write_options const &opts);
+
+  /**
+   * @brief Write a vector of vectors of strings to an HDF5 dataset using the given dataset creation policy.
+   *
+   * @details Same as h5::h5_write(group, std::string const &, std::vector<std::string> const &, write_options const &)
+   * except that a 2d dataset is written. Inner vectors which are shorter than the longest one are padded with empty
+   * strings.
+   *
+   * @param g h5::group in which the dataset is created.
+   * @param name Name of the dataset.
+   * @param v Vector of vectors of strings to be written.
+   * @param opts h5::write_options specifying the string storage, the chunking and the filter pipeline.
+   */
+  void h5_write(group g, std::string const &name, std::vector<std::vector<std::string>> const &v, write_options const &opts);
+
+  namespace detail {
+
+    // Read a vector of strings from a dataset of fixed-length or variable-length strings.
+    void read_strings(group g, std::string const &name, std::vector<std::string> &v);
+
+    // Read a vector of vectors of strings from a dataset of fixed-length or variable-length strings.
+    void read_strings(group g, std::string const &name, std::vector<std::vector<std::string>> &v);
+
+  } // namespace detail
+
   /**
    * @brief Write a std::vector to an HDF5 dataset/subgroup.
    *
    * @details Depending on the type of `T`, the following is written:
-   * - If `T` is a simple type (arithmetic or complex), a 1d dataset is written.
+   * - If `T` is a simple type (arithmetic, complex or registered with H5_COMPOUND), a 1d dataset is written.
    * - If `T` is `std::string`, an h5::char_buf is written, i.e. a 2d dataset of char with dimensions
-   * (length of vector, max length of strings).
+   * (length of vector, max length of strings). Use h5::write_options::variable_length_strings to store
+   * variable-length strings instead.
+   * - If `T` is a `std::vector` of simple types, it creates a subgroup with the `hdf5_format` tag "PackedList" which
+   * contains 2 datasets: "values" stores all elements of the inner vectors one after the other and "offsets" stores
+   * the `size() + 1` positions at which the inner vectors start in "values" (packed layout).
    * - Otherwise, it creates a subgroup and writes each element to the subgroup.
    *
    * @tparam T Value tupe of std::vector.
+   * @tparam A Allocator type of std::vector.
    * @param g h5::group in which the dataset/subgroup is created.
    * @param name Name of the dataset/subgroup to which the std::vector is written.
    * @param v std::vector to be written.
    */
-  template <typename T>
-  void h5_write(group g, std::string const &name, std::vector<T> const &v) {
-    if constexpr (std::is_arithmetic_v<T> or is_complex_v<T>) {
+  template <typename T, typename A>
+  void h5_write(group g, std::string const &name, std::vector<T, A> const &v) {
+    if constexpr (std::is_arithmetic_v<T> or is_complex_v<T> or is_compound_v<T>) {
       // vector of arithmetic/complex types
       array_interface::write(g, name, array_interface::array_view_from_vector(v), true);
     } else if constexpr (std::is_same_v<T, std::string> or std::is_same_v<T, std::vector<std::string>>) {
       // vector (of vectors) of strings
-      h5_write(g, name, to_char_buf(v));
+      h5_write(g, name, v, write_options{});
+    } else if constexpr (detail::is_packable_v<T>) {
+      // vector of vectors of arithmetic/complex types (packed layout)
+      std::vector<long> offsets(v.size() + 1, 0);
+      for (std::size_t i = 0; i < v.size(); ++i) offsets[i + 1] = offsets[i] + static_cast<long>(v[i].size());
+      std::vector<typename T::value_type> values;
+      values.reserve(offsets.back());
+      for (auto const &x : v) values.insert(values.end(), x.begin(), x.end());
+      auto gr = g.create_group(name);
+      write_hdf5_format_as_string(gr, packed_list_format);
+      h5_write(gr, "values", values);
+      h5_write(gr, "offsets", offsets);
     } else {
       // vector of generic types
       auto gr = g.create_group(name);
@@ -131,43 +267,92 @@ namespace h5 {
     }
   }
 
+  /**
+   * @brief Write a std::vector of arithmetic or complex types to an HDF5 dataset using the given dataset creation policy.
+   *
+   * @tparam T Value type of std::vector (arithmetic or complex).
+   * @tparam A Allocator type of std::vector.
+   * @param g h5::group in which the dataset is created.
+   * @param name Name of the dataset to which the std::vector is written.
+   * @param v std::vector to be written.
+   * @param opts h5::write_options specifying the chunking, the filter pipeline and the fill value settings.
+   */
+  template <typename T, typename A>
+  void h5_write(group g, std::string const &name, std::vector<T, A> const &v, write_options const &opts)
+     H5_REQUIRES(std::is_arithmetic_v<T> or is_complex_v<T> or is_compound_v<T>) {
+    array_interface::write(g, name, array_interface::array_view_from_vector(v), opts);
+  }
+
   /**
    * @brief Read a std::vector from an HDF5 dataset/subgroup.
    *
    * @details Depending on the type of `T`, the following is read:
-   * - If `T` is a simple type (arithmetic or complex), a 1d dataset is read.
-   * - If `T` is `std::string`, an h5::char_buf is read, i.e. a 2d dataset of char with dimensions
-   * (length of vector, max length of strings).
+   * - If `T` is a simple type (arithmetic, complex or registered with H5_COMPOUND), a 1d dataset is read.
+   * - If `T` is `std::string`, a dataset of variable-length strings or an h5::char_buf is read, i.e. a 2d dataset of
+   * char with dimensions (length of vector, max length of strings).
+   * - If `T` is a `std::vector` of simple types and the subgroup has the `hdf5_format` tag "PackedList", the packed
+   * layout is read (see h5::h5_write(group, std::string const &, std::vector<T, A> const &)).
    * - Otherwise, it opens a subgroup and reads each element from the subgroup.
    *
+   * Datasets of simple types are read directly into the storage of the vector. If the vector already has the size of
+   * the dataset, its storage is reused as is. Use an h5::default_init_vector to avoid the value-initialization of the
+   * elements when the vector has to be resized.
+   *
    * @tparam T Value tupe of std::vector.
+   * @tparam A Allocator type of std::vector.
    * @param g h5::group containing the dataset/subgroup.
    * @param name Name of the dataset/subgroup from which the std::vector is read.
    * @param v std::vector to read into.
    */
-  template <typename T>
-  void h5_read(group g, std::string name, std::vector<T> &v) {
+  template <typename T, typename A>
+  void h5_read(group g, std::string name, std::vector<T, A> &v) {
+    if constexpr (std::is_arithmetic_v<T> or is_complex_v<T> or is_compound_v<T>) {
+      // vector of arithmetic/complex types stored in a dataset (open it only once)
+      dataset ds;
+      try {
+        ds = g.open_dataset(name);
+      } catch (std::runtime_error const &) {
+        if (not g.has_subgroup(name)) throw;
+      }
+      if (ds.is_valid()) {
+        // only the shape is needed here (complex values stored with a complex datatype have rank 1)
+        auto lengths = array_interface::get_dataset_shape(ds);
+        int rank     = static_cast<int>(lengths.size());
+        if (rank != 1 + is_complex_v<T> and not(is_complex_v<T> and rank == 1))
+          throw make_runtime_error("Error in h5_read: Reading a vector from an array of rank ", rank, " is not allowed");
+        if (v.size() != lengths[0]) v.resize(lengths[0]);
+        array_interface::read(ds, array_interface::array_view_from_vector(v));
+        return;
+      }
+    }
+
     // throw exception if no link with the given name exists
     if (not g.has_key(name)) throw make_runtime_error("Error in h5_read: Dataset/Subgroup with name ", name, " does not exist");
 
     if (g.has_subgroup(name)) {
       // vector of generic type
       auto g2 = g.open_group(name);
-      v.resize(g2.get_all_dataset_names().size() + g2.get_all_subgroup_names().size());
+      if constexpr (detail::is_packable_v<T>) {
+        // vector of vectors of arithmetic/complex types (packed layout)
+        if (read_hdf5_format(g2) == packed_list_format) {
+          std::vector<typename T::value_type> values;
+          std::vector<long> offsets;
+          h5_read(g2, "values", values);
+          h5_read(g2, "offsets", offsets);
+          if (offsets.empty() or offsets.front() != 0 or offsets.back() != static_cast<long>(values.size())
+              or not std::is_sorted(offsets.begin(), offsets.end()))
+            throw make_runtime_error("Error in h5_read: Invalid offsets in the packed layout of ", name);
+          v.resize(offsets.size() - 1);
+          for (std::size_t i = 0; i < v.size(); ++i) v[i].assign(values.begin() + offsets[i], values.begin() + offsets[i + 1]);
+          return;
+        }
+      }
+      v.resize(g2.get_all_subgroup_dataset_names().size());
       for (int i = 0; i < v.size(); ++i) { h5_read(g2, std::to_string(i), v[i]); }
     } else {
-      if constexpr (std::is_arithmetic_v<T> or is_complex_v<T>) {
-        // vector of arithmetic/complex types
-        auto ds_info = array_interface::get_dataset_info(g, name);
-        if (ds_info.rank() != 1 + is_complex_v<T>)
-          throw make_runtime_error("Error in h5_read: Reading a vector from an array of rank ", ds_info.rank(), " is not allowed");
-        v.resize(ds_info.lengths[0]);
-        array_interface::read(g, name, array_interface::array_view_from_vector(v));
-      } else if constexpr (std::is_same_v<T, std::string> or std::is_same_v<T, std::vector<std::string>>) {
+      if constexpr (std::is_same_v<T, std::string> or std::is_same_v<T, std::vector<std::string>>) {
         // vector of strings or vector of vector of strings
-        char_buf cb;
-        h5_read(g, name, cb);
-        from_char_buf(cb, v);
+        detail::read_strings(g, name, v);
       } else {
         // unsupported type
         throw make_runtime_error("Error in h5_read: HDF5 datatype not supported for reading into a std::vector");
@@ -175,6 +360,67 @@ namespace h5 {
     }
   }
 
+  /**
+   * @brief Append a std::vector to an extensible 1d HDF5 dataset.
+   *
+   * @details If no dataset with the given name exists, an extensible dataset is created with
+   * h5::array_interface::create_extensible containing the elements of the vector. Otherwise, the elements are appended
+   * to the existing dataset with h5::array_interface::append.
+   *
+   * This allows to efficiently write time series or other data which is generated in batches, since only the newly
+   * added elements have to be written.
+   *
+   * @tparam T Value type of std::vector (arithmetic or complex).
+   * @tparam A Allocator type of std::vector.
+   * @param g h5::group containing the dataset.
+   * @param name Name of the dataset.
+   * @param v std::vector to be appended.
+   * @param opts h5::write_options used to create the dataset (ignored if the dataset already exists).
+   */
+  template <typename T, typename A>
+  void h5_append(group g, std::string const &name, std::vector<T, A> const &v, write_options const &opts = {.deflate_level = 1})
+     H5_REQUIRES(std::is_arithmetic_v<T> or is_complex_v<T> or is_compound_v<T>) {
+    if (g.has_key(name))
+      array_interface::append(g, name, array_interface::array_view_from_vector(v));
+    else
+      array_interface::create_extensible(g, name, array_interface::array_view_from_vector(v), opts);
+  }
+
+  /**
+   * @brief Write a vector of arithmetic or complex types to an HDF5 attribute.
+   *
+   * @details An existing attribute with the same name is overwritten. Complex values are stored with an additional
+   * trailing dimension of size 2.
+   *
+   * @tparam T Value type of std::vector.
+   * @param obj h5::object to which the attribute is attached.
+   * @param name Name of the attribute.
+   * @param v std::vector to be written.
+   */
+  template <typename T>
+  void h5_write_attribute(object obj, std::string const &name, std::vector<T> const &v) H5_REQUIRES(std::is_arithmetic_v<T> or is_complex_v<T>) {
+    array_interface::write_attribute(obj, name, array_interface::array_view_from_vector(v));
+  }
+
+  /**
+   * @brief Read a vector of arithmetic or complex types from an HDF5 attribute.
+   *
+   * @details The vector is resized to the length of the attribute, which has to be of rank 1 (rank 2 for complex types).
+   *
+   * @tparam T Value type of std::vector.
+   * @param obj h5::object to which the attribute is attached.
+   * @param name Name of the attribute.
+   * @param v std::vector to read into.
+   */
+  template <typename T>
+  void h5_read_attribute(object obj, std::string const &name, std::vector<T> &v) H5_REQUIRES(std::is_arithmetic_v<T> or is_complex_v<T>) {
+    auto shape = array_interface::get_attribute_shape(obj, name);
+    if (shape.size() != 1 + is_complex_v<T>)
+      throw make_runtime_error("Error in h5_read_attribute: Reading a vector from an attribute of rank ", shape.size(), " is not allowed");
+    v.resize(shape[0]);
+    array_interface::read_attribute(obj, name, array_interface::array_view_from_vector(v));
+  }
+
   /**
    * @brief Write a vector of vectors of strings to an HDF5 attribute.
    *
@@ -0,0 +1,47 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Implementation details for threading.hpp.
+ */
+
+#include "./threading.hpp"
+
+#include <hdf5.h>
+
+#include <mutex>
+
+namespace h5 {
+
+  bool is_library_threadsafe() {
+    static bool const is_ts = []() {
+      hbool_t res = false;
+      return H5is_library_threadsafe(&res) >= 0 and res;
+    }();
+    return is_ts;
+  }
+
+  std::recursive_mutex &library_mutex() {
+    static std::recursive_mutex mtx;
+    return mtx;
+  }
+
+  library_lock::library_lock() {
+    if (not is_library_threadsafe()) lock_ = std::unique_lock{library_mutex()};
+  }
+
+} // namespace h5
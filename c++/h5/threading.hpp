@@ -0,0 +1,92 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Provides tools to use h5 from multiple threads.
+ */
+
+#ifndef LIBH5_THREADING_HPP
+#define LIBH5_THREADING_HPP
+
+#include <mutex>
+
+namespace h5 {
+
+  /**
+   * @addtogroup threading
+   * @{
+   */
+
+  /**
+   * @brief Check whether the HDF5 library has been built with thread-safety enabled.
+   *
+   * @details The result of `H5is_library_threadsafe` is determined only once.
+   *
+   * @return True if HDF5 can be called concurrently from multiple threads, false otherwise.
+   */
+  [[nodiscard]] bool is_library_threadsafe();
+
+  /**
+   * @brief Get the global mutex which serializes calls into a non-thread-safe HDF5 library.
+   * @return Reference to a global `std::recursive_mutex`.
+   */
+  [[nodiscard]] std::recursive_mutex &library_mutex();
+
+  /**
+   * @brief RAII lock which makes calls into the HDF5 library from multiple threads safe.
+   *
+   * @details If the HDF5 library is thread-safe (see h5::is_library_threadsafe), HDF5 serializes all API calls with
+   * its own global lock and the h5::library_lock does nothing. Otherwise, it locks the h5::library_mutex for its
+   * lifetime. The mutex is recursive, i.e. the same thread can hold multiple locks at the same time.
+   *
+   * All calls into h5 (including the copying and destruction of h5::object handles) which might happen concurrently
+   * should be guarded by an h5::library_lock:
+   *
+   * @code{.cpp}
+   * h5::file f("data.h5", 'r');
+   * std::vector<std::thread> pool;
+   * for (int i = 0; i < n_threads; ++i) {
+   *   pool.emplace_back([&f, i]() {
+   *     h5::library_lock lock;
+   *     auto x = h5::read<std::vector<double>>(f, "data_" + std::to_string(i));
+   *   });
+   * }
+   * @endcode
+   */
+  class library_lock {
+    public:
+    /// Lock the h5::library_mutex if the HDF5 library is not thread-safe.
+    library_lock();
+
+    /// Deleted copy constructor.
+    library_lock(library_lock const &) = delete;
+
+    /// Deleted copy assignment operator.
+    library_lock &operator=(library_lock const &) = delete;
+
+    /// Check whether the lock actually holds the h5::library_mutex.
+    [[nodiscard]] bool owns_lock() const { return lock_.owns_lock(); }
+
+    private:
+    std::unique_lock<std::recursive_mutex> lock_;
+  };
+
+  /** @} */
+
+} // namespace h5
+
+#endif // LIBH5_THREADING_HPP
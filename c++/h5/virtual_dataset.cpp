@@ -0,0 +1,145 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Implementation details for virtual_dataset.hpp.
+ */
+
+#include "./virtual_dataset.hpp"
+#include "./stats.hpp"
+#include "./stl/string.hpp"
+
+#include <hdf5.h>
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace h5::array_interface {
+
+  namespace {
+
+    // Select a hyperslab in a dataspace (an empty hyperslab keeps the whole dataspace selected).
+    void select(dataspace const &dspace, hyperslab const &slab, std::string const &what) {
+      if (slab.empty()) return;
+      if (slab.rank() != H5Sget_simple_extent_ndims(dspace))
+        throw std::runtime_error("Error in h5::array_interface::create_virtual_dataset: Rank of the " + what + " selection does not match the dataset");
+      auto err = H5Sselect_hyperslab(dspace, H5S_SELECT_SET, slab.offset.data(), slab.stride.data(), slab.count.data(),
+                                     (slab.block.empty() ? nullptr : slab.block.data()));
+      if (err < 0 or H5Sselect_valid(dspace) <= 0)
+        throw std::runtime_error("Error in h5::array_interface::create_virtual_dataset: Invalid " + what + " selection");
+    }
+
+    // Hyperslab which selects a contiguous block with the given offset and shape.
+    hyperslab block_slab(dims_t offset, v_t const &shape) {
+      hyperslab slab(static_cast<int>(shape.size()), false);
+      slab.offset = std::move(offset);
+      slab.count  = shape;
+      return slab;
+    }
+
+  } // namespace
+
+  dataset create_virtual_dataset(group g, std::string const &name, datatype const &ty, v_t const &shape, std::vector<virtual_source> const &sources) {
+    H5_INSTRUMENT(instr, "array_interface::create_virtual_dataset", g, name);
+
+    // add the mappings to the dataset creation property list
+    proplist dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    if (not dcpl.is_valid()) throw std::runtime_error("Error in h5::array_interface::create_virtual_dataset: Creating the property list failed");
+    dataspace vspace = H5Screate_simple(static_cast<int>(shape.size()), shape.data(), nullptr);
+    for (auto const &src : sources) {
+      if (src.dst_slab.empty()) throw std::runtime_error("Error in h5::array_interface::create_virtual_dataset: Empty selection in the virtual dataset");
+      select(vspace, src.dst_slab, "virtual dataset");
+
+      // the source dataspace only needs the shape of the selection if the whole dataset is mapped
+      auto src_shape   = (src.src_slab.empty() ? src.dst_slab.shape() : dims_t{});
+      dataspace sspace = (src.src_slab.empty() ? dataspace{H5Screate_simple(static_cast<int>(src_shape.size()), src_shape.data(), nullptr)}
+                                               : dataspace{H5Screate(H5S_SIMPLE)});
+      if (not src.src_slab.empty()) {
+        // the extent has to cover the selection
+        v_t src_extent(src.src_slab.rank());
+        for (int i = 0; i < src.src_slab.rank(); ++i) {
+          auto const &sl = src.src_slab;
+          hsize_t block  = (sl.block.empty() ? 1 : sl.block[i]);
+          src_extent[i]  = (sl.count[i] == 0 ? sl.offset[i] : sl.offset[i] + (sl.count[i] - 1) * sl.stride[i] + block);
+        }
+        H5Sset_extent_simple(sspace, static_cast<int>(src_extent.size()), src_extent.data(), nullptr);
+        select(sspace, src.src_slab, "source");
+      }
+      if (H5Sget_select_npoints(vspace) != H5Sget_select_npoints(sspace))
+        throw std::runtime_error("Error in h5::array_interface::create_virtual_dataset: The selections of the source dataset " + src.dataset_name
+                                 + " and the virtual dataset have different sizes");
+      if (H5Pset_virtual(dcpl, vspace, src.file_name.c_str(), src.dataset_name.c_str(), sspace) < 0)
+        throw std::runtime_error("Error in h5::array_interface::create_virtual_dataset: Adding the source dataset " + src.dataset_name + " failed");
+    }
+
+    // create the virtual dataset (existing datasets are never reused, since their layout is different)
+    H5Sselect_all(vspace);
+    g.unlink(name);
+    dataset ds = H5Dcreate2(g, name.c_str(), ty, vspace, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    if (not ds.is_valid()) throw std::runtime_error("Error in h5::array_interface::create_virtual_dataset: Creating the dataset " + name + " failed");
+    return ds;
+  }
+
+  dataset concatenate_virtual(group g, std::string const &name, std::vector<std::pair<std::string, std::string>> const &sources, int axis) {
+    if (sources.empty()) throw std::runtime_error("Error in h5::array_interface::concatenate_virtual: No source datasets given");
+
+    // get the shapes and datatypes of the sources
+    v_t shape;
+    datatype ty;
+    bool is_complex = false;
+    std::vector<virtual_source> mapped;
+    mapped.reserve(sources.size());
+    for (auto const &[fname, dname] : sources) {
+      auto f          = (fname == "." ? g.get_file() : file{fname, 'r'});
+      dataset ds      = group{f}.open_dataset(dname);
+      auto src_shape  = get_dataset_shape(ds);
+      datatype src_ty = H5Dget_type(ds);
+      bool src_cplx   = (H5Aexists(ds, "__complex__") > 0);
+      if (axis < 0 or axis >= static_cast<int>(src_shape.size()) - static_cast<int>(src_cplx))
+        throw std::runtime_error("Error in h5::array_interface::concatenate_virtual: Invalid concatenation axis for the source dataset " + dname);
+
+      // check that the sources are compatible
+      if (mapped.empty()) {
+        shape       = src_shape;
+        shape[axis] = 0;
+        ty          = src_ty;
+        is_complex  = src_cplx;
+      } else {
+        bool compatible = (src_shape.size() == shape.size() and H5Tequal(src_ty, ty) > 0 and src_cplx == is_complex);
+        for (std::size_t i = 0; compatible and i < shape.size(); ++i) compatible = (static_cast<int>(i) == axis or src_shape[i] == shape[i]);
+        if (not compatible)
+          throw std::runtime_error("Error in h5::array_interface::concatenate_virtual: The source dataset " + dname + " in " + fname
+                                   + " is not compatible with the previous ones");
+      }
+
+      // map the whole source to the next block along the axis
+      dims_t offset(shape.size(), 0);
+      offset[axis] = shape[axis];
+      mapped.push_back({fname, dname, block_slab(std::move(offset), src_shape)});
+      shape[axis] += src_shape[axis];
+    }
+
+    // create the virtual dataset and mark it as complex if necessary
+    auto ds = create_virtual_dataset(g, name, ty, shape, mapped);
+    if (is_complex) h5_write_attribute(ds, "__complex__", "1");
+    return ds;
+  }
+
+} // namespace h5::array_interface
@@ -0,0 +1,106 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+/**
+ * @file
+ * @brief Provides functions to create virtual datasets which map (parts of) other datasets into a single array.
+ */
+
+#ifndef LIBH5_VIRTUAL_DATASET_HPP
+#define LIBH5_VIRTUAL_DATASET_HPP
+
+#include "./array_interface.hpp"
+#include "./group.hpp"
+#include "./object.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace h5::array_interface {
+
+  /**
+   * @addtogroup rw_arrayinterface
+   * @{
+   */
+
+  /// A hyperslab of a source dataset which is mapped to a hyperslab of a virtual dataset.
+  struct virtual_source {
+    /// Name of the file containing the source dataset ("." refers to the file of the virtual dataset).
+    std::string file_name;
+
+    /// Path of the source dataset in its file.
+    std::string dataset_name;
+
+    /// Selection in the virtual dataset.
+    hyperslab dst_slab;
+
+    /// Selection in the source dataset (an empty hyperslab selects the whole dataset).
+    hyperslab src_slab = {};
+  };
+
+  /**
+   * @brief Create a virtual dataset (VDS) which maps hyperslabs of source datasets into a single array.
+   *
+   * @details The virtual dataset only stores the mappings (see `H5Pset_virtual`), i.e. no data is copied. It can be
+   * read like any other dataset, e.g. with h5::array_interface::read and arbitrary hyperslabs or with h5::read. HDF5
+   * fetches the data from the source datasets when they are read. Elements which are not covered by any of the sources
+   * or whose source file cannot be opened are filled with the fill value (zero). Source files are looked up relative
+   * to the directory of the file containing the virtual dataset.
+   *
+   * The source datasets need not exist when the virtual dataset is created. Each source selection has to contain the
+   * same number of elements as the corresponding selection in the virtual dataset. If a link with the given name
+   * already exists, it is first unlinked.
+   *
+   * @param g h5::group in which the virtual dataset is created.
+   * @param name Name of the virtual dataset.
+   * @param ty h5::datatype of the virtual dataset (the values of the sources are converted to it).
+   * @param shape Shape of the virtual dataset.
+   * @param sources Mapped hyperslabs of the source datasets.
+   * @return Handle to the virtual dataset.
+   */
+  dataset create_virtual_dataset(group g, std::string const &name, datatype const &ty, v_t const &shape, std::vector<virtual_source> const &sources);
+
+  /**
+   * @brief Create a virtual dataset (VDS) which concatenates existing datasets along a given axis.
+   *
+   * @details This is the typical use of virtual datasets to combine per-rank or per-run outputs without copying them.
+   * The shapes and datatypes of the sources are read from the source files, which therefore have to exist. All
+   * sources must have the same datatype and the same extent in all dimensions except for the concatenation axis. The
+   * `__complex__` attribute of complex sources is copied to the virtual dataset (the trailing dimension of size 2 can
+   * not be the concatenation axis).
+   *
+   * See h5::array_interface::create_virtual_dataset for more details.
+   *
+   * @code{.cpp}
+   * h5::file f("merged.h5", 'w');
+   * h5::array_interface::concatenate_virtual(f, "data", {{"rank0.h5", "data"}, {"rank1.h5", "data"}});
+   * auto data = h5::read<std::vector<double>>(f, "data");
+   * @endcode
+   *
+   * @param g h5::group in which the virtual dataset is created.
+   * @param name Name of the virtual dataset.
+   * @param sources File and dataset names of the sources in the order in which they are concatenated.
+   * @param axis Concatenation axis.
+   * @return Handle to the virtual dataset.
+   */
+  dataset concatenate_virtual(group g, std::string const &name, std::vector<std::pair<std::string, std::string>> const &sources, int axis = 0);
+
+  /** @} */
+
+} // namespace h5::array_interface
+
+#endif // LIBH5_VIRTUAL_DATASET_HPP
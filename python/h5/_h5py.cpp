@@ -31,7 +31,8 @@ PYBIND11_MODULE(_h5py, m) {
      .def_property_readonly("name", &h5::group::name, "Name of the group")
      .def("open_group", &h5::group::open_group, "Open the subgroup", "key"_a)
      .def("create_softlink", &h5::group::create_softlink, "Create a softlink", "target_key"_a, "key"_a, "delete_if_exists"_a = true)
-     .def("create_group", &h5::group::create_group, "Open the subgroup", "key"_a, "delete_if_exists"_a = true)
+     .def("create_group", py::overload_cast<std::string const &, bool>(&h5::group::create_group, py::const_), "Open the subgroup", "key"_a,
+          "delete_if_exists"_a = true)
      .def("keys", &h5::group::get_all_subgroup_dataset_names, "All the keys")
      .def("has_subgroup", &h5::group::has_subgroup, "", "key"_a)
      .def("has_dataset", &h5::group::has_dataset, "", "key"_a)
@@ -66,4 +67,44 @@ PYBIND11_MODULE(_h5py, m) {
          return py::reinterpret_steal<py::object>(ob);
      },
      "g"_a, "name"_a);
+
+  // read a dataset into an existing numpy array
+  m.def(
+     "h5_read_into",
+     [](h5::group g, std::string const &name, py::object out) {
+       h5::h5_read_into_bare(g, name, out.ptr());
+       if (PyErr_Occurred()) throw pybind11::error_already_set();
+     },
+     "g"_a, "name"_a, "out"_a);
+
+  // write a nested dict/list/tuple of numpy arrays and scalars recursively
+  m.def(
+     "h5_write_dict",
+     [](h5::group g, py::dict d) {
+       h5::h5_write_dict_bare(g, d.ptr());
+       if (PyErr_Occurred()) throw pybind11::error_already_set();
+     },
+     "g"_a, "d"_a);
+
+  // read all datasets and subgroups of a group recursively into a nested dict
+  m.def(
+     "h5_read_tree",
+     [](h5::group g) -> py::object {
+       PyObject *ob = h5::h5_read_tree_bare(g);
+       if (ob == nullptr) throw pybind11::error_already_set();
+       return py::reinterpret_steal<py::object>(ob);
+     },
+     "g"_a);
+
+  // read-only numpy view of a memory-mapped contiguous dataset
+  m.def(
+     "h5_map",
+     [](h5::group g, std::string const &name) -> py::object {
+       PyObject *ob = h5::h5_map_bare(g, name);
+       if (ob == nullptr)
+         throw pybind11::error_already_set();
+       else
+         return py::reinterpret_steal<py::object>(ob);
+     },
+     "g"_a, "name"_a);
 }
@@ -126,6 +126,14 @@ module.add_function (name = "h5_write", signature = "void h5_write_bare (group g
 
 module.add_function (name = "h5_read", signature = "PyObject * h5_read_bare (group g, std::string name)", doc = r"""""")
 
+module.add_function (name = "h5_read_into", signature = "void h5_read_into_bare (group g, std::string name, PyObject * out)", doc = r"""Read a dataset into an existing numpy array of the same shape""")
+
+module.add_function (name = "h5_write_dict", signature = "void h5_write_dict_bare (group g, PyObject * d)", doc = r"""Write a nested dict/list/tuple of numpy arrays and scalars recursively""")
+
+module.add_function (name = "h5_read_tree", signature = "PyObject * h5_read_tree_bare (group g)", doc = r"""Read all datasets and subgroups of a group recursively into a nested dict""")
+
+module.add_function (name = "h5_map", signature = "PyObject * h5_map_bare (group g, std::string name)", doc = r"""Read-only numpy view of a memory-mapped contiguous dataset""")
+
 
 
 module.generate_code()
@@ -50,15 +50,34 @@ class Dict:
     def __factory_from_dict__(cls, name, D) :
         return {n:x for n,x in list(D.items())}
 
+class PackedList:
+    """Ragged list of arrays stored as a flat 'values' dataset and the 'offsets' of the individual arrays."""
+    @classmethod
+    def __factory_from_dict__(cls, name, D) :
+        values, offsets = D['values'], D['offsets']
+        return [values[offsets[i]:offsets[i+1]] for i in range(len(offsets) - 1)]
+
+class ColumnarDict:
+    """Dict with numeric or string keys and numeric values stored as a 'keys' and a 'values' dataset."""
+    @classmethod
+    def __factory_from_dict__(cls, name, D) :
+        keys, values = D['keys'], D['values']
+        to_list = lambda x: x.tolist() if isinstance(x, numpy.ndarray) else list(x)
+        return dict(zip(to_list(keys), to_list(values)))
+
 register_class(List)
 register_backward_compatibility_method('PythonListWrap', 'List')
 
+register_class(PackedList)
+
 register_class(Tuple)
 register_backward_compatibility_method('PythonTupleWrap', 'Tuple')
 
 register_class(Dict)
 register_backward_compatibility_method('PythonDictWrap', 'Dict')
 
+register_class(ColumnarDict)
+
 # -------------------------------------------
 #
 #  A view of a subgroup of the archive
@@ -6,6 +6,10 @@
 #include <h5/scalar.hpp>
 #include <h5/stl/string.hpp>
 #include <h5/array_interface.hpp>
+#include <h5/format.hpp>
+#include <h5/compound.hpp>
+#include <h5/complex.hpp>
+#include <h5/threading.hpp>
 
 #include <cpp2py/cpp2py.hpp>
 #include <cpp2py/converters/vector.hpp>
@@ -15,6 +19,16 @@
 #include <hdf5_hl.h>
 
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
 
 namespace h5 {
 
@@ -23,10 +37,9 @@ namespace h5 {
     int c_size;         // size of the corresponding C object
   };
 
-  std::vector<h5_c_size_t> h5_c_size_table;
-
-  static void init_h5_c_size_table() {
-    h5_c_size_table = std::vector<h5_c_size_t>{
+  // table of HDF5 datatypes and C sizes (initialized once in a thread-safe way)
+  static std::vector<h5_c_size_t> const &h5_c_size_table() {
+    static std::vector<h5_c_size_t> const table{
        {hdf5_type<char>(), sizeof(char)},
        {hdf5_type<signed char>(), sizeof(signed char)},
        {hdf5_type<unsigned char>(), sizeof(unsigned char)},
@@ -46,15 +59,26 @@ namespace h5 {
        {hdf5_type<std::complex<double>>(), sizeof(std::complex<double>)},
        {hdf5_type<std::complex<long double>>(), sizeof(std::complex<long double>)} //
     };
+    return table;
   }
 
-  // h5 -> numpy type conversion
-  //FIXME we could sort the table and use binary_search
+  // h5 -> C size conversion (classified types are looked up in constant time)
   int h5_c_size(datatype t) {
-    if (h5_c_size_table.empty()) init_h5_c_size_table();
-    auto _end = h5_c_size_table.end();
-    auto pos  = std::find_if(h5_c_size_table.begin(), _end, [t](auto const &x) { return hdf5_type_equal(x.hdf5_type, t); });
-    if (pos == _end) std::runtime_error("HDF5/Python Internal Error : can not find the numpy type from the HDF5 type");
+    static auto const sizes = []() {
+      std::array<int, static_cast<std::size_t>(type_code::compound) + 1> res{};
+      for (auto const &x : h5_c_size_table()) {
+        auto &size = res[static_cast<std::size_t>(get_type_code(x.hdf5_type))];
+        if (size == 0) size = x.c_size;
+      }
+      return res;
+    }();
+    if (auto code = get_type_code(t); code != type_code::unknown and code != type_code::compound and sizes[static_cast<std::size_t>(code)] > 0)
+      return sizes[static_cast<std::size_t>(code)];
+
+    auto const &table = h5_c_size_table();
+    auto _end         = table.end();
+    auto pos          = std::find_if(table.begin(), _end, [t](auto const &x) { return hdf5_type_equal(x.hdf5_type, t); });
+    if (pos == _end) throw std::runtime_error("HDF5/Python Internal Error : can not find the numpy type from the HDF5 type");
     return pos->c_size;
   }
 
@@ -68,12 +92,9 @@ namespace h5 {
 
   //--------------------------------------
 
-  std::vector<h5_py_type_t> h5_py_type_table;
-
-  //--------------------------------------
-
-  static void init_h5py() {
-    h5_py_type_table = std::vector<h5_py_type_t>{
+  // table of HDF5 datatypes and numpy types (initialized once in a thread-safe way)
+  static std::vector<h5_py_type_t> const &h5_py_type_table() {
+    static std::vector<h5_py_type_t> const table{
        {hdf5_type<char>(), NPY_STRING, sizeof(char)},
        {hdf5_type<signed char>(), NPY_BYTE, sizeof(signed char)},
        {hdf5_type<unsigned char>(), NPY_UBYTE, sizeof(unsigned char)},
@@ -93,18 +114,34 @@ namespace h5 {
        {hdf5_type<std::complex<double>>(), NPY_CDOUBLE, sizeof(std::complex<double>)},
        {hdf5_type<std::complex<long double>>(), NPY_CLONGDOUBLE, sizeof(std::complex<long double>)} //
     };
+    return table;
   }
 
   //--------------------------------------
 
   // h5 -> numpy type conversion
   int h5_to_npy(datatype t, bool is_complex) {
-
-    if (h5_py_type_table.empty()) init_h5py();
-    auto _end = h5_py_type_table.end();
-    auto pos  = std::find_if(h5_py_type_table.begin(), _end, [t](auto const &x) { return hdf5_type_equal(x.hdf5_type, t); });
-    if (pos == _end) throw std::runtime_error("HDF5/Python Internal Error : can not find the numpy type from the HDF5 type");
-    int res = pos->numpy_type;
+    // numpy types of the classified types (the first entry in the table with a given code wins)
+    static auto const npy_types = []() {
+      std::array<int, static_cast<std::size_t>(type_code::compound) + 1> res;
+      res.fill(-1);
+      for (auto const &x : h5_py_type_table()) {
+        auto &npy = res[static_cast<std::size_t>(get_type_code(x.hdf5_type))];
+        if (npy < 0) npy = x.numpy_type;
+      }
+      res[static_cast<std::size_t>(type_code::unknown)]  = -1;
+      res[static_cast<std::size_t>(type_code::compound)] = -1;
+      return res;
+    }();
+
+    int res = npy_types[static_cast<std::size_t>(get_type_code(t))];
+    if (res < 0) {
+      auto const &table = h5_py_type_table();
+      auto _end         = table.end();
+      auto pos          = std::find_if(table.begin(), _end, [t](auto const &x) { return hdf5_type_equal(x.hdf5_type, t); });
+      if (pos == _end) throw std::runtime_error("HDF5/Python Internal Error : can not find the numpy type from the HDF5 type");
+      res = pos->numpy_type;
+    }
     if (is_complex) {
       if (res == NPY_DOUBLE) res = NPY_CDOUBLE;
       if (res == NPY_FLOAT) res = NPY_CFLOAT;
@@ -117,10 +154,10 @@ namespace h5 {
 
   // numpy -> h5 type conversion
   datatype npy_to_h5(int t) {
-    if (h5_py_type_table.empty()) init_h5py();
-    auto _end = h5_py_type_table.end();
-    auto pos  = std::find_if(h5_py_type_table.begin(), _end, [t](auto const &x) { return x.numpy_type == t; });
-    if (pos == _end) std::runtime_error("HDF5/Python Internal Error : can not find the numpy type from the HDF5 type");
+    auto const &table = h5_py_type_table();
+    auto _end         = table.end();
+    auto pos          = std::find_if(table.begin(), _end, [t](auto const &x) { return x.numpy_type == t; });
+    if (pos == _end) throw std::runtime_error("HDF5/Python Internal Error : can not find the HDF5 type from the numpy type");
     return pos->hdf5_type;
   }
 
@@ -139,30 +176,41 @@ namespace h5 {
     datatype dt           = npy_to_h5(elementsType);
     const bool is_complex = (elementsType == NPY_CDOUBLE) or (elementsType == NPY_CLONGDOUBLE) or (elementsType == NPY_CFLOAT);
 
-    array_interface::array_view res{dt, PyArray_DATA(arr_obj), rank, is_complex};
-    std::vector<long> c_strides(rank + is_complex, 0);
-    long total_size = 1;
+    v_t shape(rank);
+    std::vector<long> c_strides(rank, 0);
+    auto const c_size = h5_c_size(dt) * (is_complex ? 2 : 1);
 
     for (int i = 0; i < rank; ++i) {
 #ifdef PYTHON_NUMPY_VERSION_LT_17
-      res.slab.count[i] = size_t(arr_obj->dimensions[i]);
-      c_strides[i]      = std::ptrdiff_t(arr_obj->strides[i]) / h5_c_size(dt);
+      shape[i]     = size_t(arr_obj->dimensions[i]);
+      c_strides[i] = std::ptrdiff_t(arr_obj->strides[i]) / c_size;
 #else
-      res.slab.count[i] = size_t(PyArray_DIMS(arr_obj)[i]);
-      c_strides[i]      = std::ptrdiff_t(PyArray_STRIDES(arr_obj)[i]) / h5_c_size(dt);
+      shape[i]     = size_t(PyArray_DIMS(arr_obj)[i]);
+      c_strides[i] = std::ptrdiff_t(PyArray_STRIDES(arr_obj)[i]) / c_size;
 #endif
-      total_size *= res.slab.count[i];
     }
 
-    // be careful to consider the last dim if complex, but do NOT copy it
-    auto [Ltot, stri] = h5::array_interface::get_parent_shape_and_h5_strides(c_strides.data(), rank + is_complex, total_size * (is_complex ? 2 : 1));
-    for (int i = 0; i < rank; ++i) {
-      res.parent_shape[i] = Ltot[i];
-      res.slab.stride[i]  = stri[i];
+    // strides which cannot be described by a hyperslab select the elements of the array directly (no copy)
+    return h5::array_interface::make_strided_view(dt, PyArray_DATA(arr_obj), shape, c_strides, is_complex);
+  }
+
+  // Release the GIL while HDF5 reads/writes the data of a numpy array. The released region holds an h5::library_lock.
+  // All other HDF5 calls of this module are only guarded by the GIL, so the GIL is kept if the HDF5 library is not
+  // thread-safe. Otherwise, HDF5 serializes the calls of concurrent Python threads itself.
+  class gil_release {
+    public:
+    gil_release() : state_(is_library_threadsafe() ? PyEval_SaveThread() : nullptr), lock_(std::in_place) {}
+    gil_release(gil_release const &)            = delete;
+    gil_release &operator=(gil_release const &) = delete;
+    ~gil_release() {
+      lock_.reset();
+      if (state_ != nullptr) PyEval_RestoreThread(state_);
     }
 
-    return res;
-  }
+    private:
+    PyThreadState *state_;
+    std::optional<library_lock> lock_;
+  };
 
   // -------------------------
   static void import_numpy() {
@@ -180,7 +228,9 @@ namespace h5 {
 
     if (PyArray_Check(ob)) {
       PyArrayObject *arr_obj = (PyArrayObject *)ob;
-      write(g, name, make_av_from_npy(arr_obj), true);
+      auto av                = make_av_from_npy(arr_obj);
+      gil_release no_gil;
+      write(g, name, av, true);
     } else if (PyArray_CheckScalar(ob)) {
       // Treat numpy scalars as 0-dimensional ndarrays
       cpp2py::pyref obsc = PyArray_FromScalar(ob, NULL);
@@ -205,32 +255,70 @@ namespace h5 {
 
   // Read any integer type from hdf5 and return a Python long
   PyObject *h5_read_any_int(group g, std::string const &name, auto h5type) {
-    if (H5Tequal(h5type, H5T_NATIVE_SHORT)) {
-      return PyLong_FromLong(h5_read<short>(g, name));
-    } else if (H5Tequal(h5type, H5T_NATIVE_INT)) {
-      return PyLong_FromLong(h5_read<int>(g, name));
-    } else if (H5Tequal(h5type, H5T_NATIVE_LONG)) {
-      return PyLong_FromLong(h5_read<long>(g, name));
-    } else if (H5Tequal(h5type, H5T_NATIVE_LLONG)) {
-      return PyLong_FromLongLong(h5_read<long long>(g, name));
-    } else if (H5Tequal(h5type, H5T_NATIVE_USHORT)) {
-      return PyLong_FromUnsignedLong(h5_read<unsigned short>(g, name));
-    } else if (H5Tequal(h5type, H5T_NATIVE_UINT)) {
-      return PyLong_FromUnsignedLong(h5_read<unsigned int>(g, name));
-    } else if (H5Tequal(h5type, H5T_NATIVE_ULONG)) {
-      return PyLong_FromUnsignedLong(h5_read<unsigned long>(g, name));
-    } else if (H5Tequal(h5type, H5T_NATIVE_ULLONG)) {
-      return PyLong_FromUnsignedLongLong(h5_read<unsigned long long>(g, name));
-    } else {
-      PyErr_SetString(PyExc_RuntimeError, "h5_read to Python: unknown integer type");
+    switch (get_type_code(h5type)) {
+      case type_code::int16: return PyLong_FromLong(h5_read<short>(g, name));
+      case type_code::int32: return PyLong_FromLong(h5_read<int>(g, name));
+      case type_code::int64: return PyLong_FromLongLong(h5_read<long long>(g, name));
+      case type_code::uint16: return PyLong_FromUnsignedLong(h5_read<unsigned short>(g, name));
+      case type_code::uint32: return PyLong_FromUnsignedLong(h5_read<unsigned int>(g, name));
+      case type_code::uint64: return PyLong_FromUnsignedLongLong(h5_read<unsigned long long>(g, name));
+      default: PyErr_SetString(PyExc_RuntimeError, "h5_read to Python: unknown integer type"); return NULL;
+    }
+  }
+
+  // Read a scalar dataset with a compound datatype (e.g. a std::tuple/std::pair of arithmetic/complex values) and
+  // return a Python tuple with one element per member
+  static PyObject *h5_read_compound_scalar(dataset const &ds, datatype const &ty) {
+    int n = H5Tget_nmembers(ty);
+    if (n < 0) {
+      PyErr_SetString(PyExc_RuntimeError, "h5_read to Python: can not get the members of the compound datatype");
       return NULL;
     }
+
+    // read a single member converted to the given C type (matched by name)
+    auto read_member = [&ds]<typename T>(std::string const &member, T x) {
+      datatype mem_ty = H5Tcreate(H5T_COMPOUND, sizeof(T));
+      if (H5Tinsert(mem_ty, member.c_str(), 0, hdf5_type<T>()) < 0 or H5Dread(ds, mem_ty, H5S_ALL, H5S_ALL, H5P_DEFAULT, &x) < 0)
+        throw std::runtime_error("h5_read to Python: reading the member " + member + " of the compound dataset failed");
+      return x;
+    };
+
+    cpp2py::pyref res = PyTuple_New(n);
+    if (res == NULL) return NULL;
+    for (int i = 0; i < n; ++i) {
+      char *c_name = H5Tget_member_name(ty, static_cast<unsigned>(i));
+      std::string member{c_name};
+      H5free_memory(c_name);
+      datatype m_ty = H5Tget_member_type(ty, static_cast<unsigned>(i));
+
+      PyObject *item = NULL;
+      if (H5Tequal(m_ty, hdf5_type<bool>()) > 0) {
+        item = PyBool_FromLong(long(read_member(member, bool{})));
+      } else if (H5Tget_class(m_ty) == H5T_INTEGER) {
+        if (H5Tget_sign(m_ty) == H5T_SGN_NONE)
+          item = PyLong_FromUnsignedLongLong(read_member(member, 0ULL));
+        else
+          item = PyLong_FromLongLong(read_member(member, 0LL));
+      } else if (H5Tget_class(m_ty) == H5T_FLOAT) {
+        item = PyFloat_FromDouble(read_member(member, double{}));
+      } else if (H5Tget_class(m_ty) == H5T_COMPOUND and get_compound_member_names(m_ty) == std::vector<std::string>{"r", "i"}) {
+        auto z = read_member(member, dcplx_t{});
+        item   = PyComplex_FromDoubles(z.r, z.i);
+      } else {
+        PyErr_SetString(PyExc_RuntimeError, "h5_read to Python: unknown type of a member of the compound dataset");
+        return NULL;
+      }
+      if (item == NULL) return NULL;
+      PyTuple_SET_ITEM((PyObject *)res, i, item);
+    }
+    return res.new_ref();
   }
 
   PyObject *h5_read_bare(group g, std::string const &name) { // There should be no errors from h5 reading
     import_numpy();
 
-    array_interface::dataset_info ds_info = array_interface::get_dataset_info(g, name);
+    dataset ds                            = g.open_dataset(name);
+    array_interface::dataset_info ds_info = array_interface::get_dataset_info(ds);
 
     // First case, we have a scalar
     if (ds_info.rank() == 0) {
@@ -250,17 +338,13 @@ namespace h5 {
         h5_read(g, name, x);
         return PyUnicode_FromString(x.c_str());
       }
-      if (H5Tequal(ds_info.ty, hdf5_type<dcplx_t>())) {
-        dcplx_t x;
-        h5_read(g, name, x);
-        return PyComplex_FromDoubles(x.r, x.i);
-      }
+      if (H5Tget_class(ds_info.ty) == H5T_COMPOUND) return h5_read_compound_scalar(ds, ds_info.ty);
       // Default case : error, we can not read
       PyErr_SetString(PyExc_RuntimeError, "h5_read to Python: unknown scalar type");
       return NULL;
     }
 
-    // A scalar complex is a special case
+    // A scalar complex is a special case (also if it is stored with a complex datatype)
     if ((ds_info.rank() == 1) and ds_info.has_complex_attribute) {
       std::complex<double> z;
       h5_read(g, name, z);
@@ -296,7 +380,187 @@ namespace h5 {
     // in case of allocation error
 
     // read from the file
-    read(g, name, make_av_from_npy((PyArrayObject *)ob));
+    auto av = make_av_from_npy((PyArrayObject *)ob);
+    {
+      gil_release no_gil;
+      read(ds, av);
+    }
+    return ob;
+  }
+
+  // -------------------------
+
+  void h5_read_into_bare(group g, std::string const &name, PyObject *ob) {
+    import_numpy();
+
+    if (not PyArray_Check(ob)) {
+      PyErr_SetString(PyExc_TypeError, "h5_read_into: The output object has to be a numpy array");
+      return;
+    }
+    PyArrayObject *arr_obj = (PyArrayObject *)ob;
+    if (not PyArray_ISWRITEABLE(arr_obj) or not PyArray_ISALIGNED(arr_obj)) {
+      PyErr_SetString(PyExc_ValueError, "h5_read_into: The output array has to be writeable and aligned");
+      return;
+    }
+
+    // the array has to have the same shape as the dataset (without the last dimension in the complex case)
+    dataset ds                            = g.open_dataset(name);
+    array_interface::dataset_info ds_info = array_interface::get_dataset_info(ds);
+    if (H5Tget_class(ds_info.ty) == H5T_STRING) {
+      PyErr_SetString(PyExc_TypeError, "h5_read_into: String datasets can not be read into a numpy array");
+      return;
+    }
+    auto av = make_av_from_npy(arr_obj);
+    if (av.is_complex != ds_info.has_complex_attribute or av.slab.shape() != ds_info.lengths) {
+      PyErr_SetString(PyExc_ValueError, "h5_read_into: The shape of the output array does not match the shape of the dataset");
+      return;
+    }
+
+    // read from the file
+    gil_release no_gil;
+    read(ds, av);
+  }
+
+  // -------------------------
+
+  // Python containers which are stored as subgroups with the format of the corresponding HDFArchive wrapper.
+  static char const *tree_format(PyObject *ob) {
+    if (PyDict_Check(ob)) return "Dict";
+    if (PyList_Check(ob)) return "List";
+    if (PyTuple_Check(ob)) return "Tuple";
+    return nullptr;
+  }
+
+  // Write the items of a dict, list or tuple to a group (the numpy arrays of a group are written together).
+  static bool write_tree(group g, PyObject *ob) {
+    // collect the names and the (borrowed) values of the items
+    std::vector<std::pair<std::string, PyObject *>> items;
+    if (PyDict_Check(ob)) {
+      PyObject *key = NULL, *value = NULL;
+      Py_ssize_t pos = 0;
+      while (PyDict_Next(ob, &pos, &key, &value)) {
+        cpp2py::pyref key_str = PyObject_Str(key);
+        char const *key_utf8  = (key_str == NULL ? NULL : PyUnicode_AsUTF8(key_str));
+        if (key_utf8 == NULL) return false;
+        items.emplace_back(key_utf8, value);
+      }
+    } else {
+      bool is_list = PyList_Check(ob);
+      Py_ssize_t n = (is_list ? PyList_GET_SIZE(ob) : PyTuple_GET_SIZE(ob));
+      for (Py_ssize_t i = 0; i < n; ++i) items.emplace_back(std::to_string(i), (is_list ? PyList_GET_ITEM(ob, i) : PyTuple_GET_ITEM(ob, i)));
+    }
+
+    // write subtrees and scalars directly and collect the arrays
+    std::vector<std::pair<std::string, array_interface::array_view>> arrays;
+    for (auto const &[name, value] : items) {
+      if (name.find('/') != std::string::npos) {
+        PyErr_SetString(PyExc_ValueError, "h5_write_dict: / can not be part of a key");
+        return false;
+      }
+      if (auto fmt = tree_format(value); fmt != nullptr) {
+        auto sub = g.create_group(name);
+        if (not write_tree(sub, value)) return false;
+        write_hdf5_format_as_string(sub, fmt);
+      } else if (PyArray_Check(value)) {
+        arrays.emplace_back(name, make_av_from_npy((PyArrayObject *)value));
+      } else {
+        h5_write_bare(g, name, value);
+        if (PyErr_Occurred()) return false;
+      }
+    }
+
+    // create and write all datasets of the group in one go
+    if (not arrays.empty()) {
+      gil_release no_gil;
+      array_interface::write_multi(g, arrays, write_options{.deflate_level = 1});
+    }
+    return true;
+  }
+
+  void h5_write_dict_bare(group g, PyObject *ob) {
+    import_numpy();
+    if (not PyDict_Check(ob)) {
+      PyErr_SetString(PyExc_TypeError, "h5_write_dict: The object has to be a dict");
+      return;
+    }
+    write_tree(g, ob);
+  }
+
+  // -------------------------
+
+  PyObject *h5_read_tree_bare(group g) {
+    import_numpy();
+
+    // read all children (subgroups are read recursively)
+    cpp2py::pyref res = PyDict_New();
+    if (res == NULL) return NULL;
+    for (auto const &c : g.children()) {
+      if (c.type != object_type::group and c.type != object_type::dataset) continue;
+      PyObject *value = (c.type == object_type::group ? h5_read_tree_bare(g.open_group(c.name)) : h5_read_bare(g, c.name));
+      if (value == NULL) return NULL;
+      int err = PyDict_SetItemString(res, c.name.c_str(), value);
+      Py_DECREF(value);
+      if (err < 0) return NULL;
+    }
+
+    // groups written from lists and tuples are converted back
+    auto fmt = read_hdf5_format(g);
+    if (fmt != "List" and fmt != "Tuple") return res.new_ref();
+    std::vector<std::pair<long, PyObject *>> items;
+    PyObject *key = NULL, *value = NULL;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(res, &pos, &key, &value)) {
+      // the keys of list and tuple groups are the indices of the items
+      char const *key_utf8 = PyUnicode_AsUTF8(key);
+      if (key_utf8 == NULL) return NULL;
+      std::string_view key_str{key_utf8};
+      long idx       = 0;
+      auto [ptr, ec] = std::from_chars(key_str.data(), key_str.data() + key_str.size(), idx);
+      if (ec != std::errc{} or ptr != key_str.data() + key_str.size() or idx < 0)
+        throw std::runtime_error("Error in h5::h5_read_tree: Key " + std::string{key_str} + " in the " + fmt + " group " + g.name()
+                                 + " is not a valid index");
+      items.emplace_back(idx, value);
+    }
+    std::sort(items.begin(), items.end(), [](auto const &x, auto const &y) { return x.first < y.first; });
+    cpp2py::pyref lst = PyList_New(static_cast<Py_ssize_t>(items.size()));
+    if (lst == NULL) return NULL;
+    for (std::size_t i = 0; i < items.size(); ++i) {
+      Py_INCREF(items[i].second);
+      PyList_SET_ITEM((PyObject *)lst, static_cast<Py_ssize_t>(i), items[i].second);
+    }
+    return (fmt == "List" ? lst.new_ref() : PyList_AsTuple(lst));
+  }
+
+  // -------------------------
+
+  PyObject *h5_map_bare(group g, std::string const &name) {
+    import_numpy();
+
+    // the capsule owns the mapping and is the base object of the numpy array
+    auto *m = new mapped_dataset(g, name);
+    PyObject *capsule = PyCapsule_New(m, "h5.mapped_dataset", [](PyObject *cap) {
+      delete static_cast<mapped_dataset *>(PyCapsule_GetPointer(cap, "h5.mapped_dataset"));
+    });
+    if (capsule == NULL) {
+      delete m;
+      return NULL;
+    }
+
+    // read-only numpy view of the mapped data (complex datasets lose their last dimension)
+    std::vector<npy_intp> L(m->shape().begin(), m->shape().end());
+    bool is_cplx_type = (get_type_code(m->type()) == type_code::complex_compound);
+    int elementsType  = (is_cplx_type ? NPY_CDOUBLE : h5_to_npy(m->type(), m->is_complex()));
+    if (m->is_complex()) L.pop_back();
+    PyObject *ob = PyArray_NewFromDescr(&PyArray_Type, PyArray_DescrFromType(elementsType), int(L.size()), L.data(), NULL,
+                                        const_cast<std::byte *>(m->data()), 0, NULL);
+    if (ob == NULL) {
+      Py_DECREF(capsule);
+      return NULL;
+    }
+    if (PyArray_SetBaseObject((PyArrayObject *)ob, capsule) < 0) {
+      Py_DECREF(ob);
+      return NULL;
+    }
     return ob;
   }
 
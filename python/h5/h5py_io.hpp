@@ -9,6 +9,10 @@ namespace h5 {
 
   void h5_write_bare(group g, std::string const &name, PyObject *ob);
   PyObject *h5_read_bare(group g, std::string const &name);
+  PyObject *h5_map_bare(group g, std::string const &name);
+  void h5_read_into_bare(group g, std::string const &name, PyObject *ob);
+  void h5_write_dict_bare(group g, PyObject *ob);
+  PyObject *h5_read_tree_bare(group g);
 
 } // namespace h5
 
@@ -19,6 +19,7 @@
 
 #include <array>
 #include <complex>
+#include <stdexcept>
 #include <string>
 
 TEST(H5, ArrayOfBasicTypes) {
@@ -68,5 +69,45 @@ TEST(H5, ArrayConvert) {
 
     EXPECT_EQ((std::array{1l, 2l}), arr_long);
     EXPECT_EQ((std::array{1.5 + 0i, 2.5 + 0i}), arr_cplx);
+
+    // the conversion policy applies to both conversions
+    using policy = h5::transfer_options::conversion_policy;
+    arr_long     = {};
+    arr_cplx     = {};
+    testing::internal::CaptureStderr();
+    h5::read(file, "arr_int", arr_long, h5::transfer_options{.conversion = policy::allow});
+    h5::read(file, "arr_dbl", arr_cplx, h5::transfer_options{.conversion = policy::allow});
+    EXPECT_TRUE(testing::internal::GetCapturedStderr().empty());
+    EXPECT_EQ((std::array{1l, 2l}), arr_long);
+    EXPECT_EQ((std::array{1.5 + 0i, 2.5 + 0i}), arr_cplx);
+    EXPECT_THROW(h5::read(file, "arr_int", arr_long, h5::transfer_options{.conversion = policy::forbid}), std::runtime_error);
+    EXPECT_THROW(h5::read(file, "arr_dbl", arr_cplx, h5::transfer_options{.conversion = policy::forbid}), std::runtime_error);
+  }
+}
+
+TEST(H5, NestedArray) {
+  // nested arrays of arithmetic/complex types are stored in a single multidimensional dataset
+  using namespace std::complex_literals;
+  auto mat  = std::array<std::array<double, 3>, 2>{{{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}}};
+  auto cube = std::array<std::array<std::array<int, 2>, 2>, 2>{};
+  for (int i = 0; i < 8; ++i) cube[i / 4][(i / 2) % 2][i % 2] = i;
+  auto cmat = std::array<std::array<std::complex<double>, 2>, 2>{{{1.0 + 1i, 2.0}, {-1i, 0.5}}};
+
+  {
+    h5::file file{"test_arr_nested.h5", 'w'};
+    h5::write(file, "mat", mat);
+    h5::write(file, "cube", cube);
+    h5::write(file, "cmat", cmat);
+  }
+
+  {
+    h5::file file{"test_arr_nested.h5", 'r'};
+    h5::group g{file};
+    EXPECT_EQ(h5::array_interface::get_dataset_shape(g.open_dataset("mat")), (h5::v_t{2, 3}));
+    EXPECT_EQ(h5::array_interface::get_dataset_shape(g.open_dataset("cube")), (h5::v_t{2, 2, 2}));
+
+    EXPECT_EQ(h5::read<decltype(mat)>(file, "mat"), mat);
+    EXPECT_EQ(h5::read<decltype(cube)>(file, "cube"), cube);
+    EXPECT_EQ(h5::read<decltype(cmat)>(file, "cmat"), cmat);
   }
 }
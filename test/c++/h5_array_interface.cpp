@@ -17,11 +17,33 @@
 #include <gtest/gtest.h>
 #include <h5/h5.hpp>
 
+#include <hdf5.h>
 #include <hdf5_hl.h>
 
+#ifdef H5_MPI_SUPPORT
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <complex>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <numeric>
+#include <string>
+#include <utility>
 #include <vector>
 
+#ifdef H5_MPI_SUPPORT
+// Initialize and finalize MPI for all tests.
+class MPIEnvironment : public ::testing::Environment {
+  public:
+  void SetUp() override { MPI_Init(nullptr, nullptr); }
+  void TearDown() override { MPI_Finalize(); }
+};
+static auto *const mpi_env = ::testing::AddGlobalTestEnvironment(new MPIEnvironment);
+#endif
+
 // Print container.
 template <typename C>
 void print(const C &c) {
@@ -190,6 +212,14 @@ TEST(H5, ArrayInterface1DArray) {
   h5::array_interface::read(file, "view_3", view_in_4, slab_4);
 
   for (int i = 0; i < 50; ++i) { EXPECT_EQ(data_in_4[i], data_in_3[i]); }
+
+  // write and read slices through an already opened dataset
+  auto ds_3 = group.open_dataset("view_3");
+  std::fill(data_in_4.begin(), data_in_4.end(), 0);
+  h5::array_interface::write_slice(ds_3, view_2, slab_4);
+  h5::array_interface::read(ds_3, view_in_4, slab_4);
+  for (int i = 0; i < 50; ++i) { EXPECT_EQ(data_in_4[i], data_in_3[i]); }
+  EXPECT_EQ(h5::array_interface::get_dataset_info(ds_3).lengths, shape_3);
 }
 
 TEST(H5, ArrayInterface3DArray) {
@@ -248,3 +278,687 @@ TEST(H5, ArrayInterface3DArray) {
   // check results
   for (int i = 0; i < 18; ++i) { EXPECT_EQ(data_in_2[i], data_in_3[i]); }
 }
+
+TEST(H5, ArrayInterfaceExtensible) {
+  // test appending to an extensible 2D array
+  h5::file file("extensible_array.h5", 'w');
+  std::vector<int> data(12, 0);
+  std::iota(data.begin(), data.end(), 0);
+
+  // create an extensible 2x3 array
+  h5::array_interface::array_view view_1(h5::hdf5_type<int>(), (void *)data.data(), 2, false);
+  view_1.slab.count   = {2, 3};
+  view_1.parent_shape = {2, 3};
+  h5::array_interface::create_extensible(file, "ext", view_1, true, 2);
+
+  // append a 2x3 array
+  h5::array_interface::array_view view_2(h5::hdf5_type<int>(), (void *)(data.data() + 6), 2, false);
+  view_2.slab.count   = {2, 3};
+  view_2.parent_shape = {2, 3};
+  h5::array_interface::append(file, "ext", view_2);
+
+  // appending an empty array does nothing
+  h5::array_interface::array_view view_3(h5::hdf5_type<int>(), (void *)data.data(), 2, false);
+  view_3.slab.count   = {0, 3};
+  view_3.parent_shape = {0, 3};
+  h5::array_interface::append(file, "ext", view_3);
+
+  // check the shape of the extended dataset
+  auto ds_info = h5::array_interface::get_dataset_info(file, "ext");
+  EXPECT_EQ(ds_info.lengths, (h5::v_t{4, 3}));
+
+  // read the full array
+  std::vector<int> data_in(12, 0);
+  h5::array_interface::array_view view_in(h5::hdf5_type<int>(), (void *)data_in.data(), 2, false);
+  view_in.slab.count   = {4, 3};
+  view_in.parent_shape = {4, 3};
+  h5::array_interface::read(file, "ext", view_in);
+  EXPECT_EQ(data, data_in);
+
+  // incompatible shapes and types
+  h5::array_interface::array_view view_4(h5::hdf5_type<int>(), (void *)data.data(), 2, false);
+  view_4.slab.count   = {3, 4};
+  view_4.parent_shape = {3, 4};
+  EXPECT_THROW(h5::array_interface::append(file, "ext", view_4), std::runtime_error);
+  std::vector<double> ddata(6, 0.0);
+  h5::array_interface::array_view view_5(h5::hdf5_type<double>(), (void *)ddata.data(), 2, false);
+  view_5.slab.count   = {2, 3};
+  view_5.parent_shape = {2, 3};
+  EXPECT_THROW(h5::array_interface::append(file, "ext", view_5), std::runtime_error);
+
+  // fixed size datasets cannot be extended
+  h5::array_interface::write(file, "fixed", view_1, true);
+  EXPECT_THROW(h5::array_interface::append(file, "fixed", view_2), std::runtime_error);
+}
+
+TEST(H5, ArrayInterfaceWriteOptions) {
+  // test the dataset creation policy for a 2D array
+  h5::file file("write_options.h5", 'w');
+  h5::group group(file);
+  std::vector<double> data(10000, 0);
+  std::iota(data.begin(), data.end(), 0);
+  h5::array_interface::array_view view(h5::hdf5_type<double>(), (void *)data.data(), 2, false);
+  view.slab.count   = {100, 100};
+  view.parent_shape = {100, 100};
+
+  // get the chunk shape and the number of filters of a dataset
+  auto get_chunk_shape = [&](std::string const &name) {
+    auto ds           = group.open_dataset(name);
+    h5::proplist dcpl = H5Dget_create_plist(ds);
+    h5::v_t chunk_shape(2, 0);
+    if (H5Pget_layout(dcpl) != H5D_CHUNKED) return std::make_pair(h5::v_t{}, 0);
+    H5Pget_chunk(dcpl, 2, chunk_shape.data());
+    return std::make_pair(chunk_shape, H5Pget_nfilters(dcpl));
+  };
+
+  // read a dataset and compare with the original data
+  auto check_data = [&](std::string const &name) {
+    std::vector<double> data_in(data.size(), 0);
+    h5::array_interface::array_view view_in(h5::hdf5_type<double>(), (void *)data_in.data(), 2, false);
+    view_in.slab.count   = {100, 100};
+    view_in.parent_shape = {100, 100};
+    h5::array_interface::read(file, name, view_in);
+    EXPECT_EQ(data, data_in);
+  };
+
+  // contiguous layout without filters
+  h5::array_interface::write(file, "contiguous", view, h5::write_options{});
+  EXPECT_EQ(get_chunk_shape("contiguous"), std::make_pair(h5::v_t{}, 0));
+  check_data("contiguous");
+
+  // legacy compression
+  h5::array_interface::write(file, "compressed", view, true);
+  EXPECT_EQ(get_chunk_shape("compressed"), std::make_pair(h5::v_t{100, 100}, 1));
+  check_data("compressed");
+
+  // user defined chunk shape with shuffle and deflate filters
+  h5::array_interface::write(file, "chunk_shape", view, h5::write_options{.chunk_shape = {10, 20}, .deflate_level = 6, .shuffle = true});
+  EXPECT_EQ(get_chunk_shape("chunk_shape"), std::make_pair(h5::v_t{10, 20}, 2));
+  check_data("chunk_shape");
+
+  // target chunk size in bytes
+  h5::array_interface::write(file, "chunk_bytes", view, h5::write_options{.chunk_bytes = 10000});
+  EXPECT_EQ(get_chunk_shape("chunk_bytes"), std::make_pair(h5::v_t{25, 50}, 0));
+  check_data("chunk_bytes");
+
+  // invalid chunk shape
+  EXPECT_THROW(h5::array_interface::write(file, "invalid", view, h5::write_options{.chunk_shape = {10}}), std::runtime_error);
+
+  // fill value of an unwritten dataset with early allocation
+  double fill    = -1.0;
+  auto opts      = h5::write_options{.chunk_shape = {5}, .allocation = h5::write_options::alloc_time::early};
+  opts.fill_value.resize(sizeof(double));
+  std::memcpy(opts.fill_value.data(), &fill, sizeof(double));
+  h5::v_t shape          = {10};
+  h5::dataspace dspace   = H5Screate_simple(1, shape.data(), nullptr);
+  auto dcpl              = h5::make_dataset_create_proplist(opts, h5::hdf5_type<double>(), shape, false);
+  std::ignore            = group.create_dataset("fill", h5::hdf5_type<double>(), dspace, dcpl);
+  std::vector<double> data_in(10, 0);
+  h5::array_interface::array_view view_in(h5::hdf5_type<double>(), (void *)data_in.data(), 1, false);
+  view_in.slab.count[0]   = 10;
+  view_in.parent_shape[0] = 10;
+  h5::array_interface::read(file, "fill", view_in);
+  EXPECT_EQ(data_in, std::vector<double>(10, fill));
+}
+
+TEST(H5, ArrayInterfaceMulti) {
+  // write and read multiple datasets at once
+  h5::file file("multi.h5", 'w');
+  h5::group group(file);
+
+  // create views of many small arrays, including an empty one
+  int n = 20;
+  std::vector<std::vector<double>> data(n);
+  std::vector<std::pair<std::string, h5::array_interface::array_view>> items;
+  for (int i = 0; i < n; ++i) {
+    data[i].resize(i, static_cast<double>(i));
+    h5::array_interface::array_view v(h5::hdf5_type<double>(), (void *)data[i].data(), 1, false);
+    v.slab.count[0]   = i;
+    v.parent_shape[0] = i;
+    items.emplace_back("obs_" + std::to_string(i), v);
+  }
+  h5::array_interface::write_multi(group, items, {.deflate_level = 1});
+
+  // read them back
+  std::vector<std::vector<double>> data_in(n);
+  std::vector<std::pair<std::string, h5::array_interface::array_view>> items_in;
+  for (int i = 0; i < n; ++i) {
+    data_in[i].resize(i, -1.0);
+    h5::array_interface::array_view v(h5::hdf5_type<double>(), (void *)data_in[i].data(), 1, false);
+    v.slab.count[0]   = i;
+    v.parent_shape[0] = i;
+    items_in.emplace_back("obs_" + std::to_string(i), v);
+  }
+  h5::array_interface::read_multi(group, items_in);
+  EXPECT_EQ(data, data_in);
+
+  // size mismatch
+  items_in[3].second.slab.count[0] = 2;
+  EXPECT_THROW(h5::array_interface::read_multi(group, items_in), std::runtime_error);
+}
+
+TEST(H5, ArrayInterfaceTransferOptions) {
+  // collective transfers are accepted (and ignored) for files which do not use the MPI-IO driver
+  h5::file file("transfer_options.h5", 'w');
+  auto xfer = h5::transfer_options{.mode = h5::transfer_options::transfer_mode::collective};
+  std::vector<int> data(10, 0);
+  std::iota(data.begin(), data.end(), 0);
+  h5::array_interface::array_view view(h5::hdf5_type<int>(), (void *)data.data(), 1, false);
+  view.slab.count[0]   = 10;
+  view.parent_shape[0] = 10;
+  h5::array_interface::write(file, "data", view, true);
+
+  // overwrite the second half
+  std::vector<int> half(5, -1);
+  h5::array_interface::array_view view_half(h5::hdf5_type<int>(), (void *)half.data(), 1, false);
+  view_half.slab.count[0]   = 5;
+  view_half.parent_shape[0] = 5;
+  h5::array_interface::hyperslab sl(1, false);
+  sl.offset[0] = 5;
+  sl.count[0]  = 5;
+  h5::array_interface::write_slice(file, "data", view_half, sl, xfer);
+
+  // read back
+  std::vector<int> data_in(10, 0);
+  h5::array_interface::array_view view_in(h5::hdf5_type<int>(), (void *)data_in.data(), 1, false);
+  view_in.slab.count[0]   = 10;
+  view_in.parent_shape[0] = 10;
+  h5::array_interface::read(file, "data", view_in, {}, xfer);
+  EXPECT_EQ(data_in, (std::vector<int>{0, 1, 2, 3, 4, -1, -1, -1, -1, -1}));
+}
+
+// Create a contiguous 1d view on a vector.
+template <typename T>
+h5::array_interface::array_view make_view(std::vector<T> &v) {
+  h5::array_interface::array_view view(h5::hdf5_type<T>(), (void *)v.data(), 1, false);
+  view.slab.count[0]   = v.size();
+  view.parent_shape[0] = v.size();
+  return view;
+}
+
+TEST(H5, ArrayInterfaceConversion) {
+  using policy = h5::transfer_options::conversion_policy;
+  h5::file file("conversion.h5", 'w');
+  std::vector<long> data{-300, -1, 0, 1, 127, 300, 70000};
+  std::vector<float> data_flt{0.5f, -1.25f, 3.0f};
+  h5::array_interface::write(file, "long", make_view(data), true);
+  h5::array_interface::write(file, "float", make_view(data_flt), true);
+
+  // narrowing integer conversion with clamping (no warning with the allow policy)
+  auto xfer = h5::transfer_options{.conversion = policy::allow};
+  for (bool fast : {true, false}) {
+    xfer.fast_conversion        = fast;
+    xfer.conversion_buffer_size = (fast ? 0 : 4096);
+    std::vector<signed char> data_in(7, 0);
+    testing::internal::CaptureStderr();
+    h5::array_interface::read(file, "long", make_view(data_in), {}, xfer);
+    EXPECT_TRUE(testing::internal::GetCapturedStderr().empty());
+    EXPECT_EQ(data_in, (std::vector<signed char>{-128, -1, 0, 1, 127, 127, 127}));
+
+    // unsigned target types clamp negative values to zero
+    std::vector<unsigned short> data_us(7, 0);
+    h5::array_interface::read(file, "long", make_view(data_us), {}, xfer);
+    EXPECT_EQ(data_us, (std::vector<unsigned short>{0, 0, 0, 1, 127, 300, 65535}));
+  }
+
+  // float to double conversion into a strided view
+  std::vector<double> data_dbl(6, -1.0);
+  h5::array_interface::array_view view_dbl(h5::hdf5_type<double>(), (void *)data_dbl.data(), 1, false);
+  view_dbl.parent_shape[0] = 6;
+  view_dbl.slab.count[0]   = 3;
+  view_dbl.slab.stride[0]  = 2;
+  h5::array_interface::read(file, "float", view_dbl, {}, xfer);
+  EXPECT_EQ(data_dbl, (std::vector<double>{0.5, -1.0, -1.25, -1.0, 3.0, -1.0}));
+
+  // widening a hyperslab
+  std::vector<long long> data_ll(2, 0);
+  h5::array_interface::hyperslab sl(1, false);
+  sl.offset[0] = 5;
+  sl.count[0]  = 2;
+  h5::array_interface::read(file, "long", make_view(data_ll), sl, xfer);
+  EXPECT_EQ(data_ll, (std::vector<long long>{300, 70000}));
+
+  // narrowing floating point conversion maps values out of range to +/- infinity
+  auto const inf = std::numeric_limits<float>::infinity();
+  std::vector<double> data_big{1e300, -1e300, 0.25};
+  h5::array_interface::write(file, "big", make_view(data_big), true);
+  for (bool fast : {true, false}) {
+    xfer.fast_conversion = fast;
+    std::vector<float> data_narrow(3, 0.0f);
+    h5::array_interface::read(file, "big", make_view(data_narrow), {}, xfer);
+    EXPECT_EQ(data_narrow, (std::vector<float>{inf, -inf, 0.25f}));
+  }
+
+  // the default policy warns, the forbid policy throws
+  std::vector<int> data_int(7, 0);
+  testing::internal::CaptureStderr();
+  h5::array_interface::read(file, "long", make_view(data_int));
+  EXPECT_FALSE(testing::internal::GetCapturedStderr().empty());
+  EXPECT_EQ(data_int, (std::vector<int>{-300, -1, 0, 1, 127, 300, 70000}));
+  EXPECT_THROW(h5::array_interface::read(file, "long", make_view(data_int), {}, h5::transfer_options{.conversion = policy::forbid}),
+               std::runtime_error);
+  std::vector<long> data_long(7, 0);
+  EXPECT_NO_THROW(h5::array_interface::read(file, "long", make_view(data_long), {}, h5::transfer_options{.conversion = policy::forbid}));
+  EXPECT_EQ(data_long, data);
+}
+
+TEST(H5, ArrayInterfaceStridedViews) {
+  // views with strides which cannot be described by a hyperslab of a parent array
+  h5::file file("strided_views.h5", 'w');
+  std::vector<int> expected(24);
+  std::iota(expected.begin(), expected.end(), 0);
+
+  // layouts which can be factorized still use a single hyperslab
+  std::vector<int> padded(3 * 8, -1);
+  EXPECT_FALSE(h5::array_interface::make_strided_view(h5::hdf5_type<int>(), padded.data(), {3, 4}, {8, 1}).is_strided());
+
+  // 3d array with non-divisible strides (the elements are ordered in memory): write and read back
+  std::vector<int> buf(2 * 20, -1);
+  for (int i = 0; i < 2; ++i)
+    for (int j = 0; j < 3; ++j)
+      for (int k = 0; k < 4; ++k) buf[i * 20 + j * 6 + k] = i * 12 + j * 4 + k;
+  auto view = h5::array_interface::make_strided_view(h5::hdf5_type<int>(), buf.data(), {2, 3, 4}, {20, 6, 1});
+  EXPECT_TRUE(view.is_strided());
+  h5::array_interface::write(file, "ordered", view, false);
+  std::vector<int> data_in(24, 0);
+  h5::array_interface::array_view view_in(h5::hdf5_type<int>(), data_in.data(), 1, false);
+  view_in.slab.count[0]   = 24;
+  view_in.parent_shape[0] = 24;
+  h5::array_interface::read(file, "ordered", view_in, h5::array_interface::hyperslab{});
+  EXPECT_EQ(data_in, expected);
+
+  std::vector<int> buf_in(2 * 20, -1);
+  auto view_buf_in = h5::array_interface::make_strided_view(h5::hdf5_type<int>(), buf_in.data(), {2, 3, 4}, {20, 6, 1});
+  h5::array_interface::read(file, "ordered", view_buf_in);
+  EXPECT_EQ(buf_in, buf);
+
+  // the same with a lazy dataset
+  std::fill(buf_in.begin(), buf_in.end(), -1);
+  h5::lazy_dataset(file, "ordered").read(view_buf_in);
+  EXPECT_EQ(buf_in, buf);
+
+  // column-major 2d array (the elements are not ordered in memory)
+  std::vector<int> fortran = {0, 3, 1, 4, 2, 5};
+  auto view_f              = h5::array_interface::make_strided_view(h5::hdf5_type<int>(), fortran.data(), {2, 3}, {1, 2});
+  EXPECT_TRUE(view_f.is_strided());
+  h5::array_interface::write(file, "fortran", view_f, false);
+  std::vector<int> fortran_in(6, 0);
+  h5::array_interface::read(file, "fortran", make_view(fortran_in));
+  EXPECT_EQ(fortran_in, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+  std::fill(fortran_in.begin(), fortran_in.end(), -1);
+  h5::array_interface::read(file, "fortran", h5::array_interface::make_strided_view(h5::hdf5_type<int>(), fortran_in.data(), {2, 3}, {1, 2}));
+  EXPECT_EQ(fortran_in, fortran);
+
+  // the converted values are scattered into a column-major view with and without the fast conversion
+  for (bool fast : {true, false}) {
+    std::vector<long> fortran_long(6, -1);
+    auto xfer = h5::transfer_options{.conversion = h5::transfer_options::conversion_policy::allow, .fast_conversion = fast};
+    h5::array_interface::read(file, "fortran", h5::array_interface::make_strided_view(h5::hdf5_type<long>(), fortran_long.data(), {2, 3}, {1, 2}), {},
+                              xfer);
+    EXPECT_EQ(fortran_long, (std::vector<long>{0, 3, 1, 4, 2, 5}));
+  }
+
+  // the asynchronous writer gathers the strided elements into its staging buffer
+  {
+    h5::async_writer writer(file);
+    writer.write("fortran_async", view_f);
+    writer.flush();
+  }
+  h5::array_interface::read(file, "fortran_async", make_view(fortran_in));
+  EXPECT_EQ(fortran_in, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+
+  // complex values with non-divisible strides stored with the additional dimension or with a compound datatype
+  std::vector<std::complex<double>> cbuf(2 * 7, -1.0);
+  for (int i = 0; i < 2; ++i)
+    for (int j = 0; j < 2; ++j)
+      for (int k = 0; k < 2; ++k) cbuf[i * 7 + j * 3 + k] = {double(i * 4 + j * 2 + k), -1.0 * (i * 4 + j * 2 + k)};
+  auto view_c = h5::array_interface::make_strided_view(h5::hdf5_type<double>(), cbuf.data(), {2, 2, 2}, {7, 3, 1}, true);
+  EXPECT_TRUE(view_c.is_strided());
+  for (auto fmt : {h5::write_options::complex_format::extra_dimension, h5::write_options::complex_format::compound}) {
+    h5::array_interface::write(file, "complex", view_c, h5::write_options{.complex_storage = fmt});
+    std::vector<std::complex<double>> cbuf_in(2 * 7, -1.0);
+    auto view_c_in = h5::array_interface::make_strided_view(h5::hdf5_type<double>(), cbuf_in.data(), {2, 2, 2}, {7, 3, 1}, true);
+    h5::array_interface::read(file, "complex", view_c_in);
+    EXPECT_EQ(cbuf_in, cbuf);
+  }
+
+  // negative strides are not supported
+  EXPECT_THROW((void)h5::array_interface::make_strided_view(h5::hdf5_type<int>(), buf.data(), {2}, {-1}), std::runtime_error);
+}
+
+TEST(H5, ArrayInterfaceUpdate) {
+  // overwrite existing datasets in place and skip unchanged ones
+  h5::file file("update.h5", 'w');
+  using mode = h5::write_options::update_mode;
+  std::vector<double> data(1000, 1.0);
+  h5::array_interface::write(file, "data", make_view(data), h5::write_options{});
+
+  // repeated in place writes do not grow the file
+  H5Fflush(file, H5F_SCOPE_GLOBAL);
+  hsize_t size_before = 0, size_after = 0;
+  H5Fget_filesize(file, &size_before);
+  for (int i = 0; i < 5; ++i) {
+    std::fill(data.begin(), data.end(), static_cast<double>(i));
+    h5::array_interface::write(file, "data", make_view(data), h5::write_options{.update = mode::in_place});
+  }
+  H5Fflush(file, H5F_SCOPE_GLOBAL);
+  H5Fget_filesize(file, &size_after);
+  EXPECT_EQ(size_after, size_before);
+  std::vector<double> data_in(1000, 0.0);
+  h5::array_interface::read(file, "data", make_view(data_in));
+  EXPECT_EQ(data_in, data);
+
+  // unchanged data is not written again (the dataset is modified behind the back of the hash to verify this)
+  auto skip_opts = h5::write_options{.update = mode::skip_unchanged};
+  h5::array_interface::write(file, "data", make_view(data), skip_opts);
+  h5::dataset ds = h5::group{file}.open_dataset("data");
+  EXPECT_GT(H5Aexists(ds, "__hash__"), 0);
+  std::vector<double> other(1000, -1.0);
+  h5::array_interface::write(file, "data", make_view(other), h5::write_options{.update = mode::in_place});
+  EXPECT_EQ(H5Aexists(ds, "__hash__"), 0);
+  h5::array_interface::write(file, "data", make_view(other), skip_opts);
+  h5::array_interface::write(file, "data", make_view(data), skip_opts);
+  h5::array_interface::read(file, "data", make_view(data_in));
+  EXPECT_EQ(data_in, data);
+  h5::array_interface::write(file, "data", make_view(other), skip_opts);
+  h5::array_interface::read(file, "data", make_view(data_in));
+  EXPECT_EQ(data_in, other);
+
+  // datasets with a different shape or datatype are recreated
+  std::vector<double> longer(2000, 2.0);
+  h5::array_interface::write(file, "data", make_view(longer), skip_opts);
+  EXPECT_EQ(h5::array_interface::get_dataset_info(file, "data").lengths, (h5::v_t{2000}));
+  std::vector<int> ints(2000, 3);
+  h5::array_interface::write(file, "data", make_view(ints), skip_opts);
+  EXPECT_EQ(h5::read<std::vector<int>>(file, "data"), ints);
+
+  // writing a slice invalidates the stored hash, i.e. the next write is not skipped and the dataset can be verified
+  std::vector<int> small = {1, 2, 3, 4}, nine = {9};
+  h5::array_interface::write(file, "small", make_view(small), skip_opts);
+  h5::array_interface::hyperslab slab(1, false);
+  slab.count = {1};
+  h5::array_interface::write_slice(file, "small", make_view(nine), slab);
+  EXPECT_EQ(H5Aexists(h5::group{file}.open_dataset("small"), "__hash__"), 0);
+  EXPECT_TRUE(h5::array_interface::verify_dataset(h5::group{file}.open_dataset("small")).ok);
+  h5::array_interface::write(file, "small", make_view(small), skip_opts);
+  EXPECT_EQ(h5::read<std::vector<int>>(file, "small"), small);
+  EXPECT_TRUE(h5::array_interface::verify_dataset(h5::group{file}.open_dataset("small")).ok);
+
+  // the same for appending to an extensible dataset
+  h5::array_interface::create_extensible(file, "ext", make_view(small), false, 4);
+  h5::array_interface::write(file, "ext", make_view(small), skip_opts);
+  EXPECT_GT(H5Aexists(h5::group{file}.open_dataset("ext"), "__hash__"), 0);
+  h5::array_interface::append(file, "ext", make_view(nine));
+  EXPECT_EQ(H5Aexists(h5::group{file}.open_dataset("ext"), "__hash__"), 0);
+  EXPECT_EQ(h5::read<std::vector<int>>(file, "ext"), (std::vector<int>{1, 2, 3, 4, 9}));
+}
+
+TEST(H5, ArrayInterfaceAttributes) {
+  // N-dimensional and strided array attributes
+  h5::file file("attributes.h5", 'w');
+  h5::group g{file};
+  h5::write(g, "data", 0);
+  auto ds = g.open_dataset("data");
+
+  std::vector<int> data(4 * 6);
+  std::iota(data.begin(), data.end(), 0);
+  h5::array_interface::array_view v(h5::hdf5_type<int>(), (void *)data.data(), 2, false);
+  v.slab.count   = {4, 6};
+  v.parent_shape = {4, 6};
+
+  // every other column of the 4x6 array
+  auto strided         = v;
+  strided.slab.count   = {4, 3};
+  strided.slab.stride  = {1, 2};
+  h5::array_interface::write_attributes(ds, {{"full", v}, {"strided", strided}});
+  EXPECT_EQ(h5::array_interface::get_attribute_shape(ds, "full"), (h5::v_t{4, 6}));
+  EXPECT_EQ(h5::array_interface::get_attribute_shape(ds, "strided"), (h5::v_t{4, 3}));
+
+  // read the full attribute back into a contiguous view and the strided attribute into a strided view
+  std::vector<int> full_in(4 * 6, -1);
+  auto v_in  = v;
+  v_in.start = full_in.data();
+  h5::array_interface::read_attribute(ds, "full", v_in);
+  EXPECT_EQ(full_in, data);
+  std::fill(full_in.begin(), full_in.end(), -1);
+  auto strided_in  = strided;
+  strided_in.start = full_in.data();
+  h5::array_interface::read_attribute(ds, "strided", strided_in);
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 6; ++j) EXPECT_EQ(full_in[i * 6 + j], (j % 2 == 0 ? data[i * 6 + j] : -1));
+
+  // shape mismatches throw and existing attributes are overwritten
+  EXPECT_THROW(h5::array_interface::read_attribute(ds, "strided", v_in), std::runtime_error);
+  h5::array_interface::write_attribute(ds, "full", strided);
+  EXPECT_EQ(h5::array_interface::get_attribute_shape(ds, "full"), (h5::v_t{4, 3}));
+
+  // column-major 2x3 array (the elements are not ordered in memory)
+  std::vector<int> fortran = {0, 3, 1, 4, 2, 5};
+  h5::array_interface::write_attribute(ds, "fortran",
+                                       h5::array_interface::make_strided_view(h5::hdf5_type<int>(), fortran.data(), {2, 3}, {1, 2}));
+  std::vector<int> fortran_in(6, -1);
+  h5::array_interface::array_view c_in(h5::hdf5_type<int>(), fortran_in.data(), 2, false);
+  c_in.slab.count   = {2, 3};
+  c_in.parent_shape = {2, 3};
+  h5::array_interface::read_attribute(ds, "fortran", c_in);
+  EXPECT_EQ(fortran_in, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+  std::fill(fortran_in.begin(), fortran_in.end(), -1);
+  h5::array_interface::read_attribute(ds, "fortran",
+                                      h5::array_interface::make_strided_view(h5::hdf5_type<int>(), fortran_in.data(), {2, 3}, {1, 2}));
+  EXPECT_EQ(fortran_in, fortran);
+}
+
+TEST(H5, ArrayInterfaceMetadata) {
+  // query the metadata of datasets without reading their attributes
+  h5::file file("metadata.h5", 'w');
+  h5::group g{file};
+  std::vector<double> data(600, 1.0);
+  std::vector<std::complex<double>> cdata(10);
+  h5::array_interface::write(g, "contiguous", make_view(data), h5::write_options{});
+  h5::write(g, "compressed", data);
+  h5::write(g, "complex", cdata, h5::write_options{.complex_storage = h5::write_options::complex_format::compound});
+  h5::write(g, "scalar", 3);
+  h5::write(g, "string", std::string("abc"));
+  g.create_group("subgroup");
+
+  h5::dataset ds = g.open_dataset("contiguous");
+  EXPECT_EQ(h5::array_interface::get_dataset_shape(ds), (h5::v_t{600}));
+  EXPECT_EQ(h5::array_interface::get_dataset_rank(ds), 1);
+  EXPECT_EQ(h5::array_interface::get_dataset_type_code(ds), h5::type_code::float64);
+  EXPECT_EQ(h5::array_interface::get_dataset_storage_size(ds), 600 * sizeof(double));
+
+  auto meta = h5::array_interface::describe_group(g);
+  ASSERT_EQ(meta.size(), 5);
+  std::sort(meta.begin(), meta.end(), [](auto const &x, auto const &y) { return x.name < y.name; });
+  EXPECT_EQ(meta[0].name, "complex");
+  EXPECT_EQ(meta[0].lengths, (h5::v_t{10}));
+  EXPECT_EQ(meta[0].code, h5::type_code::complex_compound);
+  EXPECT_EQ(meta[1].name, "compressed");
+  EXPECT_LT(meta[1].storage_size, 600 * sizeof(double));
+  EXPECT_EQ(meta[2].name, "contiguous");
+  EXPECT_EQ(meta[2].storage_size, 600 * sizeof(double));
+  EXPECT_EQ(meta[3].name, "scalar");
+  EXPECT_EQ(meta[3].rank(), 0);
+  EXPECT_EQ(meta[3].code, h5::type_code::int32);
+  EXPECT_EQ(meta[4].name, "string");
+  EXPECT_EQ(meta[4].code, h5::type_code::string);
+
+  // complex vectors stored with a complex datatype are read with the shape only
+  EXPECT_EQ(h5::read<std::vector<std::complex<double>>>(g, "complex"), cdata);
+  EXPECT_THROW(h5::read<std::vector<double>>(g, "complex"), std::runtime_error);
+}
+
+namespace {
+
+  // Flip a byte at the given offset of a file.
+  void corrupt_byte(std::string const &fname, haddr_t offset) {
+    std::fstream fs(fname, std::ios::in | std::ios::out | std::ios::binary);
+    fs.seekg(static_cast<std::streamoff>(offset));
+    char c = 0;
+    fs.read(&c, 1);
+    c = static_cast<char>(~c);
+    fs.seekp(static_cast<std::streamoff>(offset));
+    fs.write(&c, 1);
+  }
+
+} // namespace
+
+TEST(H5, ArrayInterfaceVerify) {
+  std::vector<double> data(1000);
+  std::iota(data.begin(), data.end(), 0.0);
+  {
+    h5::file file("ai_verify.h5", 'w');
+    h5::group g = h5::group{file}.create_group("sub");
+    h5::write(file, "plain", data);
+    h5::write(file, "fletcher", data, h5::write_options{.chunk_bytes = 1024, .deflate_level = 1, .fletcher32 = true});
+    h5::write(g, "hashed", data, h5::write_options{.content_hash = true});
+    h5::write(g, "strings", std::vector<std::string>{"a", "bc"}, h5::write_options{.variable_length_strings = true, .content_hash = true});
+
+    // the hash of the content is stored and the Fletcher32 filter is added
+    auto res = h5::array_interface::verify(file, 2);
+    ASSERT_EQ(res.size(), 4);
+    for (auto const &r : res) {
+      EXPECT_TRUE(r.ok) << r.name;
+      EXPECT_EQ(r.has_checksum, r.name == "fletcher" or r.name == "sub/hashed") << r.name;
+    }
+    EXPECT_EQ(h5::read<std::vector<double>>(file, "fletcher"), data);
+  }
+
+  // corrupt the data of the hashed and the checksummed dataset
+  haddr_t hashed_offset = 0, chunk_offset = 0;
+  {
+    h5::file file("ai_verify.h5", 'r');
+    h5::dataset ds = h5::group{file}.open_dataset("sub/hashed");
+    hashed_offset  = H5Dget_offset(ds);
+    h5::dataset ds2 = h5::group{file}.open_dataset("fletcher");
+    h5::dataspace dspace = H5Dget_space(ds2);
+    H5Dget_chunk_info(ds2, dspace, 1, nullptr, nullptr, &chunk_offset, nullptr);
+  }
+  corrupt_byte("ai_verify.h5", hashed_offset + 100);
+  corrupt_byte("ai_verify.h5", chunk_offset + 5);
+  h5::file file("ai_verify.h5", 'r');
+  for (auto const &r : h5::array_interface::verify(file)) EXPECT_EQ(r.ok, r.name != "fletcher" and r.name != "sub/hashed") << r.name;
+  EXPECT_TRUE(h5::array_interface::verify_dataset(h5::group{file}.open_dataset("plain")).ok);
+  EXPECT_FALSE(h5::array_interface::verify_dataset(h5::group{file}.open_dataset("sub/hashed")).ok);
+
+  // the workers restore the automatic printing of HDF5 errors
+  H5E_auto2_t func = nullptr;
+  void *client_data = nullptr;
+  EXPECT_GE(H5Eget_auto2(H5E_DEFAULT, &func, &client_data), 0);
+  EXPECT_NE(func, nullptr);
+}
+
+TEST(H5, ArrayInterfaceSameContent) {
+  std::vector<double> data(100, 1.5);
+  auto opts = h5::write_options{.content_hash = true};
+  for (auto const *name : {"ai_same_1.h5", "ai_same_2.h5", "ai_same_3.h5"}) {
+    h5::file file(name, 'w');
+    h5::write(file, "hashed", data, opts);
+    h5::write(h5::group{file}.create_group("sub"), "plain", std::vector<int>{1, 2, 3});
+  }
+  {
+    h5::file file("ai_same_3.h5", 'a');
+    h5::write(file, "hashed", std::vector<double>(100, 2.5), opts);
+  }
+
+  // compare the stored hashes (and the content of datasets without a hash)
+  h5::file f1("ai_same_1.h5", 'r'), f2("ai_same_2.h5", 'r'), f3("ai_same_3.h5", 'r');
+  EXPECT_TRUE(h5::array_interface::same_content(f1, f2));
+  EXPECT_FALSE(h5::array_interface::same_content(f1, f3));
+  EXPECT_TRUE(h5::array_interface::same_content(h5::group{f1}.open_group("sub"), h5::group{f3}.open_group("sub")));
+  EXPECT_FALSE(h5::array_interface::same_content(f1, h5::group{f2}.open_group("sub")));
+
+  // the hash does not depend on the layout or the filters
+  h5::file f4("ai_same_4.h5", 'w');
+  h5::write(f4, "hashed", data, h5::write_options{.chunk_bytes = 64, .deflate_level = 1, .content_hash = true});
+  h5::write(h5::group{f4}.create_group("sub"), "plain", std::vector<int>{1, 2, 3}, h5::write_options{.fletcher32 = true});
+  EXPECT_TRUE(h5::array_interface::same_content(f1, f4));
+}
+
+TEST(H5, ArrayInterfaceSmallDimensions) {
+  // small dimension vectors are stored inline
+  h5::dims_t dims{4, 3};
+  EXPECT_TRUE(dims.is_inline());
+  EXPECT_EQ(dims.size(), 2);
+  EXPECT_EQ(dims, (h5::v_t{4, 3}));
+  dims.push_back(2);
+  EXPECT_EQ(dims.back(), 2);
+
+  // more dimensions than the inline capacity are moved to the heap
+  h5::small_vector<h5::hsize_t, 2> large{1, 2};
+  large.push_back(3);
+  EXPECT_FALSE(large.is_inline());
+  auto moved = std::move(large);
+  EXPECT_TRUE(large.empty());
+  EXPECT_EQ(moved, (h5::v_t{1, 2, 3}));
+  large = moved;
+  large.resize(5, 7);
+  EXPECT_EQ(large, (h5::v_t{1, 2, 3, 7, 7}));
+
+  // conversions to and from an h5::v_t
+  h5::v_t v = large;
+  EXPECT_EQ(v, (h5::v_t{1, 2, 3, 7, 7}));
+  large = h5::v_t{8};
+  EXPECT_EQ(large.size(), 1);
+  EXPECT_EQ(large[0], 8);
+
+  // hyperslabs and array views of low rank do not allocate
+  std::vector<double> data(24);
+  h5::array_interface::array_view view{h5::hdf5_type<double>(), data.data(), 2, true};
+  view.slab.count = {4, 3, 2};
+  view.parent_shape = {4, 3, 2};
+  EXPECT_TRUE(view.parent_shape.is_inline() and view.slab.offset.is_inline() and view.slab.shape().is_inline());
+  EXPECT_EQ(view.slab.size(), 24);
+  EXPECT_EQ(view.slab.shape(), (h5::v_t{4, 3, 2}));
+
+  // write and read a view
+  h5::file file("ai_small_dims.h5", 'w');
+  h5::array_interface::write(file, "view", view, false);
+  auto info = h5::array_interface::get_dataset_info(file, "view");
+  EXPECT_EQ(info.lengths, view.slab.shape());
+  EXPECT_TRUE(info.lengths.is_inline());
+}
+
+#ifdef H5_MPI_SUPPORT
+TEST(H5, ArrayInterfaceMPI) {
+  // each rank writes its own hyperslab of a shared dataset collectively
+  int rank = 0, size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  auto xfer = h5::transfer_options{.mode = h5::transfer_options::transfer_mode::collective};
+  long n    = 8;
+
+  {
+    h5::file file("mpi_array.h5", 'w', MPI_COMM_WORLD);
+
+    // create the dataset (collective operation)
+    std::vector<double> zeros(size * n, 0.0);
+    h5::array_interface::array_view view_full(h5::hdf5_type<double>(), (void *)zeros.data(), 1, false);
+    view_full.slab.count[0]   = size * n;
+    view_full.parent_shape[0] = size * n;
+    h5::array_interface::write(file, "data", view_full, true);
+
+    // write the local part
+    std::vector<double> local(n, static_cast<double>(rank));
+    h5::array_interface::array_view view(h5::hdf5_type<double>(), (void *)local.data(), 1, false);
+    view.slab.count[0]   = n;
+    view.parent_shape[0] = n;
+    h5::array_interface::hyperslab sl(1, false);
+    sl.offset[0] = rank * n;
+    sl.count[0]  = n;
+    h5::array_interface::write_slice(file, "data", view, sl, xfer);
+  }
+
+  // read the full dataset collectively on every rank
+  h5::file file("mpi_array.h5", 'r', MPI_COMM_WORLD);
+  std::vector<double> data_in(size * n, -1.0);
+  h5::array_interface::array_view view_in(h5::hdf5_type<double>(), (void *)data_in.data(), 1, false);
+  view_in.slab.count[0]   = size * n;
+  view_in.parent_shape[0] = size * n;
+  h5::array_interface::read(file, "data", view_in, {}, xfer);
+  for (long i = 0; i < size * n; ++i) EXPECT_EQ(data_in[i], static_cast<double>(i / n));
+
+  // SWMR is not supported with the MPI-IO file driver
+  EXPECT_THROW(h5::file("mpi_array.h5", 'r', MPI_COMM_WORLD, MPI_INFO_NULL, h5::file_options{.swmr = true}), std::runtime_error);
+}
+#endif
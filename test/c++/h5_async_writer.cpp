@@ -0,0 +1,84 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(H5, AsyncWriter) {
+  // write a sequence of checkpoints while modifying the data
+  std::vector<double> data(100);
+  {
+    h5::file file("async_writer.h5", 'w');
+    h5::async_writer writer(file);
+    std::vector<std::shared_future<void>> futs;
+    for (int i = 0; i < 5; ++i) {
+      std::iota(data.begin(), data.end(), static_cast<double>(i));
+      futs.push_back(writer.write("data_" + std::to_string(i), data));
+    }
+    writer.write("name", std::string{"checkpoint"});
+    data.assign(data.size(), -1.0);
+    writer.flush();
+    EXPECT_EQ(writer.pending(), 0);
+    for (auto &f : futs) EXPECT_NO_THROW(f.get());
+  }
+
+  // read the checkpoints
+  h5::file file("async_writer.h5", 'r');
+  std::vector<double> data_in, exp(100);
+  for (int i = 0; i < 5; ++i) {
+    h5::read(file, "data_" + std::to_string(i), data_in);
+    std::iota(exp.begin(), exp.end(), static_cast<double>(i));
+    EXPECT_EQ(data_in, exp);
+  }
+  EXPECT_EQ(h5::read<std::string>(file, "name"), "checkpoint");
+}
+
+TEST(H5, AsyncWriterArrayView) {
+  // the selected elements of a strided view are copied into a staging buffer
+  std::vector<int> data(6 * 4);
+  std::iota(data.begin(), data.end(), 0);
+  h5::array_interface::array_view view(h5::hdf5_type<int>(), (void *)data.data(), 2, false);
+  view.parent_shape = {6, 4};
+  view.slab.offset  = {1, 1};
+  view.slab.stride  = {2, 2};
+  view.slab.count   = {3, 2};
+
+  h5::file file("async_writer_view.h5", 'w');
+  h5::async_writer writer(file);
+  auto fut = writer.write("view", view);
+  data.assign(data.size(), 0);
+  fut.get();
+
+  // read it back
+  std::vector<int> data_in(6, 0);
+  h5::array_interface::array_view view_in(h5::hdf5_type<int>(), (void *)data_in.data(), 2, false);
+  view_in.parent_shape = {3, 2};
+  view_in.slab.count   = {3, 2};
+  h5::array_interface::read(file, "view", view_in);
+  EXPECT_EQ(data_in, (std::vector<int>{5, 7, 13, 15, 21, 23}));
+
+  // errors are reported by the future and by the next flush
+  auto fut_err = writer.submit([](h5::group) { throw std::runtime_error("failed"); });
+  EXPECT_THROW(fut_err.get(), std::runtime_error);
+  EXPECT_THROW(writer.flush(), std::runtime_error);
+  EXPECT_NO_THROW(writer.flush());
+}
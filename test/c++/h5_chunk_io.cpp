@@ -0,0 +1,109 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <hdf5.h>
+
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+// Create a contiguous 2d view on a vector.
+template <typename T>
+h5::array_interface::array_view make_view(std::vector<T> &v, h5::hsize_t n0, h5::hsize_t n1) {
+  h5::array_interface::array_view view(h5::hdf5_type<T>(), (void *)v.data(), 2, false);
+  view.slab.count   = {n0, n1};
+  view.parent_shape = {n0, n1};
+  return view;
+}
+
+TEST(H5, ChunkIO) {
+  h5::file file("chunk_io.h5", 'w');
+  h5::hsize_t const n0 = 150, n1 = 70;
+  std::vector<double> data(n0 * n1);
+  for (std::size_t i = 0; i < data.size(); ++i) data[i] = (i % 7 == 0 ? std::sin(0.1 * i) : 1.0 * (i % 100));
+
+  // write with compression on multiple threads (the last chunks along each dimension are partial)
+  auto opts = h5::write_options{.chunk_shape = {32, 16}, .deflate_level = 4, .shuffle = true};
+  h5::array_interface::write_chunks(file, "data", make_view(data, n0, n1), opts, 4);
+
+  // read with the HDF5 filter pipeline
+  std::vector<double> data_in(n0 * n1, 0.0);
+  h5::array_interface::read(file, "data", make_view(data_in, n0, n1));
+  EXPECT_EQ(data_in, data);
+
+  // read the raw chunks and decompress them on multiple threads
+  std::vector<double> data_chunks(n0 * n1, 0.0);
+  h5::array_interface::read_chunks(file, "data", make_view(data_chunks, n0, n1), 3);
+  EXPECT_EQ(data_chunks, data);
+
+  // datasets written with the HDF5 filter pipeline can be read as well
+  h5::array_interface::write(file, "pipeline", make_view(data, n0, n1), opts);
+  std::fill(data_chunks.begin(), data_chunks.end(), 0.0);
+  h5::array_interface::read_chunks(file, "pipeline", make_view(data_chunks, n0, n1));
+  EXPECT_EQ(data_chunks, data);
+
+  // strided view on every other row (default chunk size, no filters)
+  h5::array_interface::array_view strided(h5::hdf5_type<double>(), (void *)data.data(), 2, false);
+  strided.parent_shape = {n0, n1};
+  strided.slab.count   = {n0 / 2, n1};
+  strided.slab.stride  = {2, 1};
+  h5::array_interface::write_chunks(file, "strided", strided, h5::write_options{});
+  std::vector<double> half(n0 / 2 * n1, 0.0);
+  h5::array_interface::read_chunks(file, "strided", make_view(half, n0 / 2, n1));
+  for (h5::hsize_t i = 0; i < n0 / 2; ++i)
+    for (h5::hsize_t j = 0; j < n1; ++j) EXPECT_EQ(half[i * n1 + j], data[2 * i * n1 + j]);
+
+  // complex values with a compound datatype
+  std::vector<std::complex<double>> cdata(40);
+  for (int i = 0; i < 40; ++i) cdata[i] = {1.0 * i, -2.0 * i};
+  h5::array_interface::array_view cview(h5::hdf5_type<double>(), (void *)cdata.data(), 1, true);
+  cview.slab.count   = {40, 2};
+  cview.parent_shape = {40, 2};
+  auto copts         = h5::write_options{.chunk_shape = {16}, .deflate_level = 1, .complex_storage = h5::write_options::complex_format::compound};
+  h5::array_interface::write_chunks(file, "complex", cview, copts, 2);
+  std::vector<std::complex<double>> cdata_in(40);
+  h5::array_interface::array_view cview_in(h5::hdf5_type<double>(), (void *)cdata_in.data(), 1, true);
+  cview_in.slab.count   = {40, 2};
+  cview_in.parent_shape = {40, 2};
+  h5::array_interface::read_chunks(file, "complex", cview_in);
+  EXPECT_EQ(cdata_in, cdata);
+  EXPECT_EQ(h5::read<std::vector<std::complex<double>>>(file, "complex"), cdata);
+
+  // unallocated chunks are filled with the fill value
+  double const fill = -1.0;
+  auto empty_opts    = h5::write_options{.chunk_shape = {10, 10}};
+  empty_opts.fill_value.resize(sizeof(double));
+  std::memcpy(empty_opts.fill_value.data(), &fill, sizeof(double));
+  h5::array_interface::create_extensible(file, "extensible", make_view(data, 0, n1), empty_opts);
+  {
+    h5::dataset ds     = h5::group{file}.open_dataset("extensible");
+    h5::hsize_t ext[2] = {20, n1};
+    ASSERT_GE(H5Dset_extent(ds, ext), 0);
+  }
+  std::vector<double> filled(20 * n1, 0.0);
+  h5::array_interface::read_chunks(file, "extensible", make_view(filled, 20, n1));
+  EXPECT_EQ(filled, std::vector<double>(20 * n1, fill));
+
+  // shape and type mismatches
+  EXPECT_THROW(h5::array_interface::read_chunks(file, "data", make_view(half, n0 / 2, n1)), std::runtime_error);
+  std::vector<float> fdata(n0 * n1);
+  EXPECT_THROW(h5::array_interface::read_chunks(file, "data", make_view(fdata, n0, n1)), std::runtime_error);
+}
@@ -16,9 +16,11 @@
 
 #include <gtest/gtest.h>
 #include <h5/h5.hpp>
+#include <hdf5.h>
 
 #include <array>
 #include <complex>
+#include <vector>
 
 TEST(H5, ComplexBackwardCompatibility) {
   // write and read a complex number the old way
@@ -74,3 +76,62 @@ TEST(H5, ComplexCompoundType) {
     EXPECT_EQ(z_in.imag(), z.i);
   }
 };
+
+TEST(H5, ComplexCompoundStorage) {
+  // write complex vectors with a compound datatype (compressed) and the old way
+  std::vector<std::complex<double>> vd(100);
+  std::vector<std::complex<float>> vf(50);
+  for (int i = 0; i < 100; ++i) vd[i] = {1.0 * i, -2.0 * i};
+  for (int i = 0; i < 50; ++i) vf[i] = {0.5f * i, 3.0f * i};
+  auto opts = h5::write_options{.deflate_level = 1, .shuffle = true, .complex_storage = h5::write_options::complex_format::compound};
+
+  {
+    h5::file file("complex_storage.h5", 'w');
+    h5::write(file, "vd", vd, opts);
+    h5::write(file, "vf", vf, opts);
+    h5::write(file, "vd_old", vd);
+    h5::array_interface::write(file, "z", h5::array_interface::array_view_from_scalar(vd[3]), opts);
+  }
+
+  h5::file file("complex_storage.h5", 'r');
+
+  // the compound datasets have no extra dimension and no complex attribute
+  auto ds = h5::group{file}.open_dataset("vd");
+  EXPECT_EQ(H5Tget_class(h5::datatype{H5Dget_type(ds)}), H5T_COMPOUND);
+  EXPECT_EQ(H5Aexists(ds, "__complex__"), 0);
+  EXPECT_EQ(H5Sget_simple_extent_ndims(h5::dataspace{H5Dget_space(ds)}), 1);
+
+  // the dataset info looks like the one of the old layout
+  auto info = h5::array_interface::get_dataset_info(file, "vf");
+  EXPECT_TRUE(info.has_complex_attribute);
+  EXPECT_TRUE(info.has_complex_datatype);
+  EXPECT_EQ(info.lengths, (h5::v_t{50, 2}));
+  EXPECT_TRUE(h5::hdf5_type_equal(info.ty, h5::hdf5_type<float>()));
+  auto info_old = h5::array_interface::get_dataset_info(file, "vd_old");
+  EXPECT_TRUE(info_old.has_complex_attribute);
+  EXPECT_FALSE(info_old.has_complex_datatype);
+
+  // read back
+  EXPECT_EQ(h5::read<std::vector<std::complex<double>>>(file, "vd"), vd);
+  EXPECT_EQ(h5::read<std::vector<std::complex<float>>>(file, "vf"), vf);
+  EXPECT_EQ(h5::read<std::vector<std::complex<double>>>(file, "vd_old"), vd);
+  EXPECT_EQ(h5::read<std::complex<double>>(file, "z"), vd[3]);
+
+  // read with conversion from float to double
+  auto xfer = h5::transfer_options{.conversion = h5::transfer_options::conversion_policy::allow};
+  std::vector<std::complex<double>> vf_in(50);
+  h5::array_interface::array_view v{h5::hdf5_type<double>(), (void *)vf_in.data(), 1, true};
+  v.slab.count[0] = v.parent_shape[0] = 50;
+  h5::array_interface::read(file, "vf", v, {}, xfer);
+  for (int i = 0; i < 50; ++i) EXPECT_EQ(vf_in[i], std::complex<double>(vf[i]));
+
+  // read a strided slice lazily
+  h5::lazy_dataset lds(file, "vd");
+  EXPECT_TRUE(lds.is_complex());
+  EXPECT_EQ(lds.shape(), (h5::v_t{100, 2}));
+  EXPECT_EQ(lds.slice<std::complex<double>>({10}, {3}, {5}), (std::vector<std::complex<double>>{vd[10], vd[15], vd[20]}));
+
+  // real views cannot be read from a complex datatype
+  std::vector<double> re(200);
+  EXPECT_THROW(h5::read(file, "vd", re), std::runtime_error);
+}
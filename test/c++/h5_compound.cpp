@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <hdf5.h>
+
+#include <array>
+#include <complex>
+#include <string>
+#include <vector>
+
+namespace test {
+
+  struct particle {
+    double x, y, z;
+    float weight;
+    bool operator==(particle const &) const = default;
+  };
+  H5_COMPOUND(particle, x, y, z, weight);
+
+  struct event {
+    long id;
+    std::complex<double> amplitude;
+    std::array<int, 3> cell;
+    particle p;
+    bool operator==(event const &) const = default;
+  };
+  H5_COMPOUND(event, id, amplitude, cell, p);
+
+  // same members as particle in a different order and without weight
+  struct position {
+    double z, x, y;
+    bool operator==(position const &) const = default;
+  };
+  H5_COMPOUND(position, z, x, y);
+
+} // namespace test
+
+TEST(H5, CompoundDatatype) {
+  static_assert(h5::is_compound_v<test::particle>);
+  static_assert(not h5::is_compound_v<double>);
+
+  // compound datatype is created only once
+  auto ty = h5::hdf5_type<test::particle>();
+  EXPECT_EQ(H5Tget_class(ty), H5T_COMPOUND);
+  EXPECT_EQ(H5Tget_nmembers(ty), 4);
+  EXPECT_EQ(H5Tget_size(ty), sizeof(test::particle));
+  EXPECT_EQ(static_cast<h5::hid_t>(ty), static_cast<h5::hid_t>(h5::hdf5_type<test::particle>()));
+  EXPECT_EQ(h5::get_name_of_h5_type(ty), "compound{x, y, z, weight}");
+}
+
+TEST(H5, CompoundReadWrite) {
+  std::vector<test::particle> particles;
+  for (int i = 0; i < 1000; ++i) particles.push_back({1.0 * i, 2.0 * i, 3.0 * i, 0.5f * i});
+  auto ev = test::event{42, {1.0, -1.0}, {1, 2, 3}, {1, 2, 3, 4}};
+  auto evs = std::array<test::event, 2>{ev, test::event{43, {2.0, 0.5}, {4, 5, 6}, {5, 6, 7, 8}}};
+
+  {
+    h5::file file("compound.h5", 'w');
+    h5::write(file, "particles", particles);
+    h5::write(file, "event", ev);
+    h5::write(file, "events", evs);
+
+    // a vector of compounds is stored in a single 1d dataset
+    auto ds_info = h5::array_interface::get_dataset_info(file, "particles");
+    EXPECT_EQ(ds_info.lengths, h5::v_t{1000});
+    EXPECT_EQ(H5Tget_class(ds_info.ty), H5T_COMPOUND);
+  }
+
+  h5::file file("compound.h5", 'r');
+  EXPECT_EQ(h5::read<std::vector<test::particle>>(file, "particles"), particles);
+  EXPECT_EQ(h5::read<test::event>(file, "event"), ev);
+  EXPECT_EQ((h5::read<std::array<test::event, 2>>(file, "events")), evs);
+
+  // members are matched by name
+  auto pos = h5::read<std::vector<test::position>>(file, "particles");
+  ASSERT_EQ(pos.size(), particles.size());
+  for (std::size_t i = 0; i < pos.size(); ++i) EXPECT_EQ(pos[i], (test::position{particles[i].z, particles[i].x, particles[i].y}));
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <array>
+#include <complex>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Minimal user defined contiguous container.
+struct arena_buffer {
+  double *ptr;
+  std::size_t n;
+  [[nodiscard]] double *begin() const { return ptr; }
+  [[nodiscard]] double *end() const { return ptr + n; }
+};
+
+static_assert(h5::SimpleContiguousRange<std::span<double const>>);
+static_assert(h5::SimpleContiguousRange<arena_buffer>);
+static_assert(h5::WritableContiguousRange<std::span<std::complex<double>>>);
+static_assert(not h5::WritableContiguousRange<std::span<double const>>);
+static_assert(not h5::SimpleContiguousRange<std::vector<double>>);
+static_assert(not h5::SimpleContiguousRange<std::string>);
+static_assert(not h5::SimpleContiguousRange<std::span<std::string>>);
+
+TEST(H5, ContiguousRange) {
+  std::vector<double> arena(100);
+  std::iota(arena.begin(), arena.end(), 0.0);
+  std::vector<std::complex<double>> cdata{{1.0, -1.0}, {2.0, 0.5}, {-3.0, 4.0}};
+
+  h5::file file{"test_contiguous_range.h5", 'w'};
+
+  // write sub-ranges of a buffer without copying them
+  auto s = std::span{arena};
+  h5::write(file, "sub", s.subspan(10, 20));
+  h5::write(file, "arena", arena_buffer{arena.data() + 50, 5}, h5::write_options{});
+  h5::write(file, "cplx", std::span{cdata});
+  EXPECT_EQ(h5::read<std::vector<double>>(file, "sub"), std::vector<double>(arena.begin() + 10, arena.begin() + 30));
+  EXPECT_EQ(h5::read<std::vector<double>>(file, "arena"), (std::vector<double>{50, 51, 52, 53, 54}));
+  EXPECT_EQ(h5::read<std::vector<std::complex<double>>>(file, "cplx"), cdata);
+
+  // read into a sub-range of a buffer
+  std::vector<double> out(25, -1.0);
+  auto out_span = std::span{out}.subspan(5, 20);
+  h5::read(file, "sub", out_span);
+  for (int i = 0; i < 25; ++i) EXPECT_EQ(out[i], i < 5 ? -1.0 : 5.0 + i);
+  std::array<std::complex<double>, 3> cout{};
+  h5::h5_read(file, "cplx", std::span{cout});
+  EXPECT_EQ(std::vector(cout.begin(), cout.end()), cdata);
+
+  // the size has to match
+  EXPECT_THROW(h5::h5_read(file, "sub", std::span{out}), std::runtime_error);
+
+  // write and read slices
+  h5::write_slice(file, "sub", s.first(3), 5);
+  std::array<double, 5> part{};
+  h5::read_slice(file, "sub", std::span{part}, 4);
+  EXPECT_EQ(part, (std::array<double, 5>{14.0, 0.0, 1.0, 2.0, 18.0}));
+
+  // append to an extensible dataset
+  h5::append(file, "series", s.first(4));
+  h5::append(file, "series", s.subspan(4, 2));
+  EXPECT_EQ(h5::read<std::vector<double>>(file, "series"), (std::vector<double>{0, 1, 2, 3, 4, 5}));
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // Write a small file with a scalar and a vector for every member of an ensemble.
+  std::vector<std::string> write_ensemble(int n) {
+    std::vector<std::string> files;
+    for (int i = 0; i < n; ++i) {
+      files.push_back(std::to_string(i).append("_ensemble.h5"));
+      h5::file f(files.back(), 'w');
+      h5::group g = h5::group{f}.create_group("results");
+      h5::write(g, "index", i);
+      h5::write(g, "energy", std::vector<double>{1.0 * i, 2.0 * i, 3.0 * i});
+    }
+    return files;
+  }
+
+} // namespace
+
+TEST(H5, EnsembleReader) {
+  using exec = h5::ensemble_options::execution;
+  auto files = write_ensemble(12);
+
+  // the results are returned in input order for all execution modes
+  for (auto mode : {exec::automatic, exec::serial, exec::threads, exec::processes}) {
+    h5::ensemble_reader<std::vector<double>> reader(files, "results/energy", {.mode = mode, .n_workers = 3});
+    EXPECT_EQ(reader.size(), 12);
+    EXPECT_NE(reader.mode(), exec::automatic);
+    if (mode != exec::automatic) { EXPECT_EQ(reader.mode(), mode); }
+    auto res = reader.read();
+    ASSERT_EQ(res.size(), 12);
+    for (int i = 0; i < 12; ++i) EXPECT_EQ(res[i], (std::vector<double>{1.0 * i, 2.0 * i, 3.0 * i}));
+
+    // stacked along a new leading dimension
+    auto [shape, data] = reader.read_stacked();
+    EXPECT_EQ(shape, (h5::v_t{12, 3}));
+    ASSERT_EQ(data.size(), 36);
+    EXPECT_EQ(data[3 * 5 + 2], 15.0);
+
+    auto idx = h5::ensemble_reader<int>(files, "results/index", {.mode = mode}).read();
+    for (int i = 0; i < 12; ++i) EXPECT_EQ(idx[i], i);
+  }
+
+  // a single worker reads serially
+  EXPECT_EQ(h5::ensemble_reader<int>(files, "results/index", {.mode = exec::processes, .n_workers = 1}).mode(), exec::serial);
+  EXPECT_TRUE(h5::ensemble_reader<int>({}, "results/index").read().empty());
+}
+
+TEST(H5, EnsembleReaderErrors) {
+  using exec = h5::ensemble_options::execution;
+  auto files = write_ensemble(4);
+  h5::write(h5::file{files[2], 'a'}, "results/energy", std::vector<double>{1.0});
+
+  for (auto mode : {exec::serial, exec::threads, exec::processes}) {
+    // missing files and objects are reported with the name of the file
+    auto missing = files;
+    missing.push_back("missing_ensemble.h5");
+    EXPECT_THROW(h5::ensemble_reader<int>(missing, "results/index", {.mode = mode, .n_workers = 2}).read(), std::runtime_error);
+    try {
+      [[maybe_unused]] auto res = h5::ensemble_reader<int>(files, "results/missing", {.mode = mode, .n_workers = 2}).read();
+      FAIL() << "expected an exception";
+    } catch (std::runtime_error const &e) { EXPECT_NE(std::string{e.what()}.find("_ensemble.h5"), std::string::npos); }
+
+    // objects of different sizes cannot be stacked
+    h5::ensemble_reader<std::vector<double>> reader(files, "results/energy", {.mode = mode, .n_workers = 2});
+    EXPECT_EQ(reader.read()[2].size(), 1);
+    EXPECT_THROW([[maybe_unused]] auto res = reader.read_stacked(), std::runtime_error);
+  }
+}
@@ -17,8 +17,14 @@
 #include <gtest/gtest.h>
 #include <h5/h5.hpp>
 
+#include <hdf5.h>
+
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <map>
 #include <string>
+#include <vector>
 
 TEST(H5, FileOperations) {
   // test various ways to construct a file
@@ -68,3 +74,203 @@ TEST(H5, FileOperations) {
   // try to create file with H5F_ACC_EXCL flag which already exists
   { EXPECT_THROW(h5::file file(fname, 'e'), std::runtime_error); }
 };
+
+TEST(H5, FileOptions) {
+  // create a file with a custom chunk cache, metadata cache and alignment
+  auto opts = h5::file_options{.chunk_cache    = h5::chunk_cache_config{.nslots = 10007, .nbytes = 32 << 20, .w0 = 0.5},
+                               .metadata_cache = h5::metadata_cache_config{.initial_size = 4 << 20, .max_size = 64 << 20},
+                               .alignment_threshold = 4096,
+                               .alignment           = 4096};
+  for (char mode : {'w', 'a', 'r'}) {
+    h5::file file("file_options.h5", mode, opts);
+    EXPECT_TRUE(file.is_valid());
+
+    // check the file access property list
+    auto fapl          = h5::proplist{H5Fget_access_plist(file)};
+    int mdc_nelmts     = 0;
+    std::size_t nslots = 0, nbytes = 0;
+    double w0          = 0.0;
+    EXPECT_GE(H5Pget_cache(fapl, &mdc_nelmts, &nslots, &nbytes, &w0), 0);
+    EXPECT_EQ(nslots, opts.chunk_cache->nslots);
+    EXPECT_EQ(nbytes, opts.chunk_cache->nbytes);
+    EXPECT_DOUBLE_EQ(w0, opts.chunk_cache->w0);
+
+    hsize_t threshold = 0, alignment = 0;
+    EXPECT_GE(H5Pget_alignment(fapl, &threshold, &alignment), 0);
+    EXPECT_EQ(threshold, 4096);
+    EXPECT_EQ(alignment, 4096);
+
+    H5AC_cache_config_t config;
+    config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+    EXPECT_GE(H5Fget_mdc_config(file, &config), 0);
+    EXPECT_EQ(config.max_size, opts.metadata_cache->max_size);
+  }
+}
+
+TEST(H5, FileOverwriteInPlace) {
+  std::string fname{"overwrite_in_place.h5"};
+  auto opts = h5::file_options{.overwrite_in_place = true, .persist_free_space = true};
+
+  // the file space settings are stored in the file creation property list
+  {
+    h5::file file(fname, 'w', opts);
+    EXPECT_TRUE(file.overwrite_in_place());
+    auto fcpl = h5::proplist{H5Fget_create_plist(file)};
+    H5F_fspace_strategy_t strategy;
+    hbool_t persist   = false;
+    hsize_t threshold = 0;
+    EXPECT_GE(H5Pget_file_space_strategy(fcpl, &strategy, &persist, &threshold), 0);
+    EXPECT_EQ(strategy, H5F_FSPACE_STRATEGY_FSM_AGGR);
+    EXPECT_TRUE(persist);
+  }
+
+  // write the same objects repeatedly in append mode
+  std::vector<double> v(10000, 1.0);
+  std::uintmax_t size = 0;
+  for (int i = 0; i < 5; ++i) {
+    {
+      h5::file file(fname, 'a', opts);
+      auto g = h5::group{file}.create_group("grp");
+      v[0]   = i;
+      h5::write(g, "vec", v);
+      h5::write(g, "scalar", i);
+      h5::write(g, "str", std::string("run"));
+      h5::write_attribute(g, "iteration", i);
+    }
+    if (i == 1) size = std::filesystem::file_size(fname);
+    if (i > 1) { EXPECT_EQ(std::filesystem::file_size(fname), size); }
+  }
+
+  // check the contents
+  {
+    h5::file file(fname, 'r');
+    auto g = h5::group{file}.open_group("grp");
+    EXPECT_EQ(h5::read<std::vector<double>>(g, "vec"), v);
+    EXPECT_EQ(h5::read<int>(g, "scalar"), 4);
+    EXPECT_EQ(h5::read<std::string>(g, "str"), "run");
+    EXPECT_EQ(h5::read_attribute<int>(g, "iteration"), 4);
+  }
+
+  // children of a reused group which are not written again are removed
+  using map_t = std::map<std::string, std::vector<double>>;
+  {
+    h5::file file(fname, 'a', opts);
+    h5::write(file, "map", map_t{{"a", {1}}, {"b", {2}}, {"c", {3}}});
+
+    // the children of a reused group are not kept open
+    auto const n_open = H5Fget_obj_count(file, H5F_OBJ_ALL);
+    auto g            = h5::group{file}.create_group("map");
+    EXPECT_LE(H5Fget_obj_count(file, H5F_OBJ_ALL), n_open + 2);
+    h5::write(g, "a", std::vector<double>{7});
+    g = {};
+
+    EXPECT_EQ(h5::read<map_t>(file, "map"), (map_t{{"a", {7}}}));
+    h5::write(file, "map", map_t{{"a", {1}}, {"b", {2}}, {"c", {3}}});
+    h5::write(file, "map", map_t{{"a", {7}}});
+    EXPECT_EQ(h5::read<map_t>(file, "map"), (map_t{{"a", {7}}}));
+  }
+
+  // datasets with different creation settings are recreated
+  {
+    h5::file file(fname, 'a', opts);
+    auto g = h5::group{file};
+    for (auto const &wopts : {h5::write_options{.deflate_level = 1, .fletcher32 = true}, h5::write_options{.fill_value = {std::byte{1}}}}) {
+      std::vector<std::uint8_t> b(100, 2);
+      h5::array_interface::write(g, "bytes", h5::array_interface::array_view_from_vector(b), h5::write_options{});
+      h5::array_interface::write(g, "bytes", h5::array_interface::array_view_from_vector(b), wopts);
+      auto dcpl = h5::proplist{H5Dget_create_plist(g.open_dataset("bytes"))};
+      EXPECT_EQ(H5Pget_nfilters(dcpl), (wopts.fletcher32 ? 2 : 0));
+      H5D_fill_value_t status = H5D_FILL_VALUE_ERROR;
+      EXPECT_GE(H5Pfill_value_defined(dcpl, &status), 0);
+      EXPECT_EQ(status, (wopts.fill_value.empty() ? H5D_FILL_VALUE_DEFAULT : H5D_FILL_VALUE_USER_DEFINED));
+    }
+  }
+  h5::file file(fname, 'r');
+  EXPECT_EQ(h5::read<map_t>(file, "map"), (map_t{{"a", {7}}}));
+}
+
+TEST(H5, FileFormatAndPagedAggregation) {
+  using libver = h5::file_options::libver;
+  std::string fname{"file_format.h5"};
+  auto opts = h5::file_options{.libver_low           = libver::latest,
+                               .fs_strategy          = h5::file_options::file_space_strategy::page,
+                               .file_space_page_size = 8192,
+                               .page_buffer_size     = 64 * 8192};
+
+  // write many small datasets into a paged file with the latest file format
+  {
+    h5::file file(fname, 'w', opts);
+    auto fapl = h5::proplist{H5Fget_access_plist(file)};
+    H5F_libver_t low = H5F_LIBVER_EARLIEST, high = H5F_LIBVER_EARLIEST;
+    EXPECT_GE(H5Pget_libver_bounds(fapl, &low, &high), 0);
+    EXPECT_EQ(low, H5F_LIBVER_LATEST);
+    EXPECT_EQ(high, H5F_LIBVER_LATEST);
+    std::size_t buf_size = 0;
+    unsigned min_meta = 0, min_raw = 0;
+    EXPECT_GE(H5Pget_page_buffer_size(fapl, &buf_size, &min_meta, &min_raw), 0);
+    EXPECT_EQ(buf_size, opts.page_buffer_size);
+
+    auto fcpl = h5::proplist{H5Fget_create_plist(file)};
+    H5F_fspace_strategy_t strategy;
+    hbool_t persist   = false;
+    hsize_t threshold = 0, page_size = 0;
+    EXPECT_GE(H5Pget_file_space_strategy(fcpl, &strategy, &persist, &threshold), 0);
+    EXPECT_EQ(strategy, H5F_FSPACE_STRATEGY_PAGE);
+    EXPECT_GE(H5Pget_file_space_page_size(fcpl, &page_size), 0);
+    EXPECT_EQ(page_size, 8192);
+
+    for (int i = 0; i < 100; ++i) h5::write(file, std::to_string(i), std::vector<int>(10, i));
+  }
+
+  // read them back through the page buffer
+  {
+    h5::file file(fname, 'r', h5::file_options{.page_buffer_size = 64 * 8192});
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(h5::read<std::vector<int>>(file, std::to_string(i)), std::vector<int>(10, i));
+  }
+
+  // memory files accept the same options
+  {
+    h5::file file(opts);
+    h5::write(file, "x", 42);
+    EXPECT_EQ(h5::read<int>(file, "x"), 42);
+  }
+
+  // the low bound must not be above the high bound
+  EXPECT_THROW(h5::file(fname, 'r', h5::file_options{.libver_low = libver::latest, .libver_high = libver::v18}), std::runtime_error);
+}
+
+TEST(H5, FileDrivers) {
+  // metadata and raw data in separate files
+  std::vector<double> v(1000, 2.5);
+  auto split_opts = h5::file_options{.driver = h5::split_driver{.meta_ext = ".meta", .raw_ext = ".raw"}};
+  {
+    h5::file file("split.h5", 'w', split_opts);
+    h5::write(file, "vec", v);
+  }
+  EXPECT_TRUE(std::filesystem::exists("split.h5.meta"));
+  EXPECT_TRUE(std::filesystem::exists("split.h5.raw"));
+  {
+    h5::file file("split.h5", 'r', split_opts);
+    EXPECT_EQ(h5::read<std::vector<double>>(file, "vec"), v);
+  }
+  std::filesystem::remove("split.h5.meta");
+  std::filesystem::remove("split.h5.raw");
+
+  // direct I/O
+#ifdef H5_HAVE_DIRECT
+  {
+    h5::file file("direct.h5", 'w', h5::file_options{.driver = h5::direct_driver{}});
+    h5::write(file, "vec", v);
+  }
+  h5::file file("direct.h5", 'r');
+  EXPECT_EQ(h5::read<std::vector<double>>(file, "vec"), v);
+#else
+  EXPECT_THROW(h5::file("direct.h5", 'w', h5::file_options{.driver = h5::direct_driver{}}), std::runtime_error);
+#endif
+
+  // S3 files are read-only
+  EXPECT_THROW(h5::file("https://bucket.s3.amazonaws.com/data.h5", 'w', h5::file_options{.driver = h5::ros3_driver{}}), std::runtime_error);
+
+  // memory files always use the core driver
+  EXPECT_THROW(h5::file{split_opts}, std::runtime_error);
+}
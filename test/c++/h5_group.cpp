@@ -19,7 +19,10 @@
 
 #include <hdf5_hl.h>
 
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
 TEST(H5, GroupOperations) {
   // test the various group operations
@@ -72,3 +75,89 @@ TEST(H5, GroupOperations) {
   EXPECT_EQ(names.size(), 2);
   for (const auto &n : names) { EXPECT_TRUE(n == gname || n == dsname); }
 };
+
+TEST(H5, GroupOpenDatasetWithChunkCache) {
+  // write a chunked dataset
+  auto file = h5::file("group_chunk_cache.h5", 'w');
+  auto root = h5::group(file);
+  h5::write(root, "vec", std::vector<double>(1000, 1.0), h5::write_options{.chunk_shape = {100}});
+
+  // open the dataset with a custom chunk cache
+  auto cfg = h5::chunk_cache_config{.nslots = 10007, .nbytes = 16 << 20, .w0 = 1.0};
+  auto ds  = root.open_dataset("vec", cfg);
+  EXPECT_TRUE(ds.is_valid());
+  EXPECT_THROW(std::ignore = root.open_dataset("nonexistent", cfg), std::runtime_error);
+
+  // check the chunk cache settings
+  auto dapl          = h5::proplist{H5Dget_access_plist(ds)};
+  std::size_t nslots = 0, nbytes = 0;
+  double w0          = 0.0;
+  EXPECT_GE(H5Pget_chunk_cache(dapl, &nslots, &nbytes, &w0), 0);
+  EXPECT_EQ(nslots, cfg.nslots);
+  EXPECT_EQ(nbytes, cfg.nbytes);
+  EXPECT_DOUBLE_EQ(w0, cfg.w0);
+}
+
+TEST(H5, GroupIterateChildren) {
+  auto file = h5::file("group_children.h5", 'w');
+  auto root = h5::group(file);
+  for (int i = 0; i < 10; ++i) h5::write(root, "ds_" + std::to_string(i), i);
+  for (int i = 0; i < 5; ++i) std::ignore = root.create_group("grp_" + std::to_string(i));
+  H5Lcreate_soft("/nonexistent", root, "dangling", H5P_DEFAULT, H5P_DEFAULT);
+
+  // single pass over all children
+  auto children = root.children();
+  EXPECT_EQ(children.size(), 16);
+  int n_ds = 0, n_grp = 0, n_unknown = 0;
+  for (auto const &c : children) {
+    if (c.type == h5::object_type::dataset) ++n_ds;
+    if (c.type == h5::object_type::group) ++n_grp;
+    if (c.type == h5::object_type::unknown) {
+      ++n_unknown;
+      EXPECT_EQ(c.name, "dangling");
+    }
+  }
+  EXPECT_EQ(n_ds, 10);
+  EXPECT_EQ(n_grp, 5);
+  EXPECT_EQ(n_unknown, 1);
+  EXPECT_EQ(root.get_all_dataset_names().size(), 10);
+  EXPECT_EQ(root.get_all_subgroup_names().size(), 5);
+  EXPECT_EQ(root.get_all_subgroup_dataset_names().size(), 15);
+
+  // early termination
+  int count = 0;
+  root.for_each_child([&count](std::string_view, h5::object_type) { return ++count < 3; });
+  EXPECT_EQ(count, 3);
+
+  // exceptions are propagated
+  EXPECT_THROW(root.for_each_child([](std::string_view, h5::object_type) -> bool { throw std::runtime_error("stop"); }), std::runtime_error);
+}
+
+TEST(H5, GroupCreationOrder) {
+  auto file = h5::file("group_creation_order.h5", 'w');
+  auto root = h5::group(file);
+  EXPECT_FALSE(root.has_creation_order_index());
+
+  // links are iterated in creation order
+  auto grp = root.create_group("ordered", h5::group_options{.creation_order = true, .max_compact = 4, .min_dense = 2, .est_num_entries = 10});
+  EXPECT_TRUE(grp.has_creation_order_index());
+  std::vector<std::string> names{"c", "a", "d", "b", "f", "e"};
+  for (auto const &n : names) h5::write(grp, n, 1);
+  std::vector<std::string> names_in;
+  for (auto const &c : root.open_group("ordered").children()) names_in.push_back(c.name);
+  EXPECT_EQ(names_in, names);
+
+  // check the link storage settings
+  auto gcpl            = h5::proplist{H5Gget_create_plist(grp)};
+  unsigned max_compact = 0, min_dense = 0, est_num = 0, est_len = 0;
+  H5Pget_link_phase_change(gcpl, &max_compact, &min_dense);
+  H5Pget_est_link_info(gcpl, &est_num, &est_len);
+  EXPECT_EQ(max_compact, 4);
+  EXPECT_EQ(min_dense, 2);
+  EXPECT_EQ(est_num, 10);
+
+  // default groups are iterated in name order
+  auto grp2 = root.create_group("unordered");
+  for (auto const &n : names) h5::write(grp2, n, 1);
+  EXPECT_EQ(grp2.get_all_dataset_names(), (std::vector<std::string>{"a", "b", "c", "d", "e", "f"}));
+}
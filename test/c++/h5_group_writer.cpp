@@ -0,0 +1,156 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <complex>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // User defined type which is written with an h5::group_writer and read with the usual functions.
+  struct run_data {
+    int n_iter = 0;
+    double beta = 0.0;
+    std::complex<double> z;
+    std::string label;
+    std::vector<double> energies;
+    std::vector<std::complex<double>> weights;
+    std::vector<std::string> names;
+    std::vector<long> params;
+
+    [[nodiscard]] static std::string hdf5_format() { return "RunData"; }
+
+    friend void h5_write(h5::group g, std::string const &name, run_data const &r) {
+      h5::group_writer w(g, name);
+      w.write_format(r);
+      w.write("n_iter", r.n_iter).write("beta", r.beta).write("z", r.z).write("label", r.label);
+      w.write("energies", r.energies).write("weights", r.weights).write("names", r.names);
+      w.subgroup("params").write("values", r.params).write_attribute("unit", "eV");
+      w.commit();
+    }
+
+    friend void h5_read(h5::group g, std::string const &name, run_data &r) {
+      auto gr = g.open_group(name);
+      h5::assert_hdf5_format(gr, r);
+      h5::read(gr, "n_iter", r.n_iter);
+      h5::read(gr, "beta", r.beta);
+      h5::read(gr, "z", r.z);
+      h5::read(gr, "label", r.label);
+      h5::read(gr, "energies", r.energies);
+      h5::read(gr, "weights", r.weights);
+      h5::read(gr, "names", r.names);
+      h5::read(gr, "params/values", r.params);
+    }
+  };
+
+  bool operator==(run_data const &a, run_data const &b) {
+    return a.n_iter == b.n_iter and a.beta == b.beta and a.z == b.z and a.label == b.label and a.energies == b.energies and a.weights == b.weights
+       and a.names == b.names and a.params == b.params;
+  }
+
+} // namespace
+
+TEST(H5, GroupWriter) {
+  run_data r{10, 2.5, {1.0, -2.0}, "test", {1.0, 2.0, 3.0}, {{1.0, 1.0}, {0.0, -1.0}}, {"a", "bc"}, {1, 2, 3, 4}};
+  {
+    h5::file f("group_writer.h5", 'w');
+    h5::write(f, "run", r);
+  }
+
+  // the layout is the same as with h5::write
+  h5::file f("group_writer.h5", 'r');
+  h5::group run = h5::group{f}.open_group("run");
+  EXPECT_EQ(h5::read_hdf5_format(run), "RunData");
+  EXPECT_EQ(h5::read<double>(run, "beta"), 2.5);
+  EXPECT_EQ(h5::read<std::string>(run, "label"), "test");
+  EXPECT_EQ(h5::read<std::vector<double>>(run, "energies"), r.energies);
+  EXPECT_EQ(h5::array_interface::get_dataset_shape(run.open_dataset("weights")), (h5::v_t{2, 2}));
+  EXPECT_EQ(h5::array_interface::get_dataset_type_code(run.open_dataset("energies")), h5::array_interface::get_dataset_type_code(run.open_dataset("beta")));
+  std::string unit;
+  h5::read_attribute(run.open_group("params"), "unit", unit);
+  EXPECT_EQ(unit, "eV");
+  EXPECT_EQ(h5::read<run_data>(f, "run"), r);
+}
+
+TEST(H5, GroupWriterExistingGroup) {
+  h5::file f("group_writer_existing.h5", 'w');
+  h5::group g{f};
+  h5::write(g, "x", std::vector<int>{1, 2, 3});
+  h5::write(g, "s", std::string("old"));
+  h5::write_hdf5_format_as_string(g, "Old");
+
+  // existing datasets and attributes are replaced, others are kept
+  {
+    h5::group_writer w(g);
+    EXPECT_EQ(w.get_group().name(), g.name());
+    w.write("x", 1.5).write("s", "new").write("y", std::vector<double>{4.0, 5.0});
+    w.write_attribute("Format", "New");
+    EXPECT_EQ(w.pending(), 4);
+  } // committed by the destructor
+  EXPECT_EQ(h5::read<double>(g, "x"), 1.5);
+  EXPECT_EQ(h5::read<std::string>(g, "s"), "new");
+  EXPECT_EQ(h5::read<std::vector<double>>(g, "y"), (std::vector<double>{4.0, 5.0}));
+  EXPECT_EQ(h5::read_hdf5_format(g), "New");
+
+  // writing a name twice throws
+  h5::group_writer w(g, "sub");
+  w.write("a", 1);
+  EXPECT_THROW(w.write("a", 2), std::runtime_error);
+  EXPECT_THROW(w.subgroup("a"), std::runtime_error);
+  w.write_attribute("Format", "Sub");
+  EXPECT_THROW(w.write_attribute("Format", "Sub"), std::runtime_error);
+
+  // the writer can be used again after a commit
+  w.commit();
+  EXPECT_EQ(w.pending(), 0);
+  w.write("b", std::vector<int>{});
+  w.commit();
+  EXPECT_EQ(h5::read<int>(g, "sub/a"), 1);
+  EXPECT_TRUE(h5::read<std::vector<int>>(g, "sub/b").empty());
+}
+
+TEST(H5, GroupWriterOverwriteInPlace) {
+  // rewriting a group with a writer reuses the datasets of the previous checkpoint (the compressed vector keeps its
+  // content so that its chunks keep their size)
+  std::string fname{"group_writer_in_place.h5"};
+  auto opts = h5::file_options{.overwrite_in_place = true, .persist_free_space = true};
+  std::vector<double> v(100000, 1.0);
+  std::uintmax_t size = 0;
+  for (int i = 0; i < 5; ++i) {
+    {
+      h5::file f(fname, (i == 0 ? 'w' : 'a'), opts);
+      h5::group_writer w(h5::group{f}, "checkpoint");
+      w.write("vec", v).write("iteration", i).write("s", "run");
+      w.subgroup("params").write("beta", 2.0);
+    }
+    // the file only varies by a few bytes due to the free space management of HDF5 (a new vector would add kilobytes)
+    if (i == 1) size = std::filesystem::file_size(fname);
+    if (i > 1) { EXPECT_LT(std::filesystem::file_size(fname), size + 256); }
+  }
+
+  h5::file f(fname, 'r');
+  EXPECT_EQ(h5::read<std::vector<double>>(f, "checkpoint/vec"), v);
+  EXPECT_EQ(h5::read<int>(f, "checkpoint/iteration"), 4);
+  EXPECT_EQ(h5::read<std::string>(f, "checkpoint/s"), "run");
+  EXPECT_EQ(h5::read<double>(f, "checkpoint/params/beta"), 2.0);
+}
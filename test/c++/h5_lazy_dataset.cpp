@@ -0,0 +1,84 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <complex>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+TEST(H5, LazyDataset) {
+  // write a 2D array of shape 6x4
+  std::vector<int> data(6 * 4);
+  std::iota(data.begin(), data.end(), 0);
+  h5::file file("lazy_dataset.h5", 'w');
+  h5::array_interface::array_view view(h5::hdf5_type<int>(), (void *)data.data(), 2, false);
+  view.parent_shape = {6, 4};
+  view.slab.count   = {6, 4};
+  h5::array_interface::write(file, "data", view, h5::write_options{.chunk_shape = {2, 4}});
+
+  // open it lazily and check the cached info
+  h5::lazy_dataset ds(file, "data", h5::chunk_cache_config{.nslots = 101, .nbytes = 1024});
+  EXPECT_EQ(ds.shape(), (h5::v_t{6, 4}));
+  EXPECT_EQ(ds.rank(), 2);
+  EXPECT_EQ(ds.size(), 24);
+  EXPECT_FALSE(ds.is_complex());
+
+  // read single rows
+  for (h5::hsize_t i = 0; i < 6; ++i) {
+    auto row = ds.slice<int>({i, 0}, {1, 4});
+    EXPECT_EQ(row, std::vector<int>(data.begin() + i * 4, data.begin() + (i + 1) * 4));
+  }
+
+  // read a strided selection
+  EXPECT_EQ(ds.slice<int>({1, 1}, {3, 2}, {2, 2}), (std::vector<int>{5, 7, 13, 15, 21, 23}));
+
+  // read into a buffer with a different (but compatible) type
+  std::vector<long> buf(4);
+  ds.read_slice(buf.data(), {5, 0}, {1, 4});
+  EXPECT_EQ(buf, (std::vector<long>{20, 21, 22, 23}));
+
+  // the conversion policy is checked on every read with a mismatching type
+  using policy = h5::transfer_options::conversion_policy;
+  testing::internal::CaptureStderr();
+  ds.read_slice(buf.data(), {4, 0}, {1, 4}, {}, h5::transfer_options{.conversion = policy::allow});
+  EXPECT_TRUE(testing::internal::GetCapturedStderr().empty());
+  EXPECT_EQ(buf, (std::vector<long>{16, 17, 18, 19}));
+  EXPECT_THROW(ds.read_slice(buf.data(), {3, 0}, {1, 4}, {}, h5::transfer_options{.conversion = policy::forbid}), std::runtime_error);
+  std::vector<int> row(4);
+  EXPECT_NO_THROW(ds.read_slice(row.data(), {3, 0}, {1, 4}, {}, h5::transfer_options{.conversion = policy::forbid}));
+  EXPECT_EQ(row, (std::vector<int>{12, 13, 14, 15}));
+
+  // invalid selections
+  EXPECT_THROW(std::ignore = ds.slice<int>({5, 0}, {2, 4}), std::runtime_error);
+  EXPECT_THROW(std::ignore = ds.slice<int>({0}, {1, 4}), std::runtime_error);
+  EXPECT_THROW(std::ignore = ds.slice<double>({0, 0}, {1, 4}), std::runtime_error);
+}
+
+TEST(H5, LazyDatasetComplex) {
+  // complex values have an additional dimension in the dataset
+  std::vector<std::complex<double>> data{{1, 2}, {3, 4}, {5, 6}, {7, 8}};
+  h5::file file("lazy_dataset_complex.h5", 'w');
+  h5::write(file, "data", data);
+
+  h5::lazy_dataset ds(file, "data");
+  EXPECT_TRUE(ds.is_complex());
+  EXPECT_EQ(ds.shape(), (h5::v_t{4, 2}));
+  EXPECT_EQ(ds.slice<std::complex<double>>({1}, {2}), (std::vector<std::complex<double>>{{3, 4}, {5, 6}}));
+  EXPECT_EQ(ds.slice<double>({1, 1}, {2, 1}), (std::vector<double>{4, 6}));
+}
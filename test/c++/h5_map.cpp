@@ -17,7 +17,9 @@
 #include <gtest/gtest.h>
 #include <h5/h5.hpp>
 
+#include <complex>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -112,3 +114,54 @@ TEST(H5, MapOldVsNew) {
     EXPECT_EQ(m, m_in);
   }
 }
+
+TEST(H5, MapColumnarLayout) {
+  // maps with arithmetic/string keys and arithmetic/complex values are stored as a keys and a values dataset
+  std::map<long, double> m_long;
+  for (long i = 0; i < 1000; ++i) m_long.emplace(3 * i - 500, 0.5 * i);
+  std::map<double, std::complex<double>> m_cplx = {{-1.5, {1.0, 2.0}}, {0.0, {-3.0, 0.5}}, {2.25, {0.0, 0.0}}};
+  std::map<std::string, int> m_str              = {{"alpha", 1}, {"beta", -2}, {"gamma", 3}};
+  std::map<int, double> m_empty;
+
+  {
+    h5::file file{"test_map_4.h5", 'w'};
+    h5::write(file, "map_long", m_long);
+    h5::write(file, "map_cplx", m_cplx);
+    h5::write(file, "map_str", m_str);
+    h5::write(file, "map_empty", m_empty);
+  }
+
+  {
+    h5::file file{"test_map_4.h5", 'r'};
+    auto gr = h5::group{file}.open_group("map_long");
+    EXPECT_EQ(h5::read_hdf5_format(gr), h5::columnar_dict_format);
+    EXPECT_EQ(gr.get_all_subgroup_dataset_names().size(), 2);
+    EXPECT_EQ(h5::read<std::vector<long>>(gr, "keys").size(), m_long.size());
+
+    EXPECT_EQ(h5::read<decltype(m_long)>(file, "map_long"), m_long);
+    EXPECT_EQ(h5::read<decltype(m_cplx)>(file, "map_cplx"), m_cplx);
+    EXPECT_EQ(h5::read<decltype(m_str)>(file, "map_str"), m_str);
+    EXPECT_EQ(h5::read<decltype(m_empty)>(file, "map_empty"), m_empty);
+  }
+
+  {
+    // the element-wise layout for non-string keys can still be read
+    h5::file file{"test_map_4.h5", 'w'};
+    auto gr = h5::group{file}.create_group("map_old");
+    h5::write_hdf5_format(gr, m_long);
+    for (int i = 0; i < 3; ++i) {
+      auto element_gr = gr.create_group(std::to_string(i));
+      h5::write(element_gr, "key", long{10 * i});
+      h5::write(element_gr, "val", 1.5 * i);
+    }
+    std::map<long, double> m_old = {{0, 0.0}, {10, 1.5}, {20, 3.0}};
+    EXPECT_EQ(h5::read<decltype(m_old)>(file, "map_old"), m_old);
+
+    // mismatching number of keys and values
+    auto bad = h5::group{file}.create_group("map_bad");
+    h5::write_hdf5_format_as_string(bad, h5::columnar_dict_format);
+    h5::write(bad, "keys", std::vector<long>{1, 2});
+    h5::write(bad, "values", std::vector<double>{1.0});
+    EXPECT_THROW(h5::read<decltype(m_old)>(file, "map_bad"), std::runtime_error);
+  }
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <complex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+TEST(H5, MappedDataset) {
+  std::vector<double> v(100000);
+  for (std::size_t i = 0; i < v.size(); ++i) v[i] = 0.5 * i;
+  std::vector<std::complex<double>> cv{{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}};
+
+  // write contiguous (no compression), chunked and complex datasets
+  {
+    h5::file file("mapped_dataset.h5", 'w');
+    h5::write(file, "vec", v, h5::write_options{});
+    h5::write(file, "compressed", v, h5::write_options{.deflate_level = 1});
+    h5::write(file, "cvec", cv, h5::write_options{});
+    h5::write(file, "scalar", 42);
+    h5::write(file, "compound", cv, h5::write_options{.complex_storage = h5::write_options::complex_format::compound});
+
+    // mapping a dataset of a file opened for writing flushes the file first
+    auto m = h5::map_dataset(file, "vec");
+    auto s = m.as_span<double>();
+    EXPECT_EQ(std::vector<double>(s.begin(), s.end()), v);
+  }
+
+  h5::mapped_dataset m;
+  {
+    h5::file file("mapped_dataset.h5", 'r');
+    m = h5::map_dataset(file, "vec");
+
+    // complex data stored with an additional dimension
+    auto mc = h5::map_dataset(file, "cvec");
+    EXPECT_TRUE(mc.is_complex());
+    EXPECT_EQ(mc.shape(), (h5::v_t{3, 2}));
+    auto sc = mc.as_span<std::complex<double>>();
+    EXPECT_EQ(std::vector<std::complex<double>>(sc.begin(), sc.end()), cv);
+    EXPECT_THROW((void)mc.as_span<double>(), std::runtime_error);
+
+    // complex data stored with a compound datatype
+    auto md = h5::map_dataset(file, "compound");
+    EXPECT_FALSE(md.is_complex());
+    auto sd = md.as_span<std::complex<double>>();
+    EXPECT_EQ(std::vector<std::complex<double>>(sd.begin(), sd.end()), cv);
+
+    // scalar
+    EXPECT_EQ(h5::map_dataset(file, "scalar").as_span<int>()[0], 42);
+
+    // chunked datasets and memory files cannot be mapped
+    EXPECT_THROW((void)h5::map_dataset(file, "compressed"), std::runtime_error);
+    h5::file mem_file;
+    h5::write(mem_file, "vec", v, h5::write_options{});
+    EXPECT_THROW((void)h5::map_dataset(mem_file, "vec"), std::runtime_error);
+  }
+
+  // the mapping outlives the file
+  EXPECT_EQ(m.shape(), h5::v_t{v.size()});
+  EXPECT_EQ(m.size_bytes(), v.size() * sizeof(double));
+  auto s = m.as_span<double>();
+  EXPECT_EQ(std::vector<double>(s.begin(), s.end()), v);
+  EXPECT_THROW((void)m.as_span<float>(), std::runtime_error);
+
+  // moving transfers the mapping
+  auto m2 = std::move(m);
+  EXPECT_EQ(m2.as_span<double>()[10], 5.0);
+  m2.unmap();
+  EXPECT_EQ(m2.data(), nullptr);
+}
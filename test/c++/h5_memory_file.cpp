@@ -17,6 +17,9 @@
 #include <gtest/gtest.h>
 #include <h5/h5.hpp>
 
+#include <hdf5.h>
+
+#include <algorithm>
 #include <cstddef>
 #include <fstream>
 #include <string>
@@ -46,6 +49,7 @@ TEST(H5, MemoryFile) {
   ostrm.write(reinterpret_cast<char *>(buf_mem.data()), static_cast<long>(buf_mem.size())); // NOLINT (reinterpret cast is wanted here)
 
   // read h5 file from disk into raw buffer
+  f_disk.flush();
   std::vector<std::byte> buf_raw;
   std::ifstream istrm{"on_disk.h5", std::ios::binary | std::ios::ate};
   buf_raw.resize(istrm.tellg(), std::byte{0});
@@ -63,3 +67,38 @@ TEST(H5, MemoryFile) {
     EXPECT_EQ(vec_str, vec_str_read);
   }
 }
+
+TEST(H5, MemoryFileWithoutCopies) {
+  // write some data to a memory file
+  auto vec = std::vector<double>(1000, 3.14);
+  auto f   = h5::file{};
+  h5::write(f, "vec", vec);
+
+  // view of the memory buffer (only the file status flags in the superblock differ from a copy)
+  auto view = f.buffer_view();
+  auto buf  = f.as_buffer();
+  EXPECT_EQ(view.size(), buf.size());
+  EXPECT_TRUE(std::equal(view.begin() + 24, view.end(), buf.begin() + 24));
+
+  // read-only file operating on an external buffer
+  {
+    auto f_view = h5::file::from_buffer_view(buf);
+    EXPECT_EQ(h5::read<std::vector<double>>(f_view, "vec"), vec);
+    EXPECT_THROW(h5::write(f_view, "vec2", vec), std::runtime_error);
+  }
+
+  // file taking ownership of a buffer
+  auto f_own = h5::file{std::move(buf)};
+  EXPECT_EQ(h5::read<std::vector<double>>(f_own, "vec"), vec);
+
+  // write more data such that the buffer has to grow
+  auto large_vec = std::vector<double>(100000, 2.71);
+  h5::write(f_own, "large_vec", large_vec);
+  EXPECT_EQ(h5::read<std::vector<double>>(f_own, "large_vec"), large_vec);
+
+  // buffer stays alive as long as an object in the file is open
+  auto ds = h5::group{f_own}.open_dataset("large_vec");
+  f_own.close();
+  EXPECT_TRUE(ds.is_valid());
+  EXPECT_EQ(H5Sget_simple_extent_npoints(h5::dataspace{H5Dget_space(ds)}), large_vec.size());
+}
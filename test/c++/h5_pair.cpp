@@ -18,6 +18,7 @@
 #include <h5/h5.hpp>
 
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -45,3 +46,22 @@ TEST(H5, Pair) {
     EXPECT_EQ(psv, psv_in);
   }
 }
+
+TEST(H5, PairOfScalars) {
+  // pairs of arithmetic/complex types are stored in a single dataset with a compound datatype
+  std::pair<int, double> p = {7, -0.25};
+
+  {
+    h5::file file{"test_pair_compact.h5", 'w'};
+    h5::write(file, "p", p);
+  }
+
+  {
+    h5::file file{"test_pair_compact.h5", 'r'};
+    EXPECT_TRUE(h5::group{file}.has_dataset("p"));
+    EXPECT_EQ((h5::read<std::pair<int, double>>(file, "p")), p);
+
+    // same layout as a tuple
+    EXPECT_EQ((h5::read<std::tuple<int, double>>(file, "p")), std::make_tuple(7, -0.25));
+  }
+}
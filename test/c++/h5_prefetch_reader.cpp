@@ -0,0 +1,72 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(H5, PrefetchReader) {
+  h5::file file("prefetch_reader.h5", 'w');
+  h5::group g = h5::group{file}.create_group("results");
+  std::vector<std::string> names;
+  for (int i = 0; i < 20; ++i) {
+    names.push_back(std::to_string(100 + i));
+    h5::write(g, names.back(), std::vector<double>(50, 1.0 * i));
+  }
+
+  // read all datasets in the group with a small pool of buffers
+  h5::prefetch_reader<std::vector<double>> reader(g, 3);
+  EXPECT_EQ(reader.size(), 20);
+  std::vector<std::string> seen;
+  std::vector<double const *> buffers;
+  while (auto const *e = reader.next()) {
+    int i = std::stoi(e->name) - 100;
+    EXPECT_EQ(e->value, std::vector<double>(50, 1.0 * i));
+    seen.push_back(e->name);
+    if (std::find(buffers.begin(), buffers.end(), e->value.data()) == buffers.end()) buffers.push_back(e->value.data());
+  }
+  std::sort(seen.begin(), seen.end());
+  EXPECT_EQ(seen, names);
+  EXPECT_EQ(reader.next(), nullptr);
+
+  // the buffers are reused
+  EXPECT_LE(buffers.size(), 4);
+}
+
+TEST(H5, PrefetchReaderNames) {
+  h5::file file("prefetch_reader_names.h5", 'w');
+  for (int i = 0; i < 5; ++i) h5::write(file, std::to_string(i), i);
+
+  // read a given sequence of objects (errors are reported by the corresponding call to next)
+  h5::prefetch_reader<int> reader(file, {"4", "missing", "0"}, 1);
+  auto const *e = reader.next();
+  ASSERT_NE(e, nullptr);
+  EXPECT_EQ(e->name, "4");
+  EXPECT_EQ(e->value, 4);
+  EXPECT_THROW(reader.next(), std::runtime_error);
+  e = reader.next();
+  ASSERT_NE(e, nullptr);
+  EXPECT_EQ(e->value, 0);
+  EXPECT_EQ(reader.next(), nullptr);
+
+  // stopping early joins the I/O thread
+  { h5::prefetch_reader<int> early(file, 2); }
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(H5, ScratchPool) {
+  h5::release_scratch_pool();
+  auto const s0 = h5::get_scratch_pool_stats();
+  EXPECT_EQ(s0.cached_bytes, 0);
+
+  // freed blocks are cached and reused by allocations of the same size class
+  void const *addr = nullptr;
+  {
+    h5::scratch_vector<char> v(1000);
+    addr = v.data();
+  }
+  EXPECT_EQ(h5::get_scratch_pool_stats().cached_bytes, 1024);
+  {
+    h5::scratch_vector<char> v(900);
+    EXPECT_EQ(static_cast<void const *>(v.data()), addr);
+    EXPECT_EQ(h5::get_scratch_pool_stats().hits, s0.hits + 1);
+  }
+
+  // blocks freed on another thread end up in the pool of that thread
+  {
+    h5::scratch_vector<int> v(100, 1);
+    std::thread([v = std::move(v)]() mutable { v = {}; }).join();
+  }
+
+  // blocks exceeding the limit are freed
+  auto limit = h5::get_scratch_pool_limit();
+  h5::set_scratch_pool_limit(2048);
+  { h5::scratch_vector<char> v(4000); }
+  EXPECT_EQ(h5::get_scratch_pool_stats().cached_bytes, 1024);
+
+  // blocks larger than 8 MiB are never pooled (and not rounded up to a size class)
+  h5::set_scratch_pool_limit(std::size_t{64} << 20);
+  auto const s1 = h5::get_scratch_pool_stats();
+  { h5::scratch_vector<char> v((std::size_t{8} << 20) + 1); }
+  EXPECT_EQ(h5::get_scratch_pool_stats().cached_bytes, 1024);
+  EXPECT_EQ(h5::get_scratch_pool_stats().misses, s1.misses);
+  h5::set_scratch_pool_limit(limit);
+  h5::release_scratch_pool();
+  EXPECT_EQ(h5::get_scratch_pool_stats().cached_bytes, 0);
+}
+
+TEST(H5, ScratchPoolStrings) {
+  std::vector<std::string> vec{"Hello", "World!", "", "scratch"};
+
+  // repeated reads/writes of strings reuse the temporary buffers
+  h5::file file("scratch.h5", 'w');
+  h5::write(file, "warmup", vec);
+  for (int i = 0; i < 10; ++i) {
+    auto fl_name = std::to_string(i), vl_name = std::to_string(100 + i);
+    auto before  = h5::get_scratch_pool_stats();
+    h5::write(file, fl_name, vec);
+    h5::write(file, vl_name, vec, h5::write_options{.variable_length_strings = true});
+    EXPECT_EQ(h5::read<std::vector<std::string>>(file, fl_name), vec);
+    EXPECT_EQ(h5::read<std::vector<std::string>>(file, vl_name), vec);
+    auto after = h5::get_scratch_pool_stats();
+    EXPECT_EQ(after.misses, before.misses);
+    EXPECT_GT(after.hits, before.hits);
+  }
+}
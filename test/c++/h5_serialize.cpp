@@ -19,6 +19,10 @@
 #include <h5/serialization.hpp>
 
 #include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
 
 TEST(H5, Serialize) {
   // serialize/deserialize an array of strings and doubles
@@ -33,3 +37,34 @@ TEST(H5, Serialize) {
   EXPECT_EQ(arr_str, arr_str_ser);
   EXPECT_EQ(arr_dbl, arr_dbl_ser);
 }
+
+TEST(H5, SerializeIntoBuffer) {
+  auto vec = std::vector<double>(10000, 3.14);
+
+  // serialize into a buffer of the estimated size
+  auto size = h5::serialized_size(vec);
+  auto buf  = std::vector<std::byte>(size);
+  EXPECT_EQ(h5::serialize_into(vec, buf), size);
+  EXPECT_EQ(h5::deserialize<std::vector<double>>(std::span{buf.data(), size}), vec);
+
+  // reuse a larger buffer for multiple objects
+  auto pool = std::vector<std::byte>(2 * size);
+  for (int i = 0; i < 3; ++i) {
+    auto v = std::vector<double>(5000 + i, static_cast<double>(i));
+    auto n = h5::serialize_into(v, pool);
+    EXPECT_LE(n, pool.size());
+    EXPECT_EQ(h5::deserialize<std::vector<double>>(std::span{pool.data(), n}), v);
+  }
+
+  // buffer too small
+  auto small_buf = std::vector<std::byte>(size / 2);
+  EXPECT_THROW(h5::serialize_into(vec, small_buf), std::runtime_error);
+  EXPECT_THROW(h5::serialize_into(vec, std::span{small_buf.data(), 10}), std::runtime_error);
+
+  // serialize with a custom allocator and with a custom memory increment
+  auto buf_alloc = h5::serialize(vec, std::allocator<std::byte>{});
+  EXPECT_EQ(buf_alloc.size(), size);
+  EXPECT_EQ(h5::deserialize<std::vector<double>>(buf_alloc), vec);
+  auto buf_inc = h5::serialize(vec, h5::file_options{.memory_increment = size});
+  EXPECT_EQ(h5::deserialize<std::vector<double>>(buf_inc), vec);
+}
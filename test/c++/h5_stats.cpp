@@ -0,0 +1,61 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <string>
+#include <vector>
+
+TEST(H5, Stats) {
+  h5::reset_stats();
+  h5::enable_tracing();
+  {
+    h5::file file("stats.h5", 'w');
+    h5::write(file, "vec", std::vector<double>(100, 1.0));
+    h5::write(file, "str", std::string{"hello"});
+    auto v = h5::read<std::vector<double>>(file, "vec");
+    EXPECT_EQ(v.size(), 100);
+  }
+  h5::enable_tracing(false);
+
+  auto s      = h5::stats();
+  auto events = h5::trace_events();
+  if constexpr (h5::instrumentation_enabled) {
+    ASSERT_TRUE(s.contains("array_interface::write"));
+    EXPECT_EQ(s["array_interface::write"].calls, 1);
+    EXPECT_EQ(s["array_interface::write"].bytes, 100 * sizeof(double));
+    EXPECT_EQ(s["array_interface::read"].bytes, 100 * sizeof(double));
+    EXPECT_EQ(s["h5_write(std::string)"].bytes, 5);
+    EXPECT_GE(s["file::open"].calls, 1);
+
+    // trace events contain the full names of the datasets
+    auto it = std::find_if(events.begin(), events.end(), [](auto const &ev) { return ev.op == "array_interface::write"; });
+    ASSERT_NE(it, events.end());
+    EXPECT_EQ(it->name, "/vec");
+    EXPECT_NE(h5::trace_to_json().find("\"name\": \"/vec\""), std::string::npos);
+    EXPECT_NE(h5::stats_to_json().find("\"array_interface::write\": {\"calls\": 1"), std::string::npos);
+  } else {
+    EXPECT_TRUE(s.empty());
+    EXPECT_TRUE(events.empty());
+    EXPECT_EQ(h5::stats_to_json(), "{}");
+  }
+
+  // reset the statistics
+  h5::reset_stats();
+  EXPECT_TRUE(h5::stats().empty());
+  EXPECT_TRUE(h5::trace_events().empty());
+}
@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 #include <h5/h5.hpp>
 
+#include <complex>
 #include <string>
 #include <vector>
 
@@ -107,3 +108,42 @@ TEST(H5, CharBuff) {
     EXPECT_EQ(vec2, vec2_in);
   }
 }
+
+TEST(H5, StringDatatypeCache) {
+  // string datatypes and the scalar dataspace are created only once
+  auto dt5 = h5::detail::fixed_string_type(5);
+  EXPECT_EQ(static_cast<h5::hid_t>(dt5), static_cast<h5::hid_t>(h5::detail::fixed_string_type(5)));
+  EXPECT_NE(static_cast<h5::hid_t>(dt5), static_cast<h5::hid_t>(h5::detail::fixed_string_type(6)));
+  EXPECT_EQ(static_cast<h5::hid_t>(h5::detail::scalar_dataspace()), static_cast<h5::hid_t>(h5::detail::scalar_dataspace()));
+  EXPECT_TRUE(h5::hdf5_type_equal(h5::char_buf{{'a', 'b', '\0'}, {1, 3}}.dtype(), h5::detail::fixed_string_type(3)));
+  EXPECT_TRUE(h5::detail::fixed_string_type(1000).is_valid());
+
+  {
+    h5::file file{"test_str_cache.h5", 'w'};
+    h5::group g{file};
+
+    // many small containers with Format and __complex__ attributes
+    for (int i = 0; i < 50; ++i) {
+      auto name = std::to_string(i);
+      h5::write(g, name, std::vector<std::complex<double>>{{1.0 * i, -1.0}});
+      h5::write(g, name + "_vec", std::vector<std::vector<int>>{{i}, {i, i}});
+      h5::write_attribute(g.open_dataset(name), "tag", std::string(i % 7, 'x'));
+    }
+    g.create_group("sub");
+    h5::h5_write_attribute_to_key(g, "sub", "note", std::string{"hello"});
+    h5::write(g, "chars", h5::char_buf{{'a', 'b', 'c', 'd', '\0', '\0'}, {2, 3}});
+  }
+
+  {
+    h5::file file{"test_str_cache.h5", 'r'};
+    h5::group g{file};
+    for (int i = 0; i < 50; ++i) {
+      auto name = std::to_string(i);
+      EXPECT_EQ(h5::read<std::vector<std::complex<double>>>(g, name), (std::vector<std::complex<double>>{{1.0 * i, -1.0}}));
+      EXPECT_EQ(h5::read<std::vector<std::vector<int>>>(g, name + "_vec"), (std::vector<std::vector<int>>{{i}, {i, i}}));
+      EXPECT_EQ(h5::read_attribute<std::string>(g.open_dataset(name), "tag"), std::string(i % 7, 'x'));
+    }
+    EXPECT_EQ(h5::h5_read_attribute_from_key<std::string>(g, "sub", "note"), "hello");
+    EXPECT_EQ(h5::read<std::vector<std::string>>(g, "chars"), (std::vector<std::string>{"abc", "d"}));
+  }
+}
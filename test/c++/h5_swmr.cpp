@@ -0,0 +1,136 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+  // Send a single byte through a pipe.
+  void signal(int fd) {
+    char c = 1;
+    if (::write(fd, &c, 1) != 1) std::_Exit(2);
+  }
+
+  // Wait for a single byte from a pipe.
+  bool wait_for(int fd) {
+    char c = 0;
+    return ::read(fd, &c, 1) == 1;
+  }
+
+  // Writer process: create an extensible dataset in SWMR mode and append to it.
+  [[noreturn]] void run_writer(int to_reader, int from_reader) {
+    int status = 0;
+    try {
+      h5::file file{"test_swmr.h5", 'w', h5::file_options{.swmr = true}};
+      std::vector<double> v(10);
+      std::iota(v.begin(), v.end(), 0.0);
+      h5::append(file, "data", v);
+      file.flush();
+      signal(to_reader);
+
+      // append more data once the reader has seen the first batch
+      if (not wait_for(from_reader)) std::_Exit(3);
+      std::iota(v.begin(), v.end(), 10.0);
+      h5::append(file, "data", v);
+      file.flush();
+      signal(to_reader);
+      if (not wait_for(from_reader)) std::_Exit(3);
+    } catch (std::exception const &) { status = 1; }
+    std::_Exit(status);
+  }
+
+} // namespace
+
+TEST(H5, SWMROptions) {
+  // SWMR writers and readers in the same process
+  {
+    h5::file file{"test_swmr_opts.h5", 'w', h5::file_options{.swmr = true}};
+    EXPECT_FALSE(file.swmr_read());
+    h5::write(file, "x", 1.5);
+    file.flush();
+  }
+  {
+    h5::file file{"test_swmr_opts.h5", 'r', h5::file_options{.swmr = true}};
+    EXPECT_TRUE(file.swmr_read());
+    EXPECT_EQ(h5::read<double>(file, "x"), 1.5);
+  }
+
+  // files with the latest file format can be switched to SWMR writing after they have been opened
+  {
+    h5::file file{"test_swmr_opts.h5", 'a'};
+    h5::write(file, "y", 2.5);
+    EXPECT_NO_THROW(file.start_swmr_write());
+  }
+
+  // files with an old file format cannot be switched to SWMR writing
+  h5::file file{"test_swmr_old.h5", 'w'};
+  EXPECT_THROW(file.start_swmr_write(), std::runtime_error);
+}
+
+TEST(H5, SWMRLiveReading) {
+  int to_reader[2], from_reader[2];
+  ASSERT_EQ(::pipe(to_reader), 0);
+  ASSERT_EQ(::pipe(from_reader), 0);
+  pid_t pid = ::fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    ::close(to_reader[0]);
+    ::close(from_reader[1]);
+    run_writer(to_reader[1], from_reader[0]);
+  }
+
+  // close the unused ends so that a failing writer cannot block the reader
+  ::close(to_reader[1]);
+  ::close(from_reader[0]);
+
+  // open the file as a SWMR reader while the writer still has it open
+  ASSERT_TRUE(wait_for(to_reader[0]));
+  {
+    h5::file file{"test_swmr.h5", 'r', h5::file_options{.swmr = true}};
+    h5::lazy_dataset ds(file, "data");
+    EXPECT_EQ(ds.shape(), (h5::v_t{10}));
+    EXPECT_EQ(ds.slice<double>({5}, {2}), (std::vector<double>{5.0, 6.0}));
+    EXPECT_FALSE(ds.refresh());
+    signal(from_reader[1]);
+
+    // the appended data becomes visible after refreshing
+    ASSERT_TRUE(wait_for(to_reader[0]));
+    EXPECT_TRUE(ds.refresh());
+    EXPECT_EQ(ds.shape(), (h5::v_t{20}));
+    EXPECT_EQ(ds.slice<double>({18}, {2}), (std::vector<double>{18.0, 19.0}));
+
+    // datasets opened by the generic read functions are refreshed automatically
+    std::vector<double> expected(20);
+    std::iota(expected.begin(), expected.end(), 0.0);
+    EXPECT_EQ(h5::read<std::vector<double>>(file, "data"), expected);
+  }
+  signal(from_reader[1]);
+  ::close(to_reader[0]);
+  ::close(from_reader[1]);
+
+  int status = -1;
+  ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+}
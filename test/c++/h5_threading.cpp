@@ -0,0 +1,75 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <atomic>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(H5, LibraryLock) {
+  // the lock only holds the mutex if HDF5 is not thread-safe
+  h5::library_lock lock;
+  EXPECT_EQ(lock.owns_lock(), not h5::is_library_threadsafe());
+
+  // the mutex is recursive
+  h5::library_lock lock2;
+  EXPECT_EQ(lock2.owns_lock(), lock.owns_lock());
+}
+
+TEST(H5, ConcurrentReads) {
+  // write some datasets
+  constexpr int n_ds = 16, n_threads = 8, n_iter = 50;
+  {
+    h5::file file("concurrent_reads.h5", 'w');
+    for (int i = 0; i < n_ds; ++i) {
+      std::vector<double> v(1000);
+      std::iota(v.begin(), v.end(), static_cast<double>(i));
+      h5::write(file, "data_" + std::to_string(i), v, h5::write_options{.chunk_shape = {100}, .deflate_level = 1});
+    }
+  }
+
+  // read them concurrently from a thread pool sharing the same file and the same lazy datasets
+  h5::file file("concurrent_reads.h5", 'r');
+  std::vector<h5::lazy_dataset> lazy;
+  for (int i = 0; i < n_ds; ++i) lazy.emplace_back(file, "data_" + std::to_string(i));
+  std::atomic<int> n_errors = 0;
+  std::vector<std::thread> pool;
+  for (int t = 0; t < n_threads; ++t) {
+    pool.emplace_back([&, t]() {
+      for (int it = 0; it < n_iter; ++it) {
+        int i = (t + it) % n_ds;
+
+        // full reads with the generic interface
+        {
+          h5::library_lock lock;
+          auto v = h5::read<std::vector<double>>(file, "data_" + std::to_string(i));
+          if (v.size() != 1000 or v[10] != i + 10.0) ++n_errors;
+          if (h5::get_name_of_h5_type(h5::hdf5_type<double>()) != "double") ++n_errors;
+        }
+
+        // partial reads with the lazy dataset
+        auto s = lazy[i].slice<double>({static_cast<h5::hsize_t>(10 * it)}, {10});
+        if (s.size() != 10 or s[0] != i + 10.0 * it) ++n_errors;
+      }
+    });
+  }
+  for (auto &th : pool) th.join();
+  EXPECT_EQ(n_errors, 0);
+}
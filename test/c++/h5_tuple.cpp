@@ -17,6 +17,8 @@
 #include <gtest/gtest.h>
 #include <h5/h5.hpp>
 
+#include <complex>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -45,3 +47,36 @@ TEST(H5, Tuple) {
     EXPECT_EQ(tsv, tsv_in);
   }
 }
+
+TEST(H5, TupleOfScalars) {
+  // tuples of arithmetic/complex types are stored in a single dataset with a compound datatype
+  std::tuple<int, double, std::complex<double>, bool, char> t = {-3, 2.5, {1.0, -1.0}, true, 'x'};
+  std::tuple<double, double, double> t3                       = {1.0, 2.0, 3.0};
+
+  {
+    h5::file file{"test_tuple_compact.h5", 'w'};
+    h5::write(file, "t", t);
+    h5::write(file, "t3", t3);
+
+    // the element-wise layout can still be read
+    auto gr = h5::group{file}.create_group("t3_old");
+    h5::write_hdf5_format(gr, t3);
+    h5::write(gr, "0", 1.0);
+    h5::write(gr, "1", 2.0);
+    h5::write(gr, "2", 3.0);
+  }
+
+  {
+    h5::file file{"test_tuple_compact.h5", 'r'};
+    h5::group g{file};
+    EXPECT_TRUE(g.has_dataset("t"));
+    EXPECT_EQ(h5::get_compound_member_names(h5::get_hdf5_type(g.open_dataset("t3"))), (std::vector<std::string>{"0", "1", "2"}));
+
+    EXPECT_EQ(h5::read<decltype(t)>(file, "t"), t);
+    EXPECT_EQ(h5::read<decltype(t3)>(file, "t3"), t3);
+    EXPECT_EQ(h5::read<decltype(t3)>(file, "t3_old"), t3);
+
+    // the number of elements has to match
+    EXPECT_THROW((h5::read<std::tuple<double, double>>(file, "t3")), std::runtime_error);
+  }
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+#include <hdf5.h>
+
+#include <complex>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+TEST(H5, TypeCodeNativeTypes) {
+  using h5::type_code;
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<std::int8_t>()), type_code::int8);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<std::uint8_t>()), type_code::uint8);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<std::int16_t>()), type_code::int16);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<std::uint16_t>()), type_code::uint16);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<std::int32_t>()), type_code::int32);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<std::uint32_t>()), type_code::uint32);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<std::int64_t>()), type_code::int64);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<std::uint64_t>()), type_code::uint64);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<float>()), type_code::float32);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<double>()), type_code::float64);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<long double>()), type_code::long_double);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<bool>()), type_code::boolean);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<std::string>()), type_code::string);
+  EXPECT_EQ(h5::get_type_code(h5::hdf5_type<h5::dcplx_t>()), type_code::complex_compound);
+
+  // names of the classified types
+  EXPECT_EQ(h5::get_name_of_h5_type(h5::hdf5_type<int>()), "int");
+  EXPECT_EQ(h5::get_name_of_h5_type(h5::hdf5_type<double>()), "double");
+  EXPECT_EQ(h5::get_name_of_h5_type(h5::hdf5_type<bool>()), "bool");
+  EXPECT_EQ(h5::get_name_of_h5_type(h5::hdf5_type<std::string>()), "std::string");
+  EXPECT_EQ(h5::get_name_of_h5_type(h5::hdf5_type<h5::dcplx_t>()), "Complex Compound Datatype");
+  EXPECT_EQ(h5::get_name_of_h5_type(h5::hdf5_type<std::uint32_t>()), "unsigned int");
+}
+
+TEST(H5, TypeCodeFileTypes) {
+  using h5::type_code;
+
+  // standard types with the native byte order are classified like the native types
+  EXPECT_EQ(h5::get_type_code(h5::datatype{H5Tcopy(H5T_STD_I32LE)}), type_code::int32);
+  EXPECT_EQ(h5::get_type_code(h5::datatype{H5Tcopy(H5T_IEEE_F64LE)}), type_code::float64);
+  EXPECT_EQ(h5::get_name_of_h5_type(h5::datatype{H5Tcopy(H5T_STD_I32LE)}), "int");
+
+  // non-native byte order and partial precision are not classified
+  EXPECT_EQ(h5::get_type_code(h5::datatype{H5Tcopy(H5T_STD_I32BE)}), type_code::unknown);
+  h5::datatype partial = H5Tcopy(H5T_NATIVE_INT);
+  H5Tset_precision(partial, 20);
+  EXPECT_EQ(h5::get_type_code(partial), type_code::unknown);
+
+  // arbitrary compound types
+  h5::datatype cmpd = H5Tcreate(H5T_COMPOUND, 16);
+  H5Tinsert(cmpd, "a", 0, H5T_NATIVE_DOUBLE);
+  H5Tinsert(cmpd, "b", 8, H5T_NATIVE_DOUBLE);
+  EXPECT_EQ(h5::get_type_code(cmpd), type_code::compound);
+
+  // only the h5 bool enum is classified as boolean
+  h5::datatype color = H5Tenum_create(H5T_NATIVE_SCHAR);
+  signed char val = 0;
+  for (auto name : {"RED", "GREEN", "BLUE"}) {
+    H5Tenum_insert(color, name, &val);
+    ++val;
+  }
+  EXPECT_EQ(h5::get_type_code(color), type_code::unknown);
+  EXPECT_EQ(h5::get_type_code(h5::datatype{H5Tcopy(h5::hdf5_type<bool>())}), type_code::boolean);
+
+  // reading classified types from a file
+  h5::file file("type_code.h5", 'w');
+  h5::write(file, "vec", std::vector<int>{1, 2, 3});
+  h5::write(file, "cplx", std::vector<std::complex<double>>{{1, 2}});
+  EXPECT_EQ(h5::get_type_code(h5::get_hdf5_type(h5::group{file}.open_dataset("vec"))), type_code::int32);
+  EXPECT_EQ(h5::get_type_code(h5::get_hdf5_type(h5::group{file}.open_dataset("cplx"))), type_code::float64);
+  EXPECT_EQ(h5::read<std::vector<int>>(file, "vec"), (std::vector<int>{1, 2, 3}));
+}
@@ -16,8 +16,12 @@
 
 #include <gtest/gtest.h>
 #include <h5/h5.hpp>
+#include <hdf5.h>
 
+#include <algorithm>
 #include <complex>
+#include <map>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -69,6 +73,52 @@ TEST(H5, VectorEmpty) {
   }
 }
 
+TEST(H5, VectorWriteOptions) {
+  // write/read a vector of doubles with a user defined dataset creation policy
+  std::vector<double> vdbl(1000, 1.0);
+
+  {
+    h5::file file{"test_vec_opts.h5", 'w'};
+    h5::write(file, "vec_dbl", vdbl, h5::write_options{.chunk_shape = {100}, .deflate_level = 9, .shuffle = true});
+  }
+
+  {
+    h5::file file{"test_vec_opts.h5", 'r'};
+
+    std::vector<double> vdbl_in;
+    h5::read(file, "vec_dbl", vdbl_in);
+
+    EXPECT_EQ(vdbl, vdbl_in);
+  }
+}
+
+TEST(H5, VectorAppend) {
+  // append vectors of doubles and complex doubles in batches
+  std::vector<double> vdbl                = {1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<std::complex<double>> vcplx = {{1.1, 2.2}, {3.3, 4.5}, {5.5, 6.6}};
+
+  {
+    h5::file file{"test_vec_append.h5", 'w'};
+    h5::append(file, "vec_dbl", std::vector<double>{});
+    h5::append(file, "vec_dbl", std::vector<double>(vdbl.begin(), vdbl.begin() + 2));
+    h5::append(file, "vec_dbl", std::vector<double>(vdbl.begin() + 2, vdbl.end()));
+    h5::append(file, "vec_cplx", std::vector<std::complex<double>>(vcplx.begin(), vcplx.begin() + 1));
+    h5::append(file, "vec_cplx", std::vector<std::complex<double>>(vcplx.begin() + 1, vcplx.end()));
+  }
+
+  {
+    h5::file file{"test_vec_append.h5", 'r'};
+
+    std::vector<double> vdbl_in;
+    std::vector<std::complex<double>> vcplx_in;
+    h5::read(file, "vec_dbl", vdbl_in);
+    h5::read(file, "vec_cplx", vcplx_in);
+
+    EXPECT_EQ(vdbl, vdbl_in);
+    EXPECT_EQ(vcplx, vcplx_in);
+  }
+}
+
 TEST(H5, VectorStringAttributes) {
   // write/read a vector of vectors of strings
   std::vector<std::vector<std::string>> vvs  = {{"a", "b"}, {"c", "d"}, {"e", "f"}};
@@ -106,6 +156,33 @@ TEST(H5, VectorStringAttributes) {
   }
 }
 
+TEST(H5, VectorNumericAttributes) {
+  h5::file file{"test_numeric_attribute.h5", 'w'};
+  h5::group grp{file};
+  h5::write(grp, "data", 0);
+  auto ds = grp.open_dataset("data");
+
+  // write several attributes at once and overwrite some of them
+  std::vector<double> x{0.0, 0.5, 1.0};
+  std::vector<std::complex<double>> z{{1.0, 2.0}, {3.0, 4.0}};
+  h5::write_attributes(ds, std::map<std::string, std::vector<double>>{{"x_axis", x}, {"y_axis", {1.0, 2.0}}});
+  h5::write_attribute(ds, "y_axis", std::vector<double>{5.0, 6.0, 7.0, 8.0});
+  h5::write_attribute(ds, "x_axis", std::vector<double>{-1.0, -2.0, -3.0});
+  h5::write_attribute(ds, "z", z);
+  h5::write_attribute(ds, "label", std::string("first"));
+  h5::write_attribute(ds, "label", std::string("second"));
+  h5::write_attribute(ds, "n", 1);
+  h5::write_attribute(ds, "n", 2.5);
+
+  EXPECT_EQ(h5::read_attribute<std::vector<double>>(ds, "x_axis"), (std::vector<double>{-1.0, -2.0, -3.0}));
+  EXPECT_EQ(h5::read_attribute<std::vector<double>>(ds, "y_axis"), (std::vector<double>{5.0, 6.0, 7.0, 8.0}));
+  EXPECT_EQ(h5::read_attribute<std::vector<std::complex<double>>>(ds, "z"), z);
+  EXPECT_EQ(h5::read_attribute<std::string>(ds, "label"), "second");
+  EXPECT_EQ(h5::read_attribute<double>(ds, "n"), 2.5);
+  EXPECT_THROW(h5::read_attribute<std::vector<int>>(ds, "x_axis"), std::runtime_error);
+  EXPECT_THROW(h5::read_attribute<std::vector<double>>(ds, "n"), std::runtime_error);
+}
+
 // Custom type.
 class foo {
   int var;
@@ -140,3 +217,111 @@ TEST(H5, VectorOfCustomType) {
     EXPECT_EQ(v, v_in);
   }
 }
+
+TEST(H5, VectorOfVectors) {
+  // write/read ragged vectors of doubles and complex doubles in the packed layout
+  std::vector<std::vector<double>> vv                = {{1.0, 2.0}, {}, {3.0}, {4.0, 5.0, 6.0}};
+  std::vector<std::vector<std::complex<double>>> vvc = {{{1, 2}}, {{3, 4}, {5, 6}}};
+  std::vector<std::vector<int>> vv_empty;
+
+  {
+    h5::file file{"test_vec_vec.h5", 'w'};
+    h5::write(file, "vv", vv);
+    h5::write(file, "vvc", vvc);
+    h5::write(file, "vv_empty", vv_empty);
+
+    // only 2 datasets are created
+    h5::group g(file);
+    auto gr = g.open_group("vv");
+    EXPECT_EQ(h5::read_hdf5_format(gr), "PackedList");
+    EXPECT_EQ(gr.get_all_dataset_names(), (std::vector<std::string>{"offsets", "values"}));
+    EXPECT_EQ(h5::read<std::vector<long>>(gr, "offsets"), (std::vector<long>{0, 2, 2, 3, 6}));
+
+    // legacy layout: one dataset per element
+    auto gr_legacy = g.create_group("vv_legacy");
+    h5::write_hdf5_format_as_string(gr_legacy, "List");
+    for (std::size_t i = 0; i < vv.size(); ++i) h5::write(gr_legacy, std::to_string(i), vv[i]);
+  }
+
+  {
+    h5::file file{"test_vec_vec.h5", 'r'};
+    EXPECT_EQ(h5::read<std::vector<std::vector<double>>>(file, "vv"), vv);
+    EXPECT_EQ((h5::read<std::vector<std::vector<std::complex<double>>>>(file, "vvc")), vvc);
+    EXPECT_EQ(h5::read<std::vector<std::vector<int>>>(file, "vv_empty"), vv_empty);
+    EXPECT_EQ(h5::read<std::vector<std::vector<double>>>(file, "vv_legacy"), vv);
+  }
+}
+
+TEST(H5, VectorOfVariableLengthStrings) {
+  // strings of very different lengths are stored without padding
+  std::vector<std::string> vs{"a", std::string(1000, 'x'), "", "abc"};
+  std::vector<std::vector<std::string>> vvs{{"a", "bb"}, {std::string(500, 'y')}, {}};
+  h5::write_options opts{.variable_length_strings = true};
+
+  {
+    h5::file file{"test_vec_vlstr.h5", 'w'};
+    h5::write(file, "vs", vs, opts);
+    h5::write(file, "vvs", vvs, opts);
+    h5::write(file, "vs_chunked", vs, h5::write_options{.chunk_shape = {2}, .deflate_level = 1, .variable_length_strings = true});
+    h5::write(file, "vs_empty", std::vector<std::string>{}, opts);
+    h5::write(file, "vs_fixed", vs, h5::write_options{.deflate_level = 1});
+
+    // check the datatypes stored in the file
+    for (auto const &[name, is_vl] : {std::pair{"vs", true}, {"vvs", true}, {"vs_fixed", false}}) {
+      hid_t ds = H5Dopen2(file, name, H5P_DEFAULT);
+      hid_t ty = H5Dget_type(ds);
+      EXPECT_EQ(H5Tis_variable_str(ty) > 0, is_vl);
+      H5Tclose(ty);
+      H5Dclose(ds);
+    }
+  }
+
+  {
+    h5::file file{"test_vec_vlstr.h5", 'r'};
+    EXPECT_EQ(h5::read<std::vector<std::string>>(file, "vs"), vs);
+    EXPECT_EQ(h5::read<std::vector<std::string>>(file, "vs_chunked"), vs);
+    EXPECT_EQ(h5::read<std::vector<std::string>>(file, "vs_fixed"), vs);
+    EXPECT_TRUE(h5::read<std::vector<std::string>>(file, "vs_empty").empty());
+    EXPECT_EQ(h5::read<std::vector<std::vector<std::string>>>(file, "vvs"),
+              (std::vector<std::vector<std::string>>{{"a", "bb"}, {std::string(500, 'y'), ""}, {"", ""}}));
+    EXPECT_THROW(h5::read<std::vector<std::string>>(file, "vvs"), std::runtime_error);
+  }
+}
+
+TEST(H5, VectorReadReusesStorage) {
+  std::vector<double> v(1000);
+  for (int i = 0; i < 1000; ++i) v[i] = 0.5 * i;
+  std::vector<std::string> vs                = {"a", "bcd", ""};
+  std::vector<std::vector<std::string>> vvs = {{"x", "yy"}, {"zzz", ""}};
+
+  h5::file file{"test_vec_storage.h5", 'w'};
+  h5::write(file, "v", v);
+  h5::write(file, "vs", vs);
+  h5::write(file, "vvs", vvs);
+
+  // vectors with a default-initializing allocator can be written and read
+  h5::default_init_vector<double> dv;
+  h5::read(file, "v", dv);
+  EXPECT_TRUE(std::equal(dv.begin(), dv.end(), v.begin(), v.end()));
+  h5::write(file, "dv", dv);
+  EXPECT_EQ(h5::read<std::vector<double>>(file, "dv"), v);
+
+  // repeated reads of the same size reuse the storage of the vector
+  auto const *ptr = dv.data();
+  h5::read(file, "v", dv);
+  EXPECT_EQ(dv.data(), ptr);
+  std::vector<double> v_in(1000, -1.0);
+  ptr = v_in.data();
+  h5::read(file, "v", v_in);
+  EXPECT_EQ(v_in.data(), ptr);
+  EXPECT_EQ(v_in, v);
+
+  // vectors of strings are overwritten
+  std::vector<std::string> vs_in = {"old", "old", "old", "old"};
+  h5::read(file, "vs", vs_in);
+  EXPECT_EQ(vs_in, vs);
+  std::vector<std::vector<std::string>> vvs_in = {{"old"}};
+  h5::read(file, "vvs", vvs_in);
+  EXPECT_EQ(vvs_in, vvs);
+  EXPECT_THROW(h5::read(file, "vvs", vs_in), std::runtime_error);
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2024 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Thomas Hahn
+
+#include <gtest/gtest.h>
+#include <h5/h5.hpp>
+
+#include <hdf5.h>
+
+#include <complex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // Contiguous 2d view on a vector.
+  template <typename T>
+  h5::array_interface::array_view make_view(std::vector<T> &v, h5::hsize_t n0, h5::hsize_t n1) {
+    h5::array_interface::array_view view(h5::hdf5_type<T>(), (void *)v.data(), 2, false);
+    view.slab.count   = {n0, n1};
+    view.parent_shape = {n0, n1};
+    return view;
+  }
+
+} // namespace
+
+TEST(H5, VirtualDatasetConcatenate) {
+  // each "rank" writes a 2d block into its own file
+  h5::hsize_t const n1 = 4;
+  std::vector<std::vector<double>> blocks;
+  std::vector<std::string> const fnames{"vds_rank0.h5", "vds_rank1.h5", "vds_rank2.h5"};
+  for (int r = 0; r < 3; ++r) {
+    auto n0 = static_cast<h5::hsize_t>(r + 1);
+    blocks.emplace_back(n0 * n1);
+    std::iota(blocks.back().begin(), blocks.back().end(), 100.0 * r);
+    h5::file f(fnames[r], 'w');
+    h5::array_interface::write(f, "data", make_view(blocks.back(), n0, n1), h5::write_options{});
+    h5::write(f, "cplx", std::vector<std::complex<double>>(2, {1.0 * r, -1.0 * r}));
+  }
+
+  // concatenate them along the first axis without copying
+  {
+    h5::file file("vds.h5", 'w');
+    auto ds = h5::array_interface::concatenate_virtual(file, "data", {{"vds_rank0.h5", "data"}, {"vds_rank1.h5", "data"}, {"vds_rank2.h5", "data"}});
+    EXPECT_EQ(h5::array_interface::get_dataset_shape(ds), (h5::v_t{6, n1}));
+    auto dcpl = h5::proplist{H5Dget_create_plist(ds)};
+    EXPECT_EQ(H5Pget_layout(dcpl), H5D_VIRTUAL);
+    h5::array_interface::concatenate_virtual(file, "cplx", {{"vds_rank0.h5", "cplx"}, {"vds_rank2.h5", "cplx"}});
+  }
+
+  // read the whole array and a hyperslab which crosses the source boundaries
+  h5::file file("vds.h5", 'r');
+  std::vector<double> all(6 * n1), expected;
+  for (auto const &b : blocks) expected.insert(expected.end(), b.begin(), b.end());
+  h5::array_interface::read(file, "data", make_view(all, 6, n1));
+  EXPECT_EQ(all, expected);
+
+  std::vector<double> part(3 * 2);
+  auto view = make_view(part, 3, 2);
+  h5::array_interface::hyperslab slab(2, false);
+  slab.offset = {0, 1};
+  slab.count  = {3, 2};
+  h5::array_interface::read(file, "data", view, slab);
+  EXPECT_EQ(part, (std::vector<double>{1, 2, 101, 102, 105, 106}));
+
+  // complex sources keep their attribute
+  using cvec = std::vector<std::complex<double>>;
+  EXPECT_EQ(h5::read<cvec>(file, "cplx"), (cvec{{0.0, 0.0}, {0.0, 0.0}, {2.0, -2.0}, {2.0, -2.0}}));
+
+  // sources have to be compatible
+  h5::file out("vds_bad.h5", 'w');
+  EXPECT_THROW(h5::array_interface::concatenate_virtual(out, "bad", {{"vds_rank0.h5", "data"}, {"vds_rank0.h5", "cplx"}}), std::runtime_error);
+  EXPECT_THROW(h5::array_interface::concatenate_virtual(out, "bad", {{"vds_rank0.h5", "data"}}, 2), std::runtime_error);
+}
+
+TEST(H5, VirtualDatasetMappings) {
+  h5::file file("vds_mappings.h5", 'w');
+  std::vector<int> even(5), odd(10);
+  std::iota(even.begin(), even.end(), 0);
+  std::iota(odd.begin(), odd.end(), 100);
+  h5::write(file, "even", even, h5::write_options{});
+  h5::write(file, "odd", odd, h5::write_options{});
+
+  // interleave the source datasets and leave the last elements unmapped
+  using h5::array_interface::hyperslab;
+  hyperslab dst_even(1, false), dst_odd(1, false), src_odd(1, false);
+  dst_even.count  = {5};
+  dst_even.stride = {2};
+  dst_odd         = dst_even;
+  dst_odd.offset  = {1};
+  src_odd.offset  = {2};
+  src_odd.count   = {5};
+  h5::array_interface::create_virtual_dataset(file, "mixed", h5::hdf5_type<int>(), {12},
+                                              {{".", "even", dst_even}, {".", "odd", dst_odd, src_odd}});
+  EXPECT_EQ(h5::read<std::vector<int>>(file, "mixed"), (std::vector<int>{0, 102, 1, 103, 2, 104, 3, 105, 4, 106, 0, 0}));
+
+  // the selections have to contain the same number of elements
+  src_odd.count = {4};
+  EXPECT_THROW(h5::array_interface::create_virtual_dataset(file, "bad", h5::hdf5_type<int>(), {12}, {{".", "odd", dst_odd, src_odd}}),
+               std::runtime_error);
+}
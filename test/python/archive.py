@@ -185,5 +185,24 @@ class TestHdf5Io(unittest.TestCase):
             with self.assertRaises(RuntimeError) :
                 a.create_softlink('data', 'link', delete_if_exists = False)
 
+    def test_columnar_dict(self):
+        # maps with numeric or string keys and numeric values written by the C++ library
+        with HDFArchive('columnar_dict.ref.h5', 'r') as arch:
+            str_keys = arch['str_keys']
+            int_keys = arch['int_keys']
+
+        self.assertEqual(str_keys, {'a': 0.5, 'b': 1.5, 'c': 2.5})
+        self.assertEqual(int_keys, {1: 1.0 - 1.0j, 3: 2.0j})
+
+    def test_compact_tuple(self):
+        # tuples and pairs of numeric values written by the C++ library as scalar compound datasets
+        with HDFArchive('compact_tuple.ref.h5', 'r') as arch:
+            tup = arch['tuple']
+            pair = arch['pair']
+
+        self.assertEqual(tup, (-3, 2.5, 1.0 - 2.0j, True, 7))
+        self.assertIs(type(tup[3]), bool)
+        self.assertEqual(pair, (42, 0.5))
+
 if __name__ == '__main__':
     unittest.main()
@@ -105,5 +105,67 @@ class TestH5Interface(unittest.TestCase):
             assert_arrays_are_close(r, a)
             c += 1 
 
+    def test_h5_read_into(self):
+
+        f = h5.File("test_read_into.h5", 'w')
+        g = h5.Group(f)
+        a = np.arange(12, dtype=float).reshape(3, 4)
+        h5.h5_write(g, 'a', a)
+        h5.h5_write(g, 'c', a + 1j * a)
+
+        # read into contiguous and strided arrays
+        out = np.zeros((3, 4))
+        h5.h5_read_into(g, 'a', out)
+        assert_arrays_are_close(out, a)
+
+        big = np.zeros((6, 8))
+        h5.h5_read_into(g, 'a', big[::2, ::2])
+        assert_arrays_are_close(big[::2, ::2], a)
+        self.assertEqual(np.abs(big[1::2, :]).max(), 0)
+
+        cout = np.zeros((3, 4), complex)
+        h5.h5_read_into(g, 'c', cout)
+        assert_arrays_are_close(cout, a + 1j * a)
+
+        # shape mismatches and read-only arrays
+        with self.assertRaises(ValueError):
+            h5.h5_read_into(g, 'a', np.zeros((4, 3)))
+        with self.assertRaises(ValueError):
+            h5.h5_read_into(g, 'a', np.zeros((3, 4), complex))
+        out.flags.writeable = False
+        with self.assertRaises(ValueError):
+            h5.h5_read_into(g, 'a', out)
+
+    def test_h5_dict_tree(self):
+
+        d = {'a': np.arange(5.0), 'i': 3, 's': "text", 'c': np.ones((2, 2), complex),
+             'sub': {'b': np.zeros((3, 2), int), 'x': 1.5, 'l': [1, np.arange(3), "t"], 't': (2, 3)}}
+
+        f = h5.File("test_tree.h5", 'w')
+        h5.h5_write_dict(h5.Group(f), d)
+        del f
+
+        f = h5.File("test_tree.h5", 'r')
+        r = h5.h5_read_tree(h5.Group(f))
+        self.assertEqual(sorted(r.keys()), sorted(d.keys()))
+        assert_arrays_are_close(r['a'], d['a'])
+        assert_arrays_are_close(r['c'], d['c'])
+        self.assertEqual(r['i'], 3)
+        self.assertEqual(r['s'], "text")
+        assert_arrays_are_close(r['sub']['b'], d['sub']['b'])
+        self.assertEqual(r['sub']['x'], 1.5)
+        self.assertEqual(r['sub']['t'], (2, 3))
+        self.assertEqual(len(r['sub']['l']), 3)
+        assert_arrays_are_close(r['sub']['l'][1], np.arange(3))
+        del f
+
+        # list groups with keys which are not indices can not be read
+        f = h5.File("test_tree_bad_key.h5", 'w')
+        g = h5.Group(f).create_group('l')
+        h5.h5_write_dict(g, {'0': 1, 'x': 2})
+        g.write_attribute('Format', 'List')
+        with self.assertRaises(RuntimeError):
+            h5.h5_read_tree(h5.Group(f))
+
 if __name__ == '__main__':
     unittest.main()